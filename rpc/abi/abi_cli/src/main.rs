@@ -182,6 +182,8 @@ enum Commands {
 enum Language {
     /// Generate C code (.h and .c files)
     C,
+    /// Generate header-only C++20 views (.hpp files)
+    Cpp,
     /// Generate Rust code (.rs files)
     Rust,
     /// Generate TypeScript code (.ts files)
@@ -208,6 +210,7 @@ fn main() -> anyhow::Result<()> {
         } => {
             let lang = match language {
                 Language::C => abi_gen::cmds::codegen::Language::C,
+                Language::Cpp => abi_gen::cmds::codegen::Language::Cpp,
                 Language::Rust => abi_gen::cmds::codegen::Language::Rust,
                 Language::TypeScript => abi_gen::cmds::codegen::Language::TypeScript,
             };
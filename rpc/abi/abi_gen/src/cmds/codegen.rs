@@ -8,6 +8,7 @@ use std::path::PathBuf;
 #[derive(Copy, Clone, PartialEq, Eq, PartialOrd, Ord, Debug)]
 pub enum Language {
     C,
+    Cpp,
     Rust,
     TypeScript,
 }
@@ -161,6 +162,43 @@ fn generate_code(
                 }
             }
         }
+        Language::Cpp => {
+            use crate::codegen::cpp;
+
+            /* Generate code for each package in its own directory */
+            for (package, package_types) in &types_by_package {
+                /* Convert package name to directory path (e.g., "thru.common.primitives" -> "thru/common/primitives") */
+                let package_dir = package.replace('.', "/");
+                let full_output_dir = output_dir.join(&package_dir);
+
+                std::fs::create_dir_all(&full_output_dir)?;
+
+                if verbose {
+                    println!(
+                        "[~] Generating code for package '{}' in {}",
+                        package,
+                        full_output_dir.display()
+                    );
+                }
+
+                let options = cpp::CppCodeGeneratorOptions {
+                    output_dir: full_output_dir.to_string_lossy().to_string(),
+                    package: Some(package.clone()),
+                    all_packages: types_by_package.keys().cloned().collect(),
+                    import_resolver: Some(import_resolver),
+                };
+                let generator = cpp::CppCodeGenerator::new(type_resolver, options);
+                generator.emit_code(package_types);
+            }
+
+            if verbose {
+                println!("[✓] Generated C++ code in package directories:");
+                for package in types_by_package.keys() {
+                    let package_dir = package.replace('.', "/");
+                    println!("    - {}/{}/types.hpp", output_dir.display(), package_dir);
+                }
+            }
+        }
         Language::Rust => {
             use crate::codegen::rust;
 
@@ -0,0 +1,159 @@
+use crate::abi::resolved::{ResolvedType, ResolvedTypeKind, TypeResolver};
+use crate::codegen::cpp_gen::helpers::{CppTypeNames, package_namespace};
+use crate::codegen::cpp_gen::{CPP_RUNTIME, CppContext, ViewEmitter, emit_layout};
+use std::collections::BTreeSet;
+use std::fs;
+
+/* Header-only C++20 views: one types.hpp per package holding layout
+structs for fixed-size types and zero-copy View / Mut classes over
+std::span for every type.  The header needs nothing beyond the standard
+library, so on-chain programs and host tools include the same file. */
+pub struct CppCodeGenerator<'a> {
+    resolver: &'a TypeResolver,
+    options: CppCodeGeneratorOptions<'a>,
+}
+
+pub struct CppCodeGeneratorOptions<'a> {
+    pub output_dir: String,
+    pub package: Option<String>,
+    pub all_packages: Vec<String>,
+    pub import_resolver: Option<&'a crate::abi::file::ImportResolver>,
+}
+
+impl<'a> Default for CppCodeGeneratorOptions<'a> {
+    fn default() -> Self {
+        Self {
+            output_dir: ".".to_string(), // Default to current directory, should be overridden
+            package: None,
+            all_packages: Vec::new(),
+            import_resolver: None,
+        }
+    }
+}
+
+impl<'a> CppCodeGenerator<'a> {
+    pub fn new(resolver: &'a TypeResolver, options: CppCodeGeneratorOptions<'a>) -> Self {
+        Self { resolver, options }
+    }
+
+    pub fn emit_code(self, resolved_types: &[&ResolvedType]) -> String {
+        let ctx = CppContext {
+            resolver: self.resolver,
+            names: CppTypeNames {
+                package: self.options.package.as_deref(),
+                import_resolver: self.options.import_resolver,
+            },
+        };
+        let views = ViewEmitter::new(&ctx);
+
+        let mut types_output = String::new();
+        for resolved_type in resolved_types {
+            types_output.push_str(&emit_layout(resolved_type, &ctx));
+            types_output.push_str(&views.emit_view(resolved_type));
+        }
+        if types_output.is_empty() {
+            return types_output;
+        }
+
+        let mut header_output = String::from("#pragma once\n\n");
+        for include in [
+            "array",
+            "bit",
+            "cstddef",
+            "cstdint",
+            "cstring",
+            "span",
+            "type_traits",
+        ] {
+            header_output.push_str(&format!("#include <{}>\n", include));
+        }
+        header_output.push('\n');
+
+        /* Add includes for imported types from other packages */
+        if let (Some(current_package), Some(import_resolver)) =
+            (&self.options.package, &self.options.import_resolver)
+        {
+            let mut includes = BTreeSet::new();
+            for resolved_type in resolved_types {
+                collect_type_dependencies(resolved_type, &mut includes, import_resolver);
+            }
+            includes.remove(current_package);
+            for dep_package in &includes {
+                header_output.push_str(&format!(
+                    "#include \"{}/types.hpp\"\n",
+                    get_relative_include_path(current_package, dep_package)
+                ));
+            }
+            if !includes.is_empty() {
+                header_output.push('\n');
+            }
+        }
+
+        header_output.push_str(CPP_RUNTIME);
+        header_output.push('\n');
+        match &self.options.package {
+            Some(package) => {
+                let namespace = package_namespace(package);
+                header_output.push_str(&format!("namespace {} {{\n\n", namespace));
+                header_output.push_str(&types_output);
+                header_output.push_str(&format!("}} // namespace {}\n", namespace));
+            }
+            None => header_output.push_str(&types_output),
+        }
+
+        let types_path = format!("{}/types.hpp", self.options.output_dir);
+        if let Err(e) = fs::write(&types_path, &header_output) {
+            eprintln!("Warning: Failed to write types to {}: {}", types_path, e);
+        }
+        header_output
+    }
+}
+
+/* Packages whose types resolved_type refers to */
+fn collect_type_dependencies(
+    resolved_type: &ResolvedType,
+    includes: &mut BTreeSet<String>,
+    import_resolver: &crate::abi::file::ImportResolver,
+) {
+    match &resolved_type.kind {
+        ResolvedTypeKind::Struct { fields, .. } | ResolvedTypeKind::Union { variants: fields } => {
+            for field in fields {
+                collect_type_dependencies(&field.field_type, includes, import_resolver);
+            }
+        }
+        ResolvedTypeKind::Enum { variants, .. } => {
+            for variant in variants {
+                collect_type_dependencies(&variant.variant_type, includes, import_resolver);
+            }
+        }
+        ResolvedTypeKind::SizeDiscriminatedUnion { variants } => {
+            for variant in variants {
+                collect_type_dependencies(&variant.variant_type, includes, import_resolver);
+            }
+        }
+        ResolvedTypeKind::Array { element_type, .. } => {
+            collect_type_dependencies(element_type, includes, import_resolver);
+        }
+        ResolvedTypeKind::TypeRef { target_name, .. } => {
+            if let Some(package) = import_resolver.get_package_for_type(target_name) {
+                includes.insert(package);
+            }
+        }
+        ResolvedTypeKind::Primitive { .. } => {}
+    }
+}
+
+/* Relative path from current package's directory to dependency package's */
+fn get_relative_include_path(from_package: &str, to_package: &str) -> String {
+    let from_parts: Vec<&str> = from_package.split('.').collect();
+    let to_parts: Vec<&str> = to_package.split('.').collect();
+    let common_len = from_parts
+        .iter()
+        .zip(&to_parts)
+        .take_while(|(f, t)| f == t)
+        .count();
+
+    let mut path_parts = vec![".."; from_parts.len() - common_len];
+    path_parts.extend(&to_parts[common_len..]);
+    path_parts.join("/")
+}
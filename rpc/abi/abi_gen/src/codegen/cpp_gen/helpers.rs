@@ -0,0 +1,286 @@
+/* Naming and type helpers for C++ codegen */
+
+use crate::abi::expr::LiteralExpr;
+use crate::abi::file::ImportResolver;
+use crate::abi::types::{FloatingPointType, IntegralType, PrimitiveType};
+
+/* Names every generated view defines for itself.  A schema field or
+variant with one of these names gets a trailing underscore instead. */
+const RESERVED_MEMBERS: &[&str] = &[
+    "as_bytes",
+    "buffer_size",
+    "footprint",
+    "outer",
+    "validate",
+    "validated_size",
+    "view",
+    "Layout",
+    "SIZE",
+    "TAGGED",
+];
+
+/* Further names enum, union and size-discriminated union views define */
+const RESERVED_VARIANTS: &[&str] = &["tag", "Tag"];
+
+const CPP_KEYWORDS: &[&str] = &[
+    "alignas",
+    "alignof",
+    "and",
+    "and_eq",
+    "asm",
+    "auto",
+    "bitand",
+    "bitor",
+    "bool",
+    "break",
+    "case",
+    "catch",
+    "char",
+    "char8_t",
+    "char16_t",
+    "char32_t",
+    "class",
+    "co_await",
+    "co_return",
+    "co_yield",
+    "compl",
+    "concept",
+    "const",
+    "consteval",
+    "constexpr",
+    "constinit",
+    "const_cast",
+    "continue",
+    "decltype",
+    "default",
+    "delete",
+    "do",
+    "double",
+    "dynamic_cast",
+    "else",
+    "enum",
+    "explicit",
+    "export",
+    "extern",
+    "false",
+    "float",
+    "for",
+    "friend",
+    "goto",
+    "if",
+    "inline",
+    "int",
+    "long",
+    "mutable",
+    "namespace",
+    "new",
+    "noexcept",
+    "not",
+    "not_eq",
+    "nullptr",
+    "operator",
+    "or",
+    "or_eq",
+    "private",
+    "protected",
+    "public",
+    "register",
+    "reinterpret_cast",
+    "requires",
+    "return",
+    "short",
+    "signed",
+    "sizeof",
+    "static",
+    "static_assert",
+    "static_cast",
+    "struct",
+    "switch",
+    "template",
+    "this",
+    "thread_local",
+    "throw",
+    "true",
+    "try",
+    "typedef",
+    "typeid",
+    "typename",
+    "union",
+    "unsigned",
+    "using",
+    "virtual",
+    "void",
+    "volatile",
+    "wchar_t",
+    "while",
+    "xor",
+    "xor_eq",
+    // Names the generated code relies on
+    "std",
+    "abi_rt",
+];
+
+fn sanitize_identifier(name: &str) -> String {
+    let mut sanitized: String = name
+        .chars()
+        .map(|c| {
+            if c.is_ascii_alphanumeric() || c == '_' {
+                c
+            } else {
+                '_'
+            }
+        })
+        .collect();
+
+    if sanitized.is_empty() {
+        sanitized.push('_');
+    }
+
+    if sanitized
+        .chars()
+        .next()
+        .map(|c| c.is_ascii_digit())
+        .unwrap_or(false)
+    {
+        sanitized.insert(0, '_');
+    }
+
+    sanitized
+}
+
+/* Sanitize a type or namespace name, escaping C++ keywords */
+pub fn escape_cpp_keyword(name: &str) -> String {
+    let mut sanitized = sanitize_identifier(name);
+    if CPP_KEYWORDS.contains(&sanitized.as_str()) {
+        sanitized.push('_');
+    }
+    sanitized
+}
+
+/* Sanitize a field or variant name used as a member, also escaping the
+names views define for themselves */
+pub fn escape_cpp_member(name: &str) -> String {
+    let mut sanitized = escape_cpp_keyword(name);
+    if RESERVED_MEMBERS.contains(&sanitized.as_str()) {
+        sanitized.push('_');
+    }
+    sanitized
+}
+
+/* As escape_cpp_member, for an enum or union variant */
+pub fn escape_cpp_variant(name: &str) -> String {
+    let mut sanitized = escape_cpp_member(name);
+    if RESERVED_VARIANTS.contains(&sanitized.as_str()) {
+        sanitized.push('_');
+    }
+    sanitized
+}
+
+/* snake_case field name to the PascalCase stem of a nested class name */
+pub fn pascal_case(name: &str) -> String {
+    let mut out = String::new();
+    let mut upper = true;
+    for c in sanitize_identifier(name).chars() {
+        if c == '_' {
+            upper = true;
+        } else if upper {
+            out.push(c.to_ascii_uppercase());
+            upper = false;
+        } else {
+            out.push(c);
+        }
+    }
+    if out.is_empty() || out.starts_with(|c: char| c.is_ascii_digit()) {
+        out.insert(0, 'F');
+    }
+    out
+}
+
+pub fn primitive_to_cpp_type(prim_type: &PrimitiveType) -> &'static str {
+    match prim_type {
+        PrimitiveType::Integral(int_type) => match int_type {
+            IntegralType::U8 => "std::uint8_t",
+            IntegralType::U16 => "std::uint16_t",
+            IntegralType::U32 => "std::uint32_t",
+            IntegralType::U64 => "std::uint64_t",
+            IntegralType::I8 => "std::int8_t",
+            IntegralType::I16 => "std::int16_t",
+            IntegralType::I32 => "std::int32_t",
+            IntegralType::I64 => "std::int64_t",
+            IntegralType::Char => "std::uint8_t",
+        },
+        PrimitiveType::FloatingPoint(float_type) => match float_type {
+            /* No portable half type before C++23; callers get the raw bits */
+            FloatingPointType::F16 => "std::uint16_t",
+            FloatingPointType::F32 => "float",
+            FloatingPointType::F64 => "double",
+        },
+    }
+}
+
+pub fn literal_to_cpp(literal: &LiteralExpr) -> String {
+    match literal {
+        LiteralExpr::U64(v) => format!("{}ULL", v),
+        LiteralExpr::U32(v) => format!("{}ULL", v),
+        LiteralExpr::U16(v) => format!("{}ULL", v),
+        LiteralExpr::U8(v) => format!("{}ULL", v),
+        LiteralExpr::I64(v) => format!("static_cast<std::uint64_t>({}LL)", v),
+        LiteralExpr::I32(v) => format!("static_cast<std::uint64_t>({}LL)", v),
+        LiteralExpr::I16(v) => format!("static_cast<std::uint64_t>({}LL)", v),
+        LiteralExpr::I8(v) => format!("static_cast<std::uint64_t>({}LL)", v),
+    }
+}
+
+/* "thru.common.primitives" -> "thru::common::primitives" */
+pub fn package_namespace(package: &str) -> String {
+    package
+        .split('.')
+        .map(escape_cpp_keyword)
+        .collect::<Vec<_>>()
+        .join("::")
+}
+
+/* Qualifies top-level type names, so a generated header can name types
+from its own package and from the packages it includes alike */
+pub struct CppTypeNames<'a> {
+    pub package: Option<&'a str>,
+    pub import_resolver: Option<&'a ImportResolver>,
+}
+
+impl<'a> CppTypeNames<'a> {
+    fn prefix(&self, type_name: &str) -> String {
+        let package = self
+            .import_resolver
+            .and_then(|resolver| resolver.get_package_for_type(type_name))
+            .or_else(|| self.package.map(str::to_string));
+        match package {
+            Some(package) => format!("::{}::", package_namespace(&package)),
+            None => "::".to_string(),
+        }
+    }
+
+    /* The layout struct (or alias) mirroring a fixed-size type */
+    pub fn layout(&self, type_name: &str) -> String {
+        format!(
+            "{}{}",
+            self.prefix(type_name),
+            escape_cpp_keyword(type_name)
+        )
+    }
+
+    pub fn view(&self, type_name: &str) -> String {
+        format!(
+            "{}{}View",
+            self.prefix(type_name),
+            escape_cpp_keyword(type_name)
+        )
+    }
+
+    pub fn view_mut(&self, type_name: &str) -> String {
+        format!(
+            "{}{}Mut",
+            self.prefix(type_name),
+            escape_cpp_keyword(type_name)
+        )
+    }
+}
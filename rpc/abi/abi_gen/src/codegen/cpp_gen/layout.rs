@@ -0,0 +1,235 @@
+/* Layout structs for fixed-size C++ types.
+
+A type whose size is constant and which is built only from primitives,
+fixed arrays and structs gets a trivially copyable struct whose member
+offsets match the wire layout exactly: packed types are
+__attribute__((packed)), aligned types keep natural alignment and name
+their padding, so the struct has no unnamed padding bytes.  These are
+what fixed-size account, instruction and event layouts are declared
+with in C++ programs. */
+
+use super::CppContext;
+use super::helpers::{escape_cpp_keyword, escape_cpp_member, pascal_case, primitive_to_cpp_type};
+use crate::abi::resolved::{ConstantStatus, ResolvedType, ResolvedTypeKind, Size};
+use std::fmt::Write;
+
+/* True if ty (at any nesting) can be mirrored by a layout struct */
+pub fn has_layout(ty: &ResolvedType, ctx: &CppContext) -> bool {
+    if !matches!(ty.size, Size::Const(_)) {
+        return false;
+    }
+    match &ty.kind {
+        ResolvedTypeKind::Primitive { .. } => true,
+        ResolvedTypeKind::Struct { fields, .. } => fields
+            .iter()
+            .all(|field| field.offset.is_some() && has_layout(&field.field_type, ctx)),
+        ResolvedTypeKind::Array {
+            element_type,
+            size_expression,
+            size_constant_status,
+            ..
+        } => {
+            matches!(size_constant_status, ConstantStatus::Constant)
+                && ctx
+                    .resolver
+                    .evaluate_constant_expression(size_expression)
+                    .is_some()
+                && has_layout(element_type, ctx)
+        }
+        ResolvedTypeKind::TypeRef { target_name, .. } => ctx
+            .target(target_name)
+            .map_or(false, |target| has_layout(target, ctx)),
+        ResolvedTypeKind::Enum { .. }
+        | ResolvedTypeKind::Union { .. }
+        | ResolvedTypeKind::SizeDiscriminatedUnion { .. } => false,
+    }
+}
+
+/* Layout struct or alias for a top-level type, or "" if it has none */
+pub fn emit_layout(ty: &ResolvedType, ctx: &CppContext) -> String {
+    if !has_layout(ty, ctx) {
+        return String::new();
+    }
+
+    let name = escape_cpp_keyword(&ty.name);
+    let mut output = String::new();
+    if let Some(comment) = &ty.comment {
+        writeln!(output, "/* {} */", comment).unwrap();
+    }
+    match &ty.kind {
+        ResolvedTypeKind::Struct { .. } => {
+            emit_layout_struct(&name, ty, ctx, "", &mut output);
+            emit_layout_asserts(&name, ty, &mut output);
+        }
+        _ => {
+            let target = member_type(&ty.name, ty, ctx, "", &mut output);
+            writeln!(output, "using {} = {};", name, target).unwrap();
+        }
+    }
+    output.push('\n');
+    output
+}
+
+fn emit_layout_struct(
+    name: &str,
+    ty: &ResolvedType,
+    ctx: &CppContext,
+    indent: &str,
+    output: &mut String,
+) {
+    let ResolvedTypeKind::Struct {
+        fields,
+        packed,
+        custom_alignment,
+    } = &ty.kind
+    else {
+        return;
+    };
+    let Size::Const(size) = ty.size else {
+        return;
+    };
+
+    /* A packed struct with a custom alignment that does not divide its
+    size cannot be expressed without tail padding; it is laid out at
+    byte alignment instead, which is always safe to read */
+    let attributes = match (packed, custom_alignment) {
+        (true, Some(align)) if size % align == 0 => {
+            format!("__attribute__((packed, aligned({}))) ", align)
+        }
+        (true, _) => "__attribute__((packed)) ".to_string(),
+        (false, Some(align)) => format!("alignas({}) ", align),
+        (false, None) => String::new(),
+    };
+
+    let inner = format!("{}  ", indent);
+    let mut members = String::new();
+    let mut nested = String::new();
+    let mut cursor = 0u64;
+    let mut pad_idx = 0usize;
+    for field in fields {
+        let offset = field.offset.unwrap_or(cursor);
+        if offset > cursor {
+            writeln!(
+                members,
+                "{}std::uint8_t _pad{}[{}];",
+                inner,
+                pad_idx,
+                offset - cursor
+            )
+            .unwrap();
+            pad_idx += 1;
+        }
+        let member = member_type(&field.name, &field.field_type, ctx, &inner, &mut nested);
+        writeln!(
+            members,
+            "{}{} {};",
+            inner,
+            member,
+            escape_cpp_member(&field.name)
+        )
+        .unwrap();
+        if let Size::Const(field_size) = field.field_type.size {
+            cursor = offset + field_size;
+        }
+    }
+    if size > cursor {
+        writeln!(
+            members,
+            "{}std::uint8_t _pad{}[{}];",
+            inner,
+            pad_idx,
+            size - cursor
+        )
+        .unwrap();
+    }
+
+    writeln!(output, "{}struct {}{} {{", indent, attributes, name).unwrap();
+    output.push_str(&nested);
+    output.push_str(&members);
+    writeln!(output, "{}}};", indent).unwrap();
+}
+
+/* The member type for a field of type ty, emitting a nested struct into
+nested when the field declares one inline */
+fn member_type(
+    field_name: &str,
+    ty: &ResolvedType,
+    ctx: &CppContext,
+    indent: &str,
+    nested: &mut String,
+) -> String {
+    match &ty.kind {
+        ResolvedTypeKind::Primitive { prim_type } => primitive_to_cpp_type(prim_type).to_string(),
+        ResolvedTypeKind::TypeRef { target_name, .. } => ctx.names.layout(target_name),
+        ResolvedTypeKind::Array {
+            element_type,
+            size_expression,
+            ..
+        } => {
+            let count = ctx
+                .resolver
+                .evaluate_constant_expression(size_expression)
+                .unwrap_or(0);
+            let element = member_type(field_name, element_type, ctx, indent, nested);
+            format!("std::array<{}, {}>", element, count)
+        }
+        ResolvedTypeKind::Struct { .. } => {
+            let name = pascal_case(field_name);
+            emit_layout_struct(&name, ty, ctx, indent, nested);
+            name
+        }
+        ResolvedTypeKind::Enum { .. }
+        | ResolvedTypeKind::Union { .. }
+        | ResolvedTypeKind::SizeDiscriminatedUnion { .. } => "std::uint8_t".to_string(),
+    }
+}
+
+fn emit_layout_asserts(name: &str, ty: &ResolvedType, output: &mut String) {
+    let (ResolvedTypeKind::Struct { fields, .. }, Size::Const(size)) = (&ty.kind, &ty.size) else {
+        return;
+    };
+    writeln!(
+        output,
+        "static_assert(sizeof({}) == {}, \"{} layout size\");",
+        name, size, name
+    )
+    .unwrap();
+    writeln!(
+        output,
+        "static_assert(alignof({}) == {}, \"{} layout alignment\");",
+        name,
+        layout_alignment(ty),
+        name
+    )
+    .unwrap();
+    for field in fields {
+        if let Some(offset) = field.offset {
+            writeln!(
+                output,
+                "static_assert(offsetof({}, {}) == {}, \"{}::{} offset\");",
+                name,
+                escape_cpp_member(&field.name),
+                offset,
+                name,
+                field.name
+            )
+            .unwrap();
+        }
+    }
+}
+
+/* alignof the layout struct emit_layout_struct produces for ty */
+fn layout_alignment(ty: &ResolvedType) -> u64 {
+    match (&ty.kind, &ty.size) {
+        (
+            ResolvedTypeKind::Struct {
+                packed: true,
+                custom_alignment: Some(align),
+                ..
+            },
+            Size::Const(size),
+        ) if size % align == 0 => *align,
+        (ResolvedTypeKind::Struct { packed: true, .. }, _) => 1,
+        _ => ty.alignment,
+    }
+}
@@ -0,0 +1,25 @@
+pub mod helpers;
+pub mod layout;
+pub mod runtime;
+pub mod views;
+
+use crate::abi::resolved::{ResolvedType, TypeResolver};
+use helpers::CppTypeNames;
+
+// Re-export main public functions
+pub use layout::{emit_layout, has_layout};
+pub use runtime::CPP_RUNTIME;
+pub use views::ViewEmitter;
+
+/* What the emitters need to know beyond the type at hand */
+pub struct CppContext<'a> {
+    pub resolver: &'a TypeResolver,
+    pub names: CppTypeNames<'a>,
+}
+
+impl<'a> CppContext<'a> {
+    /* A top-level type, from this package or an imported one */
+    pub fn target(&self, type_name: &str) -> Option<&'a ResolvedType> {
+        self.resolver.types.get(type_name)
+    }
+}
@@ -0,0 +1,99 @@
+/* Runtime support every generated C++ header carries.  Each package's
+header embeds the same block behind one include guard, so headers from
+several packages can be included together without a shared runtime file. */
+
+pub const CPP_RUNTIME: &str = r#"#ifndef THRU_ABI_CPP_RUNTIME_V1
+#define THRU_ABI_CPP_RUNTIME_V1
+
+/* Views read wire data in place with unaligned little-endian loads:
+   validate() (or validated_size()) once at the trust boundary, then
+   every accessor is a load at a constant or lazily computed offset. */
+namespace abi_rt {
+
+static_assert(std::endian::native == std::endian::little,
+              "abi_gen views read little-endian wire data in place");
+
+/* validated_size() / footprint() of bytes holding no well-formed value */
+inline constexpr std::uint64_t INVALID = ~std::uint64_t{0};
+
+template <typename T> inline T load(std::span<const std::byte> data, std::uint64_t off) {
+  T value;
+  std::memcpy(&value, data.data() + off, sizeof(T));
+  return value;
+}
+
+template <typename T> inline void store(std::span<std::byte> data, std::uint64_t off, T value) {
+  std::memcpy(data.data() + off, &value, sizeof(T));
+}
+
+inline constexpr std::uint64_t align_up(std::uint64_t value, std::uint64_t align) {
+  return (value + align - 1U) & ~(align - 1U);
+}
+
+/* Size arithmetic on untrusted counts; INVALID absorbs */
+inline constexpr std::uint64_t add(std::uint64_t a, std::uint64_t b) {
+  std::uint64_t r;
+  return __builtin_add_overflow(a, b, &r) || r == INVALID ? INVALID : r;
+}
+
+inline constexpr std::uint64_t mul(std::uint64_t a, std::uint64_t b) {
+  std::uint64_t r;
+  return __builtin_mul_overflow(a, b, &r) || r == INVALID ? INVALID : r;
+}
+
+/* Size and tag expression operators, defined for every operand */
+inline constexpr std::uint64_t div(std::uint64_t a, std::uint64_t b) { return b ? a / b : 0U; }
+inline constexpr std::uint64_t mod(std::uint64_t a, std::uint64_t b) { return b ? a % b : 0U; }
+inline constexpr std::uint64_t shl(std::uint64_t a, std::uint64_t b) { return b < 64U ? a << b : 0U; }
+inline constexpr std::uint64_t shr(std::uint64_t a, std::uint64_t b) { return b < 64U ? a >> b : 0U; }
+
+inline constexpr std::uint64_t pow(std::uint64_t base, std::uint64_t exp) {
+  std::uint64_t r = 1U;
+  for (; exp; exp >>= 1) {
+    if (exp & 1U) {
+      r *= base;
+    }
+    base *= base;
+  }
+  return r;
+}
+
+/* cnt primitives of type T */
+template <typename T> class Array {
+public:
+  constexpr Array(std::span<const std::byte> data, std::uint64_t cnt) : data_(data), cnt_(cnt) {}
+
+  std::uint64_t size() const { return cnt_; }
+  T operator[](std::uint64_t i) const { return load<T>(data_, i * sizeof(T)); }
+
+  std::uint64_t footprint() const { return cnt_ * sizeof(T); }
+  std::uint64_t validated_size() const {
+    std::uint64_t sz = mul(cnt_, sizeof(T));
+    return sz <= data_.size() ? sz : INVALID;
+  }
+  std::span<const std::byte> as_bytes() const { return data_.first(footprint()); }
+
+private:
+  std::span<const std::byte> data_;
+  std::uint64_t cnt_;
+};
+
+template <typename T> class MutArray {
+public:
+  constexpr MutArray(std::span<std::byte> data, std::uint64_t cnt) : data_(data), cnt_(cnt) {}
+
+  std::uint64_t size() const { return cnt_; }
+  T operator[](std::uint64_t i) const { return load<T>(data_, i * sizeof(T)); }
+  void set(std::uint64_t i, T value) const { store<T>(data_, i * sizeof(T), value); }
+
+  std::span<std::byte> as_bytes() const { return data_.first(cnt_ * sizeof(T)); }
+
+private:
+  std::span<std::byte> data_;
+  std::uint64_t cnt_;
+};
+
+} // namespace abi_rt
+
+#endif /* THRU_ABI_CPP_RUNTIME_V1 */
+"#;
@@ -0,0 +1,1503 @@
+/* Zero-copy C++ views.
+
+Every top-level type gets a view class over std::span<const std::byte>.
+Inline structs, enums, unions, size-discriminated unions and arrays of
+anything but primitives become member classes of the top-level view
+(StateProofView::ProofBodyView, ...).  A view holds its bytes and, when
+it sits inside a struct, a copy of the enclosing struct's view, so size
+and tag expressions can read fields of any enclosing struct the same
+way the resolver looks them up: innermost struct first, `..` to step
+out.
+
+Offsets the resolver fixed are static constexpr members (OFFSET_<field>);
+the rest are computed on demand from the preceding field's footprint.
+Accessors assume the bytes were accepted by validate() or
+validated_size(), which walk the layout once with checked arithmetic. */
+
+use super::CppContext;
+use super::helpers::{
+    escape_cpp_keyword, escape_cpp_member, escape_cpp_variant, literal_to_cpp, pascal_case,
+    primitive_to_cpp_type,
+};
+use super::layout::has_layout;
+use crate::abi::expr::ExprKind;
+use crate::abi::resolved::{
+    ConstantStatus, ResolvedEnumVariant, ResolvedField, ResolvedSizeDiscriminatedVariant,
+    ResolvedType, ResolvedTypeKind, Size,
+};
+use std::fmt::Write;
+
+/* Where a generated class sits */
+#[derive(Clone)]
+struct Site<'t> {
+    /* Qualified within the package namespace: Root or Root::StemView */
+    class: String,
+    /* PascalCase path from the root, used to name member classes */
+    stem: String,
+    /* The enclosing struct view this class holds as outer_, if any */
+    outer: Option<String>,
+    /* Struct scopes for field references, innermost first.  For a struct
+    class scopes[0] is the class itself. */
+    scopes: Vec<&'t [ResolvedField]>,
+    is_struct: bool,
+    /* True if the outermost scope is the top-level view itself */
+    root_is_struct: bool,
+}
+
+impl<'t> Site<'t> {
+    /* Member-access prefix reaching scope idx from inside this class */
+    fn access(&self, idx: usize) -> String {
+        let outer_idx = if self.is_struct {
+            if idx == 0 {
+                return String::new();
+            }
+            idx - 1
+        } else {
+            idx
+        };
+        let mut prefix = String::from("outer_.");
+        for _ in 0..outer_idx {
+            prefix.push_str("outer().");
+        }
+        prefix
+    }
+
+    /* A member class of this site's root */
+    fn member(
+        &self,
+        stem_suffix: &str,
+        scopes: Vec<&'t [ResolvedField]>,
+        is_struct: bool,
+    ) -> Site<'t> {
+        let stem = format!("{}{}", self.stem, stem_suffix);
+        let root = self.class.split("::").next().unwrap_or(&self.class);
+        let outer = if self.is_struct {
+            Some(self.class.clone())
+        } else {
+            self.outer.clone()
+        };
+        Site {
+            class: format!("{}::{}View", root, stem),
+            stem,
+            outer,
+            scopes,
+            is_struct,
+            root_is_struct: self.root_is_struct,
+        }
+    }
+
+    /* Struct scopes a member class inherits */
+    fn chain(&self) -> Vec<&'t [ResolvedField]> {
+        self.scopes.clone()
+    }
+
+    /* Expression passed as the outer view to a member class */
+    fn outer_arg(&self) -> Option<&'static str> {
+        if self.is_struct {
+            Some("*this")
+        } else if self.outer.is_some() {
+            Some("outer_")
+        } else {
+            None
+        }
+    }
+}
+
+/* How a field, variant or element is read */
+enum Child {
+    /* A primitive loaded by value */
+    Prim(&'static str),
+    /* A top-level type's view, built from its bytes */
+    View(String),
+    /* A member class, built from its bytes and the enclosing struct view */
+    Member {
+        class: String,
+        outer_arg: Option<&'static str>,
+    },
+    /* cnt primitives of type elem */
+    PrimArray {
+        elem: &'static str,
+        count: String,
+    },
+}
+
+impl Child {
+    fn ret_type(&self) -> String {
+        match self {
+            Child::Prim(cpp) => cpp.to_string(),
+            Child::View(class) | Child::Member { class, .. } => class.clone(),
+            Child::PrimArray { elem, .. } => format!("::abi_rt::Array<{}>", elem),
+        }
+    }
+
+    /* Builds the child over bytes (a std::span expression) */
+    fn construct(&self, bytes: &str) -> String {
+        match self {
+            Child::Prim(_) => unreachable!("primitives are loaded, not constructed"),
+            Child::View(class) => format!("{}({})", class, bytes),
+            Child::Member { class, outer_arg } => match outer_arg {
+                Some(outer) => format!("{}({}, {})", class, bytes, outer),
+                None => format!("{}({})", class, bytes),
+            },
+            Child::PrimArray { elem, count } => {
+                format!("::abi_rt::Array<{}>({}, {})", elem, bytes, count)
+            }
+        }
+    }
+}
+
+/* Emitted text for one top-level type's views */
+#[derive(Default)]
+struct Emission {
+    /* Class definitions, each enclosing class before the classes it encloses */
+    decls: Vec<String>,
+    /* Member class names to forward-declare inside the root class */
+    members: Vec<String>,
+    /* Out-of-line member function definitions */
+    defs: String,
+}
+
+pub struct ViewEmitter<'a, 'c> {
+    ctx: &'c CppContext<'a>,
+}
+
+const SPAN: &str = "std::span<const std::byte>";
+const U64: &str = "std::uint64_t";
+
+impl<'a, 'c> ViewEmitter<'a, 'c> {
+    pub fn new(ctx: &'c CppContext<'a>) -> Self {
+        Self { ctx }
+    }
+
+    /* View (and, for structs, Mut) classes for a top-level type, or an
+    explanatory comment if the type uses something views cannot express */
+    pub fn emit_view(&self, ty: &ResolvedType) -> String {
+        match self.try_emit_view(ty) {
+            Ok(code) => code,
+            Err(reason) => {
+                eprintln!(
+                    "Warning: no C++ view for {} (C++ codegen): {}",
+                    ty.name, reason
+                );
+                format!(
+                    "/* {}View not generated: {} */\n\n",
+                    escape_cpp_keyword(&ty.name),
+                    reason
+                )
+            }
+        }
+    }
+
+    /* Ok if a view for the named top-level type can be generated */
+    fn view_supported(&self, type_name: &str) -> Result<(), String> {
+        let target = self
+            .ctx
+            .target(type_name)
+            .ok_or_else(|| format!("unknown type {}", type_name))?;
+        self.try_emit_view(target)
+            .map(|_| ())
+            .map_err(|reason| format!("{} ({})", type_name, reason))
+    }
+
+    fn try_emit_view(&self, ty: &ResolvedType) -> Result<String, String> {
+        let name = escape_cpp_keyword(&ty.name);
+        let root = format!("{}View", name);
+        let mut output = String::new();
+
+        match &ty.kind {
+            ResolvedTypeKind::Primitive { .. } => return Ok(String::new()),
+            ResolvedTypeKind::TypeRef { target_name, .. } => {
+                let target = self
+                    .ctx
+                    .target(target_name)
+                    .ok_or_else(|| format!("unknown type {}", target_name))?;
+                if matches!(target.kind, ResolvedTypeKind::Primitive { .. }) {
+                    return Ok(String::new());
+                }
+                self.view_supported(target_name)?;
+                writeln!(
+                    output,
+                    "using {} = {};",
+                    root,
+                    self.ctx.names.view(target_name)
+                )
+                .unwrap();
+                if self.has_mut(target) {
+                    writeln!(
+                        output,
+                        "using {}Mut = {};",
+                        name,
+                        self.ctx.names.view_mut(target_name)
+                    )
+                    .unwrap();
+                }
+                output.push('\n');
+                return Ok(output);
+            }
+            _ => {}
+        }
+
+        let site = Site {
+            class: root.clone(),
+            stem: String::new(),
+            outer: None,
+            scopes: match &ty.kind {
+                ResolvedTypeKind::Struct { fields, .. } => vec![fields.as_slice()],
+                _ => Vec::new(),
+            },
+            is_struct: matches!(ty.kind, ResolvedTypeKind::Struct { .. }),
+            root_is_struct: matches!(ty.kind, ResolvedTypeKind::Struct { .. }),
+        };
+        let mut emission = Emission::default();
+        self.emit_class(&site, ty, true, &mut emission)?;
+
+        if let Some(comment) = &ty.comment {
+            writeln!(output, "/* {} */", comment).unwrap();
+        }
+        for decl in &emission.decls {
+            output.push_str(decl);
+            output.push('\n');
+        }
+        output.push_str(&emission.defs);
+        output.push('\n');
+
+        if let ResolvedTypeKind::Struct { fields, .. } = &ty.kind {
+            output.push_str(&self.emit_mut(&name, ty, fields)?);
+        }
+        Ok(output)
+    }
+
+    fn emit_class(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        match &ty.kind {
+            ResolvedTypeKind::Struct { fields, packed, .. } => {
+                self.emit_struct(site, ty, fields, *packed, is_root, emission)
+            }
+            ResolvedTypeKind::Enum {
+                tag_expression,
+                variants,
+                ..
+            } => self.emit_enum(site, ty, tag_expression, variants, is_root, emission),
+            ResolvedTypeKind::Union { variants } => {
+                self.emit_union(site, ty, variants, is_root, emission)
+            }
+            ResolvedTypeKind::SizeDiscriminatedUnion { variants } => {
+                self.emit_sdu(site, ty, variants, is_root, emission)
+            }
+            ResolvedTypeKind::Array {
+                element_type,
+                size_expression,
+                jagged,
+                ..
+            } => self.emit_array(
+                site,
+                ty,
+                element_type,
+                size_expression,
+                *jagged,
+                is_root,
+                emission,
+            ),
+            ResolvedTypeKind::Primitive { .. } | ResolvedTypeKind::TypeRef { .. } => {
+                Err("not a class type".to_string())
+            }
+        }
+    }
+
+    /* How the holder class at site reads a value of type ty; member
+    classes it needs are emitted on the way */
+    fn child(
+        &self,
+        site: &Site,
+        name: &str,
+        ty: &ResolvedType,
+        emission: &mut Emission,
+    ) -> Result<Child, String> {
+        match &ty.kind {
+            ResolvedTypeKind::Primitive { prim_type } => {
+                Ok(Child::Prim(primitive_to_cpp_type(prim_type)))
+            }
+            ResolvedTypeKind::TypeRef { target_name, .. } => {
+                let target = self
+                    .ctx
+                    .target(target_name)
+                    .ok_or_else(|| format!("unknown type {}", target_name))?;
+                if let ResolvedTypeKind::Primitive { prim_type } = &target.kind {
+                    return Ok(Child::Prim(primitive_to_cpp_type(prim_type)));
+                }
+                self.view_supported(target_name)?;
+                Ok(Child::View(self.ctx.names.view(target_name)))
+            }
+            ResolvedTypeKind::Array {
+                element_type,
+                size_expression,
+                ..
+            } if self.prim_of(element_type).is_some() => Ok(Child::PrimArray {
+                elem: self.prim_of(element_type).unwrap(),
+                count: self.expr(site, size_expression)?,
+            }),
+            _ => {
+                let is_struct = matches!(ty.kind, ResolvedTypeKind::Struct { .. });
+                let mut scopes = Vec::new();
+                if let ResolvedTypeKind::Struct { fields, .. } = &ty.kind {
+                    scopes.push(fields.as_slice());
+                }
+                scopes.extend(site.chain());
+                let member = site.member(name, scopes, is_struct);
+                let class = member.class.clone();
+                emission
+                    .members
+                    .push(class.rsplit("::").next().unwrap_or(&class).to_string());
+                self.emit_class(&member, ty, false, emission)?;
+                Ok(Child::Member {
+                    class,
+                    outer_arg: site.outer_arg(),
+                })
+            }
+        }
+    }
+
+    fn prim_of(&self, ty: &ResolvedType) -> Option<&'static str> {
+        match &ty.kind {
+            ResolvedTypeKind::Primitive { prim_type } => Some(primitive_to_cpp_type(prim_type)),
+            ResolvedTypeKind::TypeRef { target_name, .. } => self
+                .ctx
+                .target(target_name)
+                .and_then(|target| self.prim_of(target)),
+            _ => None,
+        }
+    }
+
+    /* True if bytes of ty need more than a bounds check to be valid */
+    fn tagged(&self, ty: &ResolvedType) -> bool {
+        match &ty.kind {
+            ResolvedTypeKind::Primitive { .. } => false,
+            ResolvedTypeKind::Enum { .. } | ResolvedTypeKind::SizeDiscriminatedUnion { .. } => true,
+            ResolvedTypeKind::Struct { fields, .. } => {
+                fields.iter().any(|field| self.tagged(&field.field_type))
+            }
+            ResolvedTypeKind::Union { variants } => variants
+                .iter()
+                .any(|variant| self.tagged(&variant.field_type)),
+            ResolvedTypeKind::Array { element_type, .. } => self.tagged(element_type),
+            ResolvedTypeKind::TypeRef { target_name, .. } => self
+                .ctx
+                .target(target_name)
+                .map_or(false, |target| self.tagged(target)),
+        }
+    }
+
+    fn has_mut(&self, ty: &ResolvedType) -> bool {
+        match &ty.kind {
+            ResolvedTypeKind::Struct { .. } => true,
+            ResolvedTypeKind::TypeRef { target_name, .. } => self
+                .ctx
+                .target(target_name)
+                .map_or(false, |target| self.has_mut(target)),
+            _ => false,
+        }
+    }
+
+    /* Class head shared by every view: constants, constructor and the
+    footprint / validation entry points */
+    fn class_head(&self, site: &Site, ty: &ResolvedType, is_root: bool, out: &mut String) {
+        let short = site.class.rsplit("::").next().unwrap_or(&site.class);
+        writeln!(out, "class {} {{", site.class).unwrap();
+        out.push_str("public:\n");
+        if is_root && has_layout(ty, self.ctx) {
+            writeln!(out, "  using Layout = {};", self.ctx.names.layout(&ty.name)).unwrap();
+        }
+        if let Size::Const(size) = ty.size {
+            writeln!(out, "  static constexpr {} SIZE = {};", U64, size).unwrap();
+            writeln!(out, "  static constexpr bool TAGGED = {};", self.tagged(ty)).unwrap();
+        }
+        match &site.outer {
+            Some(outer) => {
+                writeln!(
+                    out,
+                    "  constexpr {}({} data, {} const& outer) : data_(data), outer_(outer) {{}}",
+                    short, SPAN, outer
+                )
+                .unwrap();
+            }
+            None => {
+                writeln!(
+                    out,
+                    "  constexpr explicit {}({} data) : data_(data) {{}}",
+                    short, SPAN
+                )
+                .unwrap();
+            }
+        }
+        out.push('\n');
+        if is_root {
+            out.push_str(
+                "  /* True if data starts with a well-formed value; footprint, if given,\n",
+            );
+            out.push_str("     receives its size */\n");
+            writeln!(
+                out,
+                "  static bool validate({} data, {}* footprint = nullptr) {{",
+                SPAN, U64
+            )
+            .unwrap();
+            writeln!(out, "    {} sz = {}(data).validated_size();", U64, short).unwrap();
+            out.push_str("    if (footprint) {\n      *footprint = sz;\n    }\n");
+            out.push_str("    return sz != ::abi_rt::INVALID;\n  }\n\n");
+        }
+        out.push_str("  /* Size of the value at the front of the bytes, or abi_rt::INVALID if\n");
+        out.push_str("     they hold none */\n");
+        writeln!(out, "  {} validated_size() const;", U64).unwrap();
+        out.push_str("  /* Size of the value; the bytes must be valid */\n");
+        writeln!(out, "  {} footprint() const;", U64).unwrap();
+        writeln!(
+            out,
+            "  {} as_bytes() const {{ return data_.first(footprint()); }}",
+            SPAN
+        )
+        .unwrap();
+        writeln!(
+            out,
+            "  {} buffer_size() const {{ return data_.size(); }}",
+            U64
+        )
+        .unwrap();
+        if let Some(outer) = &site.outer {
+            writeln!(out, "  {} const& outer() const {{ return outer_; }}", outer).unwrap();
+        }
+    }
+
+    fn class_tail(&self, site: &Site, out: &mut String) {
+        out.push_str("\nprivate:\n");
+        writeln!(out, "  {} data_;", SPAN).unwrap();
+        if let Some(outer) = &site.outer {
+            writeln!(out, "  {} outer_;", outer).unwrap();
+        }
+        out.push_str("};\n");
+    }
+
+    fn emit_struct(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        fields: &[ResolvedField],
+        packed: bool,
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        let slot = emission.decls.len();
+        emission.decls.push(String::new());
+
+        let mut children = Vec::with_capacity(fields.len());
+        for field in fields {
+            children.push(self.child(
+                site,
+                &pascal_case(&field.name),
+                &field.field_type,
+                emission,
+            )?);
+        }
+
+        let class = &site.class;
+        let mut decl = String::new();
+        self.class_head(site, ty, is_root, &mut decl);
+        if fields.iter().any(|field| field.offset.is_some()) {
+            decl.push('\n');
+        }
+        for field in fields {
+            if let Some(offset) = field.offset {
+                writeln!(
+                    decl,
+                    "  static constexpr {} OFFSET_{} = {};",
+                    U64,
+                    escape_cpp_keyword(&field.name),
+                    offset
+                )
+                .unwrap();
+            }
+        }
+        for (field, child) in fields.iter().zip(&children) {
+            let member = escape_cpp_member(&field.name);
+            decl.push('\n');
+            writeln!(
+                decl,
+                "  {} offset_{}() const;",
+                U64,
+                escape_cpp_keyword(&field.name)
+            )
+            .unwrap();
+            writeln!(decl, "  {} {}() const;", child.ret_type(), member).unwrap();
+        }
+        self.class_tail(site, &mut decl);
+        emission.decls[slot] = decl;
+
+        /* Offsets and accessors */
+        let defs = &mut emission.defs;
+        for (idx, (field, child)) in fields.iter().zip(&children).enumerate() {
+            let offset_fn = format!("offset_{}", escape_cpp_keyword(&field.name));
+            let offset = match field.offset {
+                Some(_) => format!("OFFSET_{}", escape_cpp_keyword(&field.name)),
+                None if idx == 0 => "0U".to_string(),
+                None => {
+                    let prev = &fields[idx - 1];
+                    let end = format!(
+                        "offset_{}() + {}",
+                        escape_cpp_keyword(&prev.name),
+                        self.size_of(
+                            &prev.field_type,
+                            &format!("{}()", escape_cpp_member(&prev.name))
+                        )
+                    );
+                    let align = if packed {
+                        1
+                    } else {
+                        field.field_type.alignment
+                    };
+                    if align > 1 {
+                        format!("::abi_rt::align_up({}, {})", end, align)
+                    } else {
+                        end
+                    }
+                }
+            };
+            writeln!(
+                defs,
+                "inline {} {}::{}() const {{ return {}; }}",
+                U64, class, offset_fn, offset
+            )
+            .unwrap();
+            writeln!(
+                defs,
+                "inline {} {}::{}() const {{ return {}; }}",
+                child.ret_type(),
+                class,
+                escape_cpp_member(&field.name),
+                self.read(child, &field.field_type, &format!("{}()", offset_fn))
+            )
+            .unwrap();
+        }
+
+        /* footprint */
+        let footprint = match (&ty.size, fields.last()) {
+            (Size::Const(_), _) => "SIZE".to_string(),
+            (Size::Variable(_), None) => "0U".to_string(),
+            (Size::Variable(_), Some(last)) => {
+                let end = format!(
+                    "offset_{}() + {}",
+                    escape_cpp_keyword(&last.name),
+                    self.size_of(
+                        &last.field_type,
+                        &format!("{}()", escape_cpp_member(&last.name))
+                    )
+                );
+                if !packed && ty.alignment > 1 {
+                    format!("::abi_rt::align_up({}, {})", end, ty.alignment)
+                } else {
+                    end
+                }
+            }
+        };
+        writeln!(
+            defs,
+            "inline {} {}::footprint() const {{ return {}; }}",
+            U64, class, footprint
+        )
+        .unwrap();
+
+        /* validated_size: one bounds check for the fixed prefix, then each
+        field whose offset or size depends on the data, in order */
+        let head = fields
+            .iter()
+            .take_while(|field| {
+                field.offset.is_some() && matches!(field.field_type.size, Size::Const(_))
+            })
+            .map(|field| match field.field_type.size {
+                Size::Const(size) => field.offset.unwrap_or(0) + size,
+                Size::Variable(_) => 0,
+            })
+            .max()
+            .unwrap_or(0);
+        let head_cnt = fields
+            .iter()
+            .take_while(|field| {
+                field.offset.is_some() && matches!(field.field_type.size, Size::Const(_))
+            })
+            .count();
+
+        writeln!(defs, "inline {} {}::validated_size() const {{", U64, class).unwrap();
+        if head > 0 {
+            writeln!(
+                defs,
+                "  if (data_.size() < {}U) {{\n    return ::abi_rt::INVALID;\n  }}",
+                head
+            )
+            .unwrap();
+        }
+        for field in &fields[..head_cnt] {
+            if self.tagged(&field.field_type) {
+                writeln!(
+                    defs,
+                    "  if ({}().validated_size() == ::abi_rt::INVALID) {{\n    return ::abi_rt::INVALID;\n  }}",
+                    escape_cpp_member(&field.name)
+                )
+                .unwrap();
+            }
+        }
+        if head_cnt == fields.len() {
+            if let Size::Const(size) = ty.size {
+                if size > head {
+                    writeln!(
+                        defs,
+                        "  if (data_.size() < SIZE) {{\n    return ::abi_rt::INVALID;\n  }}"
+                    )
+                    .unwrap();
+                }
+            }
+            writeln!(defs, "  return {};", footprint).unwrap();
+        } else {
+            writeln!(defs, "  {} end = 0U;", U64).unwrap();
+            for field in &fields[head_cnt..] {
+                let member = escape_cpp_member(&field.name);
+                defs.push_str("  {\n");
+                writeln!(
+                    defs,
+                    "    {} off = offset_{}();",
+                    U64,
+                    escape_cpp_keyword(&field.name)
+                )
+                .unwrap();
+                defs.push_str(
+                    "    if (off > data_.size()) {\n      return ::abi_rt::INVALID;\n    }\n",
+                );
+                match field.field_type.size {
+                    Size::Const(size) => {
+                        writeln!(
+                            defs,
+                            "    if (data_.size() - off < {}U) {{\n      return ::abi_rt::INVALID;\n    }}",
+                            size
+                        )
+                        .unwrap();
+                        if self.tagged(&field.field_type) {
+                            writeln!(
+                                defs,
+                                "    if ({}().validated_size() == ::abi_rt::INVALID) {{\n      return ::abi_rt::INVALID;\n    }}",
+                                member
+                            )
+                            .unwrap();
+                        }
+                        writeln!(defs, "    end = off + {}U;", size).unwrap();
+                    }
+                    Size::Variable(_) => {
+                        writeln!(defs, "    {} sz = {}().validated_size();", U64, member).unwrap();
+                        defs.push_str(
+                            "    if (sz == ::abi_rt::INVALID) {\n      return ::abi_rt::INVALID;\n    }\n",
+                        );
+                        defs.push_str("    end = off + sz;\n");
+                    }
+                }
+                defs.push_str("  }\n");
+            }
+            if !packed && ty.alignment > 1 {
+                writeln!(defs, "  end = ::abi_rt::align_up(end, {});", ty.alignment).unwrap();
+                defs.push_str("  if (end > data_.size()) {\n    return ::abi_rt::INVALID;\n  }\n");
+            }
+            defs.push_str("  return end;\n");
+        }
+        defs.push_str("}\n");
+
+        if is_root {
+            self.finish_root(emission, slot);
+        }
+        Ok(())
+    }
+
+    /* Member classes are collected while the root is emitted, so their
+    forward declarations go into the root class once it is done */
+    fn finish_root(&self, emission: &mut Emission, slot: usize) {
+        if emission.members.is_empty() {
+            return;
+        }
+        let mut forward = String::new();
+        for member in &emission.members {
+            writeln!(forward, "  class {};", member).unwrap();
+        }
+        let decl = &mut emission.decls[slot];
+        if let Some(pos) = decl.find("public:\n") {
+            decl.insert_str(pos + "public:\n".len(), &forward);
+        }
+    }
+
+    /* Size of a value of type ty read as the expression obj */
+    fn size_of(&self, ty: &ResolvedType, obj: &str) -> String {
+        match ty.size {
+            Size::Const(size) => format!("{}U", size),
+            Size::Variable(_) => format!("{}.footprint()", obj),
+        }
+    }
+
+    /* Reads a child of type ty at offset off within data_ */
+    fn read(&self, child: &Child, ty: &ResolvedType, off: &str) -> String {
+        match child {
+            Child::Prim(cpp) => format!("::abi_rt::load<{}>(data_, {})", cpp, off),
+            _ => {
+                let bytes = match ty.size {
+                    Size::Const(size) => format!("data_.subspan({}, {})", off, size),
+                    Size::Variable(_) => format!("data_.subspan({})", off),
+                };
+                child.construct(&bytes)
+            }
+        }
+    }
+
+    fn emit_enum(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        tag_expression: &ExprKind,
+        variants: &[ResolvedEnumVariant],
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        let slot = emission.decls.len();
+        emission.decls.push(String::new());
+
+        let tag = self.expr(site, tag_expression)?;
+        let mut children = Vec::with_capacity(variants.len());
+        for variant in variants {
+            children.push(self.child(
+                site,
+                &pascal_case(&variant.name),
+                &variant.variant_type,
+                emission,
+            )?);
+        }
+
+        let class = &site.class;
+        let mut decl = String::new();
+        self.class_head(site, ty, is_root, &mut decl);
+        decl.push('\n');
+        writeln!(decl, "  enum class Tag : {} {{", U64).unwrap();
+        for variant in variants {
+            writeln!(
+                decl,
+                "    {} = {}U,",
+                escape_cpp_variant(&variant.name),
+                variant.tag_value
+            )
+            .unwrap();
+        }
+        decl.push_str("  };\n");
+        decl.push_str("  Tag tag() const;\n");
+        for (variant, child) in variants.iter().zip(&children) {
+            let member = escape_cpp_variant(&variant.name);
+            writeln!(
+                decl,
+                "  bool is_{}() const {{ return tag() == Tag::{}; }}",
+                escape_cpp_keyword(&variant.name),
+                member
+            )
+            .unwrap();
+            writeln!(decl, "  {} {}() const;", child.ret_type(), member).unwrap();
+        }
+        self.class_tail(site, &mut decl);
+        emission.decls[slot] = decl;
+
+        let defs = &mut emission.defs;
+        writeln!(
+            defs,
+            "inline {}::Tag {}::tag() const {{ return static_cast<Tag>({}); }}",
+            class, class, tag
+        )
+        .unwrap();
+        for (variant, child) in variants.iter().zip(&children) {
+            writeln!(
+                defs,
+                "inline {} {}::{}() const {{ return {}; }}",
+                child.ret_type(),
+                class,
+                escape_cpp_variant(&variant.name),
+                self.read(child, &variant.variant_type, "0U")
+            )
+            .unwrap();
+        }
+
+        writeln!(defs, "inline {} {}::footprint() const {{", U64, class).unwrap();
+        if matches!(ty.size, Size::Const(_)) {
+            defs.push_str("  return SIZE;\n");
+        } else {
+            defs.push_str("  switch (tag()) {\n");
+            for variant in variants {
+                let member = escape_cpp_variant(&variant.name);
+                writeln!(
+                    defs,
+                    "  case Tag::{}:\n    return {};",
+                    member,
+                    self.size_of(&variant.variant_type, &format!("{}()", member))
+                )
+                .unwrap();
+            }
+            defs.push_str("  }\n  return ::abi_rt::INVALID;\n");
+        }
+        defs.push_str("}\n");
+
+        writeln!(defs, "inline {} {}::validated_size() const {{", U64, class).unwrap();
+        defs.push_str("  switch (tag()) {\n");
+        for variant in variants {
+            let member = escape_cpp_variant(&variant.name);
+            writeln!(defs, "  case Tag::{}:", member).unwrap();
+            defs.push_str(&self.variant_check(&variant.variant_type, &member, "    "));
+        }
+        defs.push_str("  }\n  return ::abi_rt::INVALID;\n}\n");
+
+        if is_root {
+            self.finish_root(emission, slot);
+        }
+        Ok(())
+    }
+
+    /* Statements returning the validated size of a variant at offset 0 */
+    fn variant_check(&self, ty: &ResolvedType, member: &str, indent: &str) -> String {
+        let mut out = String::new();
+        match ty.size {
+            Size::Const(size) => {
+                if size > 0 {
+                    writeln!(
+                        out,
+                        "{}if (data_.size() < {}U) {{\n{}  return ::abi_rt::INVALID;\n{}}}",
+                        indent, size, indent, indent
+                    )
+                    .unwrap();
+                }
+                if self.tagged(ty) {
+                    writeln!(
+                        out,
+                        "{}if ({}().validated_size() == ::abi_rt::INVALID) {{\n{}  return ::abi_rt::INVALID;\n{}}}",
+                        indent, member, indent, indent
+                    )
+                    .unwrap();
+                }
+                writeln!(out, "{}return {}U;", indent, size).unwrap();
+            }
+            Size::Variable(_) => {
+                writeln!(out, "{}return {}().validated_size();", indent, member).unwrap();
+            }
+        }
+        out
+    }
+
+    fn emit_union(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        variants: &[ResolvedField],
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        let Size::Const(size) = ty.size else {
+            return Err("union of variable-size variants".to_string());
+        };
+        let slot = emission.decls.len();
+        emission.decls.push(String::new());
+
+        let mut children = Vec::with_capacity(variants.len());
+        for variant in variants {
+            children.push(self.child(
+                site,
+                &pascal_case(&variant.name),
+                &variant.field_type,
+                emission,
+            )?);
+        }
+
+        let class = &site.class;
+        let mut decl = String::new();
+        self.class_head(site, ty, is_root, &mut decl);
+        decl.push('\n');
+        for (variant, child) in variants.iter().zip(&children) {
+            writeln!(
+                decl,
+                "  {} {}() const;",
+                child.ret_type(),
+                escape_cpp_variant(&variant.name)
+            )
+            .unwrap();
+        }
+        self.class_tail(site, &mut decl);
+        emission.decls[slot] = decl;
+
+        let defs = &mut emission.defs;
+        for (variant, child) in variants.iter().zip(&children) {
+            writeln!(
+                defs,
+                "inline {} {}::{}() const {{ return {}; }}",
+                child.ret_type(),
+                class,
+                escape_cpp_variant(&variant.name),
+                self.read(child, &variant.field_type, "0U")
+            )
+            .unwrap();
+        }
+        writeln!(
+            defs,
+            "inline {} {}::footprint() const {{ return SIZE; }}",
+            U64, class
+        )
+        .unwrap();
+        /* Which variant is live is up to the reader, so only the size is checked */
+        writeln!(
+            defs,
+            "inline {} {}::validated_size() const {{ return data_.size() < {}U ? ::abi_rt::INVALID : SIZE; }}",
+            U64, class, size
+        )
+        .unwrap();
+
+        if is_root {
+            self.finish_root(emission, slot);
+        }
+        Ok(())
+    }
+
+    fn emit_sdu(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        variants: &[ResolvedSizeDiscriminatedVariant],
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        let slot = emission.decls.len();
+        emission.decls.push(String::new());
+
+        let mut children = Vec::with_capacity(variants.len());
+        for variant in variants {
+            children.push(self.child(
+                site,
+                &pascal_case(&variant.name),
+                &variant.variant_type,
+                emission,
+            )?);
+        }
+
+        let class = &site.class;
+        let mut decl = String::new();
+        self.class_head(site, ty, is_root, &mut decl);
+        decl.push_str("\n  /* The variant is the one whose size is exactly the bytes' size */\n");
+        for (variant, child) in variants.iter().zip(&children) {
+            let member = escape_cpp_variant(&variant.name);
+            writeln!(
+                decl,
+                "  bool is_{}() const {{ return data_.size() == {}U; }}",
+                escape_cpp_keyword(&variant.name),
+                variant.expected_size
+            )
+            .unwrap();
+            writeln!(decl, "  {} {}() const;", child.ret_type(), member).unwrap();
+        }
+        self.class_tail(site, &mut decl);
+        emission.decls[slot] = decl;
+
+        let defs = &mut emission.defs;
+        for (variant, child) in variants.iter().zip(&children) {
+            writeln!(
+                defs,
+                "inline {} {}::{}() const {{ return {}; }}",
+                child.ret_type(),
+                class,
+                escape_cpp_variant(&variant.name),
+                self.read(child, &variant.variant_type, "0U")
+            )
+            .unwrap();
+        }
+
+        writeln!(defs, "inline {} {}::footprint() const {{", U64, class).unwrap();
+        if matches!(ty.size, Size::Const(_)) {
+            defs.push_str("  return SIZE;\n");
+        } else {
+            for variant in variants {
+                writeln!(
+                    defs,
+                    "  if (data_.size() == {}U) {{\n    return {}U;\n  }}",
+                    variant.expected_size, variant.expected_size
+                )
+                .unwrap();
+            }
+            defs.push_str("  return ::abi_rt::INVALID;\n");
+        }
+        defs.push_str("}\n");
+
+        writeln!(defs, "inline {} {}::validated_size() const {{", U64, class).unwrap();
+        for variant in variants {
+            let member = escape_cpp_variant(&variant.name);
+            writeln!(defs, "  if (data_.size() == {}U) {{", variant.expected_size).unwrap();
+            if self.tagged(&variant.variant_type)
+                || matches!(variant.variant_type.size, Size::Variable(_))
+            {
+                writeln!(
+                    defs,
+                    "    return {}().validated_size() == {}U ? {}U : ::abi_rt::INVALID;",
+                    member, variant.expected_size, variant.expected_size
+                )
+                .unwrap();
+            } else {
+                writeln!(defs, "    return {}U;", variant.expected_size).unwrap();
+            }
+            defs.push_str("  }\n");
+        }
+        defs.push_str("  return ::abi_rt::INVALID;\n}\n");
+
+        if is_root {
+            self.finish_root(emission, slot);
+        }
+        Ok(())
+    }
+
+    fn emit_array(
+        &self,
+        site: &Site,
+        ty: &ResolvedType,
+        element_type: &ResolvedType,
+        size_expression: &ExprKind,
+        jagged: bool,
+        is_root: bool,
+        emission: &mut Emission,
+    ) -> Result<(), String> {
+        let slot = emission.decls.len();
+        emission.decls.push(String::new());
+
+        let count = self.expr(site, size_expression)?;
+        let elem = self.child(site, "Elem", element_type, emission)?;
+        let stride = match element_type.size {
+            Size::Const(size) if !jagged => Some(size),
+            _ => None,
+        };
+
+        let class = &site.class;
+        let mut decl = String::new();
+        self.class_head(site, ty, is_root, &mut decl);
+        decl.push('\n');
+        writeln!(decl, "  {} size() const;", U64).unwrap();
+        if stride.is_none() {
+            decl.push_str("  /* Elements vary in size: indexing walks the preceding elements */\n");
+        }
+        writeln!(decl, "  {} operator[]({} i) const;", elem.ret_type(), U64).unwrap();
+        if stride.is_none() {
+            decl.push_str("\nprivate:\n");
+            writeln!(decl, "  {} at_offset({} off) const;", elem.ret_type(), U64).unwrap();
+        }
+        self.class_tail(site, &mut decl);
+        emission.decls[slot] = decl;
+
+        let defs = &mut emission.defs;
+        writeln!(
+            defs,
+            "inline {} {}::size() const {{ return {}; }}",
+            U64, class, count
+        )
+        .unwrap();
+        match stride {
+            Some(stride) => {
+                writeln!(
+                    defs,
+                    "inline {} {}::operator[]({} i) const {{ return {}; }}",
+                    elem.ret_type(),
+                    class,
+                    U64,
+                    self.read(&elem, element_type, &format!("i * {}U", stride))
+                )
+                .unwrap();
+                let footprint = if let Size::Const(_) = ty.size {
+                    "SIZE".to_string()
+                } else {
+                    format!("size() * {}U", stride)
+                };
+                writeln!(
+                    defs,
+                    "inline {} {}::footprint() const {{ return {}; }}",
+                    U64, class, footprint
+                )
+                .unwrap();
+                writeln!(defs, "inline {} {}::validated_size() const {{", U64, class).unwrap();
+                writeln!(defs, "  {} sz = ::abi_rt::mul(size(), {}U);", U64, stride).unwrap();
+                defs.push_str("  if (sz > data_.size()) {\n    return ::abi_rt::INVALID;\n  }\n");
+                if self.tagged(element_type) {
+                    writeln!(
+                        defs,
+                        "  for ({} i = 0U, cnt = size(); i < cnt; i++) {{",
+                        U64
+                    )
+                    .unwrap();
+                    defs.push_str(
+                        "    if ((*this)[i].validated_size() == ::abi_rt::INVALID) {\n      return ::abi_rt::INVALID;\n    }\n  }\n",
+                    );
+                }
+                defs.push_str("  return sz;\n}\n");
+            }
+            None => {
+                let align = element_type.alignment;
+                let advance = |off: &str, sz: &str| {
+                    if align > 1 {
+                        format!("::abi_rt::align_up({} + {}, {})", off, sz, align)
+                    } else {
+                        format!("{} + {}", off, sz)
+                    }
+                };
+                writeln!(
+                    defs,
+                    "inline {} {}::at_offset({} off) const {{ return {}; }}",
+                    elem.ret_type(),
+                    class,
+                    U64,
+                    elem.construct("data_.subspan(off)")
+                )
+                .unwrap();
+                writeln!(
+                    defs,
+                    "inline {} {}::operator[]({} i) const {{",
+                    elem.ret_type(),
+                    class,
+                    U64
+                )
+                .unwrap();
+                writeln!(defs, "  {} off = 0U;", U64).unwrap();
+                writeln!(defs, "  for ({} k = 0U; k < i; k++) {{", U64).unwrap();
+                writeln!(
+                    defs,
+                    "    off = {};",
+                    advance("off", "at_offset(off).footprint()")
+                )
+                .unwrap();
+                defs.push_str("  }\n  return at_offset(off);\n}\n");
+
+                writeln!(defs, "inline {} {}::footprint() const {{", U64, class).unwrap();
+                writeln!(defs, "  {} off = 0U;", U64).unwrap();
+                writeln!(
+                    defs,
+                    "  for ({} k = 0U, cnt = size(); k < cnt; k++) {{",
+                    U64
+                )
+                .unwrap();
+                writeln!(
+                    defs,
+                    "    off = {};",
+                    advance("off", "at_offset(off).footprint()")
+                )
+                .unwrap();
+                defs.push_str("  }\n  return off;\n}\n");
+
+                writeln!(defs, "inline {} {}::validated_size() const {{", U64, class).unwrap();
+                writeln!(defs, "  {} off = 0U;", U64).unwrap();
+                writeln!(
+                    defs,
+                    "  for ({} k = 0U, cnt = size(); k < cnt; k++) {{",
+                    U64
+                )
+                .unwrap();
+                defs.push_str(
+                    "    if (off > data_.size()) {\n      return ::abi_rt::INVALID;\n    }\n",
+                );
+                writeln!(defs, "    {} sz = at_offset(off).validated_size();", U64).unwrap();
+                defs.push_str(
+                    "    if (sz == ::abi_rt::INVALID) {\n      return ::abi_rt::INVALID;\n    }\n",
+                );
+                writeln!(defs, "    off = {};", advance("off", "sz")).unwrap();
+                defs.push_str("  }\n  return off <= data_.size() ? off : ::abi_rt::INVALID;\n}\n");
+            }
+        }
+
+        if is_root {
+            self.finish_root(emission, slot);
+        }
+        Ok(())
+    }
+
+    /* Encoder for a top-level struct: setters for primitive fields and
+    writable views of nested top-level structs and primitive arrays, at
+    the same offsets the view reads.  Offsets that depend on counts or
+    tags are read back from the bytes, so those fields are written
+    first, as the schema orders them anyway. */
+    fn emit_mut(
+        &self,
+        name: &str,
+        ty: &ResolvedType,
+        fields: &[ResolvedField],
+    ) -> Result<String, String> {
+        let view = format!("{}View", name);
+        let class = format!("{}Mut", name);
+        let mut out = String::new();
+        writeln!(out, "class {} {{", class).unwrap();
+        out.push_str("public:\n");
+        if let Size::Const(size) = ty.size {
+            writeln!(out, "  static constexpr {} SIZE = {};", U64, size).unwrap();
+        }
+        writeln!(
+            out,
+            "  constexpr explicit {}(std::span<std::byte> data) : data_(data) {{}}\n",
+            class
+        )
+        .unwrap();
+        writeln!(out, "  {} view() const {{ return {}(data_); }}", view, view).unwrap();
+        out.push_str(
+            "  std::span<std::byte> as_bytes() const { return data_.first(view().footprint()); }\n",
+        );
+
+        for field in fields {
+            let member = escape_cpp_member(&field.name);
+            let offset = format!("view().offset_{}()", escape_cpp_keyword(&field.name));
+            let bytes = match field.field_type.size {
+                Size::Const(size) => format!("data_.subspan({}, {})", offset, size),
+                Size::Variable(_) => format!("data_.subspan({})", offset),
+            };
+            out.push('\n');
+            if let Some(prim) = self.prim_of(&field.field_type) {
+                writeln!(
+                    out,
+                    "  void set_{}({} value) const {{ ::abi_rt::store<{}>(data_, {}, value); }}",
+                    escape_cpp_keyword(&field.name),
+                    prim,
+                    prim,
+                    offset
+                )
+                .unwrap();
+                continue;
+            }
+            match &field.field_type.kind {
+                ResolvedTypeKind::Array { element_type, .. }
+                    if self.prim_of(element_type).is_some() =>
+                {
+                    let elem = self.prim_of(element_type).unwrap();
+                    writeln!(
+                        out,
+                        "  ::abi_rt::MutArray<{}> {}() const {{\n    return ::abi_rt::MutArray<{}>({}, view().{}().size());\n  }}",
+                        elem, member, elem, bytes, member
+                    )
+                    .unwrap();
+                }
+                ResolvedTypeKind::TypeRef { target_name, .. }
+                    if self
+                        .ctx
+                        .target(target_name)
+                        .map_or(false, |t| self.has_mut(t)) =>
+                {
+                    let target_mut = self.ctx.names.view_mut(target_name);
+                    writeln!(
+                        out,
+                        "  {} {}() const {{ return {}({}); }}",
+                        target_mut, member, target_mut, bytes
+                    )
+                    .unwrap();
+                }
+                _ => {
+                    out.push_str(
+                        "  /* Raw bytes from the field on, to encode with its own view */\n",
+                    );
+                    writeln!(
+                        out,
+                        "  std::span<std::byte> {}() const {{ return {}; }}",
+                        member, bytes
+                    )
+                    .unwrap();
+                }
+            }
+        }
+        out.push_str("\nprivate:\n  std::span<std::byte> data_;\n};\n\n");
+        Ok(out)
+    }
+
+    /* A size or tag expression as a std::uint64_t C++ expression
+    evaluated inside the class at site */
+    fn expr(&self, site: &Site, expr: &ExprKind) -> Result<String, String> {
+        let bin = |op: &str, l: &ExprKind, r: &ExprKind| -> Result<String, String> {
+            Ok(format!(
+                "({} {} {})",
+                self.expr(site, l)?,
+                op,
+                self.expr(site, r)?
+            ))
+        };
+        let call = |f: &str, l: &ExprKind, r: &ExprKind| -> Result<String, String> {
+            Ok(format!(
+                "::abi_rt::{}({}, {})",
+                f,
+                self.expr(site, l)?,
+                self.expr(site, r)?
+            ))
+        };
+        let boolean = |op: &str, l: &ExprKind, r: &ExprKind| -> Result<String, String> {
+            Ok(format!(
+                "static_cast<{}>({} {} {})",
+                U64,
+                self.expr(site, l)?,
+                op,
+                self.expr(site, r)?
+            ))
+        };
+        let logical = |op: &str, l: &ExprKind, r: &ExprKind| -> Result<String, String> {
+            Ok(format!(
+                "static_cast<{}>(({} != 0U) {} ({} != 0U))",
+                U64,
+                self.expr(site, l)?,
+                op,
+                self.expr(site, r)?
+            ))
+        };
+        match expr {
+            ExprKind::Literal(lit) => Ok(literal_to_cpp(lit)),
+            ExprKind::FieldRef(field_ref) if field_ref.path.join(".") == "__buffer_size" => {
+                /* The bytes handed to the top-level view, as the other
+                backends take buf_sz */
+                let root = if site.root_is_struct {
+                    site.access(site.scopes.len() - 1)
+                } else if !site.class.contains("::") {
+                    String::new()
+                } else {
+                    return Err("__buffer_size below a top-level enum, union or array".to_string());
+                };
+                Ok(format!("static_cast<{}>({}buffer_size())", U64, root))
+            }
+            ExprKind::FieldRef(field_ref) => {
+                let access = self.field_ref(site, &field_ref.path)?;
+                Ok(format!("static_cast<{}>({})", U64, access))
+            }
+            ExprKind::Sizeof(e) => self
+                .ctx
+                .target(&e.type_name)
+                .and_then(|target| match target.size {
+                    Size::Const(size) => Some(format!("{}ULL", size)),
+                    Size::Variable(_) => None,
+                })
+                .ok_or_else(|| format!("sizeof({}) is not a constant", e.type_name)),
+            ExprKind::Alignof(e) => self
+                .ctx
+                .target(&e.type_name)
+                .map(|target| format!("{}ULL", target.alignment))
+                .ok_or_else(|| format!("alignof({}) names an unknown type", e.type_name)),
+            ExprKind::Add(e) => bin("+", &e.left, &e.right),
+            ExprKind::Sub(e) => bin("-", &e.left, &e.right),
+            ExprKind::Mul(e) => bin("*", &e.left, &e.right),
+            ExprKind::Div(e) => call("div", &e.left, &e.right),
+            ExprKind::Mod(e) => call("mod", &e.left, &e.right),
+            ExprKind::Pow(e) => call("pow", &e.left, &e.right),
+            ExprKind::BitAnd(e) => bin("&", &e.left, &e.right),
+            ExprKind::BitOr(e) => bin("|", &e.left, &e.right),
+            ExprKind::BitXor(e) => bin("^", &e.left, &e.right),
+            ExprKind::LeftShift(e) => call("shl", &e.left, &e.right),
+            ExprKind::RightShift(e) => call("shr", &e.left, &e.right),
+            ExprKind::Eq(e) => boolean("==", &e.left, &e.right),
+            ExprKind::Ne(e) => boolean("!=", &e.left, &e.right),
+            ExprKind::Lt(e) => boolean("<", &e.left, &e.right),
+            ExprKind::Gt(e) => boolean(">", &e.left, &e.right),
+            ExprKind::Le(e) => boolean("<=", &e.left, &e.right),
+            ExprKind::Ge(e) => boolean(">=", &e.left, &e.right),
+            ExprKind::And(e) => logical("&&", &e.left, &e.right),
+            ExprKind::Or(e) => logical("||", &e.left, &e.right),
+            ExprKind::Xor(e) => logical("!=", &e.left, &e.right),
+            ExprKind::BitNot(e) => Ok(format!("(~{})", self.expr(site, &e.operand)?)),
+            ExprKind::Neg(e) => Ok(format!("(0ULL - {})", self.expr(site, &e.operand)?)),
+            ExprKind::Not(e) => Ok(format!(
+                "static_cast<{}>({} == 0U)",
+                U64,
+                self.expr(site, &e.operand)?
+            )),
+            ExprKind::Popcount(e) => Ok(format!(
+                "static_cast<{}>(std::popcount({}))",
+                U64,
+                self.expr(site, &e.operand)?
+            )),
+        }
+    }
+
+    /* Accessor chain reading the primitive a field path names, found the
+    way the resolver finds it: from the innermost enclosing struct out */
+    fn field_ref(&self, site: &Site, path: &[String]) -> Result<String, String> {
+        (0..site.scopes.len())
+            .find_map(|start| self.resolve_path(site, path, start))
+            .ok_or_else(|| {
+                format!(
+                    "field reference {} does not name a primitive in an enclosing struct",
+                    path.join(".")
+                )
+            })
+    }
+
+    fn resolve_path(&self, site: &Site, path: &[String], start: usize) -> Option<String> {
+        let mut scope = start;
+        let mut code = site.access(scope);
+        let mut cursor = Cursor::Fields(site.scopes[scope]);
+        for segment in path {
+            if segment == ".." {
+                scope += 1;
+                if scope >= site.scopes.len() {
+                    return None;
+                }
+                code = site.access(scope);
+                cursor = Cursor::Fields(site.scopes[scope]);
+                continue;
+            }
+            let next = match cursor {
+                Cursor::Fields(fields) => {
+                    let name = segment.trim_start_matches("../");
+                    let field = fields.iter().find(|field| field.name == name)?;
+                    if !code.is_empty() && !code.ends_with('.') {
+                        code.push('.');
+                    }
+                    write!(code, "{}()", escape_cpp_member(&field.name)).unwrap();
+                    &field.field_type
+                }
+                Cursor::Array(element_type, count) => {
+                    let idx = segment.parse::<u64>().ok()?;
+                    if count.map_or(true, |count| idx >= count) {
+                        return None;
+                    }
+                    write!(code, "[{}]", idx).unwrap();
+                    element_type
+                }
+                Cursor::Prim => return None,
+            };
+            cursor = self.cursor_of(next)?;
+        }
+        match cursor {
+            Cursor::Prim => Some(code),
+            _ => None,
+        }
+    }
+
+    fn cursor_of<'t>(&'t self, ty: &'t ResolvedType) -> Option<Cursor<'t>> {
+        match &ty.kind {
+            ResolvedTypeKind::Primitive { .. } => Some(Cursor::Prim),
+            ResolvedTypeKind::Struct { fields, .. } => Some(Cursor::Fields(fields)),
+            ResolvedTypeKind::Array {
+                element_type,
+                size_expression,
+                size_constant_status,
+                ..
+            } => {
+                let count = match size_constant_status {
+                    ConstantStatus::Constant => self
+                        .ctx
+                        .resolver
+                        .evaluate_constant_expression(size_expression),
+                    _ => None,
+                };
+                Some(Cursor::Array(element_type, count))
+            }
+            ResolvedTypeKind::TypeRef { target_name, .. } => {
+                self.cursor_of(self.ctx.target(target_name)?)
+            }
+            ResolvedTypeKind::Enum { .. }
+            | ResolvedTypeKind::Union { .. }
+            | ResolvedTypeKind::SizeDiscriminatedUnion { .. } => None,
+        }
+    }
+}
+
+/* Position while following a field reference path */
+enum Cursor<'t> {
+    Fields(&'t [ResolvedField]),
+    Array(&'t ResolvedType, Option<u64>),
+    Prim,
+}
@@ -1,5 +1,7 @@
 pub mod c;
 pub mod c_gen;
+pub mod cpp;
+pub mod cpp_gen;
 pub mod rust;
 pub mod rust_gen;
 pub mod shared;
@@ -80,6 +80,8 @@ enum Commands {
 enum Language {
     /* Generate C code (.h and .c files) */
     C,
+    /* Generate header-only C++20 views (.hpp files) */
+    Cpp,
     /* Generate Rust code (.rs files) */
     Rust,
     /* Generate TypeScript code (.ts files) */
@@ -91,6 +93,7 @@ impl From<Language> for cmds::codegen::Language {
     fn from(lang: Language) -> Self {
         match lang {
             Language::C => cmds::codegen::Language::C,
+            Language::Cpp => cmds::codegen::Language::Cpp,
             Language::Rust => cmds::codegen::Language::Rust,
             Language::TypeScript => cmds::codegen::Language::TypeScript,
         }
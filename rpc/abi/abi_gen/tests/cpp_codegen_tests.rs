@@ -0,0 +1,311 @@
+/* C++ Code Generation Tests
+ *
+ * These tests verify that the C++ code generator produces headers that compile
+ * cleanly under strict warnings, and that the generated views and writers
+ * round-trip data for fixed layouts, FAMs, enums and aligned structs.
+ */
+
+use abi_gen::abi::file::AbiFile;
+use abi_gen::abi::resolved::{ResolvedType, TypeResolver};
+use abi_gen::codegen::cpp::{CppCodeGenerator, CppCodeGeneratorOptions};
+use std::fs;
+use std::path::PathBuf;
+use std::process::Command;
+
+/* Helper to resolve types from ABI YAML */
+fn resolve_types_from_yaml(yaml_content: &str) -> Result<TypeResolver, String> {
+    let abi: AbiFile =
+        serde_yml::from_str(yaml_content).map_err(|e| format!("Failed to parse YAML: {}", e))?;
+
+    let mut resolver = TypeResolver::new();
+    for typedef in &abi.types {
+        resolver.add_typedef(typedef.clone());
+    }
+
+    resolver
+        .resolve_all()
+        .map_err(|e| format!("Failed to resolve types: {:?}", e))?;
+
+    Ok(resolver)
+}
+
+fn collect_resolved_refs<'a>(resolver: &'a TypeResolver) -> Vec<&'a ResolvedType> {
+    resolver
+        .resolution_order
+        .iter()
+        .filter_map(|name| resolver.get_type_info(name))
+        .collect()
+}
+
+/* Generates types.hpp for the ABI into a per-test directory */
+fn generate_header(yaml_content: &str, test_name: &str) -> (PathBuf, String) {
+    let resolver = resolve_types_from_yaml(yaml_content).expect("Failed to resolve types");
+    let resolved_refs = collect_resolved_refs(&resolver);
+
+    let out_dir = std::env::temp_dir().join("abi_cpp_tests").join(test_name);
+    fs::create_dir_all(&out_dir).expect("Failed to create temp dir");
+
+    let cpp_gen = CppCodeGenerator::new(
+        &resolver,
+        CppCodeGeneratorOptions {
+            output_dir: out_dir.to_str().unwrap().to_string(),
+            package: Some("test.cpp".to_string()),
+            ..Default::default()
+        },
+    );
+    let header = cpp_gen.emit_code(&resolved_refs);
+    (out_dir, header)
+}
+
+/* Compiles main_body (the body of int main, returning nonzero on failure)
+against the generated header and runs it */
+fn compile_and_run_cpp(out_dir: &PathBuf, main_body: &str) -> Result<(), String> {
+    let cpp_file = out_dir.join("main.cpp");
+    let cpp_content = format!(
+        "#include \"types.hpp\"\n#include <vector>\nusing namespace test::cpp;\n\
+         #define CHECK(c) do {{ if (!(c)) {{ return __LINE__; }} }} while (0)\n\
+         int main() {{\n{}\n  return 0;\n}}\n",
+        main_body
+    );
+    fs::write(&cpp_file, cpp_content).map_err(|e| format!("Failed to write C++ file: {}", e))?;
+
+    let binary = out_dir.join("main");
+    let output = Command::new("g++")
+        .arg("-std=c++20")
+        .arg("-Wall")
+        .arg("-Wextra")
+        .arg("-Wpedantic")
+        .arg("-Wconversion")
+        .arg("-Werror")
+        .arg(format!("-I{}", out_dir.to_str().unwrap()))
+        .arg(&cpp_file)
+        .arg("-o")
+        .arg(&binary)
+        .output()
+        .map_err(|e| format!("Failed to run g++: {}", e))?;
+    if !output.status.success() {
+        let stderr = String::from_utf8_lossy(&output.stderr);
+        return Err(format!("G++ compilation failed:\n{}", stderr));
+    }
+
+    let status = Command::new(&binary)
+        .status()
+        .map_err(|e| format!("Failed to run test binary: {}", e))?;
+    if !status.success() {
+        return Err(format!(
+            "CHECK failed at line {:?} of main.cpp",
+            status.code()
+        ));
+    }
+
+    let _ = fs::remove_dir_all(out_dir);
+    Ok(())
+}
+
+#[test]
+fn test_cpp_primitives() {
+    let abi_content = r#"
+abi:
+  package: "test.cpp"
+  abi-version: 1
+  package-version: "1.0.0"
+  description: "Test primitives"
+
+types:
+  - name: "Primitives"
+    kind:
+      struct:
+        packed: true
+        fields:
+          - name: "u8_field"
+            field-type:
+              primitive: u8
+          - name: "u64_field"
+            field-type:
+              primitive: u64
+          - name: "i16_field"
+            field-type:
+              primitive: i16
+          - name: "f64_field"
+            field-type:
+              primitive: f64
+"#;
+
+    let (out_dir, header) = generate_header(abi_content, "primitives");
+    assert!(header.contains("struct __attribute__((packed)) Primitives"));
+    assert!(header.contains("static constexpr std::uint64_t OFFSET_i16_field = 9;"));
+
+    compile_and_run_cpp(
+        &out_dir,
+        r#"
+  static_assert(sizeof(Primitives) == 19);
+  static_assert(PrimitivesView::SIZE == 19);
+  Primitives p{};
+  p.u8_field = 7;
+  p.u64_field = 1ULL << 40;
+  p.i16_field = -3;
+  p.f64_field = 0.5;
+  PrimitivesView v(std::as_bytes(std::span(&p, 1)));
+  CHECK(PrimitivesView::validate(std::as_bytes(std::span(&p, 1))));
+  CHECK(v.u8_field() == 7 && v.u64_field() == (1ULL << 40));
+  CHECK(v.i16_field() == -3 && v.f64_field() == 0.5);
+  CHECK(!PrimitivesView::validate(std::as_bytes(std::span(&p, 1)).first(18)));
+"#,
+    )
+    .expect("C++ primitives should round-trip");
+}
+
+#[test]
+fn test_cpp_simple_fam() {
+    let abi_content = r#"
+abi:
+  package: "test.cpp"
+  abi-version: 1
+  package-version: "1.0.0"
+  description: "Test types"
+
+types:
+  - name: "SimpleFAM"
+    kind:
+      struct:
+        packed: true
+        fields:
+          - name: "count"
+            field-type:
+              primitive: u32
+          - name: "data"
+            field-type:
+              array:
+                size:
+                  field-ref:
+                    path: ["count"]
+                element-type:
+                  primitive: u16
+          - name: "trailer"
+            field-type:
+              primitive: u8
+"#;
+
+    let (out_dir, _) = generate_header(abi_content, "simple_fam");
+    compile_and_run_cpp(
+        &out_dir,
+        r#"
+  std::vector<std::byte> buf(4 + 3 * 2 + 1);
+  SimpleFAMMut m(buf);
+  m.set_count(3);
+  m.data().set(2, 0xBEEF);
+  m.set_trailer(9);
+  std::uint64_t fp = 0;
+  CHECK(SimpleFAMView::validate(buf, &fp) && fp == 11);
+  SimpleFAMView v(buf);
+  CHECK(v.data().size() == 3 && v.data()[2] == 0xBEEF);
+  CHECK(v.offset_trailer() == 10 && v.trailer() == 9);
+  CHECK(!SimpleFAMView::validate(std::span<const std::byte>(buf).first(10)));
+  m.set_count(0xFFFFFFFFU);
+  CHECK(!SimpleFAMView::validate(buf));
+"#,
+    )
+    .expect("C++ simple FAM should round-trip");
+}
+
+#[test]
+fn test_cpp_aligned_struct_with_enum() {
+    let abi_content = r#"
+abi:
+  package: "test.cpp"
+  abi-version: 1
+  package-version: "1.0.0"
+  description: "Test types"
+
+types:
+  - name: "Rec"
+    kind:
+      struct:
+        packed: false
+        fields:
+          - name: "flag"
+            field-type:
+              primitive: u8
+          - name: "value"
+            field-type:
+              primitive: u64
+          - name: "len"
+            field-type:
+              primitive: u16
+          - name: "items"
+            field-type:
+              array:
+                size:
+                  field-ref:
+                    path: ["len"]
+                element-type:
+                  primitive: u32
+          - name: "kind"
+            field-type:
+              primitive: u8
+          - name: "body"
+            field-type:
+              enum:
+                tag-ref:
+                  field-ref:
+                    path: ["kind"]
+                variants:
+                  - name: "none"
+                    tag-value: 0
+                    variant-type:
+                      struct:
+                        packed: false
+                        fields: []
+                  - name: "pair"
+                    tag-value: 1
+                    variant-type:
+                      struct:
+                        packed: false
+                        fields:
+                          - name: "a"
+                            field-type:
+                              primitive: u32
+                          - name: "b"
+                            field-type:
+                              primitive: u64
+          - name: "tail"
+            field-type:
+              primitive: u16
+"#;
+
+    let (out_dir, header) = generate_header(abi_content, "aligned_enum");
+    assert!(header.contains("class RecView::BodyView"));
+    compile_and_run_cpp(
+        &out_dir,
+        r#"
+  std::vector<std::byte> buf(64);
+  std::span<std::byte> all(buf);
+  RecMut m(all);
+  m.set_len(3);
+  m.items().set(2, 12);
+  m.set_kind(1);
+  CHECK(m.view().offset_items() == 20);
+  CHECK(m.view().offset_body() == 40);
+  abi_rt::store<std::uint64_t>(all, 48, 1234);
+  m.set_tail(0xBEEF);
+  std::uint64_t fp = 0;
+  CHECK(RecView::validate(buf, &fp) && fp == 64);
+  RecView v(buf);
+  CHECK(v.body().is_pair() && v.body().pair().b() == 1234);
+  CHECK(v.items()[2] == 12 && v.tail() == 0xBEEF);
+  m.set_kind(0);
+  CHECK(RecView::validate(buf, &fp) && fp == 48);
+  m.set_kind(2);
+  CHECK(!RecView::validate(buf));
+"#,
+    )
+    .expect("C++ aligned struct with enum should round-trip");
+}
+
+#[test]
+fn test_cpp_advanced_types() {
+    let abi_content = fs::read_to_string("tests/advanced_types.abi.yaml")
+        .expect("Failed to read advanced_types.abi.yaml");
+    let (out_dir, _) = generate_header(&abi_content, "advanced_types");
+    compile_and_run_cpp(&out_dir, "").expect("C++ advanced types should compile");
+}
@@ -48,6 +48,7 @@ fn type_library_abis_resolve_roots_and_codegen() -> anyhow::Result<()> {
 
         for (language, language_name) in [
             (Language::C, "c"),
+            (Language::Cpp, "cpp"),
             (Language::Rust, "rust"),
             (Language::TypeScript, "typescript"),
         ] {
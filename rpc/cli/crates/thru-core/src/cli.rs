@@ -911,6 +911,7 @@ pub enum AbiAccountCommands {
 #[derive(Copy, Clone, PartialEq, Eq, PartialOrd, Ord, ValueEnum, Debug)]
 pub enum AbiLanguage {
     C,
+    Cpp,
     Rust,
     #[value(name = "typescript")]
     TypeScript,
@@ -2371,6 +2372,20 @@ pub enum DebugCommands {
         #[arg(long, default_value = "5")]
         context: u32,
     },
+
+    /// Decode binary thru::log records from a C++ SDK program
+    ///
+    /// Looks up each record's format id in the .tsdk_logfmt section of the program .elf
+    /// and prints the formatted message. Text log lines are passed through unchanged.
+    #[command(name = "decode-log")]
+    DecodeLog {
+        /// Path to the program .elf file that emitted the records
+        #[arg(long)]
+        elf: std::path::PathBuf,
+
+        /// Hex-encoded log payloads (read one per line from stdin if omitted)
+        records: Vec<String>,
+    },
 }
 
 #[cfg(test)]
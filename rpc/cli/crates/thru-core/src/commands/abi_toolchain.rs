@@ -23,6 +23,7 @@ pub fn handle_codegen_command(
 ) -> Result<(), CliError> {
     let language = match language {
         AbiLanguage::C => abi_gen::cmds::codegen::Language::C,
+        AbiLanguage::Cpp => abi_gen::cmds::codegen::Language::Cpp,
         AbiLanguage::Rust => abi_gen::cmds::codegen::Language::Rust,
         AbiLanguage::TypeScript => abi_gen::cmds::codegen::Language::TypeScript,
     };
@@ -1,5 +1,6 @@
 //! Debug commands for transaction analysis
 
+mod logfmt;
 mod resolve;
 mod variables;
 
@@ -37,6 +38,9 @@ pub async fn handle_debug_command(
             )
             .await
         }
+        DebugCommands::DecodeLog { elf, records } => {
+            logfmt::handle_decode_log(&elf, &records, json_format)
+        }
     }
 }
 
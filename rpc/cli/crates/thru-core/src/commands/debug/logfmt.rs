@@ -0,0 +1,403 @@
+//! Decoder for binary `thru::log` records emitted by C++ SDK programs.
+//!
+//! Programs built without THRUNET_DEBUG log a compact record through `tsys_log` instead of
+//! formatted text (see `tn_sdk_log.hpp` in the C++ SDK):
+//!
+//! ```text
+//! [0x00][version = 1][0x00 0x00][format id: u32 LE][args...]
+//! ```
+//!
+//! The format strings live in the non-loaded `.tsdk_logfmt` section of the program ELF as
+//! a sequence of entries, possibly separated by zero padding:
+//!
+//! ```text
+//! ['L'][format id: u32 LE][level: u8][argc: u8][arg tags: argc bytes]
+//! [format size: u16 LE][format bytes]
+//! ```
+
+use std::collections::HashMap;
+use std::io::BufRead;
+use std::path::Path;
+
+use object::{Object, ObjectSection};
+use serde::Serialize;
+use serde_json::json;
+
+use crate::error::CliError;
+use crate::output;
+
+const FMT_SECTION: &str = ".tsdk_logfmt";
+const FMT_ENTRY_MAGIC: u8 = b'L';
+const RECORD_VERSION: u8 = 1;
+const RECORD_HDR_SZ: usize = 8;
+
+const LEVEL_NAMES: [&str; 5] = ["trace", "debug", "info", "warn", "error"];
+
+/// One format string from the `.tsdk_logfmt` section.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct FormatEntry {
+    pub id: u32,
+    pub level: u8,
+    pub tags: Vec<u8>,
+    pub format: String,
+}
+
+/// Format id → format string table for one program.
+#[derive(Debug, Default)]
+pub struct FormatTable {
+    entries: HashMap<u32, FormatEntry>,
+}
+
+impl FormatTable {
+    /// Loads the table from a program ELF. A program that never uses binary logging has
+    /// no `.tsdk_logfmt` section and yields an empty table.
+    pub fn from_elf(elf_data: &[u8]) -> Result<Self, CliError> {
+        let object = object::File::parse(elf_data).map_err(|e| CliError::Generic {
+            message: format!("failed to parse ELF: {e}"),
+        })?;
+        let Some(section) = object.section_by_name(FMT_SECTION) else {
+            return Ok(Self::default());
+        };
+        let data = section.data().map_err(|e| CliError::Generic {
+            message: format!("failed to read {FMT_SECTION}: {e}"),
+        })?;
+        Self::parse(data).map_err(|message| CliError::Generic { message })
+    }
+
+    /// Parses the raw contents of a `.tsdk_logfmt` section.
+    pub fn parse(mut data: &[u8]) -> Result<Self, String> {
+        let mut entries = HashMap::new();
+        loop {
+            while let [0, rest @ ..] = data {
+                data = rest;
+            }
+            if data.is_empty() {
+                break;
+            }
+            let mut r = Reader::new(data);
+            if r.u8()? != FMT_ENTRY_MAGIC {
+                return Err(format!("bad {FMT_SECTION} entry magic"));
+            }
+            let id = r.u32()?;
+            let level = r.u8()?;
+            let argc = r.u8()? as usize;
+            let tags = r.bytes(argc)?.to_vec();
+            let fmt_sz = r.u16()? as usize;
+            let format = String::from_utf8_lossy(r.bytes(fmt_sz)?).into_owned();
+            data = r.rest();
+            entries.insert(
+                id,
+                FormatEntry {
+                    id,
+                    level,
+                    tags,
+                    format,
+                },
+            );
+        }
+        Ok(Self { entries })
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    pub fn get(&self, id: u32) -> Option<&FormatEntry> {
+        self.entries.get(&id)
+    }
+}
+
+/// A decoded log line.
+#[derive(Debug, Serialize, PartialEq, Eq)]
+pub struct DecodedLog {
+    /// Level name for binary records; text lines carry no level.
+    pub level: Option<&'static str>,
+    pub format_id: Option<u32>,
+    pub message: String,
+}
+
+/// True if `data` is a binary `thru::log` record rather than a text log line.
+pub fn is_binary_record(data: &[u8]) -> bool {
+    data.len() >= RECORD_HDR_SZ && data[0] == 0 && data[1] == RECORD_VERSION
+}
+
+/// Decodes one `tsys_log` payload. Text payloads are returned unchanged.
+pub fn decode_record(table: &FormatTable, data: &[u8]) -> Result<DecodedLog, String> {
+    if !is_binary_record(data) {
+        return Ok(DecodedLog {
+            level: None,
+            format_id: None,
+            message: String::from_utf8_lossy(data).into_owned(),
+        });
+    }
+
+    let id = u32::from_le_bytes(data[4..8].try_into().unwrap());
+    let entry = table
+        .get(id)
+        .ok_or_else(|| format!("unknown format id {id:#010x} (wrong ELF?)"))?;
+
+    let mut r = Reader::new(&data[RECORD_HDR_SZ..]);
+    let mut args = Vec::with_capacity(entry.tags.len());
+    for &tag in &entry.tags {
+        args.push(Arg::read(tag, &mut r)?);
+    }
+    if !r.rest().is_empty() {
+        return Err(format!("{} trailing bytes in record", r.rest().len()));
+    }
+
+    Ok(DecodedLog {
+        level: Some(LEVEL_NAMES.get(entry.level as usize).copied().unwrap_or("error")),
+        format_id: Some(id),
+        message: render(&entry.format, &args)?,
+    })
+}
+
+enum Arg {
+    Unsigned(u64),
+    Signed(i64),
+    Bool(bool),
+    Pointer(u64),
+    Key([u8; 32]),
+    Str(String),
+}
+
+impl Arg {
+    fn read(tag: u8, r: &mut Reader<'_>) -> Result<Self, String> {
+        Ok(match tag {
+            b'b' => Arg::Bool(r.u8()? != 0),
+            b'B' => Arg::Unsigned(r.u8()? as u64),
+            b'c' => Arg::Signed(r.u8()? as i8 as i64),
+            b'H' => Arg::Unsigned(r.u16()? as u64),
+            b'h' => Arg::Signed(r.u16()? as i16 as i64),
+            b'I' => Arg::Unsigned(r.u32()? as u64),
+            b'i' => Arg::Signed(r.u32()? as i32 as i64),
+            b'Q' => Arg::Unsigned(r.u64()?),
+            b'q' => Arg::Signed(r.u64()? as i64),
+            b'p' => Arg::Pointer(r.u64()?),
+            b'K' => Arg::Key(r.bytes(32)?.try_into().unwrap()),
+            b's' => {
+                let len = r.u16()? as usize;
+                Arg::Str(String::from_utf8_lossy(r.bytes(len)?).into_owned())
+            }
+            _ => return Err(format!("unknown argument tag {:?}", tag as char)),
+        })
+    }
+
+    fn render(&self, hex: bool, out: &mut String) {
+        use std::fmt::Write as _;
+        match self {
+            Arg::Unsigned(v) if hex => write!(out, "{v:#x}"),
+            Arg::Unsigned(v) => write!(out, "{v}"),
+            Arg::Signed(v) if hex => write!(out, "{:#x}", *v as u64),
+            Arg::Signed(v) => write!(out, "{v}"),
+            Arg::Bool(v) => write!(out, "{v}"),
+            Arg::Pointer(v) => write!(out, "{v:#x}"),
+            // Hex for both `{}` and `{:x}`, as the SDK's text mode renders it
+            Arg::Key(k) => write!(out, "{}", hex::encode(k)),
+            Arg::Str(s) => write!(out, "{s}"),
+        }
+        .unwrap();
+    }
+}
+
+/// Expands `{}` / `{:x}` placeholders and `{{` / `}}` escapes.
+fn render(format: &str, args: &[Arg]) -> Result<String, String> {
+    let mut out = String::with_capacity(format.len());
+    let mut args = args.iter();
+    let mut rest = format;
+    while let Some(pos) = rest.find(['{', '}']) {
+        out.push_str(&rest[..pos]);
+        rest = &rest[pos..];
+        let (hex, skip) = if rest.starts_with("{{") {
+            out.push('{');
+            rest = &rest[2..];
+            continue;
+        } else if rest.starts_with("}}") {
+            out.push('}');
+            rest = &rest[2..];
+            continue;
+        } else if rest.starts_with("{}") {
+            (false, 2)
+        } else if rest.starts_with("{:x}") {
+            (true, 4)
+        } else {
+            return Err(format!("malformed format string {format:?}"));
+        };
+        args.next()
+            .ok_or_else(|| format!("too few arguments for {format:?}"))?
+            .render(hex, &mut out);
+        rest = &rest[skip..];
+    }
+    out.push_str(rest);
+    Ok(out)
+}
+
+struct Reader<'a> {
+    data: &'a [u8],
+}
+
+impl<'a> Reader<'a> {
+    fn new(data: &'a [u8]) -> Self {
+        Self { data }
+    }
+
+    fn bytes(&mut self, n: usize) -> Result<&'a [u8], String> {
+        if self.data.len() < n {
+            return Err("truncated log data".to_string());
+        }
+        let (head, tail) = self.data.split_at(n);
+        self.data = tail;
+        Ok(head)
+    }
+
+    fn u8(&mut self) -> Result<u8, String> {
+        Ok(self.bytes(1)?[0])
+    }
+
+    fn u16(&mut self) -> Result<u16, String> {
+        Ok(u16::from_le_bytes(self.bytes(2)?.try_into().unwrap()))
+    }
+
+    fn u32(&mut self) -> Result<u32, String> {
+        Ok(u32::from_le_bytes(self.bytes(4)?.try_into().unwrap()))
+    }
+
+    fn u64(&mut self) -> Result<u64, String> {
+        Ok(u64::from_le_bytes(self.bytes(8)?.try_into().unwrap()))
+    }
+
+    fn rest(&self) -> &'a [u8] {
+        self.data
+    }
+}
+
+// --- Command entry point ---
+
+/// Decodes hex-encoded log payloads (from `records`, or one per line on stdin when
+/// `records` is empty) against the format table of `elf_path`.
+pub fn handle_decode_log(
+    elf_path: &Path,
+    records: &[String],
+    json_format: bool,
+) -> Result<(), CliError> {
+    let elf_data = std::fs::read(elf_path).map_err(|e| CliError::Generic {
+        message: format!("failed to read ELF {}: {e}", elf_path.display()),
+    })?;
+    let table = FormatTable::from_elf(&elf_data)?;
+
+    let inputs: Vec<String> = if records.is_empty() {
+        std::io::stdin()
+            .lock()
+            .lines()
+            .collect::<Result<Vec<_>, _>>()?
+            .into_iter()
+            .filter(|l| !l.trim().is_empty())
+            .collect()
+    } else {
+        records.to_vec()
+    };
+
+    let mut decoded = Vec::with_capacity(inputs.len());
+    for input in &inputs {
+        let trimmed = input.trim();
+        let hex_str = trimmed.strip_prefix("0x").unwrap_or(trimmed);
+        let bytes = hex::decode(hex_str)
+            .map_err(|e| CliError::Validation(format!("invalid hex record {trimmed:?}: {e}")))?;
+        let log = decode_record(&table, &bytes).map_err(CliError::Validation)?;
+        decoded.push(log);
+    }
+
+    if json_format {
+        output::print_output(json!({ "logs": decoded }), true);
+    } else {
+        for log in &decoded {
+            match log.level {
+                Some(level) => println!("{level}: {}", log.message),
+                None => println!("{}", log.message),
+            }
+        }
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn entry(id: u32, level: u8, tags: &[u8], format: &str) -> Vec<u8> {
+        let mut e = vec![FMT_ENTRY_MAGIC];
+        e.extend_from_slice(&id.to_le_bytes());
+        e.push(level);
+        e.push(tags.len() as u8);
+        e.extend_from_slice(tags);
+        e.extend_from_slice(&(format.len() as u16).to_le_bytes());
+        e.extend_from_slice(format.as_bytes());
+        e
+    }
+
+    fn record(id: u32, args: &[u8]) -> Vec<u8> {
+        let mut r = vec![0, RECORD_VERSION, 0, 0];
+        r.extend_from_slice(&id.to_le_bytes());
+        r.extend_from_slice(args);
+        r
+    }
+
+    fn table() -> FormatTable {
+        let mut section = entry(7, 2, b"HQi", "transfer {} -> {:x} delta={} {{ok}}");
+        section.extend_from_slice(&[0, 0, 0]);
+        section.extend(entry(9, 4, b"sb", "name={} flag={}"));
+        section.extend(entry(11, 1, b"KK", "from {} to {:x}"));
+        FormatTable::parse(&section).unwrap()
+    }
+
+    #[test]
+    fn parses_padded_table() {
+        let t = table();
+        assert_eq!(t.len(), 3);
+        assert_eq!(t.get(9).unwrap().tags, b"sb");
+    }
+
+    #[test]
+    fn decodes_integer_record() {
+        let mut args = 3u16.to_le_bytes().to_vec();
+        args.extend_from_slice(&255u64.to_le_bytes());
+        args.extend_from_slice(&(-42i32).to_le_bytes());
+        let log = decode_record(&table(), &record(7, &args)).unwrap();
+        assert_eq!(log.level, Some("info"));
+        assert_eq!(log.message, "transfer 3 -> 0xff delta=-42 {ok}");
+    }
+
+    #[test]
+    fn decodes_string_record() {
+        let args = [2, 0, b'h', b'i', 1];
+        let log = decode_record(&table(), &record(9, &args)).unwrap();
+        assert_eq!(log.level, Some("error"));
+        assert_eq!(log.message, "name=hi flag=true");
+    }
+
+    #[test]
+    fn decodes_pubkey_record_as_hex() {
+        let mut args = [0xabu8; 32].to_vec();
+        args.extend_from_slice(&[0x01u8; 32]);
+        let log = decode_record(&table(), &record(11, &args)).unwrap();
+        assert_eq!(log.level, Some("debug"));
+        assert_eq!(log.message, format!("from {} to {}", "ab".repeat(32), "01".repeat(32)));
+    }
+
+    #[test]
+    fn passes_text_through() {
+        let log = decode_record(&table(), b"plain text").unwrap();
+        assert_eq!(log.level, None);
+        assert_eq!(log.message, "plain text");
+    }
+
+    #[test]
+    fn rejects_unknown_id_and_truncation() {
+        assert!(decode_record(&table(), &record(8, &[])).is_err());
+        assert!(decode_record(&table(), &record(7, &[1, 0])).is_err());
+    }
+}
@@ -1,5 +1,7 @@
 #include "tn_crypto.h"
 
+#include <string.h>
+
 /* Domain separation tag for consensus signatures */
 static uchar const TN_CONSENSUS_DST[] = "TN_CONSENSUS_V1";
 
@@ -201,6 +203,107 @@ tn_crypto_subtract_pubkey( tn_bls_pubkey_t *       aggregate,
   return TN_CRYPTO_SUCCESS;
 }
 
+int
+tn_crypto_aggregate_pubkeys_many( tn_bls_pubkey_t *       aggregate,
+                                  tn_bls_pubkey_t const * pubkeys,
+                                  ulong                   cnt ) {
+  if( UNLIKELY( !aggregate || !pubkeys || !cnt ) ) {
+    return TN_CRYPTO_ERR_INVALID_PARAM;
+  }
+
+  blst_p1 acc;
+  blst_p1_from_affine( &acc, &pubkeys[ 0 ] );
+  for( ulong i = 1; i < cnt; i++ ) {
+    blst_p1_add_or_double_affine( &acc, &acc, &pubkeys[ i ] );
+  }
+
+  blst_p1_to_affine( aggregate, &acc );
+
+  return TN_CRYPTO_SUCCESS;
+}
+
+/* Adds set[i] to acc for every i < set_cnt whose signer bit equals
+   val.  acc must hold a valid point (possibly infinity) on entry. */
+static void
+tn_crypto_add_signer_runs( blst_p1 *               acc,
+                           tn_bls_pubkey_t const * set,
+                           ulong                   set_cnt,
+                           tn_rle_t const *        signers,
+                           int                     val ) {
+  ulong pos = 0;
+  int   bit = !!signers->first_bit;
+  for( ushort r = 0; r < signers->run_count && pos < set_cnt; r++, bit = !bit ) {
+    ulong end = pos + signers->runs[ r ];
+    end = end < set_cnt ? end : set_cnt;
+    if( bit == val ) {
+      for( ulong i = pos; i < end; i++ ) {
+        blst_p1_add_or_double_affine( acc, acc, &set[ i ] );
+      }
+    }
+    pos = end;
+  }
+
+  /* Members the RLE does not cover did not sign */
+  if( !val ) {
+    for( ulong i = pos; i < set_cnt; i++ ) {
+      blst_p1_add_or_double_affine( acc, acc, &set[ i ] );
+    }
+  }
+}
+
+int
+tn_crypto_aggregate_pubkeys_rle( tn_bls_pubkey_t *       aggregate,
+                                 tn_bls_pubkey_t const * set,
+                                 ulong                   set_cnt,
+                                 tn_rle_t const *        signers,
+                                 tn_bls_pubkey_t const * full_aggregate ) {
+  if( UNLIKELY( !aggregate || !set || !signers ) ) {
+    return TN_CRYPTO_ERR_INVALID_PARAM;
+  }
+
+  /* Count the signers, one step per run */
+  ulong present = 0;
+  ulong pos     = 0;
+  int   bit     = !!signers->first_bit;
+  for( ushort r = 0; r < signers->run_count; r++, bit = !bit ) {
+    ulong len = signers->runs[ r ];
+    if( bit && len ) {
+      if( UNLIKELY( pos + len > set_cnt ) ) {
+        return TN_CRYPTO_ERR_INVALID_PARAM;
+      }
+      present += len;
+    }
+    pos += len;
+  }
+
+  if( UNLIKELY( !present ) ) {
+    return TN_CRYPTO_ERR_AGGREGATE_FAILED;
+  }
+
+  /* A zeroed projective point (Z = 0) is the point at infinity */
+  blst_p1 acc;
+  memset( &acc, 0, sizeof( acc ) );
+
+  ulong absent = set_cnt - present;
+  if( full_aggregate && absent < present ) {
+    /* full - sum(absent), as tn_crypto_subtract_pubkey does per key but
+       with a single negation and affine conversion */
+    tn_crypto_add_signer_runs( &acc, set, set_cnt, signers, 0 );
+    blst_p1_cneg( &acc, 1 );
+    blst_p1_add_or_double_affine( &acc, &acc, full_aggregate );
+  } else {
+    tn_crypto_add_signer_runs( &acc, set, set_cnt, signers, 1 );
+  }
+
+  if( UNLIKELY( blst_p1_is_inf( &acc ) ) ) {
+    return TN_CRYPTO_ERR_AGGREGATE_FAILED;
+  }
+
+  blst_p1_to_affine( aggregate, &acc );
+
+  return TN_CRYPTO_SUCCESS;
+}
+
 int
 tn_crypto_verify_aggregate_with_dst( tn_bls_signature_t const * aggregate_sig,
                                      tn_bls_pubkey_t const *    aggregate_pk,
@@ -259,6 +362,126 @@ tn_crypto_verify_aggregate( tn_bls_signature_t const * aggregate_sig,
       TN_CONSENSUS_DST, sizeof( TN_CONSENSUS_DST ) - 1 );
 }
 
+/* Scalar weighting entry idx: the low 128 bits of sha256( seed || idx ),
+   forced odd so it is never zero.  128 bits keeps the chance that a
+   forged batch passes at 2^-128, matching the security level of the
+   curve rather than the 2^-64 of 64-bit weights. */
+static void
+tn_crypto_batch_scalar( uchar         scalar[ 16 ],
+                        uchar const * seed,
+                        ulong         idx ) {
+  uchar buf[ 32 + 8 ];
+  memcpy( buf, seed, 32 );
+  memcpy( buf + 32, &idx, 8 );
+
+  uchar hash[ 32 ];
+  blst_sha256( hash, buf, sizeof( buf ) );
+  memcpy( scalar, hash, 16 );
+  scalar[ 0 ] |= 1;
+}
+
+/* Checks entries[lo,hi) as one random linear combination.  pairing is
+   reinitialized, so one context serves every check of a batch. */
+static int
+tn_crypto_batch_check( blst_pairing *                  pairing,
+                       tn_crypto_batch_entry_t const * entries,
+                       ulong                           lo,
+                       ulong                           hi,
+                       uchar const *                   seed,
+                       uchar const *                   dst,
+                       ulong                           dst_len ) {
+  blst_pairing_init( pairing, 1, dst, dst_len );
+
+  for( ulong i = lo; i < hi; i++ ) {
+    tn_crypto_batch_entry_t const * e = &entries[ i ];
+    uchar scalar[ 16 ];
+    tn_crypto_batch_scalar( scalar, seed, i );
+
+    BLST_ERROR err = blst_pairing_mul_n_aggregate_pk_in_g1(
+        pairing, e->pubkey, e->signature, scalar, 128,
+        (uchar const *)e->message, e->message_len, NULL, 0 );
+    if( UNLIKELY( err != BLST_SUCCESS ) ) {
+      FD_LOG_WARNING(( "blst_pairing_mul_n_aggregate_pk_in_g1 (batch) failed: %d", (int)err ));
+      return 0;
+    }
+  }
+
+  blst_pairing_commit( pairing );
+
+  return blst_pairing_finalverify( pairing, NULL );
+}
+
+int
+tn_crypto_verify_batch_with_dst( tn_crypto_batch_entry_t const * entries,
+                                 ulong                           cnt,
+                                 uchar const *                   dst,
+                                 ulong                           dst_len,
+                                 ulong *                         opt_failed_idx ) {
+  if( UNLIKELY( !entries || !cnt || !dst ) ) {
+    return TN_CRYPTO_ERR_INVALID_PARAM;
+  }
+
+  /* Group check every point (as recommended by blst README) and bind
+     the scalars to the batch: seed = H( ... H( seed || sig || pk || H( msg ) ) ) */
+  uchar seed[ 32 ] = { 0 };
+  for( ulong i = 0; i < cnt; i++ ) {
+    tn_crypto_batch_entry_t const * e = &entries[ i ];
+    if( UNLIKELY( !e->signature || !e->pubkey || !e->message ) ) {
+      return TN_CRYPTO_ERR_INVALID_PARAM;
+    }
+
+    if( UNLIKELY( !blst_p1_affine_in_g1( e->pubkey ) ||
+                  !blst_p2_affine_in_g2( e->signature ) ) ) {
+      FD_LOG_WARNING(( "batch entry %lu group check failed", i ));
+      if( opt_failed_idx ) *opt_failed_idx = i;
+      return TN_CRYPTO_ERR_VERIFY_FAILED;
+    }
+
+    uchar buf[ 32 + TN_CRYPTO_G2_UNCOMPRESSED_SIZE + TN_CRYPTO_G1_UNCOMPRESSED_SIZE + 32 ];
+    uchar * p = buf;
+    memcpy( p, seed, 32 );                      p += 32;
+    blst_p2_affine_serialize( p, e->signature ); p += TN_CRYPTO_G2_UNCOMPRESSED_SIZE;
+    blst_p1_affine_serialize( p, e->pubkey );    p += TN_CRYPTO_G1_UNCOMPRESSED_SIZE;
+    blst_sha256( p, (uchar const *)e->message, e->message_len );
+    blst_sha256( seed, buf, sizeof( buf ) );
+  }
+
+  /* BLST's pairing API expects callers to reserve the pairing context.
+     Current builds use roughly 1.5 KiB here, so keep this path on normal
+     tile/application stacks and out of signal or tiny-stack contexts. */
+  blst_pairing * pairing = (blst_pairing *)__builtin_alloca( blst_pairing_sizeof() );
+
+  if( LIKELY( tn_crypto_batch_check( pairing, entries, 0, cnt, seed, dst, dst_len ) ) ) {
+    return TN_CRYPTO_SUCCESS;
+  }
+
+  if( opt_failed_idx ) {
+    /* [lo,hi) holds a failing entry.  If the left half checks out the
+       failure is in the right half. */
+    ulong lo = 0;
+    ulong hi = cnt;
+    while( hi - lo > 1 ) {
+      ulong mid = lo + ( hi - lo ) / 2;
+      if( tn_crypto_batch_check( pairing, entries, lo, mid, seed, dst, dst_len ) ) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    *opt_failed_idx = lo;
+  }
+
+  return TN_CRYPTO_ERR_VERIFY_FAILED;
+}
+
+int
+tn_crypto_verify_batch( tn_crypto_batch_entry_t const * entries,
+                        ulong                           cnt,
+                        ulong *                         opt_failed_idx ) {
+  return tn_crypto_verify_batch_with_dst( entries, cnt,
+      TN_CONSENSUS_DST, sizeof( TN_CONSENSUS_DST ) - 1, opt_failed_idx );
+}
+
 int
 tn_crypto_pubkey_on_curve( tn_bls_pubkey_t const * pubkey ) {
   if( UNLIKELY( !pubkey ) ) {
@@ -3,6 +3,8 @@
 
 #include <blst.h>
 
+#include "tn_rle.h"
+
 /* Detect smart contract build via THRU_VM flag set by thruvm.mk */
 #ifdef THRU_VM
 #include "tn_sdk_base.h"
@@ -87,6 +89,34 @@ int tn_crypto_subtract_signature( tn_bls_signature_t *       aggregate,
 int tn_crypto_subtract_pubkey( tn_bls_pubkey_t *       aggregate,
                                tn_bls_pubkey_t const * to_subtract );
 
+/* tn_crypto_aggregate_pubkeys_many aggregates pubkeys[0,cnt).  The sum
+   is accumulated in projective coordinates and converted to affine
+   once at the end.  Use it to compute the full-set aggregate that
+   tn_crypto_aggregate_pubkeys_rle can start from. */
+int tn_crypto_aggregate_pubkeys_many( tn_bls_pubkey_t *       aggregate,
+                                      tn_bls_pubkey_t const * pubkeys,
+                                      ulong                   cnt );
+
+/* tn_crypto_aggregate_pubkeys_rle aggregates the pubkeys in
+   set[0,set_cnt) whose bit is set in signers (bit i set means set[i]
+   signed).  Positions past the end of the RLE count as absent; a set
+   bit at or past set_cnt is TN_CRYPTO_ERR_INVALID_PARAM.  Runs are
+   walked directly, never bit by bit, and only one affine conversion is
+   done.
+
+   full_aggregate, if non-NULL, is the aggregate of the whole set (e.g.
+   cached next to the set by tn_crypto_aggregate_pubkeys_many).  When
+   fewer than half of the set is absent the result is computed from it,
+   subtracting the absent pubkeys rather than adding the present ones,
+   so the cost is about min(present,absent) point additions.
+
+   Returns TN_CRYPTO_ERR_AGGREGATE_FAILED if nobody signed. */
+int tn_crypto_aggregate_pubkeys_rle( tn_bls_pubkey_t *       aggregate,
+                                     tn_bls_pubkey_t const * set,
+                                     ulong                   set_cnt,
+                                     tn_rle_t const *        signers,
+                                     tn_bls_pubkey_t const * full_aggregate );
+
 /* tn_crypto_verify_aggregate_with_dst verifies an aggregate signature
    using a caller-specified domain separation tag (DST). */
 int tn_crypto_verify_aggregate_with_dst( tn_bls_signature_t const * aggregate_sig,
@@ -102,6 +132,39 @@ int tn_crypto_verify_aggregate( tn_bls_signature_t const * aggregate_sig,
                                 tn_bls_pubkey_t const * aggregate_pk,
                                 void const * message, ulong message_len );
 
+/* A (signature, pubkey, message) tuple for tn_crypto_verify_batch.  The
+   entry only points at its members; they must outlive the call. */
+typedef struct tn_crypto_batch_entry tn_crypto_batch_entry_t;
+struct tn_crypto_batch_entry {
+  tn_bls_signature_t const * signature;
+  tn_bls_pubkey_t const *    pubkey;
+  void const *               message;
+  ulong                      message_len;
+};
+
+/* tn_crypto_verify_batch_with_dst verifies entries[0,cnt) with a single
+   multi-pairing instead of one pairing check per entry.  Each entry is
+   weighted by a 128-bit scalar derived by hashing the whole batch, so
+   invalid signatures cannot be crafted to cancel out across entries.
+
+   On failure the batch is bisected to find the lowest failing entry,
+   which is stored in *opt_failed_idx if non-NULL.  Bisection costs
+   about one more batch check per halving, only on the failure path.
+
+   Returns TN_CRYPTO_SUCCESS if every entry verifies and
+   TN_CRYPTO_ERR_VERIFY_FAILED if any does not. */
+int tn_crypto_verify_batch_with_dst( tn_crypto_batch_entry_t const * entries,
+                                     ulong                           cnt,
+                                     uchar const *                   dst,
+                                     ulong                           dst_len,
+                                     ulong *                         opt_failed_idx );
+
+/* tn_crypto_verify_batch is tn_crypto_verify_batch_with_dst using the
+   default consensus DST ("TN_CONSENSUS_V1"). */
+int tn_crypto_verify_batch( tn_crypto_batch_entry_t const * entries,
+                            ulong                           cnt,
+                            ulong *                         opt_failed_idx );
+
 /* tn_crypto_pubkey_on_curve verifies a pubkey lies on the BLS12-381 curve */
 int tn_crypto_pubkey_on_curve( tn_bls_pubkey_t const * pubkey );
 
@@ -1,5 +1,7 @@
 #include "tn_rle.h"
 
+#include <string.h>
+
 ulong
 tn_rle_footprint( ushort max_runs ) {
   return sizeof( tn_rle_t ) + ( (ulong)max_runs * sizeof( ushort ));
@@ -24,6 +26,31 @@ tn_rle_delete( tn_rle_t * rle ) {
   return rle;
 }
 
+/* Largest length a single run entry can hold */
+#define TN_RLE_RUN_MAX (65535UL)
+
+/* push_run appends a run of len bits.  Runs longer than a ushort are
+   split with zero-length runs of the other value in between, so that
+   the value still alternates on every entry. */
+static int
+push_run( tn_rle_t * rle,
+          ushort     max_runs,
+          ulong      len ) {
+  while( TN_RLE_UNLIKELY( len > TN_RLE_RUN_MAX ) ) {
+    if( TN_RLE_UNLIKELY( (ulong)rle->run_count + 2UL > max_runs ) ) {
+      return TN_RLE_ERR_RUNS_TOO_SMALL;
+    }
+    rle->runs[ rle->run_count++ ] = (ushort)TN_RLE_RUN_MAX;
+    rle->runs[ rle->run_count++ ] = 0;
+    len -= TN_RLE_RUN_MAX;
+  }
+  if( TN_RLE_UNLIKELY( rle->run_count >= max_runs ) ) {
+    return TN_RLE_ERR_RUNS_TOO_SMALL;
+  }
+  rle->runs[ rle->run_count++ ] = (ushort)len;
+  return TN_RLE_SUCCESS;
+}
+
 int
 tn_rle_encode( tn_rle_t *    rle,
                ushort        max_runs,
@@ -33,45 +60,42 @@ tn_rle_encode( tn_rle_t *    rle,
     return TN_RLE_ERR_INVALID_PARAM;
   }
 
+  rle->run_count = 0;
+  rle->first_bit = 0;
+
   if( TN_RLE_UNLIKELY( bit_count == 0 ) ) {
-    rle->run_count = 0;
-    rle->first_bit = 0;
     return TN_RLE_SUCCESS;
   }
 
-  rle->run_count = 0;
-
   ulong current_bit = ( bitset[ 0 ] >> 63UL ) & 1UL;
   rle->first_bit = (ushort)current_bit;
 
-  ushort run_length = 1;
-
-  for( ulong i = 1; i < bit_count; i++ ) {
-    ulong bit = ( bitset[ i / 64UL ] >> ( 63UL - ( i % 64UL ))) & 1UL;
-
-    if( bit == current_bit ) {
-      if( run_length == 65535 ) {
-        if( rle->run_count >= max_runs ) {
-          return TN_RLE_ERR_RUNS_TOO_SMALL;
-        }
-        rle->runs[ rle->run_count++ ] = 65535;
-        run_length                    = 0;
+  /* Each run is found a word at a time: flipping the word when the run
+     is of 1s turns the first bit that ends the run into the first set
+     bit, which clz finds in one instruction (Zbb) */
+  ulong pos = 0UL;
+  while( pos < bit_count ) {
+    ulong flip = current_bit ? ~0UL : 0UL;
+    ulong end  = pos;
+    for(;;) {
+      ulong off = end % 64UL;
+      ulong x   = ( bitset[ end / 64UL ] ^ flip ) << off;
+      if( x ) {
+        end += (ulong)__builtin_clzl( x );
+        break;
       }
-      run_length++;
-    } else {
-      if( rle->run_count >= max_runs ) {
-        return TN_RLE_ERR_RUNS_TOO_SMALL;
-      }
-      rle->runs[ rle->run_count++ ] = run_length;
-      current_bit                   = bit;
-      run_length                    = 1;
+      end += 64UL - off;
+      if( end >= bit_count ) break;
     }
-  }
+    if( end > bit_count ) end = bit_count;
 
-  if( rle->run_count >= max_runs ) {
-    return TN_RLE_ERR_RUNS_TOO_SMALL;
+    int err = push_run( rle, max_runs, end - pos );
+    if( TN_RLE_UNLIKELY( err != TN_RLE_SUCCESS ) ) {
+      return err;
+    }
+    pos         = end;
+    current_bit ^= 1UL;
   }
-  rle->runs[ rle->run_count++ ] = run_length;
 
   return TN_RLE_SUCCESS;
 }
@@ -111,15 +135,28 @@ tn_rle_decode( tn_rle_t const * rle,
   ulong  bit_pos     = 0;
 
   for( ushort run_idx = 0; run_idx < rle->run_count && bit_pos < max_bits; run_idx++ ) {
-    ushort run_length = rle->runs[ run_idx ];
-
-    for( ushort i = 0; i < run_length && bit_pos < max_bits; i++ ) {
-      if( current_bit ) {
-        bitset[ bit_pos / 64UL ] |= ( 1UL << ( 63UL - ( bit_pos % 64UL )));
+    ulong end = bit_pos + rle->runs[ run_idx ];
+    if( end > max_bits ) end = max_bits;
+
+    /* Runs of 0s are already clear; runs of 1s are ORed in a word at a
+       time, with partial masks only at the ends */
+    if( current_bit && end > bit_pos ) {
+      ulong first = bit_pos / 64UL;
+      ulong last  = ( end - 1UL ) / 64UL;
+      ulong head  = ~0UL >> ( bit_pos % 64UL );
+      ulong tail  = ~0UL << ( 63UL - ( ( end - 1UL ) % 64UL ) );
+      if( first == last ) {
+        bitset[ first ] |= head & tail;
+      } else {
+        bitset[ first ] |= head;
+        for( ulong w = first + 1UL; w < last; w++ ) {
+          bitset[ w ] = ~0UL;
+        }
+        bitset[ last ] |= tail;
       }
-      bit_pos++;
     }
 
+    bit_pos     = end;
     current_bit = (ushort)( 1U - current_bit );
   }
 
@@ -143,28 +180,35 @@ tn_rle_decode_bytes( tn_rle_t const * rle,
 
   /* Clear bitset first */
   ulong byte_count = ( max_bits + 7UL ) / 8UL;
-  for( ulong i = 0; i < byte_count; i++ ) {
-    bitset[ i ] = 0;
-  }
+  memset( bitset, 0, byte_count );
 
   uchar current_bit = (uchar)tn_rle_get_first_bit( rle );
   ulong bit_pos     = 0;
 
   for( ushort run_idx = 0; run_idx < rle->run_count && bit_pos < max_bits; run_idx++ ) {
-    ushort run_length = rle->runs[ run_idx ];
-
-    for( ushort i = 0; i < run_length && bit_pos < max_bits; i++ ) {
-      if( current_bit ) {
-        /* Set bit in big-endian order within each byte */
-        bitset[ bit_pos / 8UL ] |= (uchar)( 1U << ( 7U - ( bit_pos % 8UL )));
+    ulong end = bit_pos + rle->runs[ run_idx ];
+    if( end > max_bits ) end = max_bits;
+
+    /* Set bits in big-endian order within each byte, whole bytes at a
+       time between the partial ends */
+    if( current_bit && end > bit_pos ) {
+      ulong first = bit_pos / 8UL;
+      ulong last  = ( end - 1UL ) / 8UL;
+      uchar head  = (uchar)( 0xFFU >> ( bit_pos % 8UL ) );
+      uchar tail  = (uchar)( 0xFFU << ( 7UL - ( ( end - 1UL ) % 8UL ) ) );
+      if( first == last ) {
+        bitset[ first ] |= (uchar)( head & tail );
+      } else {
+        bitset[ first ] |= head;
+        memset( bitset + first + 1UL, 0xFF, last - first - 1UL );
+        bitset[ last ] |= tail;
       }
-      bit_pos++;
     }
 
+    bit_pos     = end;
     current_bit = (uchar)( 1U - current_bit );
   }
 
   *out_bit_count = bit_pos;
   return TN_RLE_SUCCESS;
 }
-
@@ -49,6 +49,9 @@ tn_rle_delete( tn_rle_t * rle );
 /* tn_rle_encode encodes a bitset to RLE format
    bitset: array of ulong words, bits in big-endian order within each word
    bit_count: number of bits to encode
+   Runs are found a word at a time, so the cost scales with the number of
+   runs and words rather than bits.  Runs longer than 65535 bits are split
+   with zero-length runs of the other value in between.
    Returns TN_RLE_SUCCESS on success, error code on failure */
 int
 tn_rle_encode( tn_rle_t *    rle,
@@ -0,0 +1,60 @@
+# Reference programs for CU regression tracking (see bench/run.sh)
+#
+# "make bench-programs" builds the host harnesses (MACHINE=host) or the
+# deployable binaries (any other machine) without running anything;
+# "make bench-program-list" prints the programs this configuration has
+# (with BENCH_ALL=1, every program, built or not) and "make
+# bench-objdir" where it builds them
+
+.PHONY: bench-programs bench-program-list bench-objdir
+
+BENCH_DIR:=$(MKPATH)
+BENCH_PROGRAMS_ALL:=token_transfer map_insert merkle_append cpi_router bls_quorum
+ifdef TSDK_HAS_BLST
+BENCH_PROGRAMS:=$(BENCH_PROGRAMS_ALL)
+else
+BENCH_PROGRAMS:=$(filter-out bls_quorum,$(BENCH_PROGRAMS_ALL))
+endif
+
+bench-program-list:
+	@echo $(if $(BENCH_ALL),$(BENCH_PROGRAMS_ALL),$(BENCH_PROGRAMS))
+
+bench-objdir:
+	@echo $(OBJDIR)
+
+ifdef THRU_HOST
+
+# Each program linked with host_runner, which runs its scenario in the
+# host VM and prints the syscalls and heap pages of its RUN instruction
+define _make-bench-program
+
+DEPFILES+=$(OBJDIR)/obj/$(BENCH_DIR)$(1).d
+
+bench: run-bench-program-$(1)
+bench-programs: $(OBJDIR)/bench/program_$(1)
+
+$(OBJDIR)/bench/program_$(1): $(OBJDIR)/obj/$(BENCH_DIR)$(1).o $(OBJDIR)/obj/$(BENCH_DIR)host_runner.o $(OBJDIR)/lib/libtn_sdk.a
+	#######################################################################
+	# Linking reference program harness $$@ from $$^
+	#######################################################################
+	$(MKDIR) $$(dir $$@) && \
+$(CXX) $(CXXFLAGS) -o $$@ $(OBJDIR)/obj/$(BENCH_DIR)$(1).o $(OBJDIR)/obj/$(BENCH_DIR)host_runner.o -L$(OBJDIR)/lib -ltn_sdk $(LDFLAGS)
+
+.PHONY: run-bench-program-$(1)
+run-bench-program-$(1): $(OBJDIR)/bench/program_$(1)
+	#######################################################################
+	# Running reference program $$<
+	#######################################################################
+	$$<
+
+endef
+
+DEPFILES+=$(OBJDIR)/obj/$(BENCH_DIR)host_runner.d
+$(foreach prog,$(BENCH_PROGRAMS),$(eval $(call _make-bench-program,$(prog))))
+
+else
+
+$(foreach prog,$(BENCH_PROGRAMS),$(call make-bin,bench_$(prog),$(prog),tn_sdk))
+bench-programs: $(foreach prog,$(BENCH_PROGRAMS),$(OBJDIR)/bin/bench_$(prog).bin)
+
+endif
@@ -0,0 +1,94 @@
+#ifndef HEADER_sdks_cpp_bench_bench_program_hpp
+#define HEADER_sdks_cpp_bench_bench_program_hpp
+
+#include "../thru-sdk/cpp/tn_sdk.hpp"
+#include "../thru-sdk/cpp/tn_sdk_pda.hpp"
+#include "../thru-sdk/cpp/tn_sdk_syscall.hpp"
+
+#include <span>
+
+/* Shared by the reference programs in bench/ and their runners.
+
+   Every reference program answers two instructions: SETUP creates and
+   formats the accounts it works on (run once, not measured) and RUN is
+   the workload whose cost is tracked.  Programs find their accounts by
+   index only and treat same-role accounts alike, so the runners may
+   pass them in any order (thru-cli sorts them).
+
+   A program also describes, for the runners, the accounts and
+   instruction data it is driven with (Scenario, compiled into host
+   builds only): run.sh replays the same bytes on a node that host_runner
+   replays in the host VM. */
+
+/* Reference program revert codes */
+constexpr ulong BENCH_ERR_NO_SEED = 0xBE0C0000UL; /* No seed derives the account's address */
+constexpr ulong BENCH_ERR_RESIZE  = 0xBE0C0001UL; /* tsys_account_resize refused */
+constexpr ulong BENCH_ERR_CREATE  = 0xBE0C0002UL; /* tsys_account_create_ephemeral refused */
+
+namespace bench {
+
+constexpr uchar SETUP = 0U;
+constexpr uchar RUN = 1U;
+
+namespace detail {
+
+template <thru::Seed S> bool create_from(ushort idx, pubkey_t const& self) {
+  pubkey_t const& addr = tn_txn_get_acct_addrs(thru::transaction::get())[idx];
+  if (!thru::pubkey_eq(thru::pda<S, true>(self), addr)) {
+    return false;
+  }
+  if (TSDK_UNLIKELY(tsys_account_create_ephemeral(idx, S.bytes) != TSDK_SUCCESS)) {
+    tsdk_revert(BENCH_ERR_CREATE);
+  }
+  return true;
+}
+
+} // namespace detail
+
+/* Makes the account at idx an account of this program with at least sz
+   bytes of data, first creating it from whichever of Seeds derives its
+   (ephemeral) address if it does not exist.  Returns true if the data
+   had to be grown, in which case it is zeroed and needs formatting. */
+template <thru::Seed... Seeds> bool ensure_account(ushort idx, ulong sz) {
+  thru::Account account(idx);
+  if (!account.exists()) {
+    pubkey_t const& self = *tsdk_get_current_program_acc_addr();
+    if (TSDK_UNLIKELY(!(detail::create_from<Seeds>(idx, self) || ...))) {
+      tsdk_revert(BENCH_ERR_NO_SEED);
+    }
+  }
+  if (account.get_meta()->data_sz >= sz) {
+    return false;
+  }
+  if (TSDK_UNLIKELY(tsys_set_account_data_writable(idx) != TSDK_SUCCESS ||
+                    tsys_account_resize(idx, sz) != TSDK_SUCCESS)) {
+    tsdk_revert(BENCH_ERR_RESIZE);
+  }
+  return true;
+}
+
+#if defined(THRU_HOST)
+
+/* An account passed after the fee payer (0) and the program (1) */
+struct AccountSpec {
+  char const* seed;    /* Seed of an ephemeral account, or nullptr for a program account */
+  char const* program; /* Reference program owning it (or, without a seed, the program
+                          itself); nullptr for the program being run */
+};
+
+struct Scenario {
+  char const* name;
+  std::span<const uchar> setup; /* Empty if the program needs no setup */
+  std::span<const uchar> run;
+  std::span<const AccountSpec> rw;
+  std::span<const AccountSpec> ro;
+};
+
+/* Defined by each reference program */
+extern Scenario const SCENARIO;
+
+#endif
+
+} // namespace bench
+
+#endif /* HEADER_sdks_cpp_bench_bench_program_hpp */
@@ -0,0 +1,129 @@
+/* Reference program: BLS quorum check.
+
+   A committee of 16 BLS pubkeys, with their full aggregate cached next
+   to them, in one account owned by the program.  RUN takes a quorum
+   certificate's RLE signer set as its tail, aggregates the signers'
+   pubkeys (13 of 16, so by subtracting the 3 absent ones from the full
+   aggregate) and checks the committee's aggregate signature against
+   it: one G1 aggregation and one pairing check, as a light client or
+   bridge checks a certificate.
+
+   SETUP derives the committee from fixed secrets and signs the fixed
+   message with the signers' summed secret, so nothing needs to be
+   generated off chain.  Built only with blst (TSDK_HAS_BLST). */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/tn_sdk_accounts.hpp"
+#include "../thru-sdk/cpp/tn_sdk_bls.hpp"
+#include "../thru-sdk/cpp/tn_sdk_dispatch.hpp"
+
+#include <cstddef>
+
+/* The pairing context and blst's working set live on the stack */
+TSDK_PROGRAM_RESOURCES(4, 0);
+
+/* The batch check allocas blst's pairing context (blst_pairing_sizeof(),
+   about 3.2 KiB on 64-bit) and then runs the Miller loop and final
+   exponentiation, whose fp12 temporaries take a few KiB more.  Estimated
+   from blst's sources with headroom, not measured. */
+TSDK_STACK_BOUND("tn_crypto_verify_batch_with_dst", 12288);
+
+namespace {
+
+constexpr ulong ERR_KEYGEN     = 0x7E000401UL; /* Secret sum out of range */
+constexpr ulong ERR_BAD_QUORUM = 0x7E000402UL; /* Aggregate signature did not verify */
+
+constexpr ulong COMMITTEE_SZ = 16UL;
+
+constexpr uchar MESSAGE[] = "thru bench quorum certificate";
+
+struct Committee {
+  thru::crypto::BlsPubkey set[COMMITTEE_SZ];
+  thru::crypto::BlsPubkey full;
+  thru::crypto::BlsSignature quorum_sig; /* Over MESSAGE by the signers */
+};
+
+std::span<const std::byte> message() {
+  return {reinterpret_cast<std::byte const*>(MESSAGE), sizeof(MESSAGE) - 1UL};
+}
+
+struct Setup {
+  static constexpr uchar DISCRIMINATOR = bench::SETUP;
+  struct Args {};
+
+  /* tail is the signer set RUN will be given */
+  static void handle(Args const&, std::span<const std::byte> tail, thru::WritableSet& writable) {
+    if (!bench::ensure_account<"bench-committee">(2U, sizeof(Committee))) {
+      return;
+    }
+    thru::AccountViewMut<Committee> committee(thru::Account(2), writable);
+
+    blst_scalar sk[COMMITTEE_SZ];
+    for (ulong i = 0UL; i < COMMITTEE_SZ; i++) {
+      uchar ikm[32] = {static_cast<uchar>(i), 0x7EU};
+      blst_keygen(&sk[i], ikm, sizeof(ikm), nullptr, 0UL);
+      blst_p1 pk;
+      blst_sk_to_pk_in_g1(&pk, &sk[i]);
+      blst_p1_to_affine(&committee->set[i], &pk);
+    }
+    committee->full = thru::crypto::aggregate_pubkeys(committee->set);
+
+    /* Every signer signs the same message, so the aggregate signature is
+       a signature by the sum of their secrets */
+    blst_scalar sum{};
+    for (ulong idx : thru::rle::Rle(tail).set_bits(COMMITTEE_SZ)) {
+      if (TSDK_UNLIKELY(!blst_sk_add_n_check(&sum, &sum, &sk[idx]))) {
+        tsdk_revert(ERR_KEYGEN);
+      }
+    }
+    blst_p2 hash;
+    blst_hash_to_g2(&hash, MESSAGE, sizeof(MESSAGE) - 1UL, thru::crypto::BLS_CONSENSUS_DST,
+                    sizeof(thru::crypto::BLS_CONSENSUS_DST) - 1UL, nullptr, 0UL);
+    blst_p2 sig;
+    blst_sign_pk_in_g1(&sig, &hash, &sum);
+    blst_p2_to_affine(&committee->quorum_sig, &sig);
+  }
+};
+
+struct CheckQuorum {
+  static constexpr uchar DISCRIMINATOR = bench::RUN;
+  struct Args {};
+  using Accounts =
+      thru::Accounts<thru::OwnedBy<2, thru::Self>, thru::MinSize<2, sizeof(Committee)>>;
+
+  static void handle(Args const&, std::span<const std::byte> tail, thru::WritableSet&) {
+    thru::AccountView<Committee> committee(thru::Account(2));
+    thru::crypto::BlsPubkey agg =
+        thru::crypto::aggregate_pubkeys(committee->set, thru::rle::Rle(tail), &committee->full);
+    thru::crypto::BatchVerifier<1> batch;
+    batch.add(committee->quorum_sig, agg, message());
+    if (TSDK_UNLIKELY(!batch.verify())) {
+      tsdk_revert(ERR_BAD_QUORUM);
+    }
+  }
+};
+
+using Program = thru::Dispatcher<Setup, CheckQuorum>;
+
+} // namespace
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+  thru::WritableSet writable;
+  Program::run(instr_data, instr_data_sz, writable);
+}
+
+#if defined(THRU_HOST)
+
+namespace {
+
+/* Signers 0..12 of 16: first bit 1, runs of 13 ones then 3 zeros */
+constexpr uchar SETUP_DATA[] = {bench::SETUP, 1U, 0U, 2U, 0U, 13U, 0U, 3U, 0U};
+constexpr uchar RUN_DATA[] = {bench::RUN, 1U, 0U, 2U, 0U, 13U, 0U, 3U, 0U};
+constexpr bench::AccountSpec RW[] = {{"bench-committee", nullptr}};
+
+} // namespace
+
+bench::Scenario const bench::SCENARIO = {"bls_quorum", SETUP_DATA, RUN_DATA, RW, {}};
+
+#endif
@@ -0,0 +1,77 @@
+/* Reference program: multi-CPI router.
+
+   Routes a payment through token_transfer in several hops, each a
+   cross-program invocation of its Transfer instruction on the two
+   balances token_transfer owns.  The callee owns everything it writes,
+   so the router passes no authority; its (empty) auth list is validated
+   once and the token reused for every hop, leaving the invoke and the
+   callee's own work as the cost per hop.
+
+   The host VM does not run the callee; there only the invokes are
+   counted, and the callee's cost shows up in token_transfer's own
+   numbers. */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/tn_sdk_dispatch.hpp"
+#include "../thru-sdk/cpp/tn_sdk_invoke.hpp"
+
+#include <cstddef>
+
+namespace {
+
+constexpr ulong ERR_INVOKE = 0x7E000301UL; /* A hop failed */
+
+constexpr ushort TOKEN_PROGRAM_IDX = 4U; /* After the two balances */
+
+struct __attribute__((packed)) TransferInstr {
+  uchar discriminator;
+  ulong amount;
+};
+
+constexpr thru::InvokeAuth<0> NO_AUTH{};
+
+struct Route {
+  static constexpr uchar DISCRIMINATOR = bench::RUN;
+  struct __attribute__((packed)) Args {
+    ulong amount;
+    uchar hop_cnt;
+  };
+
+  static void handle(Args const& args) {
+    TransferInstr const instr = {bench::RUN, args.amount};
+    std::span<const std::byte> data(reinterpret_cast<std::byte const*>(&instr), sizeof(instr));
+
+    thru::InvokeAuthToken auth = NO_AUTH.validate();
+    for (uchar hop = 0U; hop < args.hop_cnt; hop++) {
+      ulong err = 0UL;
+      ulong rc = thru::syscall::invoke(data, TOKEN_PROGRAM_IDX, err, auth);
+      if (TSDK_UNLIKELY(rc != TSDK_SUCCESS || err != TSDK_SUCCESS)) {
+        tsdk_revert(ERR_INVOKE);
+      }
+    }
+  }
+};
+
+using Program = thru::Dispatcher<Route>;
+
+} // namespace
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+  Program::run(instr_data, instr_data_sz);
+}
+
+#if defined(THRU_HOST)
+
+namespace {
+
+constexpr uchar RUN_DATA[] = {bench::RUN, 1U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 4U};
+constexpr bench::AccountSpec RW[] = {{"bench-balance-a", "token_transfer"},
+                                     {"bench-balance-b", "token_transfer"}};
+constexpr bench::AccountSpec RO[] = {{nullptr, "token_transfer"}};
+
+} // namespace
+
+bench::Scenario const bench::SCENARIO = {"cpi_router", {}, RUN_DATA, RW, RO};
+
+#endif
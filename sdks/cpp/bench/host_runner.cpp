@@ -0,0 +1,127 @@
+/* Drives one reference program (linked in with its Scenario) in the
+   host VM and prints what its RUN instruction cost, one metric per
+   line, in the format run.sh compares against bench/baseline.txt:
+
+     token_transfer syscall.set_account_data_writable 2
+     token_transfer heap_pages 0
+
+   Syscalls are counted by TN_SYSCALL_CODE_* (all of them, so a call
+   appearing where there was none is a regression too) and heap pages
+   are those the frame mapped.  Compute units need the real VM and come
+   from run.sh's node run.
+
+   With --describe it prints the scenario instead, for run.sh to replay
+   on a node:
+
+     setup <hex>          (omitted if the program needs no setup)
+     run <hex>
+     rw <seed> <owner>    (owner "-" for the program itself)
+     ro - <program> */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/host/tn_sdk_host.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz);
+
+namespace {
+
+constexpr char const* SYSCALL_NAMES[TSDK_HOST_SYSCALL_CNT] = {
+    "set_anonymous_segment_sz",
+    "increment_anonymous_segment_sz",
+    "set_account_data_writable",
+    "account_transfer",
+    "account_create",
+    "account_create_ephemeral",
+    "account_delete",
+    "account_resize",
+    "account_compress",
+    "account_decompress",
+    "invoke",
+    "exit",
+    "log",
+    "emit_event",
+    "account_set_flags",
+    "account_create_eoa",
+};
+
+void print_hex(char const* tag, std::span<const uchar> data) {
+  std::printf("%s ", tag);
+  for (uchar b : data) {
+    std::printf("%02x", b);
+  }
+  std::printf("\n");
+}
+
+void describe(bench::Scenario const& s) {
+  if (!s.setup.empty()) {
+    print_hex("setup", s.setup);
+  }
+  print_hex("run", s.run);
+  for (bench::AccountSpec const& a : s.rw) {
+    std::printf("rw %s %s\n", a.seed ? a.seed : "-", a.program ? a.program : "-");
+  }
+  for (bench::AccountSpec const& a : s.ro) {
+    std::printf("ro %s %s\n", a.seed ? a.seed : "-", a.program ? a.program : "-");
+  }
+}
+
+/* Runs start() on instr as the transaction's instruction data, with
+   the accounts left as the previous run left them */
+bool execute(tn_txn* txn, std::span<const uchar> instr, char const* what) {
+  txn->hdr.v1.instr_data_sz = static_cast<ushort>(instr.size());
+  std::memcpy(const_cast<uchar*>(tn_txn_get_instr_data(txn)), instr.data(), instr.size());
+
+  tsdk_shadow_stack* ss = thru::host::shadow_stack();
+  ss->stack_frames[ss->call_depth].heap_pages = 0U;
+  ss->current_total_heap_pages = 0U;
+
+  thru::host::Exit ex = thru::host::run([&] { start(tn_txn_get_instr_data(txn), instr.size()); });
+  if (!ex.exited || ex.reverted || ex.code != TSDK_SUCCESS) {
+    std::fprintf(stderr, "%s: %s %s with 0x%lx\n", bench::SCENARIO.name, what,
+                 ex.reverted ? "reverted" : "returned", ex.code);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bench::Scenario const& s = bench::SCENARIO;
+  if (argc > 1 && !std::strcmp(argv[1], "--describe")) {
+    describe(s);
+    return 0;
+  }
+
+  thru::host::set_log_quiet(true);
+  tn_txn* txn = thru::host::init_txn(static_cast<ushort>(s.rw.size()),
+                                     static_cast<ushort>(s.ro.size()));
+  pubkey_t const* addrs = thru::host::account_addrs();
+  for (ulong i = 0UL; i < s.rw.size(); i++) {
+    /* The program's own accounts start out as empty accounts it owns,
+       as SETUP would leave them after creating them on a node */
+    if (!s.rw[i].program) {
+      thru::host::set_account(static_cast<ushort>(2UL + i), addrs[1], 0UL);
+    }
+  }
+
+  if (!s.setup.empty() && !execute(txn, s.setup, "SETUP")) {
+    return 1;
+  }
+  thru::host::reset_syscall_cnts();
+  if (!execute(txn, s.run, "RUN")) {
+    return 1;
+  }
+
+  for (ulong code = 0UL; code < TSDK_HOST_SYSCALL_CNT; code++) {
+    std::printf("%s syscall.%s %lu\n", s.name, SYSCALL_NAMES[code],
+                thru::host::syscall_cnt(code));
+  }
+  std::printf("%s heap_pages %u\n", s.name,
+              static_cast<uint>(thru::host::shadow_stack()->current_total_heap_pages));
+  return 0;
+}
@@ -0,0 +1,97 @@
+/* Reference program: map insert and lookup.
+
+   A FlatMap<ulong, ulong> of 1024 slots in one account owned by the
+   program.  RUN inserts a run of consecutive keys and then looks every
+   one of them up again, so the cost is hashing and probing at the fill
+   the run leaves the map in. */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/tn_sdk_accounts.hpp"
+#include "../thru-sdk/cpp/tn_sdk_dispatch.hpp"
+#include "../thru-sdk/cpp/tn_sdk_map.hpp"
+
+namespace {
+
+constexpr ulong ERR_FULL   = 0x7E000101UL; /* Map has no room for a key */
+constexpr ulong ERR_LOOKUP = 0x7E000102UL; /* An inserted key was not found */
+
+using Map = thru::FlatMap<ulong, ulong, 10>;
+
+struct Setup {
+  static constexpr uchar DISCRIMINATOR = bench::SETUP;
+  struct Args {};
+
+  static void handle(Args const&, thru::WritableSet&) {
+    if (bench::ensure_account<"bench-map">(2U, Map::footprint())) {
+      Map::format(thru::Account(2).get_data_ptr());
+    }
+  }
+};
+
+struct InsertLookup {
+  static constexpr uchar DISCRIMINATOR = bench::RUN;
+  struct __attribute__((packed)) Args {
+    ulong first_key; /* Nonzero */
+    ushort key_cnt;
+  };
+  using Accounts =
+      thru::Accounts<thru::Writable<2>, thru::OwnedBy<2, thru::Self>, thru::MinSize<2, Map::footprint()>>;
+
+  static void handle(Args const& args, thru::WritableSet& writable) {
+    writable.promote(2U);
+    Map map = Map::join(thru::Account(2));
+    if (TSDK_UNLIKELY(!map.valid())) {
+      tsdk_revert(ERR_LOOKUP);
+    }
+
+    for (ulong i = 0UL; i < args.key_cnt; i++) {
+      ulong key = args.first_key + i;
+      Map::Slot* slot = map.insert(key);
+      if (!slot) {
+        /* Already there from an earlier run */
+        slot = map.query(key);
+      }
+      if (TSDK_UNLIKELY(!slot)) {
+        tsdk_revert(ERR_FULL);
+      }
+      slot->value = i;
+    }
+
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < args.key_cnt; i++) {
+      ulong const* value = map.find(args.first_key + i);
+      if (TSDK_UNLIKELY(!value)) {
+        tsdk_revert(ERR_LOOKUP);
+      }
+      sum += *value;
+    }
+    if (TSDK_UNLIKELY(sum != static_cast<ulong>(args.key_cnt) * (args.key_cnt - 1UL) / 2UL)) {
+      tsdk_revert(ERR_LOOKUP);
+    }
+  }
+};
+
+using Program = thru::Dispatcher<Setup, InsertLookup>;
+
+} // namespace
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+  thru::WritableSet writable;
+  Program::run(instr_data, instr_data_sz, writable);
+}
+
+#if defined(THRU_HOST)
+
+namespace {
+
+constexpr uchar SETUP_DATA[] = {bench::SETUP};
+/* 512 keys from 1: the map ends the run half full */
+constexpr uchar RUN_DATA[] = {bench::RUN, 1U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0x00U, 0x02U};
+constexpr bench::AccountSpec RW[] = {{"bench-map", nullptr}};
+
+} // namespace
+
+bench::Scenario const bench::SCENARIO = {"map_insert", SETUP_DATA, RUN_DATA, RW, {}};
+
+#endif
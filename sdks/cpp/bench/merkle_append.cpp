@@ -0,0 +1,76 @@
+/* Reference program: Merkle append.
+
+   A depth-32 MerkleAccumulator in one account owned by the program.
+   RUN appends a batch of leaves and takes the root, so the cost is the
+   frontier folds of the appends (one hash per trailing one of each
+   index) plus the 32 hashes of the root. */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/tn_sdk_accounts.hpp"
+#include "../thru-sdk/cpp/tn_sdk_dispatch.hpp"
+#include "../thru-sdk/cpp/tn_sdk_merkle.hpp"
+
+#include <cstring>
+
+namespace {
+
+constexpr ulong ERR_EMPTY_ROOT = 0x7E000201UL; /* Root still that of the empty tree */
+
+using Accumulator = thru::MerkleAccumulator<32UL>;
+
+struct Setup {
+  static constexpr uchar DISCRIMINATOR = bench::SETUP;
+  struct Args {};
+
+  static void handle(Args const&, thru::WritableSet& writable) {
+    if (bench::ensure_account<"bench-merkle">(2U, Accumulator::FOOTPRINT)) {
+      Accumulator::format(thru::Account(2), writable);
+    }
+  }
+};
+
+struct Append {
+  static constexpr uchar DISCRIMINATOR = bench::RUN;
+  struct __attribute__((packed)) Args {
+    ushort leaf_cnt;
+  };
+  using Accounts = thru::Accounts<thru::Writable<2>, thru::OwnedBy<2, thru::Self>,
+                                  thru::MinSize<2, Accumulator::FOOTPRINT>>;
+
+  static void handle(Args const& args, thru::WritableSet& writable) {
+    Accumulator acc = Accumulator::join(thru::Account(2), writable);
+    pubkey_t leaf{};
+    for (ulong i = 0UL; i < args.leaf_cnt; i++) {
+      std::memcpy(&leaf, &i, sizeof(ulong));
+      acc.append(leaf);
+    }
+    pubkey_t root = acc.root();
+    if (TSDK_UNLIKELY(thru::pubkey_eq(root, Accumulator::ZEROS[32]))) {
+      tsdk_revert(ERR_EMPTY_ROOT);
+    }
+  }
+};
+
+using Program = thru::Dispatcher<Setup, Append>;
+
+} // namespace
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+  thru::WritableSet writable;
+  Program::run(instr_data, instr_data_sz, writable);
+}
+
+#if defined(THRU_HOST)
+
+namespace {
+
+constexpr uchar SETUP_DATA[] = {bench::SETUP};
+constexpr uchar RUN_DATA[] = {bench::RUN, 64U, 0U};
+constexpr bench::AccountSpec RW[] = {{"bench-merkle", nullptr}};
+
+} // namespace
+
+bench::Scenario const bench::SCENARIO = {"merkle_append", SETUP_DATA, RUN_DATA, RW, {}};
+
+#endif
@@ -0,0 +1,416 @@
+#!/usr/bin/env bash
+#
+# run.sh - compute regression check for the C++ SDK reference programs
+#
+# Usage:
+#   bench/run.sh [--vm | --cu] [--update]
+#
+# Runs every reference program in bench/ and compares what its RUN
+# instruction cost against bench/baseline.txt.  The check fails if any
+# metric grew by more than BENCH_THRESHOLD_PCT percent (or from zero to
+# anything), if a metric in the baseline was not measured (MISSING), if
+# a measured metric is not in the baseline (NEW), or if a program was
+# not built (SKIPPED).  Without BENCH_PROGRAMS the programs are those
+# this configuration builds (bls_quorum only with blst), so a plain run
+# on a clean tree checks the host VM metrics and passes.  --vm and --cu
+# select every program, and refuse to run (UNRECORDED) while the
+# baseline has none of their metrics for one of them: the check would
+# otherwise gate nothing.
+#
+# Metrics, one "<program> <metric> <value>" line each, by source:
+#   host  syscall.<name>  syscalls by TN_SYSCALL_CODE_* (host VM)
+#         heap_pages      heap pages the frame mapped (host VM)
+#   vm    binary_size     bytes of the .bin built for thruvm
+#         stack_bytes     stack start() needs, from the build's stack check
+#         stack_pages     stack pages the binary declares
+#   node  cu              compute units consumed
+#         state_units     state units consumed
+#         pages           VM pages the transaction used
+#
+# By default only the host VM is measured: the programs are built for
+# MACHINE=host and run there.  Compute units are checked only when asked
+# for, since they need the RISC-V toolchain and a node: --vm also builds
+# the programs for thruvm, and --cu also deploys those binaries as
+# ephemeral programs and executes them through thru-cli against the node
+# its config points at.  Baseline metrics of a source left out are
+# reported as not checked.  --update merges the measured values into the
+# baseline instead of checking.
+#
+# Environment variables:
+#   BENCH_THRESHOLD_PCT - allowed growth per metric in percent (default: 2).
+#   BENCH_BASELINE      - baseline file (default: bench/baseline.txt).
+#   BENCH_PROGRAMS      - programs to run (default: all this configuration
+#                         builds, or all with --vm and --cu); a selected
+#                         program that is not built fails.
+#   BENCH_SDK_EXTRAS    - SDK_EXTRAS to build with, to compare an optimization
+#                         mode (lto, size) against the baseline.  bls_quorum
+#                         is only built with blst (BLST_DIR for the host).
+#   BENCH_FEE_PAYER     - thru-cli key paying for the transactions (default: default).
+#   BENCH_RUN_ID        - distinguishes this run's program seeds (default: unix time).
+#   SKIP_BUILD          - set to 1 to reuse existing builds.
+#   THRU_CLI_BIN        - override path to the thru-cli binary.
+#
+# Dependencies: bash (>= 4), make, od and the C++ SDK toolchains; for the
+#               node, jq and a thru node with the fee payer funded.
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SDK_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+REPO_ROOT="$(git -C "$SCRIPT_DIR" rev-parse --show-toplevel 2>/dev/null || (cd "$SDK_DIR/../.." && pwd))"
+readonly SCRIPT_DIR SDK_DIR REPO_ROOT
+
+readonly THRESHOLD_PCT="${BENCH_THRESHOLD_PCT:-2}"
+readonly BASELINE="${BENCH_BASELINE:-$SCRIPT_DIR/baseline.txt}"
+readonly FEE_PAYER="${BENCH_FEE_PAYER:-default}"
+readonly RUN_ID="${BENCH_RUN_ID:-$(date +%s)}"
+readonly SKIP_BUILD="${SKIP_BUILD:-0}"
+readonly SDK_EXTRAS="${BENCH_SDK_EXTRAS:-}"
+readonly THRU_CLI_BIN="${THRU_CLI_BIN:-$REPO_ROOT/rpc/cli/target/release/thru}"
+
+SOURCES="host"
+UPDATE=0
+for arg in "$@"; do
+  case "$arg" in
+    --vm) SOURCES="host vm" ;;
+    --cu) SOURCES="host vm node" ;;
+    --update) UPDATE=1 ;;
+    -h|--help) sed -n '2,/^$/s/^# \{0,1\}//p' "${BASH_SOURCE[0]}"; exit 0 ;;
+    *) printf 'unknown argument: %s\n' "$arg" >&2; exit 2 ;;
+  esac
+done
+
+WORK_DIR="$(mktemp -d)"
+readonly WORK_DIR
+trap 'rm -rf "$WORK_DIR"' EXIT
+readonly METRICS="$WORK_DIR/metrics.txt"
+: > "$METRICS"
+
+# Programs selected but not built, by source
+SKIPPED=0
+
+log() {
+  printf '[%(%Y-%m-%dT%H:%M:%S%z)T] %s\n' -1 "$*" >&2
+}
+
+die() {
+  log "FATAL: $*"
+  exit 1
+}
+
+require_command() {
+  command -v "$1" >/dev/null 2>&1 || die "Missing dependency: '$1'"
+}
+
+sdk_make() {
+  local machine="$1"; shift
+  make -C "$SDK_DIR" MACHINE="$machine" SDK_EXTRAS="$SDK_EXTRAS" "$@"
+}
+
+# Build tree of MACHINE=$1 with the selected extras
+declare -A OBJDIRS=()
+objdir() {
+  local machine="$1" dir
+  if [[ -z "${OBJDIRS[$machine]:-}" ]]; then
+    dir=$(sdk_make "$machine" -s bench-objdir 2>/dev/null | tail -n 1) ||
+      die "cannot find the build tree for MACHINE=$machine"
+    [[ "$dir" == /* ]] || dir="$SDK_DIR/$dir"
+    OBJDIRS[$machine]="$dir"
+  fi
+  printf '%s' "${OBJDIRS[$machine]}"
+}
+
+build() {
+  local machine="$1"
+  if [[ "$SKIP_BUILD" != "1" ]]; then
+    log "Building reference programs for MACHINE=$machine"
+    sdk_make "$machine" -j"$(nproc)" bench-programs >"$WORK_DIR/build-$machine.log" 2>&1 ||
+      { tail -n 40 "$WORK_DIR/build-$machine.log" >&2; die "build for MACHINE=$machine failed"; }
+  fi
+}
+
+# Whether MACHINE=$1 builds program $2 (bls_quorum needs SDK_EXTRAS=blst)
+configured() {
+  local machine="$1" prog="$2" list
+  list=$(sdk_make "$machine" -s bench-program-list 2>/dev/null | tail -n 1) ||
+    die "cannot list the reference programs for MACHINE=$machine"
+  [[ " $list " == *" $prog "* ]]
+}
+
+skip() {
+  printf 'SKIPPED     %s\n' "$*"
+  SKIPPED=$((SKIPPED + 1))
+}
+
+# Host harness of a program, which also describes its scenario
+host_harness() {
+  printf '%s/bench/program_%s' "$(objdir host)" "$1"
+}
+
+# ---------------------------------------------------------------------------
+# Host VM
+# ---------------------------------------------------------------------------
+
+run_host() {
+  build host
+  objdir host > /dev/null
+  local prog harness
+  for prog in "${PROGRAMS[@]}"; do
+    if ! configured host "$prog"; then
+      skip "$prog: not built for MACHINE=host"
+      continue
+    fi
+    harness="$(host_harness "$prog")"
+    [[ -x "$harness" ]] || die "$prog: no host harness at $harness"
+    log "Running $prog in the host VM"
+    "$harness" >> "$METRICS" || die "$prog failed in the host VM"
+  done
+}
+
+# ---------------------------------------------------------------------------
+# thruvm build
+# ---------------------------------------------------------------------------
+
+thruvm_bin() {
+  printf '%s/bin/bench_%s' "$(objdir thruvm)" "$1"
+}
+
+run_vm() {
+  build thruvm
+  objdir thruvm > /dev/null
+  local prog bin
+  for prog in "${PROGRAMS[@]}"; do
+    if ! configured thruvm "$prog"; then
+      skip "$prog: not built for MACHINE=thruvm"
+      continue
+    fi
+    bin="$(thruvm_bin "$prog")"
+    [[ -f "$bin.bin" ]] || die "$prog: no binary at $bin.bin"
+    {
+      printf '%s binary_size %s\n' "$prog" "$(wc -c < "$bin.bin")"
+      # Written by the stack check; missing if TSDK_STACK_CHECK=0
+      [[ -f "$bin.stack" ]] && printf '%s stack_bytes %s\n' "$prog" "$(< "$bin.stack")"
+      # u16 after the header's version bytes (config/link.ld)
+      printf '%s stack_pages %s\n' "$prog" "$(od -An -tu2 -j2 -N2 "$bin.bin" | tr -d ' ')"
+    } >> "$METRICS"
+  done
+}
+
+# ---------------------------------------------------------------------------
+# Node
+# ---------------------------------------------------------------------------
+
+declare -A PROGRAM_ADDR=()
+
+cli_json() {
+  local output
+  if ! output=$("$THRU_CLI_BIN" --json "$@" 2>&1); then
+    log "thru-cli $* failed: $output"
+    return 1
+  fi
+  printf '%s\n' "$output"
+}
+
+jq_str() {
+  local _json="$1"; shift
+  jq "$@" <<< "$_json"
+}
+
+derive_address() {
+  local owner="$1" seed="$2" json
+  json=$(cli_json program derive-address "$owner" "$seed" --ephemeral) || die "derive-address $seed failed"
+  jq_str "$json" -er '.derive_address.derived_address'
+}
+
+# Executes one instruction of program prog; prints the execute JSON
+execute() {
+  local prog="$1" data="$2"; shift 2
+  cli_json txn execute "${PROGRAM_ADDR[$prog]}" "$data" --fee-payer "$FEE_PAYER" --timeout 60 "$@" ||
+    die "$prog: instruction $data failed"
+}
+
+run_node_program() {
+  local prog="$1"
+  local bin
+  bin="$(thruvm_bin "$prog").bin"
+  # run_vm has reported programs without a binary
+  [[ -f "$bin" ]] || return 0
+  [[ -x "$(host_harness "$prog")" ]] || die "$prog: no host harness to describe its scenario"
+
+  local seed="bench-$RUN_ID-$prog" json
+  log "Deploying $prog as ephemeral program $seed"
+  json=$(cli_json program create --ephemeral "$seed" "$bin") || die "deploying $prog failed"
+  PROGRAM_ADDR[$prog]=$(jq_str "$json" -er '.program_create.program_account')
+
+  local setup="" run="" kind acct owner addr
+  local -a accts=()
+  while read -r kind acct owner; do
+    case "$kind" in
+      setup) setup="$acct" ;;
+      run) run="$acct" ;;
+      rw|ro)
+        [[ "$owner" == "-" ]] && owner="$prog"
+        [[ -n "${PROGRAM_ADDR[$owner]:-}" ]] || die "$prog needs $owner deployed first"
+        if [[ "$acct" == "-" ]]; then
+          addr="${PROGRAM_ADDR[$owner]}"
+        else
+          addr=$(derive_address "${PROGRAM_ADDR[$owner]}" "$acct")
+        fi
+        if [[ "$kind" == "rw" ]]; then
+          accts+=(--readwrite-accounts "$addr")
+        else
+          accts+=(--readonly-accounts "$addr")
+        fi
+        ;;
+    esac
+  done < <("$(host_harness "$prog")" --describe)
+
+  if [[ -n "$setup" ]]; then
+    log "Running $prog SETUP"
+    execute "$prog" "$setup" "${accts[@]}" >/dev/null
+  fi
+  log "Running $prog RUN"
+  json=$(execute "$prog" "$run" "${accts[@]}")
+  {
+    printf '%s cu %s\n' "$prog" "$(jq_str "$json" -er '.transaction_execute.compute_units_consumed')"
+    printf '%s state_units %s\n' "$prog" "$(jq_str "$json" -er '.transaction_execute.state_units_consumed')"
+    printf '%s pages %s\n' "$prog" "$(jq_str "$json" -er '.transaction_execute.pages_used')"
+  } >> "$METRICS"
+}
+
+run_node() {
+  require_command jq
+  [[ -x "$THRU_CLI_BIN" ]] || die "thru-cli not found at $THRU_CLI_BIN (set THRU_CLI_BIN, or run without --cu)"
+  local prog
+  for prog in "${PROGRAMS[@]}"; do
+    run_node_program "$prog"
+  done
+}
+
+# ---------------------------------------------------------------------------
+# Baseline
+# ---------------------------------------------------------------------------
+
+# Merges the measured metrics into the baseline, keeping its order and
+# any metrics not measured this run
+update_baseline() {
+  local tmp="$WORK_DIR/baseline.new" old=/dev/null
+  [[ -f "$BASELINE" ]] && old="$BASELINE"
+  {
+    grep '^#' "$old" || true
+    awk '!/^#/ && NF == 3 {
+           key = $1 " " $2
+           if (!(key in val)) { order[++n] = key }
+           val[key] = $3
+         }
+         END { for (i = 1; i <= n; i++) { print order[i], val[order[i]] } }' "$old" "$METRICS"
+  } > "$tmp"
+  mv "$tmp" "$BASELINE"
+  log "Updated $BASELINE with $(wc -l < "$METRICS") metrics"
+}
+
+# Source of each metric, for awk
+readonly AWK_SOURCE='
+  function source(metric) {
+    if (metric ~ /^syscall\./ || metric == "heap_pages") return "host"
+    if (metric == "binary_size" || metric == "stack_bytes" || metric == "stack_pages") return "vm"
+    return "node"
+  }'
+
+# Fails before anything is built if a selected source has no baseline
+# metric for a selected program, printing a line per pair
+check_recorded() {
+  [[ -f "$BASELINE" ]] || die "no baseline at $BASELINE (run with --update)"
+  awk -v sources="$SOURCES" -v programs="${PROGRAMS[*]}" "$AWK_SOURCE"'
+    !/^#/ && NF == 3 { recorded[$1 " " source($2)] = 1 }
+    END {
+      ns = split(sources, s, " ")
+      np = split(programs, p, " ")
+      for (i = 1; i <= np; i++) {
+        for (j = 1; j <= ns; j++) {
+          if (!((p[i] " " s[j]) in recorded)) {
+            printf "UNRECORDED  %-48s no %s metrics in the baseline\n", p[i], s[j]; bad++
+          }
+        }
+      }
+      exit bad ? 1 : 0
+    }' "$BASELINE"
+}
+
+# Prints a line per regression, improvement, new and missing metric;
+# fails on any but an improvement
+check_baseline() {
+  [[ -f "$BASELINE" ]] || die "no baseline at $BASELINE (run with --update)"
+  awk -v pct="$THRESHOLD_PCT" -v sources="$SOURCES" -v programs="${PROGRAMS[*]}" "$AWK_SOURCE"'
+    BEGIN {
+      n = split(sources, s, " ")
+      for (i = 1; i <= n; i++) measured[s[i]] = 1
+      n = split(programs, s, " ")
+      for (i = 1; i <= n; i++) selected[s[i]] = 1
+    }
+    NR == FNR {
+      if ($0 !~ /^#/ && NF == 3) { key = $1 " " $2; base[key] = $3; order[++base_cnt] = key }
+      next
+    }
+    {
+      key = $1 " " $2; cur = $3 + 0; seen[key] = 1
+      if (!(key in base)) { printf "NEW         %-48s %s\n", key, cur; bad++; next }
+      b = base[key] + 0
+      if (cur > b * (1 + pct / 100) || (b == 0 && cur > 0)) {
+        printf "REGRESSION  %-48s %s -> %s\n", key, b, cur; bad++
+      } else if (cur < b) {
+        printf "improved    %-48s %s -> %s\n", key, b, cur
+      }
+      checked++
+    }
+    END {
+      for (i = 1; i <= base_cnt; i++) {
+        key = order[i]
+        if (key in seen) continue
+        split(key, k, " ")
+        if ((source(k[2]) in measured) && (k[1] in selected)) {
+          printf "MISSING     %-48s %s\n", key, base[key]; bad++
+        } else {
+          unchecked++
+        }
+      }
+      printf "%d metrics checked against the baseline, %d failed (threshold %s%%)\n", checked, bad, pct
+      if (unchecked) printf "%d baseline metrics not checked (source or program not selected)\n", unchecked
+      exit bad ? 1 : 0
+    }' "$BASELINE" "$METRICS"
+}
+
+# Dependency order (bench/Local.mk): cpi_router routes through
+# token_transfer's accounts
+if [[ -n "${BENCH_PROGRAMS:-}" ]]; then
+  read -r -a PROGRAMS <<< "$BENCH_PROGRAMS"
+else
+  all=""
+  [[ "$SOURCES" == "host" ]] || all=1
+  program_list=$(sdk_make host -s BENCH_ALL="$all" bench-program-list 2>/dev/null | tail -n 1) ||
+    die "cannot list the reference programs"
+  read -r -a PROGRAMS <<< "$program_list"
+fi
+readonly PROGRAMS
+
+if [[ "$UPDATE" != "1" ]]; then
+  check_recorded ||
+    die "the baseline cannot gate this run; record the missing metrics with $0 $* --update"
+fi
+
+for source in $SOURCES; do
+  "run_$source"
+done
+
+if [[ "$UPDATE" == "1" ]]; then
+  [[ "$SKIPPED" == "0" ]] || die "$SKIPPED program(s) not built; not updating the baseline"
+  update_baseline
+else
+  status=0
+  check_baseline || status=1
+  if [[ "$SKIPPED" != "0" ]]; then
+    log "$SKIPPED program(s) selected but not built"
+    status=1
+  fi
+  exit "$status"
+fi
@@ -0,0 +1,92 @@
+/* Reference program: token transfer.
+
+   Two balance accounts owned by the program, both belonging to the fee
+   payer; RUN moves an amount from the lower-indexed one to the other.
+   The cost is the Accounts constraint pass, two account views and the
+   owner and balance checks.  A short balance is reported with
+   thru::runtime::printf, so the VM build puts the SDK's printf path
+   through the stack check. */
+
+#include "bench_program.hpp"
+
+#include "../thru-sdk/cpp/tn_sdk_accounts.hpp"
+#include "../thru-sdk/cpp/tn_sdk_dispatch.hpp"
+
+namespace {
+
+constexpr ulong ERR_NOT_OWNER    = 0x7E000001UL; /* Fee payer does not own the source */
+constexpr ulong ERR_INSUFFICIENT = 0x7E000002UL; /* Source balance below amount */
+
+constexpr ulong INITIAL_AMOUNT = 1000000000000UL;
+
+struct Balance {
+  pubkey_t owner;
+  ulong amount;
+};
+
+using BalanceAccounts =
+    thru::Accounts<thru::Writable<2>, thru::Writable<3>, thru::OwnedBy<2, thru::Self>,
+                   thru::OwnedBy<3, thru::Self>, thru::MinSize<2, sizeof(Balance)>,
+                   thru::MinSize<3, sizeof(Balance)>>;
+
+struct Setup {
+  static constexpr uchar DISCRIMINATOR = bench::SETUP;
+  struct Args {};
+
+  static void handle(Args const&, thru::WritableSet& writable) {
+    for (ushort idx = 2U; idx <= 3U; idx++) {
+      if (bench::ensure_account<"bench-balance-a", "bench-balance-b">(idx, sizeof(Balance))) {
+        thru::AccountViewMut<Balance> balance(thru::Account(idx), writable);
+        balance->owner = tn_txn_get_acct_addrs(thru::transaction::get())[0];
+        balance->amount = INITIAL_AMOUNT;
+      }
+    }
+  }
+};
+
+struct Transfer {
+  static constexpr uchar DISCRIMINATOR = bench::RUN;
+  struct __attribute__((packed)) Args {
+    ulong amount;
+  };
+  using Accounts = BalanceAccounts;
+
+  static void handle(Args const& args, thru::WritableSet& writable) {
+    thru::AccountViewMut<Balance> from(thru::Account(2), writable);
+    thru::AccountViewMut<Balance> to(thru::Account(3), writable);
+    if (TSDK_UNLIKELY(!thru::pubkey_eq(from->owner,
+                                       tn_txn_get_acct_addrs(thru::transaction::get())[0]))) {
+      tsdk_revert(ERR_NOT_OWNER);
+    }
+    if (TSDK_UNLIKELY(from->amount < args.amount)) {
+      thru::runtime::printf("balance %lu below amount %lu\n", from->amount,
+                            ulong{args.amount});
+      tsdk_revert(ERR_INSUFFICIENT);
+    }
+    from->amount -= args.amount;
+    to->amount += args.amount;
+  }
+};
+
+using Program = thru::Dispatcher<Setup, Transfer>;
+
+} // namespace
+
+TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+  thru::WritableSet writable;
+  Program::run(instr_data, instr_data_sz, writable);
+}
+
+#if defined(THRU_HOST)
+
+namespace {
+
+constexpr uchar SETUP_DATA[] = {bench::SETUP};
+constexpr uchar RUN_DATA[] = {bench::RUN, 100U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
+constexpr bench::AccountSpec RW[] = {{"bench-balance-a", nullptr}, {"bench-balance-b", nullptr}};
+
+} // namespace
+
+bench::Scenario const bench::SCENARIO = {"token_transfer", SETUP_DATA, RUN_DATA, RW, {}};
+
+#endif
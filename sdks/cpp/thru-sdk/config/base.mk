@@ -1,10 +1,12 @@
 BASEDIR?=build
-BUILDDIR?=thruvm
+MACHINE?=thruvm
+BUILDDIR?=$(MACHINE)
 
 SHELL:=bash
 
 # Generic flags (toolchain-specific flags will be added by extras)
 CXXFLAGS:=-std=c++20 -Werror -Wall -Wextra -Wpedantic -Wstrict-aliasing=2 -Wconversion
+CFLAGS:=-std=c17 -Werror -Wall -Wextra -Wpedantic -Wstrict-aliasing=2 -Wconversion
 LDFLAGS:=
 ARFLAGS:=rv
 
@@ -20,12 +22,16 @@ FIND:=find
 SCRUB:=$(FIND) . -type f -name "*~" -o -name "\#*" | xargs $(RM)
 DATE:=date
 CAT:=cat
+AWK:=awk
+OD:=od
 
 # Toolchain will be set by extra configuration files
 # Default to standard names if not overridden
 CXX?=g++
+CC?=gcc
 OBJCOPY?=objcopy
 OBJDUMP?=objdump
+READELF?=readelf
 AR?=ar
 RANLIB?=ranlib
 
@@ -0,0 +1,26 @@
+# BLS12-381 over blst (tn_sdk_bls.hpp)
+# Opt in with SDK_EXTRAS=blst, for the SDK library and the program.  The
+# library then also builds the C SDK's tn_crypto.c, which tn_sdk_bls.hpp
+# calls.  thruvm builds link the libblst.a deps.sh builds into the
+# toolchain, along with its call graph for the stack check; host builds
+# need BLST_DIR set to a host build of blst (a checkout after ./build.sh).
+# Objects go to a separate $(BUILDDIR)-blst tree.
+
+ifdef THRU_HOST
+BLST_LIB:=$(BLST_DIR)/libblst.a
+BLST_INCLUDE:=$(BLST_DIR)/bindings
+else
+BLST_LIB:=$(RISCV_TOOLCHAIN_ROOT)/lib/libblst.a
+BLST_INCLUDE:=$(RISCV_TOOLCHAIN_ROOT)/include
+TSDK_STACK_CI+=$(wildcard $(RISCV_TOOLCHAIN_ROOT)/lib/libblst.ci)
+endif
+
+ifeq (,$(wildcard $(BLST_LIB)))
+$(error SDK_EXTRAS=blst: $(BLST_LIB) not found (run deps.sh, or set BLST_DIR for host builds))
+endif
+
+BUILDDIR:=$(BUILDDIR)-blst
+
+TSDK_HAS_BLST:=1
+CPPFLAGS+=-DTSDK_HAS_BLST=1 -I$(BLST_INCLUDE)
+LDFLAGS+=$(BLST_LIB)
@@ -6,6 +6,8 @@ CPPFLAGS += -g -DDEBUG=1
 
 CXXFLAGS := $(patsubst -O%,-O0,$(CXXFLAGS))
 CXXFLAGS += -g
+CFLAGS := $(patsubst -O%,-O0,$(CFLAGS))
+CFLAGS += -g
 
 # Remove optimization-related flags that might interfere with debugging
 CPPFLAGS := $(patsubst -flto,,$(CPPFLAGS))
@@ -16,6 +18,10 @@ CXXFLAGS := $(patsubst -flto,,$(CXXFLAGS))
 CXXFLAGS := $(patsubst -fdata-sections,,$(CXXFLAGS))
 CXXFLAGS := $(patsubst -ffunction-sections,,$(CXXFLAGS))
 
+CFLAGS := $(patsubst -flto,,$(CFLAGS))
+CFLAGS := $(patsubst -fdata-sections,,$(CFLAGS))
+CFLAGS := $(patsubst -ffunction-sections,,$(CFLAGS))
+
 # Remove linker optimization flags  
 comma := ,
 LDFLAGS := $(patsubst -Wl$(comma)--gc-sections,,$(LDFLAGS))
@@ -60,14 +60,17 @@ endif
 
 # Set up toolchain variables
 CXX := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)g++
+CC := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)gcc
 OBJCOPY := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)objcopy
 OBJDUMP := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)objdump
+READELF := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)readelf
 AR := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)ar
 RANLIB := $(RISCV_TOOLCHAIN_PATH)/$(RISCV_PREFIX)ranlib
 
 # Add sysroot and RISC-V specific flags
 CPPFLAGS += -isystem $(RISCV_SYSROOT)/include --sysroot=$(RISCV_SYSROOT)
 CXXFLAGS += --sysroot=$(RISCV_SYSROOT)
+CFLAGS += --sysroot=$(RISCV_SYSROOT)
 
 # Some distro-provided riscv64-unknown-elf compilers do not ship libstdc++
 # headers in the compiler's built-in search path.  When the SDK sysroot has
@@ -0,0 +1,23 @@
+# Link-time optimization
+# Lets the compiler inline across the SDK library and the program, e.g.
+# small SDK wrappers such as tsdk_get_account_meta.  Whether that lowers
+# compute units is program dependent and unmeasured; compare with
+# BENCH_SDK_EXTRAS=lto bench/run.sh --cu.  Build the SDK library and the
+# program with SDK_EXTRAS=lto.  Objects go to a separate $(BUILDDIR)-lto
+# tree so they never mix with non-LTO ones.
+
+BUILDDIR:=$(BUILDDIR)-lto
+
+CXXFLAGS += -flto=auto -fno-fat-lto-objects
+CFLAGS += -flto=auto -fno-fat-lto-objects
+
+# Archives of LTO objects need the plugin-aware archiver for their
+# symbol tables
+AR := $(patsubst %g++,%gcc-ar,$(CXX))
+RANLIB := $(patsubst %g++,%gcc-ranlib,$(CXX))
+
+# Code is only generated at link time, so the objects carry no call
+# graphs for the stack check.  make-bin takes them from the link
+# instead, with the whole program in one partition so they land in a
+# single .ci.
+TSDK_LTO:=1
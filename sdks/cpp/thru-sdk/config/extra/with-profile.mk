@@ -0,0 +1,6 @@
+# Profiling build configuration
+# Enables thru::prof::Scope / TSDK_PROF_SCOPE probes (tn_sdk_prof.hpp).
+# Build both the SDK library and the program with SDK_EXTRAS=profile: the
+# library maps the profile table in _start and dumps it on exit.
+
+CPPFLAGS += -DTSDK_PROFILE=1
@@ -0,0 +1,10 @@
+# Size-optimized build
+# -Os in place of -O3.  Whether the smaller image is worth the slower
+# code is program dependent and unmeasured; compare both with "make size"
+# and BENCH_SDK_EXTRAS=size bench/run.sh --cu before switching.  Objects
+# go to $(BUILDDIR)-size.
+
+BUILDDIR:=$(BUILDDIR)-size
+
+CXXFLAGS := $(patsubst -O%,-Os,$(CXXFLAGS))
+CFLAGS := $(patsubst -O%,-Os,$(CFLAGS))
@@ -0,0 +1,26 @@
+BUILDDIR?=host
+
+# Host machine configuration
+# This configuration builds the SDK natively with the host compiler, with
+# the VM segments and syscalls emulated (cpp/host).  It is for benchmarks
+# and tests only; the binaries cannot be deployed.
+
+THRU_HOST:=1
+
+# Host toolchain (override HOST_CXX and HOST_CC to use e.g. clang++)
+HOST_CXX?=g++
+HOST_CC?=gcc
+CXX:=$(HOST_CXX)
+CC:=$(HOST_CC)
+OBJCOPY:=objcopy
+OBJDUMP:=objdump
+READELF:=readelf
+AR:=ar
+RANLIB:=ranlib
+
+# Standard flags
+CXXFLAGS+=-O3 -g -fno-exceptions -fno-rtti
+CFLAGS+=-O3 -g
+
+# Additional flags specific to host builds
+CPPFLAGS+=-DTHRU_HOST=1
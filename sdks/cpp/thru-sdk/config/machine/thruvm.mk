@@ -15,6 +15,20 @@ CXXFLAGS+=-std=c++20 \
 	-Werror -Wall -Wextra -Wpedantic -Wstrict-aliasing=2 -Wconversion \
 	-fno-exceptions -fno-rtti
 
+# C sources (tn_sdk_crypto.c, see cpp/Local.mk)
+CFLAGS+=-march=rv64imc_zba_zbb_zbc_zbs_zknh -mabi=lp64 -mcmodel=medlow -mstrict-align \
+	-specs=picolibc.specs --picolibc-prefix=$(RISCV_TOOLCHAIN_ROOT) -O3 -g -fno-stack-protector -ffreestanding \
+	-ffunction-sections -fdata-sections -nostartfiles -static-pie -fPIE
+
+# Call graphs with frame sizes (.ci next to each object) for the stack
+# check of program binaries (config/stack-check.awk).  TSDK_STACK_CHECK=0
+# skips it.
+TSDK_STACK_CHECK?=1
+ifeq ($(TSDK_STACK_CHECK),1)
+CXXFLAGS+=-fcallgraph-info=su
+CFLAGS+=-fcallgraph-info=su
+endif
+
 LDFLAGS+=-e _start -T $(THRU_CPP_SDK_DIR)/config/link.ld -Wl,-gc-sections
 
 # Additional flags specific to ThruNet VM
@@ -0,0 +1,155 @@
+# Static stack check for Thru programs
+#
+# Usage: awk -f stack-check.awk -v bin=prog.bin [-v elf=prog.elf]
+#            [-v out=prog.stack] [-v od=od] [-v readelf=readelf] file.ci ...
+#
+# Reads the stack pages declared in the program header of bin (see
+# TSDK_PROGRAM_RESOURCES in tn_sdk.hpp) and the call graphs GCC writes
+# with -fcallgraph-info=su, and fails if the deepest call chain from
+# start() needs more stack than _start maps.
+#
+# Recursion, indirect calls, dynamic allocations and functions without
+# call graph info (e.g. libc) cannot be bounded from the graph, so they
+# fail the check too unless the program bounds them with
+# TSDK_STACK_BOUND (tn_sdk.hpp), which the linker keeps in the
+# .tsdk_stack section of elf.  A bounded function costs its bound, which
+# covers everything it calls.
+#
+# out, if set, receives the stack bytes start() needs.
+
+# _start's own frame below the mapped stack top
+function entry_frame() { return 32 }
+
+# Bound declared for fn, or -1.  Internal-linkage functions are titled
+# "<source>:<symbol>" in the call graph; bounds name just the symbol.
+function bound_of(fn,    sym) {
+  if (fn in bound) return bound[fn]
+  sym = fn
+  sub(/^.*:/, "", sym)
+  if (sym in bound) return bound[sym]
+  return -1
+}
+
+function cost(fn,    i, n, c, b, best, best_callee) {
+  if (fn in memo) return memo[fn]
+  b = bound_of(fn)
+  if (b >= 0) {
+    memo[fn] = b
+    return b
+  }
+  if (!(fn in size)) {
+    unknown[fn] = 1
+    return 0
+  }
+  if (fn in active) {
+    unbounded["recursion through " fn] = 1
+    return 0
+  }
+  if (fn in dynamic) unbounded["dynamic stack in " fn] = 1
+  active[fn] = 1
+  best = 0
+  best_callee = ""
+  n = edge_cnt[fn]
+  for (i = 0; i < n; i++) {
+    if (edge[fn, i] == "__indirect_call") {
+      unbounded["indirect call in " fn] = 1
+      continue
+    }
+    c = cost(edge[fn, i])
+    if (c > best) {
+      best = c
+      best_callee = edge[fn, i]
+    }
+  }
+  delete active[fn]
+  next_fn[fn] = best_callee
+  memo[fn] = size[fn] + best
+  return memo[fn]
+}
+
+BEGIN {
+  if (od == "") od = "od"
+  if (readelf == "") readelf = "readelf"
+  if (root == "") root = "start"
+  cmd = od " -An -tu2 -j2 -N2 " bin
+  if ((cmd | getline stack_pages) <= 0) {
+    printf "stack-check: cannot read the program header of %s\n", bin > "/dev/stderr"
+    status = 2
+    exit status
+  }
+  close(cmd)
+  stack_pages += 0
+
+  # "<symbol> <bytes>" strings from TSDK_STACK_BOUND
+  if (elf != "") {
+    cmd = readelf " -p .tsdk_stack " elf " 2>/dev/null"
+    while ((cmd | getline line) > 0) {
+      if (!sub(/^ *\[ *[0-9a-f]+\] +/, "", line)) continue
+      if (split(line, f, " ") != 2 || f[2] !~ /^[0-9]+$/) {
+        printf "stack-check: %s: malformed stack bound: %s\n", elf, line > "/dev/stderr"
+        status = 2
+        exit status
+      }
+      bound[f[1]] = f[2] + 0
+    }
+    close(cmd)
+  }
+}
+
+/^node:/ {
+  if (!match($0, /title: "[^"]*"/)) next
+  title = substr($0, RSTART + 8, RLENGTH - 9)
+  if (!match($0, /[0-9]+ bytes \([a-z,]+\)/)) next
+  info = substr($0, RSTART, RLENGTH)
+  bytes = info + 0
+  # COMDAT functions appear once per object; keep the largest frame
+  if (!(title in size) || bytes > size[title]) size[title] = bytes
+  if (info ~ /dynamic\)/) dynamic[title] = 1
+}
+
+/^edge:/ {
+  if (!match($0, /sourcename: "[^"]*"/)) next
+  src = substr($0, RSTART + 13, RLENGTH - 14)
+  if (!match($0, /targetname: "[^"]*"/)) next
+  dst = substr($0, RSTART + 13, RLENGTH - 14)
+  if ((src, dst) in seen) next
+  seen[src, dst] = 1
+  edge[src, edge_cnt[src]++] = dst
+}
+
+END {
+  if (status) exit status
+  if (!(root in size) && bound_of(root) < 0) {
+    printf "stack-check: %s: no call graph for %s()\n", bin, root > "/dev/stderr"
+    printf "stack-check: build with -fcallgraph-info=su or set TSDK_STACK_CHECK=0\n" > "/dev/stderr"
+    exit 1
+  }
+
+  limit = stack_pages * 4096 - entry_frame()
+  depth = cost(root)
+
+  bad = 0
+  for (reason in unbounded) {
+    printf "stack-check: %s: not bounded: %s\n", bin, reason > "/dev/stderr"
+    bad++
+  }
+  for (fn in unknown) {
+    printf "stack-check: %s: no stack info for %s\n", bin, fn > "/dev/stderr"
+    bad++
+  }
+  if (bad) {
+    printf "stack-check: bound these with TSDK_STACK_BOUND (tn_sdk.hpp)\n" > "/dev/stderr"
+    exit 1
+  }
+
+  if (depth > limit) {
+    printf "stack-check: %s: start() needs %d bytes of stack, %d page(s) declared (%d usable)\n", \
+      bin, depth, stack_pages, limit > "/dev/stderr"
+    printf "stack-check: deepest chain:" > "/dev/stderr"
+    for (fn = root; fn != "" && steps++ < 256; fn = next_fn[fn]) printf " %s(%d)", fn, memo[fn] - memo[next_fn[fn]] > "/dev/stderr"
+    printf "\nstack-check: raise the stack pages in TSDK_PROGRAM_RESOURCES\n" > "/dev/stderr"
+    exit 1
+  }
+  if (out != "") print depth > out
+  printf "stack-check: %s: %d of %d stack bytes\n", bin, depth, limit
+}
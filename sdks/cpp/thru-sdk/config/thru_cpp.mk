@@ -2,7 +2,7 @@ MAKEFLAGS += --no-builtin-rules
 MAKEFLAGS += --no-builtin-variables
 .SUFFIXES:
 .PHONY: all info bin lib unit-test help clean distclean asm ppp show-deps include
-.PHONY: run-unit-test
+.PHONY: run-unit-test bench size
 .SECONDARY:
 .SECONDEXPANSION:
 
@@ -27,8 +27,11 @@ help:
 	# CPPFLAGS        = $(CPPFLAGS)
 	# CXX             = $(CXX)
 	# CXXFLAGS        = $(CXXFLAGS)
+	# CC              = $(CC)
+	# CFLAGS          = $(CFLAGS)
 	# OBJCOPY         = $(OBJCOPY)
 	# OBJDUMP         = $(OBJDUMP)
+	# READELF         = $(READELF)
 	# AR              = $(AR)
 	# ARFLAGS         = $(ARFLAGS)
 	# RANLIB          = $(RANLIB)
@@ -48,6 +51,8 @@ help:
 	# "make lib" makes all libraries for the current platform
 	# "make unit-test" makes all unit-tests for the current platform
 	# "make run-unit-test" runs all unit-tests for the current platform
+	# "make bench" builds and runs all benchmarks (MACHINE=host only)
+	# "make size" makes all binaries and prints their loaded image sizes
 	# "make help" prints this message
 	# "make clean" removes editor temp files and the current platform build
 	# "make distclean" removes editor temp files and all platform builds
@@ -57,6 +62,9 @@ help:
 
 info: $(OBJDIR)/info
 
+size: bin
+	@for f in $(OBJDIR)/bin/*.bin; do [ -e "$$f" ] && printf '%10s %s\n' "$$(wc -c < $$f)" "$$f"; done; true
+
 clean:
 	#######################################################################
 	# Cleaning $(OBJDIR)
@@ -71,6 +79,14 @@ distclean:
 	$(RMDIR) $(BASEDIR) && \
 $(SCRUB)
 
+run-unit-test:
+	#######################################################################
+	# Running unit tests in $(OBJDIR)/unit-test (see "make unit-test")
+	#######################################################################
+	@for t in $(wildcard $(OBJDIR)/unit-test/test_*); do \
+  echo "$$t" && "$$t" || exit 1; \
+done
+
 ##############################
 # Usage: $(call make-lib,name)
 
@@ -119,6 +135,29 @@ endef
 
 add-hdrs = $(eval $(call _add-hdrs,$(1)))
 
+##############################
+# Usage: $(call stack-check,bin,elf,cis,out)
+# Fails if the deepest call chain from start() in the call graphs cis,
+# those of the SDK libraries and TSDK_STACK_CI (call graphs of
+# third-party libraries) needs more stack than bin declares (see
+# TSDK_PROGRAM_RESOURCES in tn_sdk.hpp), or cannot be bounded with the
+# TSDK_STACK_BOUNDs in elf.  Writes the stack bytes needed to out.
+
+ifeq ($(TSDK_STACK_CHECK),1)
+stack-check = $(AWK) -f $(THRU_CPP_SDK_DIR)/config/stack-check.awk -v od=$(OD) -v readelf=$(READELF) \
+  -v bin=$(1) -v elf=$(2) -v out=$(4) $(3) $(wildcard $(OBJDIR)/lib/*.ci $(THRU_CPP_SDK_DIR)/lib/*.ci) \
+  $(TSDK_STACK_CI)
+else
+stack-check = true
+endif
+
+# Under LTO code is generated at link time, so the call graph is written
+# by the link, as one partition, next to the ELF
+ifeq ($(TSDK_STACK_CHECK)$(TSDK_LTO),11)
+link-ci-flags = -fcallgraph-info=su -flto-partition=none -dumpdir $(1).
+link-ci = && $(CAT) $(1).*.ci > $(1:.elf=.ci) && $(RM) $(1).*.ci
+endif
+
 ##############################
 # Usage: $(call make-bin,name,objs,libs,flags)
 # Creates a ThruNet program binary from object files
@@ -135,14 +174,17 @@ $(OBJDIR)/bin/$(1).elf: $(foreach obj,$(2),$(OBJDIR)/obj/$(MKPATH)$(obj).o) $(fo
 	# Linking Thru program $$@ from $$^
 	#######################################################################
 	$(MKDIR) $$(dir $$@) && \
-$(CXX) $(CXXFLAGS) -o $$@ $(foreach obj,$(2),$(OBJDIR)/obj/$(MKPATH)$(obj).o) -L$(OBJDIR)/lib $(4) $(foreach lib,$(3), -l$(lib)) $(LDFLAGS)
+$(CXX) $(CXXFLAGS) -o $$@ $(foreach obj,$(2),$(OBJDIR)/obj/$(MKPATH)$(obj).o) -L$(OBJDIR)/lib $(4) $(foreach lib,$(3), -l$(lib)) $(LDFLAGS) \
+$$(call link-ci-flags,$$@) $$(call link-ci,$$@)
 
 # Binary file from ELF
 $(OBJDIR)/bin/$(1).bin: $(OBJDIR)/bin/$(1).elf
 	#######################################################################
 	# Creating binary $$@ from $$<
 	#######################################################################
-	$(OBJCOPY) -O binary $$< $$@
+	$(OBJCOPY) -O binary $$< $$@.tmp && \
+$$(call stack-check,$$@.tmp,$$<,$(if $(TSDK_LTO),$(OBJDIR)/bin/$(1).ci,$(foreach obj,$(2),$(OBJDIR)/obj/$(MKPATH)$(obj).ci)),$(OBJDIR)/bin/$(1).stack) && \
+mv $$@.tmp $$@
 
 # Assembly dump from ELF
 $(OBJDIR)/bin/$(1).s: $(OBJDIR)/bin/$(1).elf
@@ -158,31 +200,52 @@ endef
 make-bin = $(eval $(call _make-bin,$(1),$(2),$(3),$(4)))
 
 ##############################
-# Usage: $(call make-unit-test,name,source_file)
+# Usage: $(call make-unit-test,name,source_file,extra_source_files)
 
 define _make-unit-test
 
-DEPFILES+=$(OBJDIR)/obj/test_$(1).d
+DEPFILES+=$(foreach src,$(2) $(3),$(OBJDIR)/obj/$(basename $(src)).d)
 
 unit-test: $(OBJDIR)/unit-test/test_$(1)
 
-$(OBJDIR)/obj/test_$(1).o: $(2) $(OBJDIR)/info
+$(OBJDIR)/unit-test/test_$(1): $(foreach src,$(2) $(3),$(OBJDIR)/obj/$(basename $(src)).o) $(OBJDIR)/lib/libtn_sdk.a
 	#######################################################################
-	# Compiling unit test $$< to $$@
+	# Linking unit test $$@ from $$^
 	#######################################################################
 	$(MKDIR) $$(dir $$@) && \
-$(CXX) $(CPPFLAGS) $(CXXFLAGS) -c $$< -o $$@
+$(CXX) $(CXXFLAGS) $(LDFLAGS) -o $$@ $(foreach src,$(2) $(3),$(OBJDIR)/obj/$(basename $(src)).o) -L$(OBJDIR)/lib -ltn_sdk
 
-$(OBJDIR)/unit-test/test_$(1): $(OBJDIR)/obj/test_$(1).o $(OBJDIR)/lib/libtn_sdk.a
+endef
+
+make-unit-test = $(eval $(call _make-unit-test,$(1),$(2),$(3)))
+
+##############################
+# Usage: $(call make-bench,name,source_file)
+# Benchmarks run natively, so only MACHINE=host defines any
+
+define _make-bench
+
+DEPFILES+=$(OBJDIR)/obj/$(basename $(2)).d
+
+bench: run-bench-$(1)
+
+$(OBJDIR)/bench/bench_$(1): $(OBJDIR)/obj/$(basename $(2)).o $(OBJDIR)/lib/libtn_sdk.a
 	#######################################################################
-	# Linking unit test $$@ from $$^
+	# Linking benchmark $$@ from $$^
 	#######################################################################
 	$(MKDIR) $$(dir $$@) && \
 $(CXX) $(CXXFLAGS) $(LDFLAGS) -o $$@ $$< -L$(OBJDIR)/lib -ltn_sdk
 
+.PHONY: run-bench-$(1)
+run-bench-$(1): $(OBJDIR)/bench/bench_$(1)
+	#######################################################################
+	# Running benchmark $$<
+	#######################################################################
+	$$<
+
 endef
 
-make-unit-test = $(eval $(call _make-unit-test,$(1),$(2)))
+make-bench = $(eval $(call _make-bench,$(1),$(2)))
 
 ##############################
 ## GENERIC RULES
@@ -207,6 +270,15 @@ $(CXX) $(CPPFLAGS) $(CXXFLAGS) -M -MP $< -o $@.tmp && \
 $(SED) 's,\($(notdir $*)\)\.o[ :]*,$(OBJDIR)/obj/$*.o $(OBJDIR)/obj/$*.S $(OBJDIR)/obj/$*.i $@ : ,g' < $@.tmp > $@ && \
 $(RM) $@.tmp
 
+$(OBJDIR)/obj/%.d : %.c $(OBJDIR)/info
+	#######################################################################
+	# Generating dependencies for C source $< to $@
+	#######################################################################
+	$(MKDIR) $(dir $@) && \
+$(CC) $(CPPFLAGS) $(CFLAGS) -M -MP $< -o $@.tmp && \
+$(SED) 's,\($(notdir $*)\)\.o[ :]*,$(OBJDIR)/obj/$*.o $(OBJDIR)/obj/$*.S $(OBJDIR)/obj/$*.i $@ : ,g' < $@.tmp > $@ && \
+$(RM) $@.tmp
+
 $(OBJDIR)/obj/%.o : %.cpp $(OBJDIR)/info
 	#######################################################################
 	# Compiling C++ source $< to $@
@@ -214,6 +286,13 @@ $(OBJDIR)/obj/%.o : %.cpp $(OBJDIR)/info
 	$(MKDIR) $(dir $@) && \
 $(COMPILER_LAUNCHER) $(CXX) $(CPPFLAGS) $(CXXFLAGS) -c $< -o $@
 
+$(OBJDIR)/obj/%.o : %.c $(OBJDIR)/info
+	#######################################################################
+	# Compiling C source $< to $@
+	#######################################################################
+	$(MKDIR) $(dir $@) && \
+$(COMPILER_LAUNCHER) $(CC) $(CPPFLAGS) $(CFLAGS) -c $< -o $@
+
 $(OBJDIR)/obj/%.o : %.S $(OBJDIR)/info
 	#######################################################################
 	# Compiling asm source $< to $@
@@ -237,6 +316,22 @@ $(OBJDIR)/obj/%.i : %.cpp $(OBJDIR)/info
 	$(MKDIR) $(dir $@) && \
 $(CXX) $(CPPFLAGS) $(CXXFLAGS) -E $< -o $@
 
+$(OBJDIR)/obj/%.S : %.c $(OBJDIR)/info
+	#######################################################################
+	# Compiling C source $< to assembly $@
+	#######################################################################
+	$(MKDIR) $(dir $@) && \
+$(CC) $(patsubst -g,,$(CPPFLAGS) $(CFLAGS)) -S -fverbose-asm $< -o $@.tmp && \
+$(SED) 's,^#,                                                                                               #,g' < $@.tmp > $@ && \
+$(RM) $@.tmp
+
+$(OBJDIR)/obj/%.i : %.c $(OBJDIR)/info
+	#######################################################################
+	# Preprocessing C source $< to $@
+	#######################################################################
+	$(MKDIR) $(dir $@) && \
+$(CC) $(CPPFLAGS) $(CFLAGS) -E $< -o $@
+
 $(OBJDIR)/lib/%.a :
 	#######################################################################
 	# Creating library $@ from $^
@@ -244,7 +339,8 @@ $(OBJDIR)/lib/%.a :
 	$(MKDIR) $(dir $@) && \
 $(RM) $@ && \
 $(AR) $(ARFLAGS) $@ $^ && \
-$(RANLIB)  $@
+$(RANLIB)  $@$(if $(filter 1,$(TSDK_STACK_CHECK)), && \
+$(CAT) $(wildcard $(^:.o=.ci)) /dev/null > $(@:.a=.ci))
 
 $(OBJDIR)/include/% : %
 	#######################################################################
@@ -8,10 +8,51 @@ $(call make-lib,tn_sdk)
 
 # Add SDK objects to library
 $(call add-objs,tn_sdk,tn_sdk)
-$(call add-objs,tn_sdk_syscall,tn_sdk)
+$(call add-objs,tn_sdk_sha256,tn_sdk)
+$(call add-objs,tn_sdk_prof,tn_sdk)
+$(call add-objs,tn_sdk_mem,tn_sdk)
+
+# Keep GCC from turning the mem routines' loops back into calls to themselves
+$(OBJDIR)/obj/$(MKPATH)tn_sdk_mem.o $(OBJDIR)/obj/$(MKPATH)tn_sdk_mem.S: CXXFLAGS+=-fno-tree-loop-distribute-patterns
+
+# The C SDK's BLS routines, which tn_sdk_bls.hpp calls (SDK_EXTRAS=blst)
+ifdef TSDK_HAS_BLST
+$(call add-objs,tn_sdk_crypto,tn_sdk)
+ifdef THRU_HOST
+# tn_crypto.h takes its base types from the C SDK's VM headers
+$(OBJDIR)/obj/$(MKPATH)tn_sdk_crypto.o $(OBJDIR)/obj/$(MKPATH)tn_sdk_crypto.d: CPPFLAGS+=-DTHRU_VM=1
+endif
+endif
 
-# Add assembly files to library
+# Syscall stubs and entrypoint (host builds use cpp/host instead)
+ifndef THRU_HOST
+$(call add-objs,tn_sdk_syscall,tn_sdk)
 $(call add-asms,entrypoint,tn_sdk)
+endif
+
+# Unit tests run natively (make unit-test run-unit-test)
+ifdef THRU_HOST
+$(call make-unit-test,map,$(MKPATH)test_map.cpp)
+$(call make-unit-test,btree,$(MKPATH)test_btree.cpp)
+$(call make-unit-test,vec,$(MKPATH)test_vec.cpp)
+$(call make-unit-test,merkle,$(MKPATH)test_merkle.cpp)
+$(call make-unit-test,block,$(MKPATH)test_block.cpp)
+$(call make-unit-test,proof,$(MKPATH)test_proof.cpp)
+$(call make-unit-test,pda,$(MKPATH)test_pda.cpp)
+$(call make-unit-test,invoke,$(MKPATH)test_invoke.cpp)
+$(call make-unit-test,resumable,$(MKPATH)test_resumable.cpp)
+$(call make-unit-test,log,$(MKPATH)test_log.cpp)
+$(call make-unit-test,dispatch,$(MKPATH)test_dispatch.cpp)
+$(call make-unit-test,rle,$(MKPATH)test_rle.cpp,$(MKPATH)host/tn_rle.c)
+$(call make-unit-test,mem,$(MKPATH)test_mem.cpp)
+$(call make-unit-test,sha256,$(MKPATH)test_sha256.cpp)
+$(call make-unit-test,math,$(MKPATH)test_math.cpp)
+$(call make-unit-test,sdk,$(MKPATH)test_sdk.cpp)
+$(call make-unit-test,event,$(MKPATH)test_event.cpp)
+$(call make-unit-test,accounts,$(MKPATH)test_accounts.cpp)
+# tn_rle.h takes its base types from the C SDK's VM headers
+$(OBJDIR)/obj/$(MKPATH)host/tn_rle.o $(OBJDIR)/obj/$(MKPATH)host/tn_rle.d: CPPFLAGS+=-DTHRU_VM=1
+endif
 
 # Add headers
-$(call add-hdrs,tn_sdk.hpp tn_sdk_base.hpp tn_sdk_syscall.hpp) 
\ No newline at end of file
+$(call add-hdrs,tn_sdk.hpp tn_sdk_base.hpp tn_sdk_syscall.hpp tn_sdk_sha256.hpp tn_sdk_map.hpp tn_sdk_dispatch.hpp tn_sdk_log.hpp tn_sdk_event.hpp tn_sdk_prof.hpp tn_sdk_invoke.hpp tn_sdk_rle.hpp tn_sdk_bls.hpp tn_sdk_block.hpp tn_sdk_proof.hpp tn_sdk_vec.hpp tn_sdk_btree.hpp tn_sdk_merkle.hpp tn_sdk_pda.hpp tn_sdk_accounts.hpp tn_sdk_math.hpp tn_sdk_abi.hpp tn_sdk_resumable.hpp) 
\ No newline at end of file
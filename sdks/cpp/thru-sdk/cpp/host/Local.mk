@@ -0,0 +1,10 @@
+# Host emulation of the ThruNet VM (MACHINE=host only)
+
+ifdef THRU_HOST
+
+$(call add-objs,tn_sdk_host,tn_sdk)
+$(call add-hdrs,tn_sdk_host.hpp tn_sdk_bench.hpp tn_sdk_test.hpp)
+
+$(call make-bench,sdk,$(MKPATH)bench_sdk.cpp)
+
+endif
@@ -0,0 +1,657 @@
+/* SDK microbenchmarks for MACHINE=host builds: make MACHINE=host bench
+
+   The transaction shape is a router-style call: fee payer, program,
+   14 read-write and 16 read-only accounts, invoked three frames deep
+   with auth/deauth lists at each parent, which is the case where the
+   authorization walk is most expensive. */
+
+#include "tn_sdk_bench.hpp"
+#include "../tn_sdk_accounts.hpp"
+#include "../tn_sdk_block.hpp"
+#include "../tn_sdk_btree.hpp"
+#include "../tn_sdk_invoke.hpp"
+#include "../tn_sdk_map.hpp"
+#include "../tn_sdk_math.hpp"
+#include "../tn_sdk_merkle.hpp"
+#include "../tn_sdk_pda.hpp"
+#include "../tn_sdk_rle.hpp"
+#include "../tn_sdk_sha256.hpp"
+#include "../tn_sdk_vec.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr ushort RW_CNT = 14U;
+constexpr ushort RO_CNT = 16U;
+constexpr ushort ACCT_CNT = 2U + RW_CNT + RO_CNT;
+
+using AuthList = thru::InvokeAuth<4, 2>;
+
+/* Auth lists passed by frames 1 and 2 when they invoked */
+constexpr AuthList ROOT_AUTH{{2U, 3U, 4U, 5U}, {8U, 9U}};
+constexpr AuthList MID_AUTH{{10U, 11U, 12U, 15U}, {13U, 14U}};
+
+void setup_txn() {
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  pubkey_t* accs = thru::host::account_addrs();
+
+  /* Frame 1 runs account 1, frame 2 runs account 20, frame 3 runs 24 */
+  for (ushort i = 2U; i < ACCT_CNT; i++) {
+    ushort owner = i < 10U ? 1U : i < 16U ? 20U : 24U;
+    thru::host::set_account(i, accs[owner], 64UL);
+  }
+
+  thru::host::push_frame(20U, ROOT_AUTH.get());
+  thru::host::push_frame(24U, MID_AUTH.get());
+}
+
+void bench_auth() {
+  setup_txn();
+  pubkey_t const* accs = thru::host::account_addrs();
+
+  thru::bench::run("auth by_idx x32 (depth 3)", [] {
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += static_cast<ulong>(tsdk_is_account_authorized_by_idx(i));
+    }
+    thru::bench::keep(n);
+  });
+
+  thru::bench::run("auth AuthCache build+x32", [] {
+    thru::AuthCache cache;
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += cache.is_authorized(i);
+    }
+    thru::bench::keep(n);
+  });
+
+  thru::bench::run("auth by_pubkey x32", [accs] {
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += static_cast<ulong>(tsdk_is_account_authorized_by_pubkey(&accs[i]));
+    }
+    thru::bench::keep(n);
+  });
+
+  thru::bench::run("auth AuthCache+AccountIndex by pubkey x32", [accs] {
+    ushort slots[128];
+    thru::AuthCache cache;
+    thru::transaction::AccountIndex index(slots, 128UL);
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += cache.is_authorized(accs[i], index);
+    }
+    thru::bench::keep(n);
+  });
+}
+
+void bench_invoke() {
+  /* A router issuing 16 CPIs from the root frame with one auth list */
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  pubkey_t const* accs = thru::host::account_addrs();
+  for (ushort i = 2U; i < ACCT_CNT; i++) {
+    thru::host::set_account(i, accs[1], 64UL);
+  }
+  uchar const instr[16] = {};
+  std::span<const std::byte> data(reinterpret_cast<std::byte const*>(instr), sizeof(instr));
+
+  thru::bench::run("invoke x16 auth checked per call", [data] {
+    ulong err = 0UL;
+    for (ulong i = 0UL; i < 16UL; i++) {
+      thru::syscall::invoke(data, 20U, err, ROOT_AUTH.get());
+    }
+    thru::bench::keep(err);
+  });
+
+  thru::bench::run("invoke x16 auth validated once", [data] {
+    ulong err = 0UL;
+    thru::InvokeAuthToken auth = ROOT_AUTH.validate();
+    for (ulong i = 0UL; i < 16UL; i++) {
+      thru::syscall::invoke(data, 20U, err, auth);
+    }
+    thru::bench::keep(err);
+  });
+}
+
+void bench_sha256() {
+  alignas(8) uchar buf[1024];
+  for (ulong i = 0UL; i < sizeof(buf); i++) {
+    buf[i] = static_cast<uchar>(i * 131UL);
+  }
+
+  thru::bench::run("sha256 hash 32B", [&buf] {
+    pubkey_t h;
+    thru::crypto::Sha256::hash(buf, 32UL, &h);
+    thru::bench::keep(h);
+  });
+
+  thru::bench::run("sha256 hash 64B (merkle node)", [&buf] {
+    pubkey_t h;
+    thru::crypto::Sha256::hash(buf, 64UL, &h);
+    thru::bench::keep(h);
+  });
+
+  thru::bench::run("sha256 hash 1KiB", [&buf] {
+    pubkey_t h;
+    thru::crypto::Sha256::hash(buf, sizeof(buf), &h);
+    thru::bench::keep(h);
+  });
+
+  thru::bench::run("sha256 hash 8x64B one at a time", [&buf] {
+    pubkey_t h[8];
+    for (ulong i = 0UL; i < 8UL; i++) {
+      thru::crypto::Sha256::hash(buf + 64UL * i, 64UL, &h[i]);
+    }
+    thru::bench::keep(h);
+  });
+
+  thru::bench::run("sha256 hash_many 8x64B", [&buf] {
+    std::span<const std::byte> msgs[8];
+    for (ulong i = 0UL; i < 8UL; i++) {
+      msgs[i] = std::span<const std::byte>(reinterpret_cast<std::byte const*>(buf) + 64UL * i, 64UL);
+    }
+    pubkey_t h[8];
+    thru::crypto::Sha256::hash_many(msgs, 8UL, h);
+    thru::bench::keep(h);
+  });
+}
+
+void bench_rle() {
+  /* A 65535-member guardian set where 8/9 signed, in blocks of 700 */
+  constexpr ulong GUARDIAN_CNT = 65535UL;
+  ushort buf[2UL + 256UL] = {};
+  ulong run_cnt = 0UL;
+  for (ulong pos = 0UL; pos < GUARDIAN_CNT; run_cnt++) {
+    ulong len = run_cnt % 2UL ? 700UL : 2100UL;
+    len = len < GUARDIAN_CNT - pos ? len : GUARDIAN_CNT - pos;
+    buf[2UL + run_cnt] = static_cast<ushort>(len);
+    pos += len;
+  }
+  buf[0] = 1U;
+  buf[1] = static_cast<ushort>(run_cnt);
+  thru::rle::Rle rle = thru::rle::Rle::unchecked(buf);
+
+  thru::bench::run("rle per-bit walk (65535 guardians)", [rle] {
+    /* What a bit-at-a-time iterator costs: one step per position */
+    ulong sum = 0UL, pos = 0UL;
+    bool val = rle.first_bit();
+    for (ulong r = 0UL; r < rle.run_count(); r++, val = !val) {
+      for (ulong i = 0UL; i < rle.run(r); i++, pos++) {
+        sum += val ? pos : 0UL;
+      }
+    }
+    thru::bench::keep(sum);
+  });
+
+  thru::bench::run("rle SetBits (65535 guardians)", [rle] {
+    ulong sum = 0UL;
+    for (ulong idx : rle.set_bits(GUARDIAN_CNT)) {
+      sum += idx;
+    }
+    thru::bench::keep(sum);
+  });
+
+  thru::bench::run("rle SetRuns (65535 guardians)", [rle] {
+    ulong sum = 0UL;
+    for (thru::rle::Run run : rle.set_runs(GUARDIAN_CNT)) {
+      sum += run.len;
+    }
+    thru::bench::keep(sum);
+  });
+}
+
+pubkey_t key_of(ulong i) {
+  pubkey_t k;
+  for (ulong w = 0UL; w < 4UL; w++) {
+    k.ul[w] = (i + 1UL) * 0x9E3779B97F4A7C15UL ^ (w << 56);
+  }
+  return k;
+}
+
+void bench_map() {
+  /* A balances table at half load, stored in account data as a program
+     would keep it */
+  using Balances = thru::FlatMap<pubkey_t, ulong, 12>;
+  constexpr ulong KEY_CNT = Balances::slot_cnt() / 2UL;
+
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  thru::host::set_account(2U, thru::host::account_addrs()[1], Balances::footprint());
+  Balances map = Balances::join(Balances::format(thru::host::account_data(2U)));
+  for (ulong i = 0UL; i < KEY_CNT; i++) {
+    map.insert(key_of(i))->value = i;
+  }
+
+  ulong q = 0UL;
+  thru::bench::run("map query hit (pubkey, 50% load)", [&] {
+    thru::bench::keep(map.find(key_of(q++ % KEY_CNT)));
+  });
+
+  ulong m = 0UL;
+  thru::bench::run("map query miss (pubkey, 50% load)", [&] {
+    thru::bench::keep(map.find(key_of(KEY_CNT + m++ % KEY_CNT)));
+  });
+
+  ulong r = 0UL;
+  thru::bench::run("map insert+remove (pubkey, 50% load)", [&] {
+    pubkey_t k = key_of(KEY_CNT + r++ % KEY_CNT);
+    map.insert(k)->value = r;
+    map.remove(k);
+  });
+}
+
+void bench_block() {
+  /* A full history of 400ms blocks with a drifting price */
+  constexpr ulong CUR_SLOT = 100000UL;
+  for (ulong i = 0UL; i < thru::block::HISTORY_MAX; i++) {
+    tn_block_ctx* ctx = thru::host::block_ctx(i);
+    ctx->slot = CUR_SLOT - i;
+    ctx->block_time = (CUR_SLOT - i) * 400000000UL;
+    ctx->block_price = 1000UL + (i * 7919UL) % 577UL;
+  }
+  thru::block::History hist;
+  ulong q = 0UL;
+
+  thru::bench::run("block time->slot linear scan (4096 blocks)", [&] {
+    ulong t = (CUR_SLOT - 1UL - q++ % thru::block::HISTORY_MAX) * 400000000UL;
+    ulong i = 0UL;
+    while (i < hist.size() && hist[i].block_time > t) {
+      i++;
+    }
+    thru::bench::keep(i);
+  });
+
+  thru::bench::run("block History::lower_bound_by_time (4096)", [&] {
+    ulong t = (CUR_SLOT - 1UL - q++ % thru::block::HISTORY_MAX) * 400000000UL;
+    thru::bench::keep(hist.lower_bound_by_time(t));
+  });
+
+  thru::bench::run("block 64-block mean/min/max by rescan", [&] {
+    ulong sum = 0UL, lo = ~0UL, hi = 0UL;
+    for (tn_block_ctx const& ctx : thru::block::History(64UL)) {
+      sum += ctx.block_price;
+      lo = ctx.block_price < lo ? ctx.block_price : lo;
+      hi = ctx.block_price > hi ? ctx.block_price : hi;
+    }
+    thru::bench::keep(sum / 64UL + lo + hi);
+  });
+
+  /* The per-transaction case: the persisted window is one block behind */
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  using Window = thru::block::PriceWindow<64>;
+  thru::host::set_account(2U, thru::host::account_addrs()[1], sizeof(Window));
+  Window* window = reinterpret_cast<Window*>(thru::host::account_data(2U));
+  window->update();
+  tn_block_ctx* cur = thru::host::block_ctx(0UL);
+  thru::bench::run("block PriceWindow<64>::update (+1 block)", [&] {
+    cur->slot++;
+    window->update();
+    thru::bench::keep(window->mean() + window->min() + window->max());
+  });
+}
+
+struct Order {
+  ulong slot;
+  ulong price;
+  ulong qty;
+  ulong flags;
+};
+
+void bench_vec() {
+  /* An order history appended to 1024 times in one invocation */
+  constexpr ulong ORDER_CNT = 1024UL;
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  thru::host::set_account(2U, thru::host::account_addrs()[1], 0UL);
+  thru::WritableSet writable;
+  thru::Account acct(2U);
+
+  auto per_record = [&] {
+    tsys_account_resize(2U, sizeof(ulong));
+    ulong* len = acct.get_data_as<ulong>();
+    *len = 0UL;
+    for (ulong i = 0UL; i < ORDER_CNT; i++) {
+      Order o{i, 1000UL + i, 1UL, 0UL};
+      tsys_account_resize(2U, sizeof(ulong) + (*len + 1UL) * sizeof(Order));
+      std::memcpy(reinterpret_cast<uchar*>(len + 1) + *len * sizeof(Order), &o, sizeof(o));
+      (*len)++;
+    }
+    thru::bench::keep(*len);
+  };
+  auto account_vec = [&] {
+    auto vec = thru::AccountVec<Order>::format(acct, writable);
+    for (ulong i = 0UL; i < ORDER_CNT; i++) {
+      vec.push_back(Order{i, 1000UL + i, 1UL, 0UL});
+    }
+    thru::bench::keep(vec.size());
+  };
+
+  thru::bench::run("vec append x1024 resizing per record", per_record);
+  thru::bench::run("vec AccountVec::push_back x1024", account_vec);
+  /* Host resizes are nearly free; on the VM the syscall count dominates */
+  thru::host::reset_syscall_cnts();
+  per_record();
+  ulong naive = thru::host::syscall_cnt(TN_SYSCALL_CODE_ACCOUNT_RESIZE);
+  thru::host::reset_syscall_cnts();
+  account_vec();
+  ulong vec = thru::host::syscall_cnt(TN_SYSCALL_CODE_ACCOUNT_RESIZE);
+  std::printf("bench %-44s %10lu vs %lu\n", "vec resize syscalls per 1024 appends", naive, vec);
+}
+
+void bench_btree() {
+  /* An order book keyed by price: 32K resting orders, one insert and
+     one cancel per call at a key away from either end */
+  constexpr ulong KEY_CNT = 32768UL;
+  using Book = thru::BTree<ulong, Order>;
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  thru::host::set_account(2U, thru::host::account_addrs()[1], 0UL);
+  thru::host::set_account(3U, thru::host::account_addrs()[1], 0UL);
+  thru::WritableSet writable;
+
+  /* Sorted array in account 2: [cnt][keys...][orders...] */
+  tsys_account_resize(2U, sizeof(ulong) + (KEY_CNT + 1UL) * (sizeof(ulong) + sizeof(Order)));
+  ulong* cnt = thru::Account(2U).get_data_as<ulong>();
+  ulong* keys = cnt + 1;
+  Order* orders = reinterpret_cast<Order*>(keys + KEY_CNT + 1UL);
+  for (ulong i = 0UL; i < KEY_CNT; i++) {
+    keys[i] = i * 2UL;
+    orders[i] = Order{i, i * 2UL, 1UL, 0UL};
+  }
+  *cnt = KEY_CNT;
+
+  Book book = Book::format(thru::Account(3U), writable);
+  for (ulong i = 0UL; i < KEY_CNT; i++) {
+    book.insert(i * 2UL, Order{i, i * 2UL, 1UL, 0UL});
+  }
+
+  ulong price = KEY_CNT / 4UL * 2UL + 1UL;
+  thru::bench::run("btree sorted array insert+erase (32K keys)", [&] {
+    ulong pos = static_cast<ulong>(std::lower_bound(keys, keys + *cnt, price) - keys);
+    std::memmove(keys + pos + 1, keys + pos, (*cnt - pos) * sizeof(ulong));
+    std::memmove(orders + pos + 1, orders + pos, (*cnt - pos) * sizeof(Order));
+    keys[pos] = price;
+    orders[pos] = Order{0UL, price, 1UL, 0UL};
+    (*cnt)++;
+    std::memmove(keys + pos, keys + pos + 1, (*cnt - pos - 1UL) * sizeof(ulong));
+    std::memmove(orders + pos, orders + pos + 1, (*cnt - pos - 1UL) * sizeof(Order));
+    (*cnt)--;
+    thru::bench::keep(*cnt);
+  });
+  thru::bench::run("btree BTree insert+erase (32K keys)", [&] {
+    book.insert(price, Order{0UL, price, 1UL, 0UL});
+    book.erase(price);
+    thru::bench::keep(book.size());
+  });
+  thru::bench::run("btree BTree range 64 keys (32K keys)", [&] {
+    ulong sum = 0UL;
+    for (auto it = book.range(price, price + 128UL).begin(); it != std::default_sentinel; ++it) {
+      sum += it.value().qty;
+    }
+    thru::bench::keep(sum);
+  });
+  std::printf("bench %-44s %10lu pages, height %lu\n", "btree 32K keys footprint", book.page_cnt(),
+              book.height());
+}
+
+void bench_merkle() {
+  /* A bridge's deposit tree: 1024 deposits so far, depth 32 */
+  constexpr ulong LEAF_CNT = 1024UL;
+  using Deposits = thru::MerkleAccumulator<32>;
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  thru::host::set_account(2U, thru::host::account_addrs()[1], 0UL);
+  thru::WritableSet writable;
+  Deposits acc = Deposits::format(thru::Account(2U), writable);
+
+  static pubkey_t leaves[LEAF_CNT + 1UL];
+  for (ulong i = 0UL; i < LEAF_CNT; i++) {
+    leaves[i].ul[0] = i;
+    acc.append(leaves[i]);
+  }
+
+  uchar pair[64] = {};
+  thru::bench::run("merkle Sha256::hash 64B", [&] {
+    thru::crypto::Sha256::hash(pair, sizeof(pair), pair);
+    thru::bench::keep(pair[0]);
+  });
+  thru::bench::run("merkle Sha256::hash_pair", [&] {
+    thru::crypto::Sha256::hash_pair(pair, pair + 32, pair);
+    thru::bench::keep(pair[0]);
+  });
+
+  /* Rehashing every stored leaf to get the root after one more deposit */
+  thru::bench::run("merkle append+root by rebuild (1024 leaves)", [&] {
+    pubkey_t level[LEAF_CNT + 1UL];
+    ulong cnt = LEAF_CNT + 1UL;
+    std::memcpy(level, leaves, sizeof(level));
+    for (ulong h = 0UL; h < 32UL; h++) {
+      ulong next = (cnt + 1UL) / 2UL;
+      for (ulong i = 0UL; i < next; i++) {
+        pubkey_t const& r = 2UL * i + 1UL < cnt ? level[2UL * i + 1UL] : Deposits::ZEROS[h];
+        thru::crypto::Sha256::hash_pair(&level[2UL * i], &r, &level[i]);
+      }
+      cnt = next;
+    }
+    thru::bench::keep(level[0].ul[0]);
+  });
+  Deposits::Layout saved = *thru::Account(2U).get_data_as<Deposits::Layout>();
+  thru::bench::run("merkle MerkleAccumulator append+root", [&] {
+    *thru::Account(2U).get_data_as<Deposits::Layout>() = saved;
+    acc.append(leaves[LEAF_CNT]);
+    thru::bench::keep(acc.root().ul[0]);
+  });
+
+  pubkey_t proof[32] = {};
+  pubkey_t root = proof[0];
+  for (ulong h = 0UL; h < 32UL; h++) {
+    proof[h].ul[1] = h;
+  }
+  thru::bench::run("merkle verify proof (depth 32)", [&] {
+    thru::bench::keep(Deposits::verify(root, leaves[0], 5UL, Deposits::Proof(proof, 32UL)));
+  });
+}
+
+void bench_pda() {
+  pubkey_t owner = thru::host::account_addrs()[1];
+  uchar seed[TN_SEED_SIZE] = {};
+  auto seed_span = std::span<const uchar, TN_SEED_SIZE>(seed);
+
+  /* The C SDK's tsdk_create_program_defined_account_address */
+  thru::bench::run("pda Sha256 init/append x3/fini", [&] {
+    seed[0]++;
+    uchar ephemeral = 0U;
+    pubkey_t out;
+    thru::crypto::Sha256 h;
+    h.append(&owner, sizeof(owner)).append(&ephemeral, 1UL).append(seed, sizeof(seed)).fini(&out);
+    thru::bench::keep(out.ul[0]);
+  });
+  thru::bench::run("pda thru::pda(owner, seed)", [&] {
+    seed[0]++;
+    thru::bench::keep(thru::pda(owner, seed_span).ul[0]);
+  });
+  thru::PdaOwner vaults(owner);
+  thru::bench::run("pda PdaOwner::derive(seed)", [&] {
+    seed[0]++;
+    thru::bench::keep(vaults.derive(seed_span).ul[0]);
+  });
+}
+
+/* picolibc's generic memcmp, which is what -mstrict-align builds got */
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns"))) int
+byte_memcmp(void const* s1, void const* s2, ulong n) {
+  uchar const* a = static_cast<uchar const*>(s1);
+  uchar const* b = static_cast<uchar const*>(s2);
+  for (; n; n--, a++, b++) {
+    if (*a != *b) {
+      return *a - *b;
+    }
+  }
+  return 0;
+}
+
+void bench_mem() {
+  /* The ownership check: tn_account_meta::owner (2-aligned) against a
+     transaction account address (8-aligned) */
+  setup_txn();
+  pubkey_t const* addrs = thru::host::account_addrs();
+  tn_account_meta const* meta = tsdk_get_account_meta(12U);
+  pubkey_t const* prog = &addrs[20];
+  thru::bench::run("mem owner check byte-loop memcmp", [&] {
+    thru::bench::keep(byte_memcmp(&meta->owner, prog, sizeof(pubkey_t)) == 0);
+  });
+  thru::bench::run("mem owner check tsdk_memcmp", [&] {
+    thru::bench::keep(tsdk_memcmp(&meta->owner, prog, sizeof(pubkey_t)) == 0);
+  });
+  thru::bench::run("mem owner check pubkey_eq", [&] {
+    thru::bench::keep(thru::pubkey_eq(meta->owner, *prog));
+  });
+
+  static uchar src[4096 + 8];
+  static uchar dst[4096];
+  thru::bench::run("mem tsdk_memcpy 4KiB, src off by 3", [&] {
+    tsdk_memcpy(dst, src + 3, 4096UL);
+    thru::bench::keep(dst[17]);
+  });
+  thru::bench::run("mem tsdk_memcmp 4KiB equal, src off by 3", [&] {
+    thru::bench::keep(tsdk_memcmp(dst, src + 3, 4096UL));
+  });
+}
+
+void bench_accounts() {
+  /* A handler's prologue in the depth-3 frame (program 24): three
+     signers authorized by different parents, two writable accounts and
+     two state accounts it must own */
+  setup_txn();
+  using Spec = thru::Accounts<thru::Signer<2>, thru::Signer<10>, thru::Signer<11>,
+                              thru::Writable<2>, thru::Writable<10>, thru::Exists<16>,
+                              thru::OwnedBy<16, thru::Self>, thru::MinSize<16, 64UL>,
+                              thru::OwnedBy<17, thru::Self>, thru::MinSize<17, 64UL>>;
+  thru::bench::run("accounts 10 checks, one call each", [] {
+    const tn_txn* txn = thru::transaction::get();
+    bool ok = true;
+    for (ushort i : {ushort{2}, ushort{10}, ushort{11}}) {
+      ok &= thru::Account(i).is_authorized();
+    }
+    for (ushort i : {ushort{2}, ushort{10}}) {
+      ok &= tn_txn_is_account_idx_writable(txn, i);
+    }
+    ok &= thru::Account(16U).exists();
+    for (ushort i : {ushort{16}, ushort{17}}) {
+      ok &= thru::Account(i).is_owned_by_current_program();
+      ok &= thru::Account(i).get_meta()->data_sz >= 64U;
+    }
+    thru::bench::keep(ok);
+  });
+  thru::bench::run("accounts 10 checks, Accounts<>::check", [] {
+    Spec::check();
+    thru::bench::keep(thru::transaction::get());
+  });
+  thru::bench::run("accounts 10 checks + 32 auth, one call each", [] {
+    const tn_txn* txn = thru::transaction::get();
+    bool ok = true;
+    for (ushort i : {ushort{2}, ushort{10}, ushort{11}}) {
+      ok &= thru::Account(i).is_authorized();
+    }
+    for (ushort i : {ushort{2}, ushort{10}}) {
+      ok &= tn_txn_is_account_idx_writable(txn, i);
+    }
+    ok &= thru::Account(16U).exists();
+    for (ushort i : {ushort{16}, ushort{17}}) {
+      ok &= thru::Account(i).is_owned_by_current_program();
+      ok &= thru::Account(i).get_meta()->data_sz >= 64U;
+    }
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += static_cast<ulong>(tsdk_is_account_authorized_by_idx(i));
+    }
+    thru::bench::keep(ok);
+    thru::bench::keep(n);
+  });
+  thru::bench::run("accounts 10 checks + 32 auth, shared AuthCache", [] {
+    thru::AuthCache auth;
+    Spec::check(auth);
+    ulong n = 0UL;
+    for (ushort i = 0U; i < ACCT_CNT; i++) {
+      n += auth.is_authorized(i);
+    }
+    thru::bench::keep(n);
+  });
+}
+
+/* The libgcc baseline: a 128 by 128 bit __udivti3.  On x86-64 it ends
+   in a hardware 128/64 divq, which rv64 lacks, so the run-time divisor
+   case here flatters libgcc; the reciprocal cases are the comparison
+   that carries over. */
+__attribute__((noinline)) ulong libgcc_mul_div(ulong a, ulong b, ulong c) {
+  return static_cast<ulong>(static_cast<thru::math::uint128>(a) * b / c);
+}
+
+void bench_math() {
+  /* Operands whose products need all 128 bits, as in a swap quoting
+     reserves near the top of the range */
+  constexpr ulong N = 64UL;
+  static ulong a[N], b[N], c[N];
+  ulong x = 0x9E3779B97F4A7C15UL;
+  for (ulong i = 0UL; i < N; i++) {
+    x = x * 6364136223846793005UL + 1442695040888963407UL;
+    a[i] = x | (1UL << 63);
+    x = x * 6364136223846793005UL + 1442695040888963407UL;
+    b[i] = x >> 1;
+    c[i] = (a[i] >> 1) + 1UL; /* a * b / c < 2^64 */
+  }
+  thru::bench::run("math mul_div x64, libgcc __udivti3", [] {
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < N; i++) {
+      sum += libgcc_mul_div(a[i], b[i], c[i]);
+    }
+    thru::bench::keep(sum);
+  });
+  thru::bench::run("math mul_div x64, checked 128/64", [] {
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < N; i++) {
+      sum += thru::math::mul_div(a[i], b[i], c[i]);
+    }
+    thru::bench::keep(sum);
+  });
+  thru::bench::run("math mul_div x64, Divisor (one c)", [] {
+    thru::math::Divisor d(c[0]);
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < N; i++) {
+      sum += thru::math::mul_div(a[i] >> 1, b[i], d);
+    }
+    thru::bench::keep(sum);
+  });
+  thru::bench::run("math mul_div x64 by 1e9, libgcc __udivti3", [] {
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < N; i++) {
+      sum += libgcc_mul_div(a[i] >> 34, b[i], 1000000000UL);
+    }
+    thru::bench::keep(sum);
+  });
+  thru::bench::run("math mul_div<1e9> x64", [] {
+    ulong sum = 0UL;
+    for (ulong i = 0UL; i < N; i++) {
+      sum += thru::math::mul_div<1000000000UL>(a[i] >> 34, b[i]);
+    }
+    thru::bench::keep(sum);
+  });
+}
+
+} // namespace
+
+int main() {
+  bench_auth();
+  bench_invoke();
+  bench_sha256();
+  bench_map();
+  bench_rle();
+  bench_block();
+  bench_vec();
+  bench_btree();
+  bench_merkle();
+  bench_pda();
+  bench_mem();
+  bench_accounts();
+  bench_math();
+  return 0;
+}
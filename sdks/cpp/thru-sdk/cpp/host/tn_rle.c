@@ -0,0 +1,5 @@
+/* The C SDK's RLE routines, built natively for test_rle.  Included
+   rather than compiled in place so the object lands in this build's
+   OBJDIR. */
+
+#include "../../../../c/thru-sdk/c/tn_rle.c"
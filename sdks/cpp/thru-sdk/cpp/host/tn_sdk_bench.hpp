@@ -0,0 +1,63 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_bench_hpp
+#define HEADER_sdks_cpp_tn_sdk_bench_hpp
+
+#include "tn_sdk_host.hpp"
+#include "../tn_sdk_prof.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+/* Minimal microbenchmark loop for MACHINE=host builds (make bench).
+
+     thru::bench::run("sha256 64B", [&] {
+       thru::bench::keep(thru::crypto::Sha256::hash(buf, 64));
+     });
+
+   The body is repeated in doubling batches until a batch takes at
+   least TSDK_BENCH_MS milliseconds (default 50), then ns and TSC ticks
+   per iteration are printed.  Host timings only rank alternatives; CU
+   costs come from the VM. */
+
+namespace thru {
+namespace bench {
+
+/* Keeps value (and the work producing it) from being optimized out */
+template <typename T> inline void keep(T const& value) {
+  __asm__ volatile("" : : "r"(&value) : "memory");
+}
+
+inline ulong now_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<ulong>(ts.tv_sec) * 1000000000UL + static_cast<ulong>(ts.tv_nsec);
+}
+
+inline ulong min_ns() {
+  char const* ms = std::getenv("TSDK_BENCH_MS");
+  return (ms ? std::strtoul(ms, nullptr, 10) : 50UL) * 1000000UL;
+}
+
+template <typename F> void run(char const* name, F&& fn) {
+  ulong target = min_ns();
+  for (ulong iters = 1UL;; iters <<= 1) {
+    ulong t0 = now_ns();
+    ulong c0 = prof::read_cycle();
+    for (ulong i = 0UL; i < iters; i++) {
+      fn();
+    }
+    ulong c1 = prof::read_cycle();
+    ulong t1 = now_ns();
+    if (t1 - t0 >= target || iters >= (1UL << 40)) {
+      double n = static_cast<double>(iters);
+      std::printf("bench %-44s %10.1f ns/op %10.1f tsc/op\n", name,
+                  static_cast<double>(t1 - t0) / n, static_cast<double>(c1 - c0) / n);
+      return;
+    }
+  }
+}
+
+} // namespace bench
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_bench_hpp */
@@ -0,0 +1,393 @@
+#include "tn_sdk_host.hpp"
+
+#include <sys/mman.h>
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr ulong EVENT_SZ_MAX = TSDK_SEG_OFFSET_MAX;
+
+struct HostVm {
+  bool ro_mapped;
+  bool heap_mapped;
+  bool meta_mapped[TN_TXN_ACCT_MAX];
+  bool data_mapped[TN_TXN_ACCT_MAX];
+  ulong data_sz[TN_TXN_ACCT_MAX]; /* Bytes that may be dirty */
+  ulong syscall_cnt[TSDK_HOST_SYSCALL_CNT];
+  std::jmp_buf* exit_jmp;
+  thru::host::Exit exit;
+  thru::host::InvokeFn invoke;
+  bool log_quiet;
+};
+
+HostVm vm;
+std::vector<uchar> last_event_buf;
+std::vector<uchar> last_log_buf;
+
+void* map_fixed(ulong addr, ulong sz) {
+  void* p = mmap(reinterpret_cast<void*>(addr), sz, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE, -1, 0);
+  if (p == MAP_FAILED || p != reinterpret_cast<void*>(addr)) {
+    std::fprintf(stderr, "host: cannot map VM segment at 0x%lx\n", addr);
+    std::abort();
+  }
+  return p;
+}
+
+void map_ro_segments() {
+  if (vm.ro_mapped) {
+    return;
+  }
+  map_fixed(thru::mem::segment_address(TSDK_SEG_TYPE_READONLY_DATA, TSDK_SEG_IDX_TXN_DATA, 0UL),
+            TSDK_SEG_OFFSET_MAX);
+  map_fixed(thru::mem::segment_address(TSDK_SEG_TYPE_READONLY_DATA, TSDK_SEG_IDX_SHADOW_STACK, 0UL),
+            TSDK_SEG_OFFSET_MAX);
+  map_fixed(thru::mem::segment_address(TSDK_SEG_TYPE_READONLY_DATA, TSDK_SEG_IDX_BLOCK_CTX, 0UL),
+            TSDK_SEG_OFFSET_MAX);
+  vm.ro_mapped = true;
+}
+
+void map_heap() {
+  if (!vm.heap_mapped) {
+    map_fixed(thru::mem::segment_address(TSDK_SEG_TYPE_HEAP, TSDK_SEG_IDX_NULL, 0UL),
+              TSDK_SEG_OFFSET_MAX);
+    vm.heap_mapped = true;
+  }
+}
+
+tsdk_shadow_stack* ss() { return thru::host::shadow_stack(); }
+
+tn_txn* txn() { return const_cast<tn_txn*>(tsdk_get_txn()); }
+
+bool account_valid(ulong idx) { return idx < tn_txn_account_cnt(txn()); }
+
+/* splitmix64, so account pubkeys are stable across runs */
+ulong mix(ulong x) {
+  x += 0x9E3779B97F4A7C15UL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+  return x ^ (x >> 31);
+}
+
+void count(ulong code) { vm.syscall_cnt[code]++; }
+
+} // namespace
+
+namespace thru {
+namespace host {
+
+tn_txn* init_txn(ushort rw_cnt, ushort ro_cnt, void const* instr_data, ushort instr_data_sz) {
+  ulong acct_cnt = 2UL + rw_cnt + ro_cnt;
+  if (acct_cnt > TN_TXN_ACCT_MAX) {
+    std::fprintf(stderr, "host: %lu accounts exceeds TN_TXN_ACCT_MAX\n", acct_cnt);
+    std::abort();
+  }
+  map_ro_segments();
+  map_heap();
+
+  tn_txn* t = txn();
+  std::memset(t, 0, sizeof(tn_txn_hdr_v1));
+  t->hdr.v1.transaction_version = TN_TXN_V1;
+  t->hdr.v1.readwrite_accounts_cnt = rw_cnt;
+  t->hdr.v1.readonly_accounts_cnt = ro_cnt;
+  t->hdr.v1.instr_data_sz = instr_data_sz;
+  t->hdr.v1.chain_id = 1U;
+
+  pubkey_t* accs = account_addrs();
+  for (ulong i = 0UL; i < acct_cnt; i++) {
+    for (ulong w = 0UL; w < 4UL; w++) {
+      accs[i].ul[w] = mix(i * 4UL + w);
+    }
+  }
+  if (instr_data_sz) {
+    std::memcpy(const_cast<uchar*>(tn_txn_get_instr_data(t)), instr_data, instr_data_sz);
+  }
+
+  for (ulong i = 0UL; i < acct_cnt; i++) {
+    if (!vm.meta_mapped[i]) {
+      map_fixed(mem::segment_address(TSDK_SEG_TYPE_ACCOUNT_METADATA, i, 0UL), TSDK_PAGE_SZ);
+      vm.meta_mapped[i] = true;
+    }
+    if (!vm.data_mapped[i]) {
+      map_fixed(mem::segment_address(TSDK_SEG_TYPE_ACCOUNT_DATA, i, 0UL), TSDK_SEG_OFFSET_MAX);
+      vm.data_mapped[i] = true;
+    }
+    std::memset(account_meta(static_cast<ushort>(i)), 0, sizeof(tn_account_meta));
+    account_meta(static_cast<ushort>(i))->version = 1U;
+  }
+
+  tsdk_shadow_stack* s = ss();
+  std::memset(s, 0, sizeof(tsdk_shadow_stack));
+  s->call_depth = 1U;
+  s->max_call_depth = TSDK_SHADOW_STACK_FRAME_MAX - 1U;
+  s->stack_frames[1].program_acc_idx = 1U;
+  return t;
+}
+
+pubkey_t* account_addrs() { return const_cast<pubkey_t*>(tn_txn_get_acct_addrs(txn())); }
+
+tn_account_meta* account_meta(ushort idx) {
+  return const_cast<tn_account_meta*>(tsdk_get_account_meta(idx));
+}
+
+uchar* account_data(ushort idx) { return static_cast<uchar*>(tsdk_get_account_data_ptr(idx)); }
+
+void set_account(ushort idx, pubkey_t const& owner, ulong data_sz) {
+  if (!account_valid(idx) || data_sz > TN_ACCOUNT_DATA_SZ_MAX) {
+    std::fprintf(stderr, "host: bad account %u (data_sz %lu)\n", idx, data_sz);
+    std::abort();
+  }
+  tn_account_meta* meta = account_meta(idx);
+  meta->owner = owner;
+  meta->data_sz = static_cast<uint>(data_sz);
+  ulong dirty = vm.data_sz[idx] > data_sz ? vm.data_sz[idx] : data_sz;
+  std::memset(account_data(idx), 0, dirty);
+  vm.data_sz[idx] = data_sz;
+}
+
+tsdk_shadow_stack* shadow_stack() {
+  return const_cast<tsdk_shadow_stack*>(tsdk_get_shadow_stack());
+}
+
+tn_block_ctx* block_ctx(ulong blocks_in_past) {
+  map_ro_segments();
+  return const_cast<tn_block_ctx*>(tsdk_get_past_block_ctx(blocks_in_past));
+}
+
+void push_frame(ushort program_acc_idx, tsdk_invoke_auth_t const* auth) {
+  tsdk_shadow_stack* s = ss();
+  if (s->call_depth + 1 >= TSDK_SHADOW_STACK_FRAME_MAX) {
+    std::fprintf(stderr, "host: shadow stack overflow\n");
+    std::abort();
+  }
+  tsdk_shadow_stack_frame* parent = &s->stack_frames[s->call_depth];
+  parent->saved_regs[13] = reinterpret_cast<ulong>(auth); /* a3 register */
+  s->call_depth++;
+  tsdk_shadow_stack_frame* frame = &s->stack_frames[s->call_depth];
+  std::memset(frame, 0, sizeof(tsdk_shadow_stack_frame));
+  frame->program_acc_idx = program_acc_idx;
+  frame->stack_pages = parent->stack_pages;
+  frame->heap_pages = parent->heap_pages;
+}
+
+void pop_frame() {
+  tsdk_shadow_stack* s = ss();
+  if (s->call_depth <= 1U) {
+    std::fprintf(stderr, "host: shadow stack underflow\n");
+    std::abort();
+  }
+  s->call_depth--;
+  s->stack_frames[s->call_depth].saved_regs[13] = 0UL;
+  s->current_total_heap_pages = s->stack_frames[s->call_depth].heap_pages;
+}
+
+void set_invoke_handler(InvokeFn fn) { vm.invoke = fn; }
+
+Exit run(void (*fn)(void*), void* ctx) {
+  std::jmp_buf jmp;
+  std::jmp_buf* outer = vm.exit_jmp;
+  vm.exit_jmp = &jmp;
+  if (!setjmp(jmp)) {
+    fn(ctx);
+    vm.exit_jmp = outer;
+    return Exit{0UL, false, false};
+  }
+  vm.exit_jmp = outer;
+  return vm.exit;
+}
+
+ulong syscall_cnt(ulong code) { return code < TSDK_HOST_SYSCALL_CNT ? vm.syscall_cnt[code] : 0UL; }
+
+void reset_syscall_cnts() { std::memset(vm.syscall_cnt, 0, sizeof(vm.syscall_cnt)); }
+
+std::span<const uchar> last_event() { return {last_event_buf.data(), last_event_buf.size()}; }
+
+std::span<const uchar> last_log() { return {last_log_buf.data(), last_log_buf.size()}; }
+
+void set_log_quiet(bool quiet) { vm.log_quiet = quiet; }
+
+} // namespace host
+} // namespace thru
+
+extern "C" {
+
+/* Host runs do not go through _start, so nothing is mapped up front */
+tsdk_program_resources_t const tsdk_program_resources = { 1U, 0U };
+
+ulong tsys_set_account_data_writable( ulong account_idx ) {
+  count( TN_SYSCALL_CODE_SET_ACCOUNT_DATA_WRITABLE );
+  if( !account_valid( account_idx ) ||
+      !tn_txn_is_account_idx_writable( txn( ), static_cast<ushort>( account_idx ) ) ) {
+    return TSDK_HOST_ERR_UNSUPPORTED;
+  }
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_account_transfer( ulong from_account_idx, ulong to_account_idx,
+                             ulong amount ) {
+  count( TN_SYSCALL_CODE_ACCOUNT_TRANSFER );
+  if( !account_valid( from_account_idx ) || !account_valid( to_account_idx ) ) {
+    return TSDK_HOST_ERR_UNSUPPORTED;
+  }
+  tn_account_meta * from = thru::host::account_meta( static_cast<ushort>( from_account_idx ) );
+  tn_account_meta * to   = thru::host::account_meta( static_cast<ushort>( to_account_idx ) );
+  if( from->balance < amount ) return TSDK_HOST_ERR_INSUFFICIENT_BALANCE;
+  from->balance -= amount;
+  to->balance   += amount;
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_set_anonymous_segment_sz( void * addr ) {
+  (void)addr;
+  count( TN_SYSCALL_CODE_SET_ANONYMOUS_SEGMENT_SZ );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_increment_anonymous_segment_sz( void * segment_addr, ulong delta,
+                                           void ** addr ) {
+  count( TN_SYSCALL_CODE_INCREMENT_ANONYMOUS_SEGMENT_SZ );
+  ulong seg = reinterpret_cast<ulong>( segment_addr );
+  if( ( seg >> 40 ) != TSDK_SEG_TYPE_HEAP ) return TSDK_HOST_ERR_UNSUPPORTED;
+
+  /* The current frame owns the heap above its parent's total */
+  tsdk_shadow_stack *       s     = ss( );
+  tsdk_shadow_stack_frame * frame = &s->stack_frames[ s->call_depth ];
+  ulong pages = thru::mem::align_up( delta, TSDK_PAGE_SZ ) / TSDK_PAGE_SZ;
+  ulong end   = ( frame->heap_pages + pages ) * TSDK_PAGE_SZ;
+  if( end > TSDK_SEG_OFFSET_MAX ) return TSDK_HOST_ERR_UNSUPPORTED;
+
+  if( addr ) {
+    *addr = reinterpret_cast<void *>( thru::mem::segment_address(
+        TSDK_SEG_TYPE_HEAP, TSDK_SEG_IDX_NULL, frame->heap_pages * TSDK_PAGE_SZ ) );
+  }
+  frame->heap_pages            = static_cast<ushort>( frame->heap_pages + pages );
+  s->current_total_heap_pages = frame->heap_pages;
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_account_create( ulong account_idx, const unsigned char seed[TN_SEED_SIZE],
+                           const void * proof, ulong proof_sz ) {
+  (void)account_idx; (void)seed; (void)proof; (void)proof_sz;
+  count( TN_SYSCALL_CODE_ACCOUNT_CREATE );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_account_create_ephemeral( ulong account_idx, const unsigned char seed[TN_SEED_SIZE] ) {
+  (void)account_idx; (void)seed;
+  count( TN_SYSCALL_CODE_ACCOUNT_CREATE_EPHEMERAL );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_account_delete( ulong account_idx, const signature_t * signature ) {
+  (void)account_idx; (void)signature;
+  count( TN_SYSCALL_CODE_ACCOUNT_DELETE );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_account_resize( ulong account_idx, ulong new_size ) {
+  count( TN_SYSCALL_CODE_ACCOUNT_RESIZE );
+  if( !account_valid( account_idx ) || new_size > TN_ACCOUNT_DATA_SZ_MAX ) {
+    return TSDK_HOST_ERR_UNSUPPORTED;
+  }
+  ushort            idx  = static_cast<ushort>( account_idx );
+  tn_account_meta * meta = thru::host::account_meta( idx );
+  if( new_size > meta->data_sz ) {
+    std::memset( thru::host::account_data( idx ) + meta->data_sz, 0, new_size - meta->data_sz );
+  }
+  meta->data_sz = static_cast<uint>( new_size );
+  if( new_size > vm.data_sz[ idx ] ) vm.data_sz[ idx ] = new_size;
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_account_compress( ulong account_idx, const void * proof, ulong proof_sz ) {
+  (void)account_idx; (void)proof; (void)proof_sz;
+  count( TN_SYSCALL_CODE_ACCOUNT_COMPRESS );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_account_decompress( ulong account_idx, const void * meta, const void * data,
+                               const void * proof, ulong proof_sz ) {
+  (void)account_idx; (void)meta; (void)data; (void)proof; (void)proof_sz;
+  count( TN_SYSCALL_CODE_ACCOUNT_DECOMPRESS );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+ulong tsys_invoke( const void * instr_data, ulong instr_data_sz,
+                   ushort program_account_idx,
+                   tsdk_invoke_auth_t const * auth,
+                   ulong * invoke_err_code ) {
+  if( auth != nullptr ) tsdk_invoke_auth_validate( auth );
+  return tsys_invoke_unchecked( instr_data, instr_data_sz, program_account_idx, auth,
+                                invoke_err_code );
+}
+
+ulong tsys_invoke_unchecked( const void * instr_data, ulong instr_data_sz,
+                             ushort program_account_idx,
+                             tsdk_invoke_auth_t const * auth,
+                             ulong * invoke_err_code ) {
+  count( TN_SYSCALL_CODE_INVOKE );
+  if( vm.invoke ) {
+    return vm.invoke( instr_data, instr_data_sz, program_account_idx, auth, invoke_err_code );
+  }
+  if( invoke_err_code ) *invoke_err_code = 0UL;
+  return TSDK_SUCCESS;
+}
+
+[[noreturn]] ulong tsys_exit( ulong exit_code, ulong revert ) {
+  count( TN_SYSCALL_CODE_EXIT );
+  if( vm.exit_jmp ) {
+    vm.exit = thru::host::Exit{ exit_code, revert != 0UL, true };
+    std::longjmp( *vm.exit_jmp, 1 );
+  }
+  std::fprintf( stderr, "host: %s 0x%lx outside run()\n", revert ? "revert" : "exit", exit_code );
+  std::exit( revert ? 1 : 0 );
+}
+
+ulong tsys_log( const void * data, ulong data_len ) {
+  count( TN_SYSCALL_CODE_LOG );
+  uchar const * p = static_cast<uchar const *>( data );
+  last_log_buf.assign( p, p + data_len );
+  if( vm.log_quiet ) return TSDK_SUCCESS;
+
+  /* Binary thru::log records start with a zero byte; decode them with
+     thru debug decode-log */
+  if( data_len && !p[ 0 ] ) {
+    std::fputs( "log: ", stderr );
+    for( ulong i = 0UL; i < data_len; i++ ) std::fprintf( stderr, "%02x", p[ i ] );
+    std::fputc( '\n', stderr );
+  } else {
+    std::fprintf( stderr, "log: %.*s\n", static_cast<int>( data_len ), static_cast<char const *>( data ) );
+  }
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_emit_event( const void * data, ulong data_sz ) {
+  count( TN_SYSCALL_CODE_EMIT_EVENT );
+  if( data_sz > EVENT_SZ_MAX ) return TSDK_HOST_ERR_UNSUPPORTED;
+  uchar const * p = static_cast<uchar const *>( data );
+  last_event_buf.assign( p, p + data_sz );
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_account_set_flags( ushort account_idx, uchar flags ) {
+  count( TN_SYSCALL_CODE_ACCOUNT_SET_FLAGS );
+  if( !account_valid( account_idx ) ) return TSDK_HOST_ERR_UNSUPPORTED;
+  thru::host::account_meta( account_idx )->flags = flags;
+  return TSDK_SUCCESS;
+}
+
+ulong tsys_account_create_eoa( ulong               account_idx,
+                               const signature_t * signature,
+                               const void *        proof,
+                               ulong               proof_sz ) {
+  (void)account_idx; (void)signature; (void)proof; (void)proof_sz;
+  count( TN_SYSCALL_CODE_ACCOUNT_CREATE_EOA );
+  return TSDK_HOST_ERR_UNSUPPORTED;
+}
+
+}
@@ -0,0 +1,103 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_host_hpp
+#define HEADER_sdks_cpp_tn_sdk_host_hpp
+
+#include "../tn_sdk.hpp"
+#include "../tn_sdk_syscall.hpp"
+
+#include <span>
+
+/* Host emulation of the ThruNet VM for MACHINE=host builds
+   (config/machine/host.mk), used by benchmarks and tests.
+
+   The VM segments are mapped at the same virtual addresses the program
+   would see on chain (segment type << 40 | index << 24), so
+   tsdk_get_txn, tsdk_get_account_meta, tsdk_get_shadow_stack,
+   tsdk_get_heap_base and everything built on them run unmodified
+   against mock buffers.  The tsys_* syscalls are implemented here in
+   place of the ecall stubs in tn_sdk_syscall.cpp:
+
+     thru::host::init_txn(14, 16);     // fee payer, program, 14 rw, 16 ro
+     thru::host::set_account(5, thru::host::account_addrs()[1], 256);
+     thru::host::Exit ex = thru::host::run([] { handler(...); });
+
+   Segments are reserved lazily with MAP_NORESERVE, so untouched
+   account data costs no memory.  Nothing here is thread safe; the VM
+   runs one frame at a time and so does the emulation. */
+
+/* Returned by syscalls the emulation does not model */
+constexpr ulong TSDK_HOST_ERR_UNSUPPORTED = 0xBAD0B700UL;
+
+/* TN_VM_ERR_SYSCALL_INSUFFICIENT_BALANCE */
+constexpr ulong TSDK_HOST_ERR_INSUFFICIENT_BALANCE = 0xFFFFFFFFFFFFFFDCUL;
+
+constexpr ulong TSDK_HOST_SYSCALL_CNT = TN_SYSCALL_CODE_ACCOUNT_CREATE_EOA + 1UL;
+
+namespace thru {
+namespace host {
+
+/* How a run() ended: through tsys_exit, or by returning normally */
+struct Exit {
+  ulong code;
+  bool reverted;
+  bool exited;
+};
+
+/* Called for tsys_invoke; the default handler succeeds without doing
+   anything.  Frames are not pushed automatically, see push_frame. */
+using InvokeFn = ulong (*)(void const* instr_data, ulong instr_data_sz,
+                           ushort program_acc_idx, tsdk_invoke_auth_t const* auth,
+                           ulong* invoke_err_code);
+
+/* Lays out a transaction with the fee payer (index 0), the program
+   (index 1) and rw_cnt read-write then ro_cnt read-only accounts.
+   Pubkeys are distinct and deterministic.  All accounts start empty and
+   owned by the system (zero) key, and the shadow stack is reset to a
+   single frame running account 1 with no heap. */
+tn_txn* init_txn(ushort rw_cnt, ushort ro_cnt, void const* instr_data = nullptr,
+                 ushort instr_data_sz = 0U);
+
+pubkey_t* account_addrs();
+tn_account_meta* account_meta(ushort idx);
+uchar* account_data(ushort idx);
+
+/* Sets an account's owner and data size; the data is zero filled. */
+void set_account(ushort idx, pubkey_t const& owner, ulong data_sz);
+
+tsdk_shadow_stack* shadow_stack();
+tn_block_ctx* block_ctx(ulong blocks_in_past);
+
+/* Records auth as the current frame's invoke argument (register a3)
+   and enters a frame running program_acc_idx, as tsys_invoke does on
+   chain.  The new frame's heap starts above its parent's. */
+void push_frame(ushort program_acc_idx, tsdk_invoke_auth_t const* auth = nullptr);
+void pop_frame();
+
+void set_invoke_handler(InvokeFn fn);
+
+/* Calls fn(ctx), catching tsys_exit (and so tsdk_return/tsdk_revert).
+   The stack is unwound with longjmp, so destructors of frames between
+   here and the exit do not run. */
+Exit run(void (*fn)(void*), void* ctx);
+
+template <typename F> Exit run(F&& fn) {
+  return run([](void* ctx) { (*static_cast<F*>(ctx))(); },
+             const_cast<void*>(static_cast<void const*>(&fn)));
+}
+
+/* Syscalls issued since the last reset, by TN_SYSCALL_CODE_* */
+ulong syscall_cnt(ulong code);
+void reset_syscall_cnts();
+
+/* Payload of the most recent tsys_emit_event */
+std::span<const uchar> last_event();
+
+/* Payload of the most recent tsys_log, quiet or not */
+std::span<const uchar> last_log();
+
+/* tsys_log output goes to stderr unless quiet */
+void set_log_quiet(bool quiet);
+
+} // namespace host
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_host_hpp */
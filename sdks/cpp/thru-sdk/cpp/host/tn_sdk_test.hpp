@@ -0,0 +1,55 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_test_hpp
+#define HEADER_sdks_cpp_tn_sdk_test_hpp
+
+#include "tn_sdk_host.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+/* Assertions for MACHINE=host unit tests (make unit-test, then make
+   run-unit-test).  A test is a program next to the code it covers
+   (cpp/test_<module>.cpp) that returns 0 from main when every check
+   holds:
+
+     TSDK_TEST(map.key_cnt() == 1UL);
+
+   A failing check prints its location and aborts.  thru::test::Rng
+   drives randomized tests; each test uses a fixed seed, so failures
+   reproduce. */
+
+#define TSDK_TEST(c)                                                                          \
+  do {                                                                                        \
+    if (TSDK_UNLIKELY(!(c))) {                                                                \
+      std::fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #c);                       \
+      std::abort();                                                                           \
+    }                                                                                         \
+  } while (0)
+
+namespace thru {
+namespace test {
+
+/* splitmix64 */
+class Rng {
+public:
+  explicit Rng(ulong seed) : s_(seed) {}
+
+  ulong next() {
+    ulong z = (s_ += 0x9E3779B97F4A7C15UL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+  }
+
+  /* Uniform enough in [0, n) for tests; n must be non-zero */
+  ulong below(ulong n) { return next() % n; }
+
+private:
+  ulong s_;
+};
+
+inline void pass(char const* name) { std::printf("pass %s\n", name); }
+
+} // namespace test
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_test_hpp */
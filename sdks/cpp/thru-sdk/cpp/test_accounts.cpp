@@ -0,0 +1,187 @@
+#include "tn_sdk_accounts.hpp"
+#include "tn_sdk_invoke.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <vector>
+
+/* Accounts<...>::check against the constraints checked one by one,
+   with plain metadata reads and tsdk_is_account_authorized_by_idx, in
+   the documented order of kinds, on random transactions, account
+   states and call chains.  Every constraint set is checked with and
+   without an AuthCache among the context arguments. */
+
+namespace {
+
+struct Fixed {
+  static constexpr pubkey_t KEY = {{0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+                                    0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff, 0x00,
+                                    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                                    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10}};
+};
+
+using thru::detail::AccountCheck;
+
+/* One constraint, read back from its type */
+struct Spec {
+  AccountCheck check;
+  ushort idx;
+  ulong size;
+  pubkey_t const* owner; /* nullptr: Self */
+};
+
+template <typename C> Spec spec() {
+  Spec s{C::CHECK, C::INDEX, 0UL, nullptr};
+  if constexpr (C::CHECK == AccountCheck::MIN_SIZE) {
+    s.size = C::SIZE;
+  } else if constexpr (C::CHECK == AccountCheck::OWNED_BY) {
+    if constexpr (!std::is_same_v<typename C::Owner, thru::Self>) {
+      s.owner = &C::Owner::KEY;
+    }
+  }
+  return s;
+}
+
+template <typename... Cs> std::vector<Spec> specs(thru::Accounts<Cs...> const*) {
+  return {spec<Cs>()...};
+}
+
+/* The code check() should revert with, or 0 */
+ulong expected(std::vector<Spec> const& cs, ushort rw_cnt) {
+  ushort acct_cnt = tn_txn_account_cnt(tsdk_get_txn());
+  for (Spec const& c : cs) {
+    if (c.idx >= acct_cnt) {
+      return TSDK_ACCOUNTS_ERR_INVALID_INDEX;
+    }
+  }
+  for (Spec const& c : cs) {
+    if (c.check == AccountCheck::WRITABLE && c.idx != 0U && c.idx >= 2U + rw_cnt) {
+      return TSDK_ACCOUNTS_ERR_NOT_WRITABLE;
+    }
+  }
+  tsdk_shadow_stack const* ss = thru::host::shadow_stack();
+  pubkey_t const& self =
+      thru::host::account_addrs()[ss->stack_frames[ss->call_depth].program_acc_idx];
+  AccountCheck const order[] = {AccountCheck::EXISTS, AccountCheck::OWNED_BY, AccountCheck::MIN_SIZE};
+  ulong const codes[] = {TSDK_ACCOUNTS_ERR_NOT_FOUND, TSDK_ACCOUNTS_ERR_WRONG_OWNER,
+                         TSDK_ACCOUNTS_ERR_TOO_SMALL};
+  for (ulong k = 0UL; k < 3UL; k++) {
+    for (Spec const& c : cs) {
+      if (c.check != order[k]) {
+        continue;
+      }
+      tn_account_meta const* meta = thru::host::account_meta(c.idx);
+      bool ok = c.check == AccountCheck::EXISTS     ? meta->version == TN_ACCOUNT_V1
+                : c.check == AccountCheck::OWNED_BY ? meta->owner.key == (c.owner ? *c.owner : self).key
+                                                    : meta->data_sz >= c.size;
+      if (!ok) {
+        return codes[k];
+      }
+    }
+  }
+  for (Spec const& c : cs) {
+    if (c.check != AccountCheck::SIGNER) {
+      continue;
+    }
+    int authorized = 0;
+    thru::host::Exit ex =
+        thru::host::run([&] { authorized = tsdk_is_account_authorized_by_idx(c.idx); });
+    if (ex.exited) {
+      return ex.code;
+    }
+    if (!authorized) {
+      return TSDK_ACCOUNTS_ERR_NOT_SIGNER;
+    }
+  }
+  return 0UL;
+}
+
+using Deposit = thru::Accounts<thru::Signer<2>, thru::Writable<3>, thru::OwnedBy<3, thru::Self>,
+                               thru::MinSize<3, 16UL>>;
+using Mixed = thru::Accounts<thru::MinSize<5, 100UL>, thru::Exists<4>, thru::Signer<0>,
+                             thru::OwnedBy<4, Fixed>, thru::Signer<5>, thru::Writable<2>,
+                             thru::Signer<4>>;
+using Wide = thru::Accounts<thru::Writable<6>, thru::Exists<2>, thru::Signer<3>, thru::OwnedBy<2>,
+                            thru::Writable<0>, thru::MinSize<6, 1UL>>;
+using Far = thru::Accounts<thru::MinSize<9, 1UL>, thru::Exists<1>>;
+using None = thru::Accounts<>;
+
+static_assert(Deposit::CONSTRAINT_CNT == 4UL && None::CONSTRAINT_CNT == 0UL);
+
+/* check() as the Dispatcher calls it: alone, with an AuthCache, or with
+   the cache among other context */
+template <typename A> void check_all(std::vector<Spec> const& cs, ushort rw_cnt, ulong round) {
+  ulong want = expected(cs, rw_cnt);
+  thru::host::Exit ex = thru::host::run([] { A::check(); });
+  TSDK_TEST(ex.exited == (want != 0UL) && (!ex.exited || (ex.reverted && ex.code == want)));
+  ex = thru::host::run([] {
+    thru::AuthCache auth;
+    A::check(auth);
+  });
+  TSDK_TEST(ex.exited == (want != 0UL) && (!ex.exited || ex.code == want));
+  ex = thru::host::run([&] {
+    thru::AuthCache auth;
+    A::check(round, auth);
+  });
+  TSDK_TEST(ex.exited == (want != 0UL) && (!ex.exited || ex.code == want));
+}
+
+void test_check() {
+  thru::test::Rng rng(25UL);
+  std::vector<Spec> const deposit = specs(static_cast<Deposit const*>(nullptr));
+  std::vector<Spec> const mixed = specs(static_cast<Mixed const*>(nullptr));
+  std::vector<Spec> const wide = specs(static_cast<Wide const*>(nullptr));
+  std::vector<Spec> const far = specs(static_cast<Far const*>(nullptr));
+  ulong outcomes[8] = {};
+
+  for (ulong iter = 0UL; iter < 4000UL; iter++) {
+    ushort rw = static_cast<ushort>(rng.below(7UL));
+    ushort ro = static_cast<ushort>(rng.below(5UL));
+    thru::host::init_txn(rw, ro);
+    ushort acct_cnt = static_cast<ushort>(2U + rw + ro);
+    pubkey_t* accs = thru::host::account_addrs();
+
+    /* A short call chain, passing authority now and then */
+    thru::InvokeAuth<3> auths[2];
+    for (ulong d = rng.below(3UL); d > 0UL; d--) {
+      for (ulong i = rng.below(4UL); i > 0UL; i--) {
+        auths[d - 1UL].authorize(static_cast<ushort>(rng.below(acct_cnt)));
+      }
+      thru::host::push_frame(static_cast<ushort>(rng.below(acct_cnt)),
+                             rng.below(2UL) ? auths[d - 1UL].get() : nullptr);
+    }
+
+    /* Account states that pass most constraints most of the time */
+    tsdk_shadow_stack const* ss = thru::host::shadow_stack();
+    pubkey_t self = accs[ss->stack_frames[ss->call_depth].program_acc_idx];
+    for (ushort idx = 2U; idx < acct_cnt; idx++) {
+      ulong pick = rng.below(8UL);
+      pubkey_t owner = pick < 4UL ? self : pick < 6UL ? Fixed::KEY : accs[rng.below(acct_cnt)];
+      thru::host::set_account(idx, owner, rng.below(4UL) ? 100UL + rng.below(50UL) : rng.below(20UL));
+      thru::host::account_meta(idx)->version = rng.below(8UL) ? TN_ACCOUNT_V1 : 0U;
+    }
+
+    check_all<Deposit>(deposit, rw, iter);
+    check_all<Mixed>(mixed, rw, iter);
+    check_all<Wide>(wide, rw, iter);
+    check_all<Far>(far, rw, iter);
+    check_all<None>({}, rw, iter);
+
+    ulong want = expected(mixed, rw);
+    outcomes[!want                                       ? 0UL
+             : want == TSDK_INVOKE_AUTH_ERR_PARENT_UNOWNED ? 7UL
+                                                         : want - TSDK_ACCOUNTS_ERR_INVALID_INDEX + 1UL]++;
+  }
+
+  /* Mixed passes, and fails each way, some of the time */
+  for (ulong outcome : outcomes) {
+    TSDK_TEST(outcome > 0UL);
+  }
+  thru::test::pass("accounts check");
+}
+
+} // namespace
+
+int main() {
+  test_check();
+  return 0;
+}
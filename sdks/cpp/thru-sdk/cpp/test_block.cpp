@@ -0,0 +1,188 @@
+#include "tn_sdk_block.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <vector>
+
+/* block::History and PriceWindow against brute force over a simulated
+   chain: lookups, binary searches and samples by linear scan, and the
+   window's sum, min and max recomputed from its last N prices, through
+   empty windows, ring wraparound and catch-ups of more than N blocks */
+
+namespace {
+
+struct Block {
+  ulong time;
+  ulong price;
+};
+
+/* The chain so far; block j has slot j, as on a chain that started at
+   slot 0 */
+std::vector<Block> chain;
+
+/* Appends cnt blocks with times that sometimes repeat and prices from a
+   small range, so ties are common */
+void produce(thru::test::Rng& rng, ulong cnt) {
+  for (ulong i = 0UL; i < cnt; i++) {
+    ulong time = chain.empty() ? 1000UL : chain.back().time + rng.below(3UL);
+    chain.push_back(Block{time, rng.below(4UL) ? 100UL + rng.below(16UL) : rng.next() >> 20});
+  }
+}
+
+/* Writes the newest blocks to the host's block contexts, block 0 the
+   current one */
+void publish() {
+  ulong cnt = chain.size() < thru::block::HISTORY_MAX ? chain.size() : thru::block::HISTORY_MAX;
+  for (ulong i = 0UL; i < cnt; i++) {
+    Block const& b = chain[chain.size() - 1UL - i];
+    tn_block_ctx* ctx = thru::host::block_ctx(i);
+    ctx->slot = chain.size() - 1UL - i;
+    ctx->block_time = b.time;
+    ctx->block_price = b.price;
+  }
+}
+
+Block const& ago(ulong i) { return chain[chain.size() - 1UL - i]; }
+
+void check_history(thru::test::Rng& rng) {
+  ulong avail = chain.size() < thru::block::HISTORY_MAX ? chain.size() : thru::block::HISTORY_MAX;
+  TSDK_TEST(thru::block::History::available() == avail);
+
+  ulong depth = rng.below(4UL) ? rng.below(avail + 8UL) : thru::block::HISTORY_MAX;
+  thru::block::History hist(depth);
+  ulong size = depth < avail ? depth : avail;
+  TSDK_TEST(hist.size() == size && hist.empty() == !size);
+  TSDK_TEST(static_cast<ulong>(hist.end() - hist.begin()) == size);
+  ulong i = 0UL;
+  for (tn_block_ctx const& ctx : hist) {
+    TSDK_TEST(ctx.slot == chain.size() - 1UL - i && ctx.block_price == ago(i).price);
+    i++;
+  }
+  TSDK_TEST(i == size);
+  TSDK_TEST(!size || (hist.front().slot == chain.size() - 1UL &&
+                      hist.back().slot == chain.size() - size));
+
+  /* Newest block at or before a time or slot, by scan */
+  for (ulong q = 0UL; q < 8UL; q++) {
+    ulong time = ago(rng.below(avail)).time + rng.below(3UL) - 1UL;
+    ulong want = 0UL;
+    while (want < size && ago(want).time > time) {
+      want++;
+    }
+    TSDK_TEST(hist.lower_bound_by_time(time) == want);
+
+    ulong slot = chain.size() + 1UL - rng.below(avail + 2UL);
+    want = 0UL;
+    while (want < size && chain.size() - 1UL - want > slot) {
+      want++;
+    }
+    TSDK_TEST(hist.lower_bound_by_slot(slot) == want);
+  }
+
+  /* Every stride-th block */
+  ulong stride = rng.below(12UL);
+  thru::block::History::Sampled s = hist.sampled(stride);
+  ulong n = 0UL;
+  for (auto it = s.begin(); it != s.end(); ++it, n++) {
+    TSDK_TEST(stride && n * stride < size && it.blocks_ago() == n * stride);
+    TSDK_TEST(it->block_price == ago(n * stride).price && s[n].slot == it->slot);
+  }
+  TSDK_TEST(n == s.size() && n == (stride ? (size + stride - 1UL) / stride : 0UL));
+}
+
+/* w against the cnt prices ending at last */
+template <ulong N>
+void check_window(thru::block::PriceWindow<N> const& w, ulong cnt, Block const* last) {
+  TSDK_TEST(w.count() == cnt && w.empty() == !cnt);
+  ulong sum = 0UL;
+  ulong lo = cnt ? ~0UL : 0UL;
+  ulong hi = 0UL;
+  for (ulong i = 0UL; i < cnt; i++) {
+    ulong p = (last - i)->price;
+    sum += p;
+    lo = p < lo ? p : lo;
+    hi = p > hi ? p : hi;
+  }
+  TSDK_TEST(w.sum() == sum && w.min() == lo && w.max() == hi);
+  TSDK_TEST(w.mean() == (cnt ? sum / cnt : 0UL));
+}
+
+/* A window updated from the block contexts as the chain grows, now by
+   one block, now by more than N */
+template <ulong N> void check_update(ulong seed) {
+  thru::test::Rng rng(seed);
+  chain.clear();
+  thru::block::PriceWindow<N> w{};
+  check_window(w, 0UL, nullptr);
+
+  for (ulong step = 0UL; step < 1500UL; step++) {
+    ulong k = rng.below(3UL) ? rng.below(3UL) : rng.below(3UL * N + 2UL);
+    produce(rng, chain.empty() && !k ? 1UL : k);
+    publish();
+    bool updated = rng.below(8UL) != 0UL;
+    if (updated) {
+      w.update();
+      if (rng.below(4UL)) {
+        /* Again with nothing new: no change */
+        w.update();
+      }
+      TSDK_TEST(w.last_slot() == chain.size() - 1UL);
+    }
+    if (w.empty()) {
+      check_window(w, 0UL, nullptr);
+      continue;
+    }
+    /* The N blocks up to the last update, or all of them */
+    ulong last = w.last_slot();
+    TSDK_TEST(last < chain.size());
+    check_window(w, N < last + 1UL ? N : last + 1UL, &chain[last]);
+    if (step % 32UL == 0UL) {
+      check_history(rng);
+    }
+  }
+}
+
+void test_update() {
+  thru::host::init_txn(1U, 0U);
+  check_update<1UL>(16UL);
+  check_update<3UL>(17UL);
+  check_update<64UL>(18UL);
+  check_update<200UL>(19UL);
+  thru::test::pass("block update");
+}
+
+/* push() alone, against the last N prices pushed */
+template <ulong N> void check_push(ulong seed) {
+  thru::test::Rng rng(seed);
+  thru::block::PriceWindow<N> w{};
+  std::vector<Block> pushed;
+  for (ulong i = 0UL; i < 20000UL; i++) {
+    /* Runs up, runs down and flat stretches, which the monotonic
+       queues handle differently */
+    ulong phase = i % 700UL;
+    ulong price = phase < 200UL ? phase : phase < 400UL ? 700UL - phase : rng.below(6UL);
+    if (!rng.below(4UL)) {
+      price = rng.below(1000UL);
+    }
+    pushed.push_back(Block{0UL, price});
+    w.push(i, price);
+    TSDK_TEST(w.last_slot() == i);
+    ulong cnt = pushed.size() < N ? pushed.size() : N;
+    check_window(w, cnt, &pushed.back());
+  }
+}
+
+void test_push() {
+  check_push<1UL>(20UL);
+  check_push<2UL>(21UL);
+  check_push<7UL>(22UL);
+  check_push<64UL>(23UL);
+  thru::test::pass("block push");
+}
+
+} // namespace
+
+int main() {
+  test_update();
+  test_push();
+  return 0;
+}
@@ -0,0 +1,278 @@
+#include "tn_sdk_btree.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/* BTree against std::map: random inserts, overwrites, erases and
+   lookups through growth to three levels and back down to one leaf,
+   bulk_load at sizes around the node capacities, and a tree of large
+   values that spills into its second and third accounts */
+
+namespace {
+
+using Tree = thru::BTree<ulong, ulong>;
+
+/* Few entries per page, so a modest tree fills an account */
+struct Big {
+  ulong key;
+  ulong pad[99];
+};
+using BigTree = thru::BTree<ulong, Big>;
+
+constexpr ushort FIRST_IDX = 2U;
+constexpr ulong ACCOUNT_CNT = 3UL;
+
+void init_accounts() {
+  thru::host::init_txn(static_cast<ushort>(ACCOUNT_CNT), 0U);
+  for (ushort i = 0U; i < ACCOUNT_CNT; i++) {
+    thru::host::set_account(static_cast<ushort>(FIRST_IDX + i), thru::host::account_addrs()[1],
+                            0UL);
+  }
+}
+
+/* Every entry in order, then every key of ref found with its value */
+template <typename T, typename V, typename F>
+void check_same(T const& tree, std::map<ulong, V> const& ref, F&& eq) {
+  TSDK_TEST(tree.size() == ref.size() && tree.empty() == ref.empty());
+  auto it = tree.begin();
+  for (auto const& [key, value] : ref) {
+    TSDK_TEST(it != std::default_sentinel);
+    TSDK_TEST(it.key() == key && eq(it.value(), value));
+    ++it;
+  }
+  TSDK_TEST(it == std::default_sentinel);
+}
+
+bool same_ulong(ulong a, ulong b) { return a == b; }
+
+/* lower_bound and a range [lo, hi) against the reference */
+void check_bounds(thru::test::Rng& rng, Tree const& tree, std::map<ulong, ulong> const& ref,
+                  ulong key_max) {
+  ulong lo = rng.below(key_max + 2UL);
+  auto it = tree.lower_bound(lo);
+  auto rit = ref.lower_bound(lo);
+  TSDK_TEST((it == std::default_sentinel) == (rit == ref.end()));
+  TSDK_TEST(rit == ref.end() || (it.key() == rit->first && it.value() == rit->second));
+
+  ulong hi = lo + rng.below(rng.below(8UL) ? 64UL : key_max + 1UL);
+  auto end = ref.lower_bound(hi);
+  auto range = tree.range(lo, hi);
+  auto r = range.begin();
+  for (; rit != end; ++rit, ++r) {
+    TSDK_TEST(r != std::default_sentinel && r.key() == rit->first && r.value() == rit->second);
+  }
+  TSDK_TEST(r == std::default_sentinel);
+}
+
+/* One random operation on key, mirrored in ref */
+void random_op(thru::test::Rng& rng, Tree& tree, std::map<ulong, ulong>& ref, ulong key,
+               ulong insert_pct) {
+  ulong op = rng.below(100UL);
+  if (op < insert_pct) {
+    ulong value = rng.next();
+    if (rng.below(2UL)) {
+      bool fresh = !ref.count(key);
+      TSDK_TEST(tree.insert(key, value) == fresh);
+      if (fresh) {
+        ref[key] = value;
+      }
+    } else {
+      TSDK_TEST(tree.insert_or_assign(key, value) == !ref.count(key));
+      ref[key] = value;
+    }
+  } else if (op < insert_pct + (100UL - insert_pct) / 2UL) {
+    TSDK_TEST(tree.erase(key) == (ref.erase(key) == 1UL));
+  } else {
+    ulong* v = tree.find(key);
+    auto it = ref.find(key);
+    TSDK_TEST(!!v == (it != ref.end()) && tree.contains(key) == !!v);
+    TSDK_TEST(!v || *v == it->second);
+  }
+}
+
+void test_random() {
+  init_accounts();
+  thru::host::Exit ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Tree tree = Tree::format(thru::Account(FIRST_IDX), writable);
+    std::map<ulong, ulong> ref;
+    thru::test::Rng rng(21UL);
+
+    /* Three levels need more keys than two full levels of leaves hold */
+    constexpr ulong KEY_MAX = 4UL * Tree::LEAF_MAX * Tree::INNER_MAX;
+    constexpr ulong PHASES[][2] = {{KEY_MAX, 80UL}, {KEY_MAX, 10UL}, {KEY_MAX / 8UL, 50UL}};
+    ulong max_height = 0UL;
+    for (auto const& [key_max, insert_pct] : PHASES) {
+      ulong op_cnt = insert_pct == 10UL ? 6UL * ref.size() : 3UL * key_max;
+      for (ulong i = 0UL; i < op_cnt; i++) {
+        random_op(rng, tree, ref, rng.below(key_max), insert_pct);
+        max_height = tree.height() > max_height ? tree.height() : max_height;
+        if (!(i % 1024UL)) {
+          check_bounds(rng, tree, ref, key_max);
+        }
+      }
+      check_same(tree, ref, same_ulong);
+    }
+    TSDK_TEST(max_height >= 3UL);
+
+    /* Erasing everything merges back down to the root leaf, and the
+       freed pages are reused before the tree grows again */
+    std::vector<ulong> keys;
+    for (auto const& [key, value] : ref) {
+      keys.push_back(key);
+    }
+    for (ulong i = keys.size(); i > 1UL; i--) {
+      std::swap(keys[i - 1UL], keys[rng.below(i)]);
+    }
+    for (ulong key : keys) {
+      TSDK_TEST(tree.erase(key) && !tree.contains(key));
+    }
+    ref.clear();
+    TSDK_TEST(tree.empty() && tree.height() == 1UL && tree.page_cnt() == 1UL);
+    TSDK_TEST(tree.begin() == std::default_sentinel);
+    ulong data_sz = thru::host::account_meta(FIRST_IDX)->data_sz;
+    for (ulong key = 0UL; key < KEY_MAX / 4UL; key++) {
+      TSDK_TEST(tree.insert(key, ~key));
+      ref[key] = ~key;
+    }
+    TSDK_TEST(thru::host::account_meta(FIRST_IDX)->data_sz == data_sz);
+    check_same(tree, ref, same_ulong);
+
+    /* join sees the same tree */
+    Tree again = Tree::join(thru::Account(FIRST_IDX), writable);
+    check_same(again, ref, same_ulong);
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("btree random");
+}
+
+void test_bulk_load() {
+  init_accounts();
+  constexpr ulong L = Tree::LEAF_MAX;
+  constexpr ulong FULL2 = L * (Tree::INNER_MAX + 1UL); /* Two levels, both full */
+  constexpr ulong SIZES[] = {0UL, 1UL, L - 1UL, L, L + 1UL, 2UL * L, FULL2, FULL2 + 1UL, 150000UL};
+  thru::test::Rng rng(22UL);
+  for (ulong n : SIZES) {
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::WritableSet writable;
+      Tree tree = Tree::format(thru::Account(FIRST_IDX), writable);
+      std::vector<Tree::Entry> entries;
+      std::map<ulong, ulong> ref;
+      ulong key = 0UL;
+      for (ulong i = 0UL; i < n; i++) {
+        key += 1UL + rng.below(3UL);
+        entries.push_back({key, rng.next()});
+        ref[key] = entries.back().value;
+      }
+      tree.bulk_load(entries);
+      check_same(tree, ref, same_ulong);
+      for (ulong i = 0UL; i < 256UL; i++) {
+        check_bounds(rng, tree, ref, key);
+      }
+
+      /* The loaded tree takes updates like any other */
+      for (ulong i = 0UL; i < 4UL * n + 256UL; i++) {
+        random_op(rng, tree, ref, rng.below(key + 2UL), 50UL);
+      }
+      check_same(tree, ref, same_ulong);
+    });
+    TSDK_TEST(!ex.exited);
+  }
+
+  /* Unsorted or duplicate keys, and a non-empty tree, are refused */
+  Tree::Entry const unsorted[][3] = {{{1UL, 0UL}, {3UL, 0UL}, {2UL, 0UL}},
+                                     {{1UL, 0UL}, {2UL, 0UL}, {2UL, 0UL}}};
+  for (auto const& entries : unsorted) {
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::WritableSet writable;
+      Tree::format(thru::Account(FIRST_IDX), writable).bulk_load(entries);
+    });
+    TSDK_TEST(ex.reverted && ex.code == TSDK_BTREE_ERR_UNSORTED);
+  }
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Tree tree = Tree::format(thru::Account(FIRST_IDX), writable);
+    tree.insert(5UL, 5UL);
+    tree.bulk_load(std::span<const Tree::Entry>(unsorted[0], 1UL));
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_BTREE_ERR_NOT_EMPTY);
+
+  thru::test::pass("btree bulk_load");
+}
+
+bool same_big(Big const& a, ulong key) { return a.key == key && a.pad[98] == ~key; }
+
+void test_accounts() {
+  init_accounts();
+  thru::Account accts[ACCOUNT_CNT] = {thru::Account(FIRST_IDX),
+                                      thru::Account(static_cast<ushort>(FIRST_IDX + 1U)),
+                                      thru::Account(static_cast<ushort>(FIRST_IDX + 2U))};
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    BigTree tree = BigTree::format(accts, writable);
+    std::map<ulong, ulong> ref;
+    thru::test::Rng rng(23UL);
+
+    /* Past one account's pages at any fill */
+    ulong key_cnt = 2UL * 4096UL * BigTree::LEAF_MAX;
+    Big v{};
+    while (ref.size() < key_cnt) {
+      ulong key = rng.below(4UL * key_cnt);
+      v.key = key;
+      v.pad[98] = ~key;
+      TSDK_TEST(tree.insert(key, v) == !ref.count(key));
+      ref[key] = key;
+    }
+    check_same(tree, ref, same_big);
+    TSDK_TEST(thru::host::account_meta(static_cast<ushort>(FIRST_IDX + 2U))->data_sz);
+    for (auto const& [key, value] : ref) {
+      Big const* b = tree.find(key);
+      TSDK_TEST(b && same_big(*b, value));
+    }
+
+    /* Erase down to a quarter, checking along the way */
+    for (ulong i = 0UL; ref.size() > key_cnt / 4UL; i++) {
+      ulong key = rng.below(4UL * key_cnt);
+      TSDK_TEST(tree.erase(key) == (ref.erase(key) == 1UL));
+      if (!(i % 4096UL)) {
+        TSDK_TEST(tree.size() == ref.size());
+      }
+    }
+    check_same(tree, ref, same_big);
+
+    /* The same accounts in the same order join; any other list does not */
+    BigTree again = BigTree::join(accts, writable);
+    check_same(again, ref, same_big);
+  });
+  TSDK_TEST(!ex.exited);
+
+  thru::Account swapped[ACCOUNT_CNT] = {accts[1], accts[0], accts[2]};
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    BigTree::join(swapped, writable);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_BTREE_ERR_INVALID);
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    BigTree::join(std::span<const thru::Account>(accts, 2UL), writable);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_BTREE_ERR_INVALID);
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Tree::join(accts, writable);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_BTREE_ERR_INVALID);
+
+  thru::test::pass("btree accounts");
+}
+
+} // namespace
+
+int main() {
+  test_random();
+  test_bulk_load();
+  test_accounts();
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include "tn_sdk_dispatch.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+
+/* Dispatcher: a batch's ops each start from the same arena position,
+   and the first op to fail reverts the batch with its code */
+
+namespace {
+
+ulong entry_used[32];
+ulong entry_cnt;
+
+struct Alloc {
+  static constexpr uchar DISCRIMINATOR = 1U;
+  struct __attribute__((packed)) Args {
+    ushort kib;
+    ulong code;
+  };
+  static ulong handle(Args const& args, thru::mem::Arena& arena) {
+    entry_used[entry_cnt++] = arena.used();
+    std::memset(arena.alloc(args.kib * 1024UL), 0xA5, args.kib * 1024UL);
+    return args.code;
+  }
+};
+
+using Program = thru::Dispatcher<Alloc, thru::Batch<>>;
+
+constexpr ulong OP_CNT = 16UL;
+constexpr ulong OP_KIB = 8UL;
+constexpr ulong OP_SZ = 2UL + 1UL + sizeof(Alloc::Args);
+
+/* The batch envelope of op_cnt Alloc ops; op i returns codes[i] */
+ulong build(uchar* instr, ulong op_cnt, ulong const* codes) {
+  ulong off = 0UL;
+  instr[off++] = 0xFFU;
+  ushort cnt = static_cast<ushort>(op_cnt);
+  std::memcpy(instr + off, &cnt, sizeof(ushort));
+  off += sizeof(ushort);
+  for (ulong i = 0UL; i < op_cnt; i++) {
+    ushort sz = static_cast<ushort>(1UL + sizeof(Alloc::Args));
+    std::memcpy(instr + off, &sz, sizeof(ushort));
+    off += sizeof(ushort);
+    instr[off++] = Alloc::DISCRIMINATOR;
+    Alloc::Args args{static_cast<ushort>(OP_KIB), codes[i]};
+    std::memcpy(instr + off, &args, sizeof(args));
+    off += sizeof(args);
+  }
+  return off;
+}
+
+void test_batch_arena() {
+  thru::host::init_txn(1U, 0U);
+
+  uchar instr[3UL + OP_CNT * OP_SZ];
+  ulong codes[OP_CNT] = {};
+  TSDK_TEST(build(instr, OP_CNT, codes) == sizeof(instr));
+
+  ulong code = ~0UL;
+  ulong after = 0UL;
+  entry_cnt = 0UL;
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    code = Program::dispatch(instr, sizeof(instr), arena);
+    after = arena.used();
+  });
+  TSDK_TEST(!ex.exited);
+  TSDK_TEST(code == TSDK_SUCCESS);
+  TSDK_TEST(entry_cnt == OP_CNT);
+  for (ulong i = 1UL; i < OP_CNT; i++) {
+    TSDK_TEST(entry_used[i] == entry_used[0]);
+  }
+  /* Only the op table is left once the summary is emitted */
+  TSDK_TEST(after == entry_used[0]);
+
+  std::span<const uchar> ev = thru::host::last_event();
+  TSDK_TEST(ev.size() == sizeof(thru::BatchSummary));
+  thru::BatchSummary summary;
+  std::memcpy(&summary, ev.data(), sizeof(summary));
+  TSDK_TEST(summary.tag == TSDK_DISPATCH_BATCH_EVENT && summary.op_cnt == OP_CNT);
+
+  thru::test::pass("dispatch batch arena");
+}
+
+/* Op 2 of 3 fails: the batch reverts with its code and op 3 never runs */
+void test_batch_atomic() {
+  thru::host::init_txn(1U, 0U);
+
+  uchar instr[3UL + 3UL * OP_SZ];
+  ulong codes[3] = {TSDK_SUCCESS, 7UL, TSDK_SUCCESS};
+  TSDK_TEST(build(instr, 3UL, codes) == sizeof(instr));
+
+  bool returned = false;
+  entry_cnt = 0UL;
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    Program::dispatch(instr, sizeof(instr), arena);
+    returned = true;
+  });
+  TSDK_TEST(ex.exited && ex.reverted && ex.code == 7UL);
+  TSDK_TEST(!returned);
+  TSDK_TEST(entry_cnt == 2UL);
+
+  /* Through the entry point too: a failed batch never reaches tsdk_return */
+  entry_cnt = 0UL;
+  ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    Program::run(instr, sizeof(instr), arena);
+  });
+  TSDK_TEST(ex.exited && ex.reverted && ex.code == 7UL);
+  TSDK_TEST(entry_cnt == 2UL);
+
+  thru::test::pass("dispatch batch atomic");
+}
+
+} // namespace
+
+int main() {
+  test_batch_arena();
+  test_batch_atomic();
+  return 0;
+}
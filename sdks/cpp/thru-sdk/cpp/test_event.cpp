@@ -0,0 +1,157 @@
+#include "tn_sdk_event.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* EventWriter against the bytes it should emit: a head written field
+   by field and a tail of random appends, some spanning several arena
+   pages, compared with what the host's tsys_emit_event received.  The
+   arena must be back where it was after each event, reserved tails
+   must not grow it, and misuse (interleaved allocations, reuse after
+   emit(), tails past the address space) must revert. */
+
+namespace {
+
+struct __attribute__((packed)) Head {
+  uchar kind;
+  ulong id;
+  ushort cnt;
+};
+
+/* Appends n random bytes to ev, by a random entry point, and to want */
+void append(thru::test::Rng& rng, thru::EventWriter<Head>& ev, std::vector<uchar>& want, ulong n) {
+  std::vector<uchar> bytes(n);
+  for (uchar& b : bytes) {
+    b = static_cast<uchar>(rng.next());
+  }
+  want.insert(want.end(), bytes.begin(), bytes.end());
+  switch (n == sizeof(ulong) ? 0UL : n % sizeof(pubkey_t) == 0UL ? 1UL + rng.below(3UL) : 3UL) {
+  case 0UL: {
+    ulong v;
+    std::memcpy(&v, bytes.data(), sizeof(v));
+    ev.append(v);
+    break;
+  }
+  case 1UL: {
+    pubkey_t* keys = ev.append_uninit<pubkey_t>(n / sizeof(pubkey_t));
+    std::memcpy(keys, bytes.data(), n);
+    break;
+  }
+  case 2UL:
+    ev.append(std::span<const uchar>(bytes));
+    break;
+  default:
+    ev.append_bytes(bytes.data(), n);
+    break;
+  }
+}
+
+void test_emit() {
+  thru::test::Rng rng(9UL);
+  thru::host::init_txn(1U, 0U);
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    /* Something allocated before, which the events must not disturb */
+    ulong* before = arena.alloc_array<ulong>(3UL);
+    before[0] = 0x1234UL;
+    ulong base = arena.used();
+
+    for (ulong iter = 0UL; iter < 500UL; iter++) {
+      /* Mostly small tails; now and then several pages */
+      ulong tail_sz = rng.below(4UL) ? rng.below(200UL) : rng.below(4UL * TSDK_PAGE_SZ);
+      bool reserved = rng.below(2UL) != 0UL;
+      std::vector<uchar> want(sizeof(Head));
+      Head head{static_cast<uchar>(iter), rng.next(), static_cast<ushort>(tail_sz)};
+      std::memcpy(want.data(), &head, sizeof(Head));
+
+      thru::EventWriter<Head> ev = reserved ? thru::EventWriter<Head>(arena, tail_sz)
+                                            : thru::EventWriter<Head>(arena);
+      TSDK_TEST(ev->kind == 0U && ev->id == 0UL && ev->cnt == 0U);
+      ulong cap = arena.capacity();
+      thru::host::reset_syscall_cnts();
+      ev.set<&Head::kind>(head.kind);
+      ev->id = head.id;
+      while (want.size() < sizeof(Head) + tail_sz) {
+        ulong left = sizeof(Head) + tail_sz - want.size();
+        ulong n = rng.below(2UL) ? sizeof(ulong) : sizeof(pubkey_t) * (1UL + rng.below(4UL));
+        append(rng, ev, want, rng.below(4UL) && n <= left ? n : 1UL + rng.below(left));
+      }
+      ev.head().cnt = head.cnt;
+      TSDK_TEST(ev.size() == want.size());
+      TSDK_TEST(std::memcmp(ev.bytes().data(), want.data(), want.size()) == 0);
+      if (reserved) {
+        TSDK_TEST(arena.capacity() == cap);
+        TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_INCREMENT_ANONYMOUS_SEGMENT_SZ) == 0UL);
+      }
+
+      TSDK_TEST(ev.emit() == TSDK_SUCCESS);
+      TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_EMIT_EVENT) == 1UL);
+      std::span<const uchar> got = thru::host::last_event();
+      TSDK_TEST(got.size() == want.size() && std::memcmp(got.data(), want.data(), want.size()) == 0);
+      TSDK_TEST(arena.used() == base && before[0] == 0x1234UL);
+    }
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("event emit");
+}
+
+void test_reverts() {
+  thru::host::init_txn(1U, 0U);
+
+  /* Allocating while the event is building, then growing it */
+  thru::host::Exit ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    thru::EventWriter<Head> ev(arena);
+    ev.append(1UL);
+    arena.alloc(8UL);
+    ev.append(2UL);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_EVENT_ERR_INTERLEAVED);
+
+  /* Appending or emitting again after emit() */
+  void (*reuses[])(thru::EventWriter<Head>&) = {
+      [](thru::EventWriter<Head>& ev) { ev.append(1UL); },
+      [](thru::EventWriter<Head>& ev) { ev.append_uninit<pubkey_t>(1UL); },
+      [](thru::EventWriter<Head>& ev) { ev.emit(); },
+  };
+  for (auto reuse : reuses) {
+    thru::host::reset_syscall_cnts();
+    ex = thru::host::run([&] {
+      thru::mem::Arena arena;
+      thru::EventWriter<Head> ev(arena);
+      ev.emit();
+      reuse(ev);
+    });
+    TSDK_TEST(ex.reverted && ex.code == TSDK_EVENT_ERR_EMITTED);
+    TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_EMIT_EVENT) == 1UL);
+  }
+
+  /* A count whose byte size overflows */
+  ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    thru::EventWriter<Head> ev(arena);
+    ev.append_uninit<pubkey_t>(~0UL / sizeof(pubkey_t) + 1UL);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ARENA_ERR_OUT_OF_MEMORY);
+
+  /* A writer dropped without emitting gives its buffer back */
+  ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    {
+      thru::EventWriter<Head> ev(arena);
+      ev.append_bytes("abc", 3UL);
+    }
+    TSDK_TEST(arena.used() == 0UL);
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("event reverts");
+}
+
+} // namespace
+
+int main() {
+  test_emit();
+  test_reverts();
+  return 0;
+}
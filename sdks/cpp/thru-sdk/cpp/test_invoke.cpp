@@ -0,0 +1,72 @@
+#include "tn_sdk_invoke.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <type_traits>
+
+/* InvokeAuthToken: valid until its list changes */
+
+static_assert(!std::is_copy_constructible_v<thru::InvokeAuthToken>);
+static_assert(!std::is_copy_assignable_v<thru::InvokeAuthToken>);
+
+namespace {
+
+constexpr ushort CALLEE_IDX = 5U;
+
+void test_token() {
+  thru::host::init_txn(4U, 2U);
+  for (ushort i = 2U; i < 6U; i++) {
+    thru::host::set_account(i, thru::host::account_addrs()[1], 64UL);
+  }
+  uchar const instr[8] = {};
+  std::span<const std::byte> data(reinterpret_cast<std::byte const*>(instr), sizeof(instr));
+
+  thru::InvokeAuth<3> auth{2U, 3U};
+  thru::host::reset_syscall_cnts();
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::InvokeAuthToken token = auth.validate();
+    TSDK_TEST(token.get() == auth.get());
+    for (ulong i = 0UL; i < 3UL; i++) {
+      ulong err = 0UL;
+      TSDK_TEST(thru::syscall::invoke(data, CALLEE_IDX, err, token) == TSDK_SUCCESS);
+    }
+  });
+  TSDK_TEST(!ex.exited);
+  TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_INVOKE) == 3UL);
+
+  /* Any change to the list invalidates the token */
+  void (*changes[])(thru::InvokeAuth<3>&) = {
+      [](thru::InvokeAuth<3>& a) { a.authorize(4U); },
+      [](thru::InvokeAuth<3>& a) { a.clear(); },
+  };
+  for (auto change : changes) {
+    thru::InvokeAuth<3> list{2U, 3U};
+    thru::host::reset_syscall_cnts();
+    ex = thru::host::run([&] {
+      thru::InvokeAuthToken token = list.validate();
+      change(list);
+      ulong err = 0UL;
+      thru::syscall::invoke(data, CALLEE_IDX, err, token);
+    });
+    TSDK_TEST(ex.reverted && ex.code == TSDK_INVOKE_AUTH_ERR_STALE_TOKEN);
+    TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_INVOKE) == 0UL);
+  }
+
+  /* Validating again gives a token for the new list */
+  thru::InvokeAuth<3> list{2U};
+  ex = thru::host::run([&] {
+    list.authorize(4U);
+    thru::InvokeAuthToken token = list.validate();
+    ulong err = 0UL;
+    TSDK_TEST(thru::syscall::invoke(data, CALLEE_IDX, err, token) == TSDK_SUCCESS);
+  });
+  TSDK_TEST(!ex.exited);
+
+  thru::test::pass("invoke token");
+}
+
+} // namespace
+
+int main() {
+  test_token();
+  return 0;
+}
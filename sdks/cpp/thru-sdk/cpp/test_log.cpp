@@ -0,0 +1,57 @@
+#include "tn_sdk_log.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <string_view>
+
+/* thru::log: argument tags and the rendering thru debug decode-log
+   reproduces */
+
+static_assert(thru::log::detail::type_tag<pubkey_t>() == 'K');
+static_assert(thru::log::detail::type_tag<pubkey_t const*>() == 'K');
+static_assert(thru::log::detail::type_tag<pubkey_t*>() == 'K');
+static_assert(thru::log::detail::type_tag<ulong const*>() == 'p');
+
+namespace {
+
+std::string_view logged() {
+  std::span<const uchar> l = thru::host::last_log();
+  return {reinterpret_cast<char const*>(l.data()), l.size()};
+}
+
+void test_pubkey() {
+  thru::host::set_log_quiet(true);
+  pubkey_t key;
+  for (ulong i = 0UL; i < 32UL; i++) {
+    key.key[i] = static_cast<uchar>(0xA0UL + i);
+  }
+  pubkey_t* key_ptr = &key;
+  pubkey_t const* key_cptr = &key;
+  constexpr std::string_view hex =
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf";
+
+  /* Text mode: the same 64 hex digits for every form and placeholder */
+  thru::log::detail::write_text<TSDK_LOG_LEVEL_INFO, "k={} p={} c={:x}">(key, key_ptr, key_cptr);
+  TSDK_TEST(logged().starts_with("info: k="));
+  std::string_view line = logged().substr(8);
+  TSDK_TEST(line.substr(0UL, 64UL) == hex);
+  TSDK_TEST(line.substr(64UL, 3UL) == " p=");
+  TSDK_TEST(line.substr(67UL, 64UL) == hex);
+  TSDK_TEST(line.substr(131UL, 3UL) == " c=");
+  TSDK_TEST(line.substr(134UL) == hex);
+
+  /* Binary mode: a non-const pointer is sent as the 32 key bytes */
+  thru::log::detail::write_binary<TSDK_LOG_LEVEL_INFO, "k={}">(key_ptr);
+  std::span<const uchar> rec = thru::host::last_log();
+  TSDK_TEST(rec.size() == TSDK_LOG_HDR_SZ + 32UL);
+  TSDK_TEST(!std::memcmp(rec.data() + TSDK_LOG_HDR_SZ, key.key.data(), 32UL));
+
+  thru::host::set_log_quiet(false);
+  thru::test::pass("log pubkey");
+}
+
+} // namespace
+
+int main() {
+  test_pubkey();
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include "tn_sdk_map.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <map>
+
+/* FlatMap: the null key, and random inserts/removes against std::map
+   on a map small enough that probe runs wrap and removal shifts */
+
+namespace {
+
+using SmallMap = thru::FlatMap<ulong, ulong, 4>;
+using KeyMap = thru::FlatMap<pubkey_t, ulong, 6>;
+
+alignas(64) uchar small_mem[SmallMap::footprint()];
+alignas(64) uchar key_mem[KeyMap::footprint()];
+
+void test_null_key() {
+  SmallMap map = SmallMap::join(SmallMap::format(small_mem));
+  TSDK_TEST(map.valid());
+
+  TSDK_TEST(!map.find(0UL));
+  TSDK_TEST(!map.query(0UL));
+  TSDK_TEST(!map.remove(0UL));
+  for (ulong i = 0UL; i < 2UL * SmallMap::slot_cnt(); i++) {
+    TSDK_TEST(!map.insert(0UL));
+  }
+  TSDK_TEST(map.key_cnt() == 0UL);
+
+  /* The map still takes key_max() real keys */
+  for (ulong k = 1UL; k <= SmallMap::key_max(); k++) {
+    TSDK_TEST(map.insert(k));
+  }
+  TSDK_TEST(map.key_cnt() == SmallMap::key_max());
+  TSDK_TEST(!map.find(0UL));
+  TSDK_TEST(!map.remove(0UL));
+  TSDK_TEST(map.key_cnt() == SmallMap::key_max());
+
+  map.clear();
+  SmallMap::Slot* s = map.insert(7UL);
+  TSDK_TEST(s);
+  s->value = 70UL;
+  TSDK_TEST(!map.remove(0UL));
+  TSDK_TEST(map.key_cnt() == 1UL);
+  TSDK_TEST(map.find(7UL) && *map.find(7UL) == 70UL);
+
+  KeyMap kmap = KeyMap::join(KeyMap::format(key_mem));
+  pubkey_t null_key = thru::FlatMapKeyTraits<pubkey_t>::null();
+  TSDK_TEST(!kmap.find(null_key));
+  TSDK_TEST(!kmap.insert(null_key));
+  TSDK_TEST(!kmap.remove(null_key));
+  TSDK_TEST(kmap.key_cnt() == 0UL);
+
+  thru::test::pass("map null key");
+}
+
+void test_random() {
+  SmallMap map = SmallMap::join(SmallMap::format(small_mem));
+  std::map<ulong, ulong> ref;
+  thru::test::Rng rng(1UL);
+
+  for (ulong iter = 0UL; iter < 200000UL; iter++) {
+    /* Few distinct keys, including 0, so hits, misses and a full map
+       are all common */
+    ulong key = rng.below(24UL);
+    ulong op = rng.below(3UL);
+    if (op == 0UL) {
+      SmallMap::Slot* s = map.insert(key);
+      bool ok = key && !ref.count(key) && ref.size() < SmallMap::key_max();
+      TSDK_TEST(!!s == ok);
+      if (s) {
+        s->value = iter;
+        ref[key] = iter;
+      }
+    } else if (op == 1UL) {
+      TSDK_TEST(map.remove(key) == (ref.erase(key) == 1UL));
+    } else {
+      ulong* v = map.find(key);
+      auto it = ref.find(key);
+      TSDK_TEST(!!v == (it != ref.end()));
+      TSDK_TEST(!v || *v == it->second);
+    }
+    TSDK_TEST(map.key_cnt() == ref.size());
+  }
+
+  /* Every stored key sits in exactly one occupied slot */
+  ulong occupied = 0UL;
+  for (ulong i = 0UL; i < SmallMap::slot_cnt(); i++) {
+    ulong k = map.slot(i).key;
+    if (k) {
+      occupied++;
+      TSDK_TEST(ref.count(k) && map.query(k) == &map.slot(i));
+    }
+  }
+  TSDK_TEST(occupied == ref.size());
+
+  thru::test::pass("map random");
+}
+
+} // namespace
+
+int main() {
+  test_null_key();
+  test_random();
+  return 0;
+}
@@ -0,0 +1,223 @@
+#include "tn_sdk_math.hpp"
+#include "host/tn_sdk_test.hpp"
+
+/* thru::math against plain unsigned __int128 arithmetic, on operands
+   chosen to sit at the edges: powers of two and ten, all ones, and
+   divisors just above or below the high half of the product */
+
+namespace {
+
+using thru::math::Round;
+using thru::math::uint128;
+
+constexpr ulong ITER_CNT = 1000000UL;
+constexpr Round ROUNDS[] = {Round::DOWN, Round::UP, Round::NEAREST};
+
+static_assert(thru::math::mul_div(~0UL, ~0UL, ~0UL) == ~0UL);
+static_assert(thru::math::mul_div<10000UL>(12345UL, 30UL, Round::UP) == 38UL);
+static_assert(thru::math::Fixed<9>::ratio(1UL, 3UL).raw() == 333333333UL);
+
+ulong operand(thru::test::Rng& rng) {
+  switch (rng.below(7UL)) {
+  case 0UL: return rng.below(16UL);
+  case 1UL: return rng.next();
+  case 2UL: return rng.next() >> rng.below(64UL);
+  case 3UL: return (1UL << rng.below(64UL)) + rng.below(3UL) - 1UL;
+  case 4UL: return ~0UL - rng.below(4UL);
+  case 5UL: return thru::math::pow10(static_cast<uint>(rng.below(20UL))) + rng.below(3UL) - 1UL;
+  default: return rng.next() & ~rng.next();
+  }
+}
+
+/* A divisor for a * b: often right at the high half of the product, so
+   quotients near 2^64 and the overflow boundary both come up */
+ulong divisor(thru::test::Rng& rng, ulong a, ulong b) {
+  if (rng.below(3UL)) {
+    return operand(rng);
+  }
+  ulong hi = static_cast<ulong>((static_cast<uint128>(a) * b) >> 64);
+  return hi + rng.below(3UL);
+}
+
+/* n / c rounded; false if c is zero or the result does not fit */
+bool ref_div(uint128 n, ulong c, Round round, ulong* out) {
+  if (!c) {
+    return false;
+  }
+  uint128 q = n / c;
+  uint128 r = n % c;
+  bool up = round == Round::UP ? r != 0U : round == Round::NEAREST ? 2U * r >= c : false;
+  q += up;
+  if (q >> 64) {
+    return false;
+  }
+  *out = static_cast<ulong>(q);
+  return true;
+}
+
+/* Revert code of fn(), or TSDK_SUCCESS with its result in *out */
+template <typename F> ulong run_code(F&& fn, ulong* out) {
+  thru::host::Exit ex = thru::host::run([&] { *out = fn(); });
+  TSDK_TEST(!ex.exited || ex.reverted);
+  return ex.exited ? ex.code : TSDK_SUCCESS;
+}
+
+/* What a reverting form should do given its reference result */
+ulong ref_code(bool ok, ulong c) {
+  return !c ? TSDK_MATH_ERR_DIV_BY_ZERO : ok ? TSDK_SUCCESS : TSDK_MATH_ERR_OVERFLOW;
+}
+
+void test_add_sub_mul() {
+  thru::test::Rng rng(26UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong a = operand(rng);
+    ulong b = operand(rng);
+    ulong cin = rng.below(2UL);
+    ulong cout = 2UL;
+    ulong s = thru::math::addc(a, b, cin, &cout);
+    uint128 ws = static_cast<uint128>(a) + b + cin;
+    TSDK_TEST(s == static_cast<ulong>(ws) && cout == static_cast<ulong>(ws >> 64));
+
+    ulong d = thru::math::subb(a, b, cin, &cout);
+    TSDK_TEST(d == a - b - cin && cout == (static_cast<uint128>(b) + cin > a));
+
+    ulong hi = 0UL;
+    ulong lo = thru::math::mul_wide(a, b, &hi);
+    uint128 p = static_cast<uint128>(a) * b;
+    TSDK_TEST(lo == static_cast<ulong>(p) && hi == static_cast<ulong>(p >> 64));
+
+    ulong out = 0UL;
+    bool fits = !((static_cast<uint128>(a) + b) >> 64);
+    TSDK_TEST(thru::math::try_add(a, b, &out) == fits && (!fits || out == a + b));
+    TSDK_TEST(thru::math::try_sub(a, b, &out) == (a >= b) && (a < b || out == a - b));
+    fits = !(p >> 64);
+    TSDK_TEST(thru::math::try_mul(a, b, &out) == fits && (!fits || out == a * b));
+  }
+  thru::test::pass("math add sub mul");
+}
+
+void test_mul_div() {
+  thru::test::Rng rng(27UL);
+  thru::host::init_txn(1U, 0U);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong a = operand(rng);
+    ulong b = operand(rng);
+    ulong c = divisor(rng, a, b);
+    Round round = ROUNDS[rng.below(3UL)];
+    uint128 n = static_cast<uint128>(a) * b;
+
+    ulong want = 0UL;
+    bool ok = ref_div(n, c, round, &want);
+    ulong got = 0UL;
+    TSDK_TEST(thru::math::try_mul_div(a, b, c, &got, round) == ok && (!ok || got == want));
+    if (c) {
+      thru::math::Divisor d(c);
+      TSDK_TEST(thru::math::try_mul_div(a, b, d, &got, round) == ok && (!ok || got == want));
+
+      /* The 2-by-1 divisions on their own, for any high word below c */
+      ulong u1 = rng.below(c);
+      ulong u0 = rng.next();
+      uint128 u = (static_cast<uint128>(u1) << 64) | u0;
+      ulong r = 0UL;
+      TSDK_TEST(d.div(u1, u0, &r) == static_cast<ulong>(u / c) && r == static_cast<ulong>(u % c));
+      TSDK_TEST(thru::math::detail::div_2by1(u1, u0, c, &r) == static_cast<ulong>(u / c) &&
+                r == static_cast<ulong>(u % c));
+    }
+
+    /* The reverting form, now and then: each check is a host::run */
+    if (!(iter % 16UL)) {
+      TSDK_TEST(run_code([&] { return thru::math::mul_div(a, b, c, round); }, &got) ==
+                ref_code(ok, c));
+      TSDK_TEST(!ok || got == want);
+    }
+  }
+  thru::test::pass("math mul_div");
+}
+
+template <ulong C> void check_const_div(thru::test::Rng& rng) {
+  for (ulong iter = 0UL; iter < ITER_CNT / 8UL; iter++) {
+    ulong a = operand(rng);
+    ulong b = rng.below(2UL) ? operand(rng) : C + rng.below(3UL) - 1UL;
+    Round round = ROUNDS[rng.below(3UL)];
+    ulong want = 0UL;
+    bool ok = ref_div(static_cast<uint128>(a) * b, C, round, &want);
+    ulong got = 0UL;
+    if (ok) {
+      TSDK_TEST(thru::math::mul_div<C>(a, b, round) == want);
+    } else if (!(iter % 16UL)) {
+      TSDK_TEST(run_code([&] { return thru::math::mul_div<C>(a, b, round); }, &got) ==
+                TSDK_MATH_ERR_OVERFLOW);
+    }
+  }
+}
+
+void test_const_div() {
+  thru::test::Rng rng(28UL);
+  thru::host::init_txn(1U, 0U);
+  check_const_div<1UL>(rng);
+  check_const_div<3UL>(rng);
+  check_const_div<10000UL>(rng);
+  check_const_div<1000000000UL>(rng);
+  check_const_div<1UL << 63>(rng);
+  check_const_div<~0UL>(rng);
+  thru::test::pass("math const div");
+}
+
+template <uint Frac> void check_fixed(thru::test::Rng& rng) {
+  using F = thru::math::Fixed<Frac>;
+  constexpr ulong S = F::SCALE;
+  for (ulong iter = 0UL; iter < ITER_CNT / 8UL; iter++) {
+    F x = F::from_raw(operand(rng));
+    F y = F::from_raw(rng.below(2UL) ? operand(rng) : S + rng.below(3UL) - 1UL);
+    ulong amount = operand(rng);
+    Round round = ROUNDS[rng.below(3UL)];
+    bool check_reverts = !(iter % 16UL);
+
+    ulong want = 0UL;
+    ulong got = 0UL;
+    bool ok = ref_div(static_cast<uint128>(amount) * x.raw(), S, round, &want);
+    if (ok) {
+      TSDK_TEST(x.apply(amount, round) == want);
+    } else if (check_reverts) {
+      TSDK_TEST(run_code([&] { return x.apply(amount, round); }, &got) == TSDK_MATH_ERR_OVERFLOW);
+    }
+
+    ok = ref_div(static_cast<uint128>(x.raw()) * y.raw(), S, round, &want);
+    if (ok) {
+      TSDK_TEST(x.mul(y, round).raw() == want);
+    } else if (check_reverts) {
+      TSDK_TEST(run_code([&] { return x.mul(y, round).raw(); }, &got) == TSDK_MATH_ERR_OVERFLOW);
+    }
+
+    ok = ref_div(static_cast<uint128>(x.raw()) * S, y.raw(), round, &want);
+    if (ok) {
+      TSDK_TEST(x.div(y, round).raw() == want);
+    } else if (check_reverts) {
+      TSDK_TEST(run_code([&] { return x.div(y, round).raw(); }, &got) == ref_code(false, y.raw()));
+    }
+
+    TSDK_TEST(ref_div(x.raw(), S, round, &want) && x.to_int(round) == want);
+    TSDK_TEST((x < y) == (x.raw() < y.raw()) && (x == y) == (x.raw() == y.raw()));
+  }
+}
+
+void test_fixed() {
+  thru::test::Rng rng(29UL);
+  thru::host::init_txn(1U, 0U);
+  check_fixed<1U>(rng);
+  check_fixed<6U>(rng);
+  check_fixed<9U>(rng);
+  check_fixed<18U>(rng);
+  check_fixed<19U>(rng);
+  thru::test::pass("math fixed");
+}
+
+} // namespace
+
+int main() {
+  test_add_sub_mul();
+  test_mul_div();
+  test_const_div();
+  test_fixed();
+  return 0;
+}
@@ -0,0 +1,369 @@
+#include "tn_sdk.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* tsdk_mem* and pubkey_eq against libc, at every relative alignment of
+   the operands and lengths on both sides of the word paths, and Arena
+   against a model of its bump pointer and growth batches: addresses,
+   ecall counts, mark/rollback, Scope, reset, reserve, the pmr interface
+   and the reverts at the end of the heap segment */
+
+namespace {
+
+constexpr ulong BUF_SZ = 512UL;
+constexpr ulong ITER_CNT = 200000UL;
+
+alignas(64) uchar a[BUF_SZ];
+alignas(64) uchar b[BUF_SZ];
+alignas(64) uchar ref[BUF_SZ];
+
+void fill(thru::test::Rng& rng, uchar* buf) {
+  for (ulong i = 0UL; i < BUF_SZ; i++) {
+    buf[i] = static_cast<uchar>(rng.next());
+  }
+}
+
+/* Offset and length: short lengths are where the paths split */
+void pick(thru::test::Rng& rng, ulong* off, ulong* n) {
+  *off = rng.below(24UL);
+  *n = rng.below(4UL) ? rng.below(80UL) : rng.below(BUF_SZ - 2UL * 24UL);
+}
+
+int sign(int x) { return (x > 0) - (x < 0); }
+
+void test_memset() {
+  thru::test::Rng rng(24UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong off, n;
+    pick(rng, &off, &n);
+    int c = static_cast<int>(rng.below(512UL)) - 128; /* Only the low byte counts */
+    fill(rng, a);
+    std::memcpy(ref, a, BUF_SZ);
+    TSDK_TEST(tsdk_memset(a + off, c, n) == a + off);
+    std::memset(ref + off, c, n);
+    TSDK_TEST(!std::memcmp(a, ref, BUF_SZ));
+  }
+  thru::test::pass("mem memset");
+}
+
+void test_memcpy() {
+  thru::test::Rng rng(25UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong doff, soff, n;
+    pick(rng, &doff, &n);
+    soff = rng.below(24UL);
+    fill(rng, a);
+    fill(rng, b);
+    std::memcpy(ref, a, BUF_SZ);
+    TSDK_TEST(tsdk_memcpy(a + doff, b + soff, n) == a + doff);
+    std::memcpy(ref + doff, b + soff, n);
+    TSDK_TEST(!std::memcmp(a, ref, BUF_SZ));
+  }
+  thru::test::pass("mem memcpy");
+}
+
+void test_memmove() {
+  thru::test::Rng rng(26UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    /* Overlapping either way, or not at all */
+    ulong n = rng.below(4UL) ? rng.below(80UL) : rng.below(BUF_SZ / 2UL);
+    ulong soff = rng.below(BUF_SZ - n + 1UL);
+    ulong doff = rng.below(2UL) ? rng.below(BUF_SZ - n + 1UL)
+                                : soff + rng.below(2UL * 24UL + 1UL) - 24UL;
+    if (doff > BUF_SZ - n) {
+      doff = soff;
+    }
+    fill(rng, a);
+    std::memcpy(ref, a, BUF_SZ);
+    TSDK_TEST(tsdk_memmove(a + doff, a + soff, n) == a + doff);
+    std::memmove(ref + doff, ref + soff, n);
+    TSDK_TEST(!std::memcmp(a, ref, BUF_SZ));
+  }
+  thru::test::pass("mem memmove");
+}
+
+void test_memcmp() {
+  thru::test::Rng rng(27UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong aoff, boff, n;
+    pick(rng, &aoff, &n);
+    boff = rng.below(24UL);
+    fill(rng, a);
+    std::memcpy(b + boff, a + aoff, n);
+    /* Equal, or differing first at a random byte, with more
+       differences after it half the time */
+    if (n && rng.below(4UL)) {
+      ulong at = rng.below(n);
+      b[boff + at] = static_cast<uchar>(b[boff + at] + 1U + rng.below(255UL));
+      if (rng.below(2UL)) {
+        for (ulong i = at + 1UL; i < n; i++) {
+          b[boff + i] = static_cast<uchar>(rng.next());
+        }
+      }
+    }
+    TSDK_TEST(sign(tsdk_memcmp(a + aoff, b + boff, n)) ==
+              sign(std::memcmp(a + aoff, b + boff, n)));
+  }
+  thru::test::pass("mem memcmp");
+}
+
+void test_strlen() {
+  thru::test::Rng rng(28UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong off, n;
+    pick(rng, &off, &n);
+    for (ulong i = 0UL; i < BUF_SZ; i++) {
+      a[i] = static_cast<uchar>(1UL + rng.below(255UL));
+    }
+    a[off + n] = 0U;
+    char const* s = reinterpret_cast<char const*>(a + off);
+    TSDK_TEST(tsdk_strlen(s) == std::strlen(s));
+  }
+  thru::test::pass("mem strlen");
+}
+
+void test_pubkey_eq() {
+  thru::test::Rng rng(29UL);
+  for (ulong iter = 0UL; iter < ITER_CNT; iter++) {
+    ulong aoff = rng.below(64UL);
+    ulong boff = rng.below(64UL);
+    fill(rng, a);
+    std::memcpy(b + boff, a + aoff, sizeof(pubkey_t));
+    if (rng.below(2UL)) {
+      b[boff + rng.below(sizeof(pubkey_t))] ^= static_cast<uchar>(1UL << rng.below(8UL));
+    }
+    pubkey_t const& x = *reinterpret_cast<pubkey_t const*>(a + aoff);
+    pubkey_t const& y = *reinterpret_cast<pubkey_t const*>(b + boff);
+    TSDK_TEST(thru::pubkey_eq(x, y) == !std::memcmp(a + aoff, b + boff, sizeof(pubkey_t)));
+    TSDK_TEST(thru::pubkey_prefix(x) == TSDK_LOAD(ulong, a + aoff));
+  }
+  thru::test::pass("mem pubkey_eq");
+}
+
+/* What an Arena's used(), capacity() and ecalls should be.  The host
+   declares no heap pages, so the first allocation maps the first batch. */
+struct ArenaModel {
+  ulong used = 0UL;
+  ulong cap = 0UL;
+  ulong grow_pages = thru::mem::TSDK_ARENA_GROW_PAGES_DEFAULT;
+  ulong ecall_cnt = 0UL;
+
+  void reach(ulong end) {
+    if (end <= cap) {
+      return;
+    }
+    ulong delta = thru::mem::align_up(end - cap, TSDK_PAGE_SZ);
+    delta = delta > grow_pages * TSDK_PAGE_SZ ? delta : grow_pages * TSDK_PAGE_SZ;
+    delta = delta < TSDK_SEG_OFFSET_MAX - cap ? delta : TSDK_SEG_OFFSET_MAX - cap;
+    grow_pages = grow_pages < thru::mem::TSDK_ARENA_GROW_PAGES_MAX ? 2UL * grow_pages
+                                                                   : grow_pages;
+    cap += delta;
+    ecall_cnt++;
+  }
+
+  ulong alloc(ulong sz, ulong align) {
+    ulong off = thru::mem::align_up(used, align);
+    reach(off + sz);
+    used = off + sz;
+    return off;
+  }
+};
+
+void check_model(thru::mem::Arena const& arena, ArenaModel const& m) {
+  TSDK_TEST(arena.used() == m.used && arena.capacity() == m.cap);
+  TSDK_TEST(arena.remaining() == m.cap - m.used);
+  TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_INCREMENT_ANONYMOUS_SEGMENT_SZ) ==
+            m.ecall_cnt);
+}
+
+struct Block {
+  uchar* p;
+  ulong sz;
+  uchar tag;
+};
+
+void test_arena_alloc() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::reset_syscall_cnts();
+  thru::test::Rng rng(30UL);
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    ArenaModel m;
+    uchar* base = static_cast<uchar*>(tsdk_get_heap_base());
+    std::vector<Block> blocks;
+    while (m.used < 12UL << 20) {
+      ulong sz = rng.below(8UL) ? 1UL + rng.below(4000UL) : rng.below(200000UL);
+      ulong align = 1UL << rng.below(13UL);
+      uchar* p = static_cast<uchar*>(arena.alloc(sz, align));
+      TSDK_TEST(p == base + m.alloc(sz, align) && thru::mem::is_aligned(
+                                                      reinterpret_cast<ulong>(p), align));
+      check_model(arena, m);
+      uchar tag = static_cast<uchar>(rng.next());
+      std::memset(p, tag, sz);
+      blocks.push_back(Block{p, sz, tag});
+    }
+    /* Batches doubled, so few ecalls mapped the lot */
+    TSDK_TEST(m.ecall_cnt < 12UL * 256UL / thru::mem::TSDK_ARENA_GROW_PAGES_MAX + 8UL);
+    for (Block const& b : blocks) {
+      for (ulong i = 0UL; i < b.sz; i += 1UL + b.sz / 8UL) {
+        TSDK_TEST(b.p[i] == b.tag);
+      }
+    }
+
+    /* Typed forms */
+    ulong* a = arena.alloc_array<ulong>(3UL);
+    TSDK_TEST(reinterpret_cast<uchar*>(a) == base + m.alloc(3UL * sizeof(ulong), alignof(ulong)));
+    Block* b = arena.make<Block>(Block{nullptr, 7UL, 1U});
+    TSDK_TEST(reinterpret_cast<uchar*>(b) == base + m.alloc(sizeof(Block), alignof(Block)));
+    TSDK_TEST(b->sz == 7UL && b->tag == 1U);
+    check_model(arena, m);
+  });
+  TSDK_TEST(!ex.exited);
+
+  /* Past the end of the heap segment, or a size that wraps */
+  ulong const sizes[] = {TSDK_SEG_OFFSET_MAX + 1UL, ~0UL, ~0UL - 64UL};
+  for (ulong sz : sizes) {
+    ex = thru::host::run([&] {
+      thru::mem::Arena arena;
+      arena.alloc(8UL);
+      arena.alloc(sz);
+    });
+    TSDK_TEST(ex.reverted && ex.code == TSDK_ARENA_ERR_OUT_OF_MEMORY);
+  }
+  ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    arena.alloc_array<ulong>(~0UL / 4UL);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ARENA_ERR_OUT_OF_MEMORY);
+  ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    arena.alloc(8UL);
+    arena.reserve(~0UL);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ARENA_ERR_OUT_OF_MEMORY);
+  thru::test::pass("mem arena alloc");
+}
+
+void test_arena_mark() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::reset_syscall_cnts();
+  thru::test::Rng rng(31UL);
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::mem::Arena arena;
+    ArenaModel m;
+    uchar* base = static_cast<uchar*>(tsdk_get_heap_base());
+
+    /* Nested marks, rolled back out of order: each rollback rewinds to
+       its mark, and the space after it is handed out again.  Past 4 MiB
+       it only rolls back. */
+    std::vector<thru::mem::Arena::Mark> marks;
+    for (ulong iter = 0UL; iter < 100000UL; iter++) {
+      ulong op = m.used < 4UL << 20 ? rng.below(10UL) : 8UL;
+      if (op < 6UL) {
+        ulong sz = rng.below(3000UL);
+        ulong align = 1UL << rng.below(7UL);
+        TSDK_TEST(arena.alloc(sz, align) == base + m.alloc(sz, align));
+      } else if (op < 8UL) {
+        marks.push_back(arena.mark());
+        TSDK_TEST(marks.back().used == m.used);
+      } else if (!marks.empty()) {
+        ulong i = rng.below(marks.size());
+        arena.rollback(marks[i]);
+        if (marks[i].used <= m.used) {
+          m.used = marks[i].used;
+        }
+        /* Marks past the new end stay valid but no longer rewind */
+        marks.resize(i + (rng.below(2UL) ? 0UL : 1UL));
+      } else {
+        arena.reset();
+        m.used = 0UL;
+      }
+      check_model(arena, m);
+    }
+
+    /* A mark ahead of the bump pointer is ignored */
+    thru::mem::Arena::Mark lo = arena.mark();
+    arena.alloc(64UL);
+    thru::mem::Arena::Mark hi = arena.mark();
+    arena.rollback(lo);
+    arena.rollback(hi);
+    TSDK_TEST(arena.used() == lo.used);
+    m.used = lo.used;
+
+    /* Scope rewinds on exit; the pages stay mapped */
+    {
+      thru::mem::Arena::Scope scope(arena);
+      arena.alloc(3UL * TSDK_PAGE_SZ);
+      m.alloc(3UL * TSDK_PAGE_SZ, alignof(ulong));
+      check_model(arena, m);
+    }
+    m.used = lo.used;
+    check_model(arena, m);
+
+    /* reset() keeps the capacity; filling it again costs no ecall */
+    arena.reset();
+    m.used = 0UL;
+    arena.alloc(m.cap);
+    m.alloc(m.cap, alignof(ulong));
+    check_model(arena, m);
+
+    /* reserve() maps ahead, then allocations up to it make no ecall */
+    arena.reserve(100000UL);
+    m.reach(m.used + 100000UL);
+    ulong ecall_cnt = m.ecall_cnt;
+    for (ulong i = 0UL; i < 100UL; i++) {
+      arena.alloc(1000UL, 8UL);
+      m.alloc(1000UL, 8UL);
+    }
+    TSDK_TEST(m.ecall_cnt == ecall_cnt);
+    check_model(arena, m);
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("mem arena mark");
+}
+
+void test_arena_pmr() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::Exit ex = thru::host::run([] {
+    thru::mem::Arena arena;
+    thru::mem::Arena other;
+    TSDK_TEST(arena.is_equal(arena) && !arena.is_equal(other));
+
+    std::pmr::vector<ulong> v(&arena);
+    for (ulong i = 0UL; i < 10000UL; i++) {
+      v.push_back(i * i);
+    }
+    for (ulong i = 0UL; i < v.size(); i++) {
+      TSDK_TEST(v[i] == i * i);
+    }
+    TSDK_TEST(arena.used() >= v.size() * sizeof(ulong));
+
+    /* Freeing the latest allocation gives it back; any other is kept */
+    void* p = arena.allocate(100UL, 8UL);
+    void* q = arena.allocate(40UL, 16UL);
+    ulong used = arena.used();
+    arena.deallocate(p, 100UL, 8UL);
+    TSDK_TEST(arena.used() == used);
+    arena.deallocate(q, 40UL, 16UL);
+    TSDK_TEST(arena.used() == used - 40UL && arena.allocate(40UL, 16UL) == q);
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("mem arena pmr");
+}
+
+} // namespace
+
+int main() {
+  test_memset();
+  test_memcpy();
+  test_memmove();
+  test_memcmp();
+  test_strlen();
+  test_pubkey_eq();
+  test_arena_alloc();
+  test_arena_mark();
+  test_arena_pmr();
+  return 0;
+}
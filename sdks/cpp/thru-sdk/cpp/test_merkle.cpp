@@ -0,0 +1,173 @@
+#include "tn_sdk_merkle.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* MerkleAccumulator against a tree built level by level with one-shot
+   Sha256::hash: the root after every append (up to full at small
+   depths), a proof for every leaf, and proofs, leaves and indices off
+   by one bit rejected */
+
+namespace {
+
+constexpr ushort IDX = 2U;
+
+pubkey_t node_hash(pubkey_t const& left, pubkey_t const& right) {
+  uchar buf[64];
+  std::memcpy(buf, &left, 32UL);
+  std::memcpy(buf + 32, &right, 32UL);
+  pubkey_t node;
+  thru::crypto::Sha256::hash(buf, sizeof(buf), &node);
+  return node;
+}
+
+/* The tree over leaves, padded with zero leaves to 2^depth.  Only the
+   nodes over some leaf are stored; the rest are zero subtrees. */
+struct Tree {
+  std::vector<std::vector<pubkey_t>> levels; /* levels[h][j]: node j at height h */
+  std::vector<pubkey_t> zeros;               /* zeros[h]: empty subtree of height h */
+
+  Tree(std::vector<pubkey_t> const& leaves, ulong depth)
+      : levels(depth + 1UL), zeros(depth + 1UL) {
+    for (ulong h = 1UL; h <= depth; h++) {
+      zeros[h] = node_hash(zeros[h - 1UL], zeros[h - 1UL]);
+    }
+    levels[0] = leaves;
+    for (ulong h = 0UL; h < depth; h++) {
+      for (ulong j = 0UL; j < levels[h].size(); j += 2UL) {
+        levels[h + 1UL].push_back(node_hash(node(h, j), node(h, j + 1UL)));
+      }
+    }
+  }
+
+  pubkey_t node(ulong h, ulong j) const { return j < levels[h].size() ? levels[h][j] : zeros[h]; }
+  pubkey_t root() const { return node(levels.size() - 1UL, 0UL); }
+
+  std::vector<pubkey_t> proof(ulong idx) const {
+    std::vector<pubkey_t> p;
+    for (ulong h = 0UL; h + 1UL < levels.size(); h++) {
+      p.push_back(node(h, (idx >> h) ^ 1UL));
+    }
+    return p;
+  }
+};
+
+pubkey_t random_leaf(thru::test::Rng& rng) {
+  pubkey_t leaf;
+  for (ulong i = 0UL; i < 32UL; i += 8UL) {
+    ulong w = rng.next();
+    std::memcpy(&leaf.key[i], &w, 8UL);
+  }
+  return leaf;
+}
+
+template <ulong Depth> void check_depth(ulong leaf_cnt, ulong seed) {
+  using Acc = thru::MerkleAccumulator<Depth>;
+  thru::host::init_txn(1U, 0U);
+  thru::host::set_account(IDX, thru::host::account_addrs()[1], 0UL);
+  thru::test::Rng rng(seed);
+
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Acc acc = Acc::format(thru::Account(IDX), writable);
+    std::vector<pubkey_t> leaves;
+    Tree tree(leaves, Depth);
+    TSDK_TEST(acc.empty() && thru::pubkey_eq(acc.root(), tree.root()));
+    for (ulong h = 0UL; h <= Depth; h++) {
+      TSDK_TEST(thru::pubkey_eq(Acc::ZEROS[h], tree.zeros[h]));
+    }
+
+    for (ulong n = 1UL; n <= leaf_cnt; n++) {
+      leaves.push_back(random_leaf(rng));
+      TSDK_TEST(acc.append(leaves.back()) == n - 1UL && acc.size() == n);
+      tree = Tree(leaves, Depth);
+      pubkey_t root = tree.root();
+      TSDK_TEST(thru::pubkey_eq(acc.root(), root));
+      TSDK_TEST(thru::pubkey_eq(Acc::root_of(thru::Account(IDX)), root));
+
+      for (ulong i = 0UL; i < n; i++) {
+        std::vector<pubkey_t> proof = tree.proof(i);
+        typename Acc::Proof p(proof.data(), Depth);
+        TSDK_TEST(Acc::verify(root, leaves[i], i, p) && acc.contains(leaves[i], i, p));
+
+        /* One flipped bit anywhere breaks it */
+        ulong bit = rng.below(256UL);
+        pubkey_t bad_leaf = leaves[i];
+        bad_leaf.key[bit / 8UL] ^= static_cast<uchar>(1U << (bit % 8UL));
+        TSDK_TEST(!Acc::verify(root, bad_leaf, i, p));
+        ulong h = rng.below(Depth);
+        proof[h].key[bit / 8UL] ^= static_cast<uchar>(1U << (bit % 8UL));
+        TSDK_TEST(!Acc::verify(root, leaves[i], i, p) && !acc.contains(leaves[i], i, p));
+        proof[h].key[bit / 8UL] ^= static_cast<uchar>(1U << (bit % 8UL));
+        ulong other = i ^ (1UL << rng.below(Depth));
+        TSDK_TEST(!Acc::verify(root, leaves[i], other, p));
+        TSDK_TEST(!Acc::verify(root, leaves[i], i + Acc::LEAF_CNT_MAX, p));
+      }
+
+      /* The empty slot after the last leaf is in the tree but not in
+         the list */
+      if (n < Acc::LEAF_CNT_MAX) {
+        std::vector<pubkey_t> proof = tree.proof(n);
+        typename Acc::Proof p(proof.data(), Depth);
+        TSDK_TEST(Acc::verify(root, pubkey_t{}, n, p) && !acc.contains(pubkey_t{}, n, p));
+      }
+    }
+
+    /* Joined again, it carries on from where it was */
+    Acc again = Acc::join(thru::Account(IDX), writable);
+    TSDK_TEST(again.size() == leaf_cnt && thru::pubkey_eq(again.root(), acc.root()));
+  });
+  TSDK_TEST(!ex.exited);
+}
+
+void test_roots() {
+  check_depth<1UL>(2UL, 1UL);
+  check_depth<5UL>(32UL, 2UL);
+  check_depth<10UL>(300UL, 3UL);
+  check_depth<32UL>(40UL, 4UL);
+  thru::test::pass("merkle roots");
+}
+
+void test_reverts() {
+  using Acc = thru::MerkleAccumulator<3UL>;
+  thru::host::init_txn(1U, 0U);
+  thru::host::set_account(IDX, thru::host::account_addrs()[1], 0UL);
+
+  /* Full after 2^Depth leaves */
+  thru::host::Exit ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Acc acc = Acc::format(thru::Account(IDX), writable);
+    for (ulong i = 0UL; i <= Acc::LEAF_CNT_MAX; i++) {
+      acc.append(pubkey_t{});
+    }
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_MERKLE_ERR_FULL);
+
+  /* A shallower one fits in the account but is not this accumulator */
+  ex = thru::host::run([] {
+    thru::WritableSet writable;
+    thru::MerkleAccumulator<2UL>::join(thru::Account(IDX), writable);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_MERKLE_ERR_INVALID);
+
+  /* Proofs are read in place; a short one reverts */
+  std::byte data[Acc::PROOF_SZ + 5UL] = {};
+  ex = thru::host::run([&] {
+    std::span<const std::byte> rest;
+    Acc::Proof p = Acc::proof(data, &rest);
+    TSDK_TEST(reinterpret_cast<std::byte const*>(p.data()) == data && rest.size() == 5UL);
+    Acc::proof(std::span<const std::byte>(data, Acc::PROOF_SZ - 1UL));
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_MERKLE_ERR_PROOF_TRUNCATED);
+
+  thru::test::pass("merkle reverts");
+}
+
+} // namespace
+
+int main() {
+  test_roots();
+  test_reverts();
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include "tn_sdk_pda.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* pda() and PdaOwner against the C SDK's
+   tsdk_create_program_defined_account_address.  The C SDK hashes with
+   the Zknh instructions and defines libc and tsdk_ symbols of its own,
+   so it cannot be linked into a host test; instead its derivation is
+   mirrored append by append, and pinned by addresses computed
+   independently from the same owner || is_ephemeral || seed bytes.
+   PdaOwner's precomputed prefix is also checked on its own, on every
+   length around the block boundaries. */
+
+namespace {
+
+struct Vector {
+  pubkey_t owner;
+  bool ephemeral;
+  uchar seed[TN_SEED_SIZE];
+  pubkey_t address;
+};
+
+constexpr pubkey_t ZERO_OWNER = {};
+constexpr pubkey_t SEQ_OWNER = {{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+                                 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+                                 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f}};
+constexpr pubkey_t ONES_OWNER = {{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+
+constexpr pubkey_t CONFIG_ADDR = {{0x61, 0x99, 0x22, 0x0d, 0x3e, 0xbd, 0x53, 0xfc,
+                                   0x25, 0x00, 0xa2, 0x2b, 0xe0, 0x03, 0x5e, 0xbb,
+                                   0x42, 0xe9, 0x16, 0x1c, 0x68, 0xa8, 0x86, 0x87,
+                                   0x92, 0x02, 0x78, 0x28, 0x20, 0xa3, 0x27, 0x28}};
+
+Vector const VECTORS[] = {
+    {ZERO_OWNER, false, {'c', 'o', 'n', 'f', 'i', 'g'}, CONFIG_ADDR},
+    {SEQ_OWNER, true, {'v', 'a', 'u', 'l', 't'},
+     {{0xb5, 0xb0, 0xb8, 0xeb, 0xb3, 0x18, 0xd3, 0xc2, 0xa0, 0xf7, 0x5d, 0x71, 0xd9, 0xa2, 0xd9, 0xd7,
+       0x5e, 0x29, 0x54, 0x35, 0xcf, 0xb7, 0x16, 0xf4, 0x03, 0xc9, 0x32, 0x40, 0xaa, 0xc1, 0x26, 0xc7}}},
+    {ONES_OWNER, false,
+     {0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+      0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f},
+     {{0x4a, 0x11, 0xa7, 0x1e, 0xc6, 0x45, 0xe0, 0x16, 0x6d, 0x90, 0x92, 0xb3, 0xab, 0x58, 0x67, 0x22,
+       0x56, 0xac, 0x2a, 0xbe, 0x94, 0x01, 0x45, 0xfd, 0x3e, 0xc2, 0x30, 0x57, 0xd9, 0x2f, 0x30, 0x89}}},
+    {SEQ_OWNER, false, {},
+     {{0x82, 0x7c, 0x9a, 0x7e, 0x4c, 0x98, 0xff, 0x98, 0x87, 0xc3, 0xa5, 0xed, 0xdf, 0xcd, 0xc5, 0x04,
+       0x5f, 0x1f, 0x4f, 0xd0, 0xf7, 0xd1, 0x13, 0x81, 0x7a, 0x82, 0xd8, 0xb4, 0x2e, 0x7e, 0x48, 0x5c}}},
+};
+
+/* The string-seed form folds to the same literal at compile time */
+static_assert(thru::pda<"config">(ZERO_OWNER).key == CONFIG_ADDR.key);
+
+/* tsdk_create_program_defined_account_address, step for step */
+pubkey_t c_sdk_pda(pubkey_t const& owner, uchar is_ephemeral, uchar const* seed) {
+  thru::crypto::Sha256 sha;
+  sha.append(&owner, sizeof(pubkey_t));
+  sha.append(&is_ephemeral, sizeof(uchar));
+  sha.append(seed, TN_SEED_SIZE);
+  return sha.fini();
+}
+
+using SeedSpan = std::span<const uchar, TN_SEED_SIZE>;
+
+void test_vectors() {
+  for (Vector const& v : VECTORS) {
+    uchar eph = v.ephemeral ? 1U : 0U;
+    TSDK_TEST(thru::pubkey_eq(c_sdk_pda(v.owner, eph, v.seed), v.address));
+    TSDK_TEST(thru::pubkey_eq(thru::pda(v.owner, SeedSpan(v.seed), v.ephemeral), v.address));
+    TSDK_TEST(thru::pubkey_eq(thru::PdaOwner(v.owner).derive(SeedSpan(v.seed), v.ephemeral),
+                              v.address));
+  }
+
+  /* String seeds at run time, with and without a PdaOwner */
+  TSDK_TEST(thru::pubkey_eq(thru::pda<"config">(VECTORS[0].owner), CONFIG_ADDR));
+  TSDK_TEST(thru::pubkey_eq(thru::PdaOwner(VECTORS[0].owner).derive<"config">(), CONFIG_ADDR));
+  TSDK_TEST(thru::pubkey_eq(thru::PdaOwner(VECTORS[1].owner).derive<"vault", true>(),
+                            VECTORS[1].address));
+  TSDK_TEST(!thru::pubkey_eq(thru::PdaOwner(VECTORS[1].owner).derive<"vault">(),
+                             VECTORS[1].address));
+  thru::test::pass("pda vectors");
+}
+
+pubkey_t random_key(thru::test::Rng& rng) {
+  pubkey_t key;
+  for (ulong i = 0UL; i < 32UL; i += 8UL) {
+    ulong w = rng.next();
+    std::memcpy(&key.key[i], &w, 8UL);
+  }
+  return key;
+}
+
+void test_random() {
+  thru::test::Rng rng(23UL);
+  for (ulong iter = 0UL; iter < 200UL; iter++) {
+    /* One owner, many seeds, as for one vault per user */
+    pubkey_t owner = random_key(rng);
+    thru::PdaOwner po(owner);
+    for (ulong i = 0UL; i < 50UL; i++) {
+      pubkey_t seed = random_key(rng);
+      bool eph = rng.below(2UL) != 0UL;
+      pubkey_t want = c_sdk_pda(owner, eph ? 1U : 0U, seed.key.data());
+      TSDK_TEST(thru::pubkey_eq(thru::pda(owner, SeedSpan(seed.key), eph), want));
+      TSDK_TEST(thru::pubkey_eq(po.derive(SeedSpan(seed.key), eph), want));
+    }
+  }
+  thru::test::pass("pda random");
+}
+
+/* Sha256::prefix32 and hash_prefixed, which PdaOwner is built on, for
+   any rest up to a few blocks: prefix || rest hashed in one go */
+void test_prefix() {
+  thru::test::Rng rng(24UL);
+  std::vector<uchar> msg(32UL + 4UL * TSDK_SHA256_BLOCK_SZ);
+  for (uchar& b : msg) {
+    b = static_cast<uchar>(rng.next());
+  }
+  thru::crypto::Sha256::Prefix32 prefix = thru::crypto::Sha256::prefix32(msg.data());
+  for (ulong rest_sz = 0UL; rest_sz + 32UL <= msg.size(); rest_sz++) {
+    pubkey_t want;
+    thru::crypto::Sha256::hash(msg.data(), 32UL + rest_sz, &want);
+    pubkey_t got;
+    TSDK_TEST(thru::crypto::Sha256::hash_prefixed(prefix, msg.data() + 32, rest_sz, &got) == &got);
+    TSDK_TEST(thru::pubkey_eq(got, want));
+  }
+  thru::test::pass("pda prefix");
+}
+
+} // namespace
+
+int main() {
+  test_vectors();
+  test_random();
+  test_prefix();
+  return 0;
+}
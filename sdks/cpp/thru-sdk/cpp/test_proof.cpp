@@ -0,0 +1,256 @@
+#include "tn_sdk_proof.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* StateProofView on proofs of each type with random path bitsets, cut
+   short at every length, followed by trailing bytes, and with type bits
+   3, against the layout of the Rust SDK's StateProof.  FIXTURE is shared
+   byte for byte with the tests in sdks/rust/core/src/types/state_proof.rs. */
+
+namespace {
+
+using Proof = thru::StateProofView;
+
+/* Updating proof at slot 0x0102030405 with path bits 29 and 136 set:
+   header, leaf hash, then two sibling hashes */
+constexpr uchar FIXTURE[] = {
+    0x05, 0x04, 0x03, 0x02, 0x01, 0x00, 0x00, 0x40, /* type_slot */
+    0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, /* path_bitset */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, /* leaf hash */
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, /* sibling 0 */
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, /* sibling 1 */
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+};
+static_assert(sizeof(FIXTURE) == 136UL);
+
+std::span<const std::byte> bytes(void const* p, ulong sz) {
+  return {static_cast<std::byte const*>(p), sz};
+}
+
+bool all(pubkey_t const& key, uchar b) {
+  for (uchar k : key.key) {
+    if (k != b) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Revert code of fn(), or TSDK_SUCCESS if it returns */
+template <typename F> ulong run_code(F&& fn) {
+  thru::host::Exit ex = thru::host::run([&] { fn(); });
+  TSDK_TEST(!ex.exited || ex.reverted);
+  return ex.exited ? ex.code : TSDK_SUCCESS;
+}
+
+void test_fixture() {
+  thru::host::init_txn(1U, 0U);
+  auto fixture = bytes(FIXTURE, sizeof(FIXTURE));
+  TSDK_TEST(run_code([&] {
+              Proof p(fixture);
+              TSDK_TEST(p.type() == Proof::Type::Updating && p.slot() == 0x0102030405UL);
+              TSDK_TEST(p.footprint() == sizeof(FIXTURE) && p.bytes().data() == fixture.data());
+              TSDK_TEST(p.path_bitset().key[3] == 0x20U && p.path_bitset().key[17] == 0x01U);
+              TSDK_TEST(all(p.existing_leaf_hash(), 0x11U));
+              TSDK_TEST(p.sibling_hashes().size() == 2UL && all(p.sibling_hashes()[0], 0x22U) &&
+                        all(p.sibling_hashes()[1], 0x33U));
+            }) == TSDK_SUCCESS);
+
+  /* Only an Updating proof */
+  TSDK_TEST(run_code([&] { Proof(fixture).existing_leaf_pubkey(); }) ==
+            TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+  TSDK_TEST(run_code([&] { Proof(fixture).expect(Proof::Type::Existing); }) ==
+            TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+  thru::test::pass("proof fixture");
+}
+
+/* A proof of type t at slot with a random path bitset; hash i of the
+   body is filled with byte i + 1 */
+std::vector<uchar> make(thru::test::Rng& rng, ulong t, ulong slot, ulong* sibling_cnt) {
+  tn_state_proof_hdr hdr;
+  hdr.type_slot = (t << 62) | slot;
+  ulong density = rng.below(5UL);
+  *sibling_cnt = 0UL;
+  for (ulong i = 0UL; i < 32UL; i++) {
+    uchar b = 0U;
+    for (ulong bit = 0UL; bit < 8UL; bit++) {
+      if (density == 4UL || rng.below(8UL) < density) {
+        b = static_cast<uchar>(b | (1U << bit));
+        (*sibling_cnt)++;
+      }
+    }
+    hdr.path_bitset.key[i] = b;
+  }
+  std::vector<uchar> proof(sizeof(hdr) + (t + *sibling_cnt) * 32UL);
+  std::memcpy(proof.data(), &hdr, sizeof(hdr));
+  for (ulong i = 0UL; i < t + *sibling_cnt; i++) {
+    std::memset(proof.data() + sizeof(hdr) + i * 32UL, static_cast<int>((i + 1UL) & 0xFFUL), 32UL);
+  }
+  return proof;
+}
+
+void test_types() {
+  thru::host::init_txn(1U, 0U);
+  thru::test::Rng rng(17UL);
+  constexpr Proof::Type TYPES[] = {Proof::Type::Existing, Proof::Type::Updating,
+                                   Proof::Type::Creation};
+  for (ulong iter = 0UL; iter < 600UL; iter++) {
+    ulong t = iter % 3UL;
+    ulong slot = rng.next() >> 2;
+    ulong sibling_cnt = 0UL;
+    std::vector<uchar> proof = make(rng, t, slot, &sibling_cnt);
+    auto data = bytes(proof.data(), proof.size());
+    TSDK_TEST(proof.size() <= Proof::FOOTPRINT_MAX);
+
+    TSDK_TEST(run_code([&] {
+                Proof p(data);
+                TSDK_TEST(p.type() == TYPES[t] && p.slot() == slot);
+                TSDK_TEST(p.footprint() == proof.size());
+                TSDK_TEST(std::memcmp(&p.path_bitset(), proof.data() + 8, 32UL) == 0);
+                std::span<const pubkey_t> sib = p.sibling_hashes();
+                TSDK_TEST(sib.size() == sibling_cnt);
+                for (ulong i = 0UL; i < sib.size(); i++) {
+                  TSDK_TEST(all(sib[i], static_cast<uchar>((t + i + 1UL) & 0xFFUL)));
+                }
+                if (t) {
+                  /* The leaf hash is the last entry ahead of the siblings */
+                  TSDK_TEST(all(p.existing_leaf_hash(), static_cast<uchar>(t)));
+                }
+                if (t == 2UL) {
+                  TSDK_TEST(all(p.existing_leaf_pubkey(), 1U));
+                }
+                TSDK_TEST(&p.expect(TYPES[t]) == &p);
+                TSDK_TEST(Proof::unchecked(proof.data()).footprint() == proof.size());
+              }) == TSDK_SUCCESS);
+
+    /* Accessors for another type revert */
+    if (!t) {
+      TSDK_TEST(run_code([&] { Proof(data).existing_leaf_hash(); }) ==
+                TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+    }
+    if (t != 2UL) {
+      TSDK_TEST(run_code([&] { Proof(data).existing_leaf_pubkey(); }) ==
+                TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+    }
+    TSDK_TEST(run_code([&] { Proof(data).expect(TYPES[(t + 1UL) % 3UL]); }) ==
+              TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+  }
+
+  /* Every path bit set: the largest proof */
+  std::vector<uchar> proof(Proof::FOOTPRINT_MAX, 0xFFU);
+  ulong type_slot = 2UL << 62;
+  std::memcpy(proof.data(), &type_slot, 8UL);
+  TSDK_TEST(run_code([&] {
+              Proof p(bytes(proof.data(), proof.size()));
+              TSDK_TEST(p.sibling_hashes().size() == TN_STATE_PROOF_KEYS_MAX);
+            }) == TSDK_SUCCESS);
+  thru::test::pass("proof types");
+}
+
+void test_sizes() {
+  thru::host::init_txn(1U, 0U);
+  thru::test::Rng rng(18UL);
+  for (ulong iter = 0UL; iter < 60UL; iter++) {
+    ulong t = iter % 3UL;
+    ulong sibling_cnt = 0UL;
+    std::vector<uchar> proof = make(rng, t, rng.next() >> 2, &sibling_cnt);
+    ulong sz = proof.size();
+
+    /* Cut short anywhere: the header first, then the hashes */
+    for (ulong cut = 0UL; cut < sz; cut += 1UL + rng.below(24UL)) {
+      ulong want = cut < Proof::HDR_SZ ? TSDK_STATE_PROOF_ERR_TRUNCATED
+                                       : TSDK_STATE_PROOF_ERR_MIS_SIZED;
+      TSDK_TEST(run_code([&] { Proof(bytes(proof.data(), cut)); }) == want);
+      TSDK_TEST(run_code([&] { Proof::prefix(bytes(proof.data(), cut)); }) == want);
+    }
+    TSDK_TEST(run_code([&] { Proof(bytes(proof.data(), sz - 1UL)); }) ==
+              (sz > Proof::HDR_SZ ? TSDK_STATE_PROOF_ERR_MIS_SIZED : TSDK_STATE_PROOF_ERR_TRUNCATED));
+
+    /* Trailing bytes: a whole proof is mis-sized, a prefix hands them
+       back */
+    ulong extra = 1UL + rng.below(100UL);
+    proof.resize(sz + extra, 0xEEU);
+    auto data = bytes(proof.data(), proof.size());
+    TSDK_TEST(run_code([&] { Proof p(data); }) == TSDK_STATE_PROOF_ERR_MIS_SIZED);
+    TSDK_TEST(run_code([&] {
+                std::span<const std::byte> rest;
+                Proof p = Proof::prefix(data, &rest);
+                TSDK_TEST(p.footprint() == sz && p.bytes().size() == sz);
+                TSDK_TEST(rest.data() == data.data() + sz && rest.size() == extra);
+                TSDK_TEST(Proof::prefix(data).footprint() == sz);
+              }) == TSDK_SUCCESS);
+
+    /* Type bits 3 are no proof, whatever follows */
+    proof[7] = static_cast<uchar>(proof[7] | 0xC0U);
+    TSDK_TEST(run_code([&] { Proof::prefix(data); }) == TSDK_STATE_PROOF_ERR_INVALID_TYPE);
+    TSDK_TEST(run_code([&] { Proof(bytes(proof.data(), Proof::HDR_SZ)); }) ==
+              TSDK_STATE_PROOF_ERR_INVALID_TYPE);
+  }
+  thru::test::pass("proof sizes");
+}
+
+void test_syscalls() {
+  thru::host::init_txn(1U, 0U);
+  thru::test::Rng rng(19UL);
+  std::vector<uchar> proofs[3];
+  for (ulong t = 0UL; t < 3UL; t++) {
+    ulong sibling_cnt = 0UL;
+    proofs[t] = make(rng, t, 7UL, &sibling_cnt);
+  }
+  auto view = [&](ulong t) { return Proof::unchecked(proofs[t].data()); };
+  std::byte seed[TN_SEED_SIZE] = {};
+  std::byte meta[sizeof(tn_account_meta)] = {};
+
+  /* Each operation takes its own types to the syscall and reverts on
+     the rest without making it */
+  struct Case {
+    ulong code;
+    bool ok[3];
+  };
+  Case const cases[] = {
+      {TN_SYSCALL_CODE_ACCOUNT_CREATE, {false, false, true}},
+      {TN_SYSCALL_CODE_ACCOUNT_COMPRESS, {false, true, true}},
+      {TN_SYSCALL_CODE_ACCOUNT_DECOMPRESS, {true, false, false}},
+  };
+  for (Case const& c : cases) {
+    for (ulong t = 0UL; t < 3UL; t++) {
+      thru::host::reset_syscall_cnts();
+      ulong code = run_code([&] {
+        Proof p = view(t);
+        if (c.code == TN_SYSCALL_CODE_ACCOUNT_CREATE) {
+          thru::syscall::account_create(2UL, seed, p);
+        } else if (c.code == TN_SYSCALL_CODE_ACCOUNT_COMPRESS) {
+          thru::syscall::account_compress(2UL, p);
+        } else {
+          thru::syscall::account_decompress(2UL, meta, {}, p);
+        }
+      });
+      TSDK_TEST(code == (c.ok[t] ? TSDK_SUCCESS : TSDK_STATE_PROOF_ERR_WRONG_TYPE));
+      TSDK_TEST(thru::host::syscall_cnt(c.code) == (c.ok[t] ? 1UL : 0UL));
+    }
+  }
+  thru::test::pass("proof syscalls");
+}
+
+} // namespace
+
+int main() {
+  test_fixture();
+  test_types();
+  test_sizes();
+  test_syscalls();
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include "tn_sdk_resumable.hpp"
+#include "host/tn_sdk_test.hpp"
+
+/* Resumable: a job run over several transactions, the sequence guard
+   and both budgets */
+
+namespace {
+
+struct Sum {
+  ulong total;
+  ulong item_cnt;
+};
+
+using Job = thru::Resumable<Sum>;
+
+constexpr ushort JOB_ACC = 2U;
+
+thru::Step add_item(Sum& s, ulong cursor) {
+  s.total += cursor + 1UL;
+  return cursor + 1UL == s.item_cnt ? thru::Step::DONE : thru::Step::CONTINUE;
+}
+
+ulong seq() { return thru::host::account_meta(JOB_ACC)->seq; }
+
+/* The VM bumps seq when a transaction that wrote the account lands */
+void land() { thru::host::account_meta(JOB_ACC)->seq++; }
+
+void test_resume() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::set_account(JOB_ACC, thru::host::account_addrs()[1], Job::FOOTPRINT);
+
+  /* Start and take the 3 steps 35 CUs pay for at 10 each */
+  ulong observed = seq();
+  bool done = true;
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    job.start(Sum{0UL, 10UL});
+    thru::ComputeBudget budget(35UL, 10UL);
+    done = job.run(observed, budget, add_item);
+    TSDK_TEST(budget.left() == 5UL);
+  });
+  TSDK_TEST(!ex.exited);
+  TSDK_TEST(!done);
+  land();
+
+  /* A resumer that saw the account before that transaction is stale */
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    thru::StepBudget budget(100UL);
+    job.run(observed, budget, add_item);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_RESUMABLE_ERR_STALE);
+
+  /* 2 steps, each charged 10 plus 30 for its item */
+  observed = seq();
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    TSDK_TEST(job.cursor() == 3UL);
+    thru::ComputeBudget budget(100UL, 10UL);
+    done = job.run(observed, budget, [&](Sum& s, ulong cursor) {
+      budget.charge(30UL);
+      return add_item(s, cursor);
+    });
+  });
+  TSDK_TEST(!ex.exited);
+  TSDK_TEST(!done);
+  land();
+
+  /* The rest */
+  observed = seq();
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    thru::StepBudget budget(100UL);
+    done = job.run(observed, budget, add_item);
+    TSDK_TEST(job.cursor() == 10UL);
+    TSDK_TEST(job.runs() == 3UL);
+    TSDK_TEST(job.state().total == 55UL);
+  });
+  TSDK_TEST(!ex.exited);
+  TSDK_TEST(done);
+  land();
+
+  /* Nothing left to run */
+  observed = seq();
+  ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    thru::StepBudget budget(1UL);
+    job.run(observed, budget, add_item);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_RESUMABLE_ERR_NOT_RUNNING);
+
+  thru::test::pass("resumable resume");
+}
+
+void test_no_progress() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::set_account(JOB_ACC, thru::host::account_addrs()[1], Job::FOOTPRINT);
+
+  ulong observed = seq();
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    Job job(thru::Account(JOB_ACC), writable);
+    job.start(Sum{0UL, 10UL});
+    thru::ComputeBudget budget(9UL, 10UL);
+    job.run(observed, budget, add_item);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_RESUMABLE_ERR_NO_PROGRESS);
+
+  thru::test::pass("resumable no progress");
+}
+
+} // namespace
+
+int main() {
+  test_resume();
+  test_no_progress();
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include "tn_sdk_rle.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/* RLE: the C SDK's word-at-a-time tn_rle encode/decode against a per-bit
+   reference, and the thru::rle ranges over what it encodes */
+
+/* tn_rle.h, with the tn_rle_t layout left to thru::rle::Rle */
+extern "C" {
+int tn_rle_encode(void* rle, ushort max_runs, ulong const* bitset, ulong bit_count);
+int tn_rle_decode(void const* rle, ulong* bitset, ulong max_bits, ulong* out_bit_count);
+int tn_rle_decode_bytes(void const* rle, uchar* bitset, ulong max_bits, ulong* out_bit_count);
+}
+
+namespace {
+
+constexpr int RLE_SUCCESS = 0;
+constexpr int RLE_ERR_RUNS_TOO_SMALL = -1;
+constexpr int RLE_ERR_BITSET_TOO_SMALL = -2;
+
+constexpr ulong MAX_RUNS = 8192UL;
+
+alignas(8) ushort rle_mem[2UL + MAX_RUNS];
+
+bool bit(std::vector<ulong> const& words, ulong i) {
+  return (words[i / 64UL] >> (63UL - i % 64UL)) & 1UL;
+}
+
+/* The per-bit encoder tn_rle_encode replaced, with its run splitting:
+   first_bit then the runs, alternating in value */
+std::vector<ushort> ref_encode(std::vector<ulong> const& words, ulong bit_count) {
+  std::vector<ushort> runs;
+  if (!bit_count) {
+    runs.push_back(0U);
+    return runs;
+  }
+  runs.push_back(static_cast<ushort>(bit(words, 0UL)));
+  ulong len = 0UL;
+  for (ulong i = 0UL; i <= bit_count; i++) {
+    if (i < bit_count && (!i || bit(words, i) == bit(words, i - 1UL))) {
+      len++;
+      continue;
+    }
+    for (; len > thru::rle::RUN_MAX; len -= thru::rle::RUN_MAX) {
+      runs.push_back(static_cast<ushort>(thru::rle::RUN_MAX));
+      runs.push_back(0U);
+    }
+    runs.push_back(static_cast<ushort>(len));
+    len = 1UL;
+  }
+  return runs;
+}
+
+/* Random runs: mostly short, with the odd one past RUN_MAX.  Bits past
+   bit_count are random too, and must be ignored. */
+std::vector<ulong> random_bits(thru::test::Rng& rng, ulong bit_count) {
+  std::vector<ulong> words(bit_count / 64UL + 2UL);
+  for (ulong& w : words) {
+    w = rng.next();
+  }
+  bool val = rng.below(2UL);
+  for (ulong i = 0UL; i < bit_count;) {
+    ulong kind = rng.below(100UL);
+    ulong len = kind < 60UL   ? 1UL + rng.below(8UL)
+                : kind < 97UL ? 1UL + rng.below(300UL)
+                : kind < 99UL ? 1UL + rng.below(5000UL)
+                              : thru::rle::RUN_MAX - 2UL + rng.below(2UL * thru::rle::RUN_MAX);
+    for (ulong end = i + len; i < end && i < bit_count; i++) {
+      ulong mask = 1UL << (63UL - i % 64UL);
+      words[i / 64UL] = val ? words[i / 64UL] | mask : words[i / 64UL] & ~mask;
+    }
+    val = !val;
+  }
+  return words;
+}
+
+void check_encode(std::vector<ulong> const& words, ulong bit_count) {
+  std::vector<ushort> ref = ref_encode(words, bit_count);
+  ulong run_cnt = ref.size() - 1UL;
+  TSDK_TEST(run_cnt <= MAX_RUNS);
+
+  TSDK_TEST(tn_rle_encode(rle_mem, static_cast<ushort>(run_cnt), words.data(), bit_count) ==
+            RLE_SUCCESS);
+  thru::rle::Rle rle = thru::rle::Rle::unchecked(rle_mem);
+  TSDK_TEST(rle.first_bit() == (ref[0] != 0U));
+  TSDK_TEST(rle.run_count() == run_cnt);
+  for (ulong i = 0UL; i < run_cnt; i++) {
+    TSDK_TEST(rle.run(i) == ref[i + 1UL]);
+  }
+  TSDK_TEST(rle.total_bits() == bit_count);
+
+  if (run_cnt) {
+    TSDK_TEST(tn_rle_encode(rle_mem, static_cast<ushort>(run_cnt - 1UL), words.data(),
+                            bit_count) == RLE_ERR_RUNS_TOO_SMALL);
+    tn_rle_encode(rle_mem, static_cast<ushort>(run_cnt), words.data(), bit_count);
+  }
+}
+
+/* rle_mem holds the encoding of words[0, bit_count) */
+void check_decode(thru::test::Rng& rng, std::vector<ulong> const& words, ulong bit_count) {
+  ulong word_cnt = bit_count / 64UL + 2UL;
+  ulong out_cnt = ~0UL;
+
+  std::vector<ulong> out(word_cnt, 0UL);
+  TSDK_TEST(tn_rle_decode(rle_mem, out.data(), bit_count + rng.below(64UL), &out_cnt) ==
+            RLE_SUCCESS);
+  TSDK_TEST(out_cnt == bit_count);
+  for (ulong i = 0UL; i < word_cnt * 64UL; i++) {
+    TSDK_TEST(bit(out, i) == (i < bit_count && bit(words, i)));
+  }
+
+  /* Merges into what is already there */
+  std::vector<ulong> merged(word_cnt);
+  for (ulong& w : merged) {
+    w = rng.next();
+  }
+  std::vector<ulong> before = merged;
+  TSDK_TEST(tn_rle_decode(rle_mem, merged.data(), bit_count, &out_cnt) == RLE_SUCCESS);
+  for (ulong w = 0UL; w < word_cnt; w++) {
+    TSDK_TEST(merged[w] == (before[w] | out[w]));
+  }
+
+  std::vector<uchar> bytes(word_cnt * 8UL, 0xEEU);
+  ulong max_bits = bit_count + rng.below(16UL);
+  TSDK_TEST(tn_rle_decode_bytes(rle_mem, bytes.data(), max_bits, &out_cnt) == RLE_SUCCESS);
+  TSDK_TEST(out_cnt == bit_count);
+  for (ulong i = 0UL; i < (max_bits + 7UL) / 8UL * 8UL; i++) {
+    bool b = (bytes[i / 8UL] >> (7UL - i % 8UL)) & 1U;
+    TSDK_TEST(b == (i < bit_count && bit(words, i)));
+  }
+  TSDK_TEST(bytes[(max_bits + 7UL) / 8UL] == 0xEEU);
+
+  if (bit_count) {
+    TSDK_TEST(tn_rle_decode(rle_mem, out.data(), bit_count - 1UL, &out_cnt) ==
+              RLE_ERR_BITSET_TOO_SMALL);
+    TSDK_TEST(tn_rle_decode_bytes(rle_mem, bytes.data(), bit_count - 1UL, &out_cnt) ==
+              RLE_ERR_BITSET_TOO_SMALL);
+  }
+}
+
+/* rle_mem holds the encoding of words[0, bit_count) */
+void check_ranges(thru::test::Rng& rng, std::vector<ulong> const& words, ulong bit_count) {
+  thru::rle::Rle rle(std::span<const std::byte>(reinterpret_cast<std::byte const*>(rle_mem),
+                                                sizeof(rle_mem)));
+  ulong limit = rng.below(4UL) ? bit_count : rng.below(bit_count + 1UL);
+
+  ulong next_set = 0UL;
+  for (ulong idx : rle.set_bits(limit)) {
+    for (; next_set < idx; next_set++) {
+      TSDK_TEST(!bit(words, next_set));
+    }
+    TSDK_TEST(idx < limit && bit(words, idx));
+    next_set = idx + 1UL;
+  }
+  for (; next_set < limit; next_set++) {
+    TSDK_TEST(!bit(words, next_set));
+  }
+
+  ulong clear_cnt = 0UL;
+  for (ulong idx : rle.clear_bits(limit)) {
+    TSDK_TEST(idx < limit && !bit(words, idx));
+    clear_cnt++;
+  }
+
+  /* Maximal runs: each is bounded by the other value, the limit or the
+     end, and together they cover every set bit */
+  ulong set_cnt = 0UL;
+  ulong prev_end = 0UL;
+  for (thru::rle::Run run : rle.set_runs(limit)) {
+    TSDK_TEST(run.len && run.start >= prev_end && run.start + run.len <= limit);
+    TSDK_TEST(!run.start || !bit(words, run.start - 1UL));
+    TSDK_TEST(run.start + run.len == limit || !bit(words, run.start + run.len));
+    for (ulong i = run.start; i < run.start + run.len; i++) {
+      TSDK_TEST(bit(words, i));
+    }
+    set_cnt += run.len;
+    prev_end = run.start + run.len;
+  }
+  TSDK_TEST(set_cnt + clear_cnt == limit);
+}
+
+void test_random() {
+  thru::test::Rng rng(13UL);
+  ulong split_cnt = 0UL;
+  for (ulong iter = 0UL; iter < 3000UL; iter++) {
+    ulong bit_count = iter < 200UL ? iter : rng.below(iter % 50UL ? 4096UL : 400000UL);
+    std::vector<ulong> words = random_bits(rng, bit_count);
+    std::vector<ushort> ref = ref_encode(words, bit_count);
+    if (ref.size() - 1UL > MAX_RUNS) {
+      continue;
+    }
+    split_cnt += std::find(ref.begin() + 1, ref.end(), 0U) != ref.end();
+    check_encode(words, bit_count);
+    check_decode(rng, words, bit_count);
+    check_ranges(rng, words, bit_count);
+  }
+  /* Long runs were split */
+  TSDK_TEST(split_cnt);
+  thru::test::pass("rle random");
+}
+
+} // namespace
+
+int main() {
+  test_random();
+  return 0;
+}
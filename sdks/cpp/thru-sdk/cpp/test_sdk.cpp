@@ -0,0 +1,358 @@
+#include "tn_sdk.hpp"
+#include "tn_sdk_invoke.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+/* The tn_sdk.hpp helpers against the plain SDK calls they stand in for:
+   AuthCache against tsdk_is_account_authorized_by_idx and _by_pubkey
+   on random call chains, auth lists and owners, and AccountIndex
+   against a scan for the first equal address, on transactions with
+   repeated addresses and addresses sharing their first 8 bytes.
+   AccountView and AccountViewMut are checked against the account's
+   bytes and the host's syscall counts. */
+
+namespace {
+
+/* What a query returned, or the code it reverted with */
+struct Answer {
+  bool authorized;
+  ulong revert;
+
+  bool operator==(Answer const&) const = default;
+};
+
+template <typename F> Answer ask(F const& query) {
+  bool authorized = false;
+  thru::host::Exit ex = thru::host::run([&] { authorized = query(); });
+  TSDK_TEST(!ex.exited || ex.reverted);
+  return Answer{ex.exited ? false : authorized, ex.exited ? ex.code : 0UL};
+}
+
+constexpr ulong DEPTH_MAX = 6UL;
+using Auth = thru::InvokeAuth<6, 4>;
+
+/* An auth list of random entries, now and then past the last account */
+void fill(thru::test::Rng& rng, Auth& auth, ushort acct_cnt) {
+  auth.clear();
+  auto pick = [&] {
+    return static_cast<ushort>(rng.below(16UL) ? rng.below(acct_cnt) : acct_cnt + rng.below(2UL));
+  };
+  for (ulong i = rng.below(7UL); i > 0UL; i--) {
+    auth.authorize(pick());
+  }
+  for (ulong i = rng.below(5UL); i > 0UL; i--) {
+    auth.deauthorize(pick());
+  }
+}
+
+/* Enters a frame running a random account, passing one of auths or
+   nothing */
+void call(thru::test::Rng& rng, Auth& auth, ushort acct_cnt) {
+  fill(rng, auth, acct_cnt);
+  thru::host::push_frame(static_cast<ushort>(rng.below(acct_cnt)),
+                         rng.below(4UL) ? auth.get() : nullptr);
+}
+
+void test_auth_cache() {
+  thru::test::Rng rng(3UL);
+  for (ulong iter = 0UL; iter < 3000UL; iter++) {
+    /* Now and then more than 64 accounts, so the bitsets span words */
+    ushort rw = static_cast<ushort>(rng.below(8UL) ? rng.below(10UL) : 60UL + rng.below(40UL));
+    ushort ro = static_cast<ushort>(rng.below(6UL));
+    thru::host::init_txn(rw, ro);
+    ushort acct_cnt = static_cast<ushort>(2U + rw + ro);
+    pubkey_t* accs = thru::host::account_addrs();
+
+    std::array<Auth, DEPTH_MAX + 1UL> auths{};
+    ulong depth = 1UL + rng.below(DEPTH_MAX);
+    for (ulong d = 1UL; d < depth; d++) {
+      call(rng, auths[d - 1UL], acct_cnt);
+    }
+
+    /* Owners are mostly programs on the stack, so auth entries are a
+       mix of owned and unowned */
+    tsdk_shadow_stack* ss = thru::host::shadow_stack();
+    for (ushort idx = 2U; idx < acct_cnt; idx++) {
+      ushort owner = rng.below(3UL) ? ss->stack_frames[1UL + rng.below(ss->call_depth)].program_acc_idx
+                                    : static_cast<ushort>(rng.below(acct_cnt));
+      pubkey_t key = accs[owner];
+      thru::host::set_account(idx, key, 0UL);
+    }
+
+    /* Queried in random order, so any query may be the one that builds
+       the cache, and past the last account */
+    thru::AuthCache cache;
+    std::vector<Answer> answers(acct_cnt + 2UL);
+    for (ulong q = 0UL; q < answers.size(); q++) {
+      ushort idx = static_cast<ushort>(rng.below(answers.size()));
+      Answer want = ask([&] { return idx < acct_cnt && tsdk_is_account_authorized_by_idx(idx); });
+      answers[idx] = ask([&] { return cache.is_authorized(idx); });
+      TSDK_TEST(answers[idx] == want);
+    }
+    for (ushort idx = 0U; idx < answers.size(); idx++) {
+      answers[idx] = ask([&] { return cache.is_authorized(idx); });
+      TSDK_TEST(answers[idx] ==
+                ask([&] { return idx < acct_cnt && tsdk_is_account_authorized_by_idx(idx); }));
+    }
+
+    /* By pubkey, with and without an index, for accounts and strangers */
+    ushort slots[256];
+    thru::transaction::AccountIndex index(slots, 256UL);
+    for (ulong q = 0UL; q < 8UL; q++) {
+      pubkey_t key = accs[rng.below(acct_cnt)];
+      if (!rng.below(4UL)) {
+        key.ul[rng.below(4UL)] ^= 1UL + rng.below(1000UL);
+      }
+      Answer want = ask([&] { return tsdk_is_account_authorized_by_pubkey(&key) != 0; });
+      TSDK_TEST(ask([&] { return cache.is_authorized(key); }) == want);
+      TSDK_TEST(ask([&] { return cache.is_authorized(key, index); }) == want);
+    }
+
+    /* Built once: a call chain changed afterwards does not move it,
+       though a new cache sees the change */
+    if (ss->call_depth < DEPTH_MAX) {
+      call(rng, auths[ss->call_depth - 1UL], acct_cnt);
+    } else {
+      thru::host::pop_frame();
+    }
+    if (acct_cnt > 2U) {
+      thru::host::set_account(static_cast<ushort>(2U + rng.below(acct_cnt - 2U)), accs[1], 0UL);
+    }
+    thru::AuthCache fresh;
+    for (ushort idx = 0U; idx < answers.size(); idx++) {
+      TSDK_TEST(ask([&] { return cache.is_authorized(idx); }) == answers[idx]);
+      TSDK_TEST(ask([&] { return fresh.is_authorized(idx); }) ==
+                ask([&] { return idx < acct_cnt && tsdk_is_account_authorized_by_idx(idx); }));
+    }
+  }
+  thru::test::pass("sdk auth cache");
+}
+
+/* The first account with address key, by memcmp */
+ushort scan(pubkey_t const& key, ushort acct_cnt) {
+  pubkey_t const* accs = thru::host::account_addrs();
+  for (ushort i = 0U; i < acct_cnt; i++) {
+    if (std::memcmp(&accs[i], &key, sizeof(pubkey_t)) == 0) {
+      return i;
+    }
+  }
+  return TSDK_ACCOUNT_IDX_NONE;
+}
+
+/* Slots for acct_cnt accounts: the smallest power of two above twice
+   the count */
+ulong slots_for(ushort acct_cnt) {
+  ulong slot_cnt = 1UL;
+  while (slot_cnt <= 2UL * acct_cnt) {
+    slot_cnt <<= 1;
+  }
+  return slot_cnt;
+}
+
+void test_account_index() {
+  thru::test::Rng rng(4UL);
+  for (ulong iter = 0UL; iter < 2000UL; iter++) {
+    ushort rw = static_cast<ushort>(rng.below(8UL) ? rng.below(16UL) : 100UL + rng.below(100UL));
+    ushort ro = static_cast<ushort>(rng.below(8UL));
+    thru::host::init_txn(rw, ro);
+    ushort acct_cnt = static_cast<ushort>(2U + rw + ro);
+    pubkey_t* accs = thru::host::account_addrs();
+
+    /* Repeats, which resolve to the lowest index, and shared prefixes,
+       which only the 32-byte confirm tells apart */
+    for (ulong i = rng.below(6UL); i > 0UL; i--) {
+      pubkey_t const& from = accs[rng.below(acct_cnt)];
+      pubkey_t& to = accs[rng.below(acct_cnt)];
+      if (rng.below(2UL)) {
+        to = from;
+      } else {
+        to.ul[0] = from.ul[0];
+      }
+    }
+
+    /* Addresses, and strangers that share an address's prefix or not */
+    std::vector<pubkey_t> keys;
+    for (ulong i = 0UL; i < 32UL; i++) {
+      keys.push_back(accs[rng.below(acct_cnt)]);
+      if (!rng.below(3UL)) {
+        keys.back().ul[rng.below(4UL)] ^= 1UL << rng.below(64UL);
+      }
+    }
+
+    /* A caller buffer of the smallest size or larger, dirty before the
+       build */
+    std::vector<ushort> slots(slots_for(acct_cnt) << rng.below(3UL), 0xFFFFU);
+    thru::InvokeAuth<0, 4> auth;
+    for (ulong i = rng.below(5UL); i > 0UL; i--) {
+      auth.deauthorize(static_cast<ushort>(rng.below(acct_cnt)));
+    }
+    thru::host::push_frame(static_cast<ushort>(rng.below(acct_cnt)), auth.get());
+
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::mem::Arena arena;
+      thru::transaction::AccountIndex by_arena(arena);
+      thru::transaction::AccountIndex by_buf(slots.data(), slots.size());
+      for (pubkey_t const& key : keys) {
+        ushort want = scan(key, acct_cnt);
+        TSDK_TEST(by_arena.find(key) == want && by_buf.find(key) == want);
+        TSDK_TEST(by_arena.contains(key) == (want != TSDK_ACCOUNT_IDX_NONE));
+        TSDK_TEST(thru::transaction::find_account_idx(key) == want);
+        TSDK_TEST(thru::transaction::is_authorized(key, by_buf) ==
+                  (tsdk_is_account_authorized_by_pubkey(&key) != 0));
+      }
+    });
+    TSDK_TEST(!ex.exited);
+  }
+  thru::test::pass("sdk account index");
+}
+
+void test_account_index_too_small() {
+  thru::test::Rng rng(5UL);
+  for (ushort acct_cnt = 2U; acct_cnt < 300U; acct_cnt = static_cast<ushort>(acct_cnt + 1U + rng.below(16UL))) {
+    thru::host::init_txn(static_cast<ushort>(acct_cnt - 2U), 0U);
+    ulong slot_cnt = slots_for(acct_cnt);
+    std::vector<ushort> slots(2UL * slot_cnt);
+
+    /* Half the smallest size, or not a power of two: reverts on the
+       first find(), not before */
+    for (ulong bad : {slot_cnt / 2UL, slot_cnt + 1UL, 2UL * slot_cnt - 1UL}) {
+      bool built = false;
+      thru::host::Exit ex = thru::host::run([&] {
+        thru::transaction::AccountIndex index(slots.data(), bad);
+        built = true;
+        index.find(thru::host::account_addrs()[0]);
+      });
+      TSDK_TEST(built && ex.reverted && ex.code == TSDK_ACCOUNT_INDEX_ERR_TOO_SMALL);
+    }
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::transaction::AccountIndex index(slots.data(), slot_cnt);
+      TSDK_TEST(index.find(thru::host::account_addrs()[acct_cnt - 1U]) == acct_cnt - 1U);
+    });
+    TSDK_TEST(!ex.exited);
+  }
+  thru::test::pass("sdk account index too small");
+}
+
+struct Layout {
+  ulong a;
+  uint b;
+  uint c;
+};
+
+constexpr ushort RW_CNT = 4U;
+constexpr ushort RO_CNT = 2U;
+
+/* Reads through a view of a random account of random size: the bytes
+   under the layout and the tail, or TOO_SMALL before any access */
+void test_account_view() {
+  thru::test::Rng rng(6UL);
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  for (ulong iter = 0UL; iter < 2000UL; iter++) {
+    ushort idx = static_cast<ushort>(rng.below(2U + RW_CNT + RO_CNT));
+    ulong sz = rng.below(2UL * sizeof(Layout) + 8UL);
+    thru::host::set_account(idx, thru::host::account_addrs()[1], sz);
+    uchar* data = thru::host::account_data(idx);
+    for (ulong i = 0UL; i < sz; i++) {
+      data[i] = static_cast<uchar>(rng.next());
+    }
+    Layout want;
+    std::memcpy(&want, data, sizeof(Layout));
+
+    bool built = false;
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::AccountView<Layout> view{thru::Account(idx)};
+      built = true;
+      TSDK_TEST(view.index() == idx && view.data_sz() == sz);
+      TSDK_TEST(view->a == want.a && (*view).b == want.b && view.get()->c == want.c);
+      std::span<const std::byte> tail = view.tail();
+      TSDK_TEST(reinterpret_cast<uchar const*>(tail.data()) == data + sizeof(Layout) &&
+                tail.size() == sz - sizeof(Layout));
+    });
+    if (sz < sizeof(Layout)) {
+      TSDK_TEST(!built && ex.reverted && ex.code == TSDK_ACCOUNT_VIEW_ERR_TOO_SMALL);
+    } else {
+      TSDK_TEST(built && !ex.exited);
+    }
+  }
+  thru::test::pass("sdk account view");
+}
+
+/* Writes through views built and upgraded repeatedly over a few
+   accounts: one promotion per account whatever the view count, the
+   writes landing in the account, and read-only accounts reverting
+   NOT_WRITABLE on the promotion */
+void test_account_view_mut() {
+  thru::test::Rng rng(7UL);
+  thru::host::init_txn(RW_CNT, RO_CNT);
+  for (ulong iter = 0UL; iter < 2000UL; iter++) {
+    ushort idxs[3];
+    ulong sizes[3];
+    for (ulong i = 0UL; i < 3UL; i++) {
+      idxs[i] = static_cast<ushort>(2U + rng.below(RW_CNT + (rng.below(8UL) ? 0U : RO_CNT)));
+      sizes[i] = rng.below(16UL) ? sizeof(Layout) + rng.below(16UL) : rng.below(sizeof(Layout));
+    }
+    /* An account's last size is the one it has */
+    for (ulong i = 0UL; i < 3UL; i++) {
+      thru::host::set_account(idxs[i], thru::host::account_addrs()[1], sizes[i]);
+    }
+    ulong promoted = 0UL;
+    ulong want_code = 0UL;
+    for (ulong i = 0UL; i < 3UL && !want_code; i++) {
+      ulong sz = thru::host::account_meta(idxs[i])->data_sz;
+      bool seen = (i > 0UL && idxs[i - 1UL] == idxs[i]) || (i > 1UL && idxs[0] == idxs[i]);
+      if (sz < sizeof(Layout)) {
+        want_code = TSDK_ACCOUNT_VIEW_ERR_TOO_SMALL;
+      } else if (!seen) {
+        promoted++;
+        if (idxs[i] >= 2U + RW_CNT) {
+          want_code = TSDK_ACCOUNT_VIEW_ERR_NOT_WRITABLE;
+        }
+      }
+    }
+
+    /* What each account should hold after the writes */
+    Layout last[2U + RW_CNT + RO_CNT];
+    thru::host::reset_syscall_cnts();
+    thru::host::Exit ex = thru::host::run([&] {
+      thru::WritableSet writable;
+      for (ulong i = 0UL; i < 3UL; i++) {
+        for (ulong k = 1UL + rng.below(4UL); k > 0UL; k--) {
+          Layout& l = last[idxs[i]];
+          l = Layout{rng.next(), static_cast<uint>(i), static_cast<uint>(k)};
+          if (rng.below(2UL)) {
+            thru::AccountView<Layout> view{thru::Account(idxs[i])};
+            thru::AccountViewMut<Layout> mut(view, writable);
+            *mut = l;
+          } else {
+            thru::AccountViewMut<Layout> mut{thru::Account(idxs[i]), writable};
+            mut->a = l.a;
+            mut.get()->b = l.b;
+            (*mut).c = l.c;
+            TSDK_TEST(mut.tail().size() == mut.data_sz() - sizeof(Layout));
+          }
+          TSDK_TEST(writable.is_promoted(idxs[i]));
+        }
+      }
+    });
+    TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_SET_ACCOUNT_DATA_WRITABLE) == promoted);
+    TSDK_TEST(ex.exited == (want_code != 0UL) && (!ex.exited || ex.code == want_code));
+    for (ulong i = 0UL; i < 3UL && !want_code; i++) {
+      TSDK_TEST(std::memcmp(thru::host::account_data(idxs[i]), &last[idxs[i]], sizeof(Layout)) == 0);
+    }
+  }
+  thru::test::pass("sdk account view mut");
+}
+
+} // namespace
+
+int main() {
+  test_auth_cache();
+  test_account_index();
+  test_account_index_too_small();
+  test_account_view();
+  test_account_view_mut();
+  return 0;
+}
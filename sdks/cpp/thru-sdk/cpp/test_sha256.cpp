@@ -0,0 +1,170 @@
+#include "tn_sdk_sha256.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <cstring>
+#include <vector>
+
+/* Sha256 on the FIPS 180-2 example messages and one million 'a's, and
+   every length from 0 to 299 bytes through each entry point (one-shot,
+   streamed in random pieces, hash_many, hash_prefixed, constexpr),
+   pinned by the digest of all 300 digests computed independently */
+
+namespace {
+
+using thru::crypto::Sha256;
+
+constexpr uchar nibble(char c) {
+  return static_cast<uchar>(c <= '9' ? c - '0' : c - 'a' + 10);
+}
+
+constexpr pubkey_t digest(char const (&hex)[65]) {
+  pubkey_t out{};
+  for (ulong i = 0UL; i < 32UL; i++) {
+    out.key[i] = static_cast<uchar>(nibble(hex[2UL * i]) << 4 | nibble(hex[2UL * i + 1UL]));
+  }
+  return out;
+}
+
+struct Vector {
+  char const* msg;
+  pubkey_t hash;
+};
+
+Vector const VECTORS[] = {
+    {"", digest("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")},
+    {"abc", digest("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")},
+    {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+     digest("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1")},
+    {"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrs"
+     "mnopqrstnopqrstu",
+     digest("cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1")},
+};
+
+constexpr pubkey_t MILLION_A = digest("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+/* SHA-256 of the digests of the first 0, 1, ..., 299 bytes of
+   (7i + 3) mod 256 */
+constexpr pubkey_t LENGTHS = digest("7b074096cabb18dd0d1b468a173cb2f97f80e952525bca29542e606fd6d0753a");
+
+constexpr uchar ABC[] = {'a', 'b', 'c'};
+static_assert(thru::crypto::sha256_constexpr(ABC, sizeof(ABC)).key ==
+              digest("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad").key);
+
+/* Hashes msg appended in random pieces, sometimes empty */
+pubkey_t streamed(thru::test::Rng& rng, uchar const* msg, ulong sz) {
+  Sha256 sha;
+  ulong off = 0UL;
+  while (off < sz) {
+    ulong n = rng.below(4UL) ? rng.below(8UL) : rng.below(200UL);
+    n = n < sz - off ? n : sz - off;
+    sha.append(msg + off, n);
+    off += n;
+  }
+  return sha.fini();
+}
+
+void test_vectors() {
+  thru::test::Rng rng(2UL);
+  for (Vector const& v : VECTORS) {
+    auto msg = reinterpret_cast<uchar const*>(v.msg);
+    ulong sz = std::strlen(v.msg);
+    pubkey_t out;
+    TSDK_TEST(Sha256::hash(msg, sz, &out) == &out && thru::pubkey_eq(out, v.hash));
+    TSDK_TEST(thru::pubkey_eq(streamed(rng, msg, sz), v.hash));
+    TSDK_TEST(thru::pubkey_eq(thru::crypto::sha256_constexpr(msg, sz), v.hash));
+
+    /* A hasher runs again after init() */
+    Sha256 sha;
+    sha.append("junk", 4UL).fini(&out);
+    TSDK_TEST(thru::pubkey_eq(sha.init().append(msg, sz).fini(), v.hash));
+  }
+
+  /* One million 'a's, streamed and in one go */
+  std::vector<uchar> a(1000000UL, 'a');
+  Sha256 sha;
+  for (ulong off = 0UL; off < a.size(); off += 1000UL) {
+    sha.append(a.data() + off, 1000UL);
+  }
+  TSDK_TEST(thru::pubkey_eq(sha.fini(), MILLION_A));
+  TSDK_TEST(thru::pubkey_eq(streamed(rng, a.data(), a.size()), MILLION_A));
+  TSDK_TEST(thru::pubkey_eq(Sha256::hash(std::as_bytes(std::span<const uchar>(a))), MILLION_A));
+  thru::test::pass("sha256 vectors");
+}
+
+void test_lengths() {
+  thru::test::Rng rng(3UL);
+  constexpr ulong LEN_CNT = 300UL;
+  uchar msg[LEN_CNT];
+  for (ulong i = 0UL; i < LEN_CNT; i++) {
+    msg[i] = static_cast<uchar>((i * 7UL + 3UL) & 0xFFUL);
+  }
+  Sha256::Prefix32 prefix = Sha256::prefix32(msg);
+
+  /* All lengths in one batch, and again with each message twice, so
+     every batch pairs equal lengths */
+  std::vector<std::span<const std::byte>> msgs;
+  std::vector<std::span<const std::byte>> pairs;
+  for (ulong n = 0UL; n < LEN_CNT; n++) {
+    msgs.push_back(std::as_bytes(std::span<const uchar>(msg, n)));
+    pairs.push_back(msgs.back());
+    pairs.push_back(msgs.back());
+  }
+  std::vector<pubkey_t> many(LEN_CNT);
+  std::vector<pubkey_t> many_pairs(2UL * LEN_CNT);
+  Sha256::hash_many(msgs, many.data());
+  Sha256::hash_many(pairs, many_pairs.data());
+
+  Sha256 chain;
+  for (ulong n = 0UL; n < LEN_CNT; n++) {
+    pubkey_t want;
+    Sha256::hash(msg, n, &want);
+    chain.append(&want, sizeof(want));
+    TSDK_TEST(thru::pubkey_eq(streamed(rng, msg, n), want));
+    TSDK_TEST(thru::pubkey_eq(thru::crypto::sha256_constexpr(msg, n), want));
+    TSDK_TEST(thru::pubkey_eq(many[n], want));
+    TSDK_TEST(thru::pubkey_eq(many_pairs[2UL * n], want) &&
+              thru::pubkey_eq(many_pairs[2UL * n + 1UL], want));
+    if (n >= 32UL) {
+      pubkey_t got;
+      Sha256::hash_prefixed(prefix, msg + 32, n - 32UL, &got);
+      TSDK_TEST(thru::pubkey_eq(got, want));
+    }
+  }
+  TSDK_TEST(thru::pubkey_eq(chain.fini(), LENGTHS));
+  thru::test::pass("sha256 lengths");
+}
+
+void test_pair() {
+  thru::test::Rng rng(4UL);
+  for (ulong iter = 0UL; iter < 10000UL; iter++) {
+    uchar buf[64];
+    for (uchar& b : buf) {
+      b = static_cast<uchar>(rng.next());
+    }
+    pubkey_t left;
+    pubkey_t right;
+    std::memcpy(&left, buf, 32UL);
+    std::memcpy(&right, buf + 32, 32UL);
+    pubkey_t want;
+    Sha256::hash(buf, sizeof(buf), &want);
+    TSDK_TEST(thru::pubkey_eq(Sha256::hash_pair(left, right), want));
+    TSDK_TEST(thru::pubkey_eq(thru::crypto::sha256_pair_constexpr(left, right), want));
+
+    /* The output may overwrite either input */
+    pubkey_t l = left;
+    pubkey_t r = right;
+    Sha256::hash_pair(&l, &r, &l);
+    Sha256::hash_pair(&left, &r, &r);
+    TSDK_TEST(thru::pubkey_eq(l, want) && thru::pubkey_eq(r, want));
+  }
+  thru::test::pass("sha256 pair");
+}
+
+} // namespace
+
+int main() {
+  test_vectors();
+  test_lengths();
+  test_pair();
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include "tn_sdk_vec.hpp"
+#include "host/tn_sdk_test.hpp"
+
+#include <vector>
+
+/* AccountVec against std::vector: pushes past the capacity regrow it
+   geometrically with the elements intact, and random push_back, append,
+   pop_back, resize, reserve, shrink_to_fit and clear keep the same
+   contents and an account sized to the capacity */
+
+namespace {
+
+struct Rec {
+  ulong a;
+  uint b;
+  uint c;
+};
+
+using Vec = thru::AccountVec<Rec>;
+
+constexpr ushort IDX = 2U;
+
+Rec rec(ulong i) {
+  return Rec{i * 0x9E3779B97F4A7C15UL, static_cast<uint>(i), ~static_cast<uint>(i)};
+}
+
+bool same(Rec const& x, Rec const& y) { return x.a == y.a && x.b == y.b && x.c == y.c; }
+
+void check_same(Vec const& vec, std::vector<Rec> const& ref) {
+  TSDK_TEST(vec.size() == ref.size() && vec.empty() == ref.empty());
+  TSDK_TEST(vec.capacity() >= vec.size());
+  TSDK_TEST(thru::host::account_meta(IDX)->data_sz == Vec::footprint(vec.capacity()));
+  for (ulong i = 0UL; i < ref.size(); i++) {
+    TSDK_TEST(same(vec[i], ref[i]));
+  }
+}
+
+void init_account() {
+  thru::host::init_txn(1U, 0U);
+  thru::host::set_account(IDX, thru::host::account_addrs()[1], 0UL);
+}
+
+void test_grow() {
+  init_account();
+  thru::host::Exit ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Vec vec = Vec::format(thru::Account(IDX), writable);
+    std::vector<Rec> ref;
+    TSDK_TEST(vec.capacity() == 0UL && vec.empty());
+
+    /* Each push past the capacity doubles it, GROW_MIN first, and
+       costs the only resize until the next one */
+    thru::host::reset_syscall_cnts();
+    ulong resize_cnt = 0UL;
+    for (ulong i = 0UL; i < 100000UL; i++) {
+      ulong cap = vec.capacity();
+      vec.push_back(rec(i));
+      ref.push_back(rec(i));
+      if (i == cap) {
+        TSDK_TEST(vec.capacity() == (cap ? 2UL * cap : Vec::GROW_MIN));
+        resize_cnt++;
+        check_same(vec, ref);
+      } else {
+        TSDK_TEST(vec.capacity() == cap);
+      }
+      TSDK_TEST(same(vec.back(), ref.back()));
+    }
+    TSDK_TEST(thru::host::syscall_cnt(TN_SYSCALL_CODE_ACCOUNT_RESIZE) == resize_cnt);
+    TSDK_TEST(resize_cnt <= 17UL);
+    check_same(vec, ref);
+
+    /* pop_back down to empty leaves the capacity alone */
+    ulong cap = vec.capacity();
+    while (!ref.empty()) {
+      TSDK_TEST(same(vec.back(), ref.back()));
+      vec.pop_back();
+      ref.pop_back();
+    }
+    TSDK_TEST(vec.empty() && vec.capacity() == cap);
+    check_same(vec, ref);
+  });
+  TSDK_TEST(!ex.exited);
+
+  /* pop_back on an empty vector reverts */
+  ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Vec::join(thru::Account(IDX), writable).pop_back();
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ACCOUNT_VEC_ERR_EMPTY);
+
+  thru::test::pass("vec grow");
+}
+
+void test_random() {
+  init_account();
+  thru::test::Rng rng(20UL);
+  thru::host::Exit ex = thru::host::run([&] {
+    thru::WritableSet writable;
+    std::vector<Rec> ref;
+    Vec::format(thru::Account(IDX), writable, rng.below(8UL));
+    ulong next = 0UL;
+    for (ulong iter = 0UL; iter < 20000UL; iter++) {
+      /* Joined afresh now and then, as on each invocation */
+      Vec vec = Vec::join(thru::Account(IDX), writable);
+      for (ulong step = rng.below(16UL); step; step--) {
+        ulong op = rng.below(100UL);
+        if (op < 40UL) {
+          vec.push_back(rec(next));
+          ref.push_back(rec(next++));
+        } else if (op < 50UL) {
+          std::vector<Rec> vs;
+          for (ulong n = rng.below(rng.below(4UL) ? 8UL : 600UL); n; n--) {
+            vs.push_back(rec(next++));
+          }
+          vec.append(vs);
+          ref.insert(ref.end(), vs.begin(), vs.end());
+        } else if (op < 75UL) {
+          if (!ref.empty()) {
+            vec.pop_back();
+            ref.pop_back();
+          }
+        } else if (op < 85UL) {
+          ulong cnt = rng.below(ref.size() + 64UL);
+          vec.resize(cnt);
+          ref.resize(cnt, Rec{0UL, 0U, 0U});
+        } else if (op < 92UL) {
+          ulong cnt = rng.below(2UL * ref.size() + 64UL);
+          ulong cap = vec.capacity();
+          vec.reserve(cnt);
+          TSDK_TEST(vec.capacity() == (cnt > cap ? cnt : cap));
+        } else if (op < 97UL) {
+          vec.shrink_to_fit();
+          TSDK_TEST(vec.capacity() == ref.size());
+        } else {
+          ulong cap = vec.capacity();
+          vec.clear();
+          ref.clear();
+          TSDK_TEST(vec.capacity() == cap);
+        }
+      }
+      check_same(vec, ref);
+
+      std::span<const Rec> view = Vec::view(thru::Account(IDX));
+      TSDK_TEST(view.size() == ref.size() && (ref.empty() || same(view.back(), ref.back())));
+    }
+  });
+  TSDK_TEST(!ex.exited);
+  thru::test::pass("vec random");
+}
+
+void test_join() {
+  init_account();
+  thru::host::Exit ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Vec::format(thru::Account(IDX), writable, 3UL).push_back(rec(1UL));
+  });
+  TSDK_TEST(!ex.exited);
+
+  /* Another element type, or a header whose length is past the
+     capacity, is not a vector of Rec */
+  ex = thru::host::run([] {
+    thru::WritableSet writable;
+    thru::AccountVec<ulong>::join(thru::Account(IDX), writable);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ACCOUNT_VEC_ERR_INVALID);
+
+  reinterpret_cast<thru::AccountVecHeader*>(thru::host::account_data(IDX))->len = 4UL;
+  ex = thru::host::run([] { Vec::view(thru::Account(IDX)); });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ACCOUNT_VEC_ERR_INVALID);
+
+  /* Growing past the largest account data reverts */
+  thru::host::set_account(IDX, thru::host::account_addrs()[1], 0UL);
+  ex = thru::host::run([] {
+    thru::WritableSet writable;
+    Vec::format(thru::Account(IDX), writable).reserve(Vec::CAPACITY_MAX + 1UL);
+  });
+  TSDK_TEST(ex.reverted && ex.code == TSDK_ACCOUNT_VEC_ERR_FULL);
+
+  thru::test::pass("vec join");
+}
+
+} // namespace
+
+int main() {
+  test_grow();
+  test_random();
+  test_join();
+  return 0;
+}
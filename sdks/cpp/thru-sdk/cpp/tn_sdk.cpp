@@ -1,4 +1,5 @@
 #include "tn_sdk.hpp"
+#include "tn_sdk_prof.hpp"
 #include "tn_sdk_syscall.hpp"
 
 #include <cstdarg>
@@ -43,16 +44,37 @@ const tsdk_shadow_stack* tsdk_get_shadow_stack(void) {
       thru::mem::segment_address(TSDK_SEG_TYPE_READONLY_DATA, TSDK_SEG_IDX_SHADOW_STACK, 0UL));
 }
 
+void* tsdk_get_heap_base(void) {
+  const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
+  /* Heap pages are stacked upwards the same way stack pages are stacked
+     downwards: the parent frame's total is the start of our slice. */
+  ulong parent_heap_pages =
+      shadow_stack->stack_frames[shadow_stack->call_depth - 1U].heap_pages;
+  return reinterpret_cast<void*>(thru::mem::segment_address(
+      TSDK_SEG_TYPE_HEAP, TSDK_SEG_IDX_NULL, parent_heap_pages * TSDK_PAGE_SZ));
+}
+
 [[noreturn]] void tsdk_revert(ulong error_code) {
+#if TSDK_PROFILE
+  tsdk_prof_dump();
+#endif
   tsys_exit(error_code, 1UL);
   __builtin_unreachable();
 }
 
 [[noreturn]] void tsdk_return(ulong return_code) {
+#if TSDK_PROFILE
+  tsdk_prof_dump();
+#endif
   tsys_exit(return_code, 0UL);
   __builtin_unreachable();
 }
 
+/* picolibc's vsnprintf has no call graph.  Its tinystdio formatter
+   (with double support, as picolibcpp.specs links it) keeps well under
+   this; the bound lets any program that prints pass the stack check. */
+TSDK_STACK_BOUND("vsnprintf", 1024);
+
 void tsdk_printf(const char* fmt, ...) {
   char buf[1024];
   va_list args;
@@ -105,11 +127,10 @@ int tsdk_is_account_authorized_by_idx(ushort account_idx) {
         const ushort* auth_idxs = auth->auth_idxs();
         for (ushort j = 0; j < auth->auth_cnt; j++) {
           if (auth_idxs[j] == account_idx) {
-            if (std::memcmp(&target_meta->owner, &accs[frame->program_acc_idx],
-                            sizeof(pubkey_t)) == 0) {
+            if (thru::pubkey_eq(target_meta->owner, accs[frame->program_acc_idx])) {
               return 1;
             }
-            tsdk_revert(0xBAD0A174UL); /* auth entry for unowned account */
+            tsdk_revert(TSDK_INVOKE_AUTH_ERR_PARENT_UNOWNED);
           }
         }
       }
@@ -125,30 +146,155 @@ int tsdk_is_account_authorized_by_idx(ushort account_idx) {
 }
 
 int tsdk_is_account_authorized_by_pubkey(const pubkey_t* pubkey) {
-  const pubkey_t* accs = tn_txn_get_acct_addrs(tsdk_get_txn());
+  /* A linear scan, as there is no AccountIndex to consult here (see
+     transaction::is_authorized).  The pubkey is resolved once and the
+     index walk reused, so the shadow stack walk compares ushorts
+     instead of 32-byte addresses against every frame and auth entry. */
+  ushort idx = thru::transaction::find_account_idx(*pubkey);
+  if (idx == TSDK_ACCOUNT_IDX_NONE) {
+    return 0;
+  }
+  return tsdk_is_account_authorized_by_idx(idx);
+}
 
-  /* Fee payer is always authorized */
-  if (std::memcmp(pubkey, &accs[0], sizeof(pubkey_t)) == 0) {
-    return 1;
+ushort tsdk_get_current_program_acc_idx(void) {
+  const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
+  return shadow_stack->stack_frames[shadow_stack->call_depth].program_acc_idx;
+}
+
+const pubkey_t* tsdk_get_current_program_acc_addr(void) {
+  return &tn_txn_get_acct_addrs(tsdk_get_txn())[tsdk_get_current_program_acc_idx()];
+}
+
+int tsdk_is_account_owned_by_current_program(ushort account_idx) {
+  const tn_account_meta* account_meta = tsdk_get_account_meta(account_idx);
+  return thru::pubkey_eq(*tsdk_get_current_program_acc_addr(), account_meta->owner);
+}
+
+void tsdk_invoke_auth_validate(tsdk_invoke_auth_t const* auth) {
+  if (auth->magic != TSDK_INVOKE_AUTH_MAGIC) {
+    tsdk_revert(TSDK_INVOKE_AUTH_ERR_BAD_MAGIC);
   }
 
+  const ushort* auth_idxs = auth->auth_idxs();
+  for (ushort i = 0; i < auth->auth_cnt; i++) {
+    ushort acc_idx = auth_idxs[i];
+    if (!tsdk_is_account_idx_valid(acc_idx)) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX);
+    }
+    if (!tsdk_is_account_owned_by_current_program(acc_idx)) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_UNOWNED_AUTH_ACCOUNT);
+    }
+  }
+
+  const ushort* deauth_idxs = auth->deauth_idxs();
+  for (ushort j = 0; j < auth->deauth_cnt; j++) {
+    if (!tsdk_is_account_idx_valid(deauth_idxs[j])) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX);
+    }
+  }
+}
+
+int tsdk_is_program_reentrant(void) {
   const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
+  ushort current_program_idx = shadow_stack->stack_frames[shadow_stack->call_depth].program_acc_idx;
 
-  /* Current program is always authorized */
+  /* If there are no previous invocations, the program is not reentrant */
+  if (shadow_stack->call_depth == 1) {
+    return 0;
+  }
+
+  /* Check if the current program appears in any previous stack frame */
+  for (ushort i = shadow_stack->call_depth - 1; i > 0; i--) {
+    const tsdk_shadow_stack_frame* frame = &shadow_stack->stack_frames[i];
+    if (frame->program_acc_idx == current_program_idx) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+int tsdk_account_exists(ushort account_idx) {
+  const tn_account_meta* account_meta = tsdk_get_account_meta(account_idx);
+  return account_meta->version == TN_ACCOUNT_V1;
+}
+
+} // extern "C"
+
+namespace thru {
+namespace mem {
+
+void Arena::grow(ulong end) {
+  if (base_ == nullptr) {
+    /* With profiling, the bottom of the heap holds the profile table */
+    base_ = static_cast<uchar*>(tsdk_get_heap_base()) + TSDK_PROF_HEAP_RESERVE;
+    /* _start mapped the declared heap above it */
+    cap_ = tsdk_program_resources.heap_pages * TSDK_PAGE_SZ;
+    if (end <= cap_) {
+      return;
+    }
+  }
+
+  ulong base_off = reinterpret_cast<ulong>(base_) & (TSDK_SEG_OFFSET_MAX - 1UL);
+  ulong limit = TSDK_SEG_OFFSET_MAX - base_off;
+  if (TSDK_UNLIKELY(end > limit)) {
+    tsdk_revert(TSDK_ARENA_ERR_OUT_OF_MEMORY);
+  }
+
+  /* Map at least the current batch, then double the batch so a steadily
+     growing arena issues a logarithmic number of ecalls. */
+  ulong delta = align_up(end - cap_, TSDK_PAGE_SZ);
+  ulong batch = grow_pages_ * TSDK_PAGE_SZ;
+  if (delta < batch) {
+    delta = batch;
+  }
+  if (delta > limit - cap_) {
+    delta = limit - cap_;
+  }
+  if (grow_pages_ < TSDK_ARENA_GROW_PAGES_MAX) {
+    grow_pages_ <<= 1;
+  }
+
+  void* addr = nullptr;
+  if (TSDK_UNLIKELY(tsys_increment_anonymous_segment_sz(base_, delta, &addr) !=
+                    TSDK_SUCCESS)) {
+    tsdk_revert(TSDK_ARENA_ERR_GROW_FAILED);
+  }
+  cap_ += delta;
+}
+
+} // namespace mem
+
+void AuthCache::build() {
+  const tn_txn* txn = tsdk_get_txn();
+  ushort acct_cnt = tn_txn_account_cnt(txn);
+  acct_cnt_ = acct_cnt;
+  decided_.clear(acct_cnt);
+  authorized_.clear(acct_cnt);
+  unowned_.clear(acct_cnt);
+  built_ = true;
+
+  const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
+
+  /* Fee payer and current program are always authorized and cannot be
+     deauthorized by a parent frame */
   ushort current_program_acc_idx =
       shadow_stack->stack_frames[shadow_stack->call_depth].program_acc_idx;
-  if (std::memcmp(pubkey, &accs[current_program_acc_idx], sizeof(pubkey_t)) ==
-      0) {
-    return 1;
-  }
+  decide(0U, true);
+  decide(current_program_acc_idx, true);
 
-  /* No parent frames to check */
   if (shadow_stack->call_depth == 1) {
-    return 0;
+    return;
   }
 
-  /* Walk shadow stack from most recent parent down to root.
-     First match wins - deeper frames override shallower ones. */
+  const pubkey_t* accs = tn_txn_get_acct_addrs(txn);
+
+  /* Same walk as tsdk_is_account_authorized_by_idx, applied to every
+     account at once: frames are visited from the most recent parent
+     down to the root and the first frame to mention an account decides
+     it.  Unowned auth entries are recorded rather than reverting here so
+     that only a query for such an account reverts, as before. */
   for (ushort i = static_cast<ushort>(shadow_stack->call_depth - 1U); i > 0;
        i--) {
     const tsdk_shadow_stack_frame* frame = &shadow_stack->stack_frames[i];
@@ -158,75 +304,91 @@ int tsdk_is_account_authorized_by_pubkey(const pubkey_t* pubkey) {
       const tsdk_invoke_auth_t* auth =
           reinterpret_cast<const tsdk_invoke_auth_t*>(auth_ptr);
       if (auth->magic == TSDK_INVOKE_AUTH_MAGIC) {
-        const ushort* deauth_idxs = auth->deauth_idxs();
+        const ushort* deauth = auth->deauth_idxs();
         for (ushort j = 0; j < auth->deauth_cnt; j++) {
-          if (std::memcmp(pubkey, &accs[deauth_idxs[j]], sizeof(pubkey_t)) ==
-              0) {
-            return 0;
-          }
+          decide(deauth[j], false);
         }
         const ushort* auth_idxs = auth->auth_idxs();
         for (ushort j = 0; j < auth->auth_cnt; j++) {
-          if (std::memcmp(pubkey, &accs[auth_idxs[j]], sizeof(pubkey_t)) ==
-              0) {
-            const tn_account_meta* target_meta = tsdk_get_account_meta(auth_idxs[j]);
-            if (std::memcmp(&target_meta->owner, &accs[frame->program_acc_idx],
-                            sizeof(pubkey_t)) == 0) {
-              return 1;
-            }
-            tsdk_revert(0xBAD0A174UL); /* auth entry for unowned account */
+          ushort idx = auth_idxs[j];
+          if (idx >= acct_cnt || decided_.test(idx)) {
+            continue;
+          }
+          const tn_account_meta* target_meta = tsdk_get_account_meta(idx);
+          if (pubkey_eq(target_meta->owner, accs[frame->program_acc_idx])) {
+            decide(idx, true);
+          } else {
+            decided_.set(idx);
+            unowned_.set(idx);
           }
         }
       }
     }
 
     /* Existing behavior: program in call chain is authorized */
-    if (std::memcmp(pubkey, &accs[frame->program_acc_idx], sizeof(pubkey_t)) ==
-        0) {
-      return 1;
-    }
+    decide(frame->program_acc_idx, true);
   }
-
-  return 0;
 }
 
-ushort tsdk_get_current_program_acc_idx(void) {
-  const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
-  return shadow_stack->stack_frames[shadow_stack->call_depth].program_acc_idx;
+bool AuthCache::is_authorized(const pubkey_t& pubkey) {
+  ushort idx = transaction::find_account_idx(pubkey);
+  return idx != TSDK_ACCOUNT_IDX_NONE && is_authorized(idx);
 }
 
-const pubkey_t* tsdk_get_current_program_acc_addr(void) {
-  return &tn_txn_get_acct_addrs(tsdk_get_txn())[tsdk_get_current_program_acc_idx()];
-}
+namespace transaction {
 
-int tsdk_is_account_owned_by_current_program(ushort account_idx) {
-  const tn_account_meta* account_meta = tsdk_get_account_meta(account_idx);
-  return std::memcmp(tsdk_get_current_program_acc_addr(), &account_meta->owner, sizeof(pubkey_t)) == 0;
+ushort find_account_idx(const pubkey_t& pubkey) {
+  const tn_txn* txn = tsdk_get_txn();
+  const pubkey_t* accs = tn_txn_get_acct_addrs(txn);
+  ushort acct_cnt = tn_txn_account_cnt(txn);
+  ulong key = pubkey_prefix(pubkey);
+  for (ushort i = 0; i < acct_cnt; i++) {
+    if (pubkey_prefix(accs[i]) == key && pubkey_eq(pubkey, accs[i])) {
+      return i;
+    }
+  }
+  return TSDK_ACCOUNT_IDX_NONE;
 }
 
-int tsdk_is_program_reentrant(void) {
-  const tsdk_shadow_stack* shadow_stack = tsdk_get_shadow_stack();
-  ushort current_program_idx = shadow_stack->stack_frames[shadow_stack->call_depth].program_acc_idx;
+void AccountIndex::build() {
+  const tn_txn* txn = tsdk_get_txn();
+  const pubkey_t* accs = tn_txn_get_acct_addrs(txn);
+  ushort acct_cnt = tn_txn_account_cnt(txn);
 
-  /* If there are no previous invocations, the program is not reentrant */
-  if (shadow_stack->call_depth == 1) {
-    return 0;
+  ulong slot_cnt = 1UL;
+  while (slot_cnt <= 2UL * acct_cnt) {
+    slot_cnt <<= 1;
+  }
+  if (arena_ != nullptr) {
+    slots_ = arena_->alloc_array<ushort>(slot_cnt);
+    slot_mask_ = slot_cnt - 1UL;
+  } else if (TSDK_UNLIKELY(slot_mask_ + 1UL < slot_cnt ||
+                           (slot_mask_ & (slot_mask_ + 1UL)) != 0UL)) {
+    tsdk_revert(TSDK_ACCOUNT_INDEX_ERR_TOO_SMALL);
+  }
+  for (ulong i = 0UL; i <= slot_mask_; i++) {
+    slots_[i] = 0U;
   }
 
-  /* Check if the current program appears in any previous stack frame */
-  for (ushort i = shadow_stack->call_depth - 1; i > 0; i--) {
-    const tsdk_shadow_stack_frame* frame = &shadow_stack->stack_frames[i];
-    if (frame->program_acc_idx == current_program_idx) {
-      return 1;
+  for (ushort i = 0; i < acct_cnt; i++) {
+    ulong key = pubkey_prefix(accs[i]);
+    ulong slot = hash(key) & slot_mask_;
+    bool dup = false;
+    while (slots_[slot] != 0U) {
+      const pubkey_t* acc = &accs[slots_[slot] - 1U];
+      if (pubkey_prefix(*acc) == key && pubkey_eq(*acc, accs[i])) {
+        dup = true;
+        break;
+      }
+      slot = (slot + 1UL) & slot_mask_;
+    }
+    if (!dup) {
+      slots_[slot] = static_cast<ushort>(i + 1U);
     }
   }
-
-  return 0;
+  built_ = true;
 }
 
-int tsdk_account_exists(ushort account_idx) {
-  const tn_account_meta* account_meta = tsdk_get_account_meta(account_idx);
-  return account_meta->version == TN_ACCOUNT_V1;
-}
+} // namespace transaction
 
-} // extern "C"
+} // namespace thru
@@ -8,6 +8,9 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <memory_resource>
+#include <new>
+#include <utility>
 
 /* TSDK_LOAD( T, src ) safely loads a value of type T from potentially
    unaligned memory location src. This macro provides safe access to
@@ -56,6 +59,69 @@ constexpr ulong TSDK_SEG_IDX_PROGRAM = 0x0003UL;
 constexpr ulong TSDK_SEG_IDX_BLOCK_CTX = 0x0004UL;
 constexpr ulong TSDK_BLOCK_CTX_VM_SPACING = 0x1000UL;
 
+constexpr ulong TSDK_PAGE_SZ = 4096UL;          /* Anonymous segment granule */
+constexpr ulong TSDK_SEG_OFFSET_MAX = 1UL << 24; /* Bytes addressable per segment */
+
+/* TSDK_PROGRAM_RESOURCES(stack_pages, heap_pages) declares the stack and
+   heap a program needs.  The counts are recorded in the program header
+   and _start maps both before start() runs, so a deeper stack or an
+   Arena that stays within heap_pages costs no further ecalls:
+
+     TSDK_PROGRAM_RESOURCES(4, 8);
+
+   Use it once, at file scope in the file that defines start().  The
+   arguments are pasted into assembler directives, so they must be plain
+   integer literals.  Without it a program gets one stack page and maps
+   its heap on demand.
+
+   Program binaries are checked against the declared stack: the build
+   fails if the deepest call chain from start() in GCC's call graph
+   needs more (see config/stack-check.awk). */
+constexpr ulong TSDK_PROGRAM_PAGES_MAX = TSDK_SEG_OFFSET_MAX / TSDK_PAGE_SZ;
+
+#define TSDK_PROGRAM_RESOURCES(stack_pages, heap_pages)                        \
+  static_assert((stack_pages) >= 1 && (stack_pages) <= TSDK_PROGRAM_PAGES_MAX, \
+                "stack_pages must be in [1, TSDK_PROGRAM_PAGES_MAX]");         \
+  static_assert((heap_pages) >= 0 && (heap_pages) <= TSDK_PROGRAM_PAGES_MAX,   \
+                "heap_pages must be in [0, TSDK_PROGRAM_PAGES_MAX]");          \
+  __asm__(".globl tsdk_program_stack_pages\n\t"                             \
+          ".set tsdk_program_stack_pages, " #stack_pages "\n\t"              \
+          ".globl tsdk_program_heap_pages\n\t"                              \
+          ".set tsdk_program_heap_pages, " #heap_pages)
+
+/* TSDK_STACK_BOUND(fn, bytes) declares that a call to fn needs at most
+   bytes of stack, including everything it calls.  The stack check cannot
+   bound recursion, indirect calls, alloca or functions built without
+   call graph info (libc, hand-written assembly), and fails the build
+   until each one on a path from start() is bounded.  The SDK library
+   bounds the libc functions it calls itself (vsnprintf, behind
+   tsdk_printf); a program bounds the ones it calls directly:
+
+     TSDK_STACK_BOUND("snprintf", 1024);
+     TSDK_STACK_BOUND("_ZN7Program4walkEPK4Nodem", 2048);
+
+   fn is the symbol as it appears in the call graph (mangled for C++) and
+   bytes a plain integer literal.  Use it at file scope; the bound is kept
+   in a section that is never loaded. */
+#define TSDK_STACK_BOUND(fn, bytes)                                            \
+  __asm__(".pushsection .tsdk_stack,\"\",@progbits\n\t"                        \
+          ".asciz \"" fn " " #bytes "\"\n\t"                                   \
+          ".popsection")
+
+/* Arena revert codes */
+constexpr ulong TSDK_ARENA_ERR_GROW_FAILED   = 0xBAD0B100UL;
+constexpr ulong TSDK_ARENA_ERR_OUT_OF_MEMORY = 0xBAD0B101UL;
+
+/* Sentinel for "no such account" in index lookups */
+constexpr ushort TSDK_ACCOUNT_IDX_NONE = 0xFFFFU;
+
+/* AccountIndex revert codes */
+constexpr ulong TSDK_ACCOUNT_INDEX_ERR_TOO_SMALL = 0xBAD0B200UL;
+
+/* AccountView revert codes */
+constexpr ulong TSDK_ACCOUNT_VIEW_ERR_TOO_SMALL    = 0xBAD0B300UL;
+constexpr ulong TSDK_ACCOUNT_VIEW_ERR_NOT_WRITABLE = 0xBAD0B301UL;
+
 constexpr ulong TN_ACCOUNT_DATA_SZ_MAX = 16UL*1024UL*1024UL; /* Max account data size (excluding metadata) */
 constexpr uchar TN_ACCOUNT_V1          = 0x01U;
 
@@ -71,6 +137,14 @@ constexpr uchar TSDK_ACCOUNT_FLAG_COMPRESSED     = 0x40U;
 // C-compatible function declarations
 extern "C" {
 
+/* The pages _start maps at entry, from the program header.  Defined by
+   link.ld (the host shim defines the defaults). */
+struct tsdk_program_resources_t {
+  ushort stack_pages;
+  ushort heap_pages;
+};
+extern tsdk_program_resources_t const tsdk_program_resources __attribute__((visibility("hidden")));
+
 const tn_account_meta* tsdk_get_account_meta(ushort account_idx);
 void* tsdk_get_account_data_ptr(ushort account_idx);
 int tsdk_account_exists(ushort account_idx);
@@ -79,11 +153,19 @@ const tn_block_ctx* tsdk_get_current_block_ctx(void);
 const tn_block_ctx* tsdk_get_past_block_ctx(ulong blocks_in_past);
 const tsdk_shadow_stack* tsdk_get_shadow_stack(void);
 
+/* Returns the first address of the current invocation's slice of the
+   anonymous heap segment.  Parent frames own the pages below it. */
+void* tsdk_get_heap_base(void);
+
 [[noreturn]] void tsdk_revert(ulong error_code);
 [[noreturn]] void tsdk_return(ulong return_code);
 void tsdk_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
 
 int tsdk_is_account_authorized_by_idx(ushort account_idx);
+
+/* Resolves pubkey with a linear scan of the account addresses, then
+   walks as by_idx does.  thru::transaction::is_authorized resolves it
+   through an AccountIndex instead. */
 int tsdk_is_account_authorized_by_pubkey(const pubkey_t* pubkey);
 ushort tsdk_get_current_program_acc_idx(void);
 const pubkey_t* tsdk_get_current_program_acc_addr(void);
@@ -93,14 +175,249 @@ int tsdk_is_account_idx_valid(ushort account_idx);
    executing program. Requires that `account_idx` is valid. */
 int tsdk_is_account_owned_by_current_program(ushort account_idx);
 
+/* Performs the checks tsys_invoke applies to its auth argument:
+   reverts unless the magic is right, every index is valid and every
+   auth index is owned by the current program. */
+void tsdk_invoke_auth_validate(tsdk_invoke_auth_t const* auth);
+
 /* Checks if the current program is already in the shadow stack (i.e.,
    has been invoked recursively). Returns 1 if the program is reentrant,
    0 otherwise. */
 int tsdk_is_program_reentrant(void);
+
+/* Word-wise memset/memcpy/memmove/memcmp/strlen for -mstrict-align
+   (tn_sdk_mem.cpp).  VM builds link them as the C library functions in
+   place of picolibc's byte loops. */
+void* tsdk_memset(void* dest, int c, ulong n);
+void* tsdk_memcpy(void* dest, void const* src, ulong n);
+void* tsdk_memmove(void* dest, void const* src, ulong n);
+int tsdk_memcmp(void const* s1, void const* s2, ulong n);
+ulong tsdk_strlen(char const* str);
 }
 
 namespace thru {
 
+/* AccountSet is a bitset over the transaction's account indices.  It is
+   sized for TN_TXN_ACCT_MAX accounts (128 bytes) so it can live on the
+   stack; indices beyond that read as clear and ignore writes. */
+class AccountSet {
+public:
+  static constexpr ulong WORD_CNT = TN_TXN_ACCT_MAX / 64UL;
+
+  /* Clears the words covering the first acct_cnt indices; only those
+     indices may be used afterwards.  Call clear(TN_TXN_ACCT_MAX) to
+     clear everything. */
+  void clear(ulong acct_cnt) {
+    ulong word_cnt = (acct_cnt + 63UL) / 64UL;
+    if (word_cnt > WORD_CNT) {
+      word_cnt = WORD_CNT;
+    }
+    for (ulong i = 0UL; i < word_cnt; i++) {
+      words_[i] = 0UL;
+    }
+  }
+
+  bool test(ulong idx) const {
+    return idx < TN_TXN_ACCT_MAX && ((words_[idx >> 6] >> (idx & 63UL)) & 1UL);
+  }
+
+  void set(ulong idx) {
+    if (TSDK_LIKELY(idx < TN_TXN_ACCT_MAX)) {
+      words_[idx >> 6] |= 1UL << (idx & 63UL);
+    }
+  }
+
+  void reset(ulong idx) {
+    if (TSDK_LIKELY(idx < TN_TXN_ACCT_MAX)) {
+      words_[idx >> 6] &= ~(1UL << (idx & 63UL));
+    }
+  }
+
+private:
+  ulong words_[WORD_CNT];
+};
+
+namespace mem {
+class Arena;
+} // namespace mem
+
+/* Loads the first 8 bytes of a pubkey.  pubkey_t is packed, so plain
+   member access compiles to byte loads under -mstrict-align; use a word
+   load when the address is provably aligned (e.g. transaction account
+   addresses, which sit at 8-byte offsets in the txn segment). */
+inline ulong pubkey_prefix(const pubkey_t& key) {
+  const void* p = &key;
+  if (TSDK_LIKELY(!(reinterpret_cast<ulong>(p) & (alignof(ulong) - 1UL)))) {
+    ulong v;
+    std::memcpy(&v, __builtin_assume_aligned(p, alignof(ulong)), sizeof(ulong));
+    return v;
+  }
+  ulong v;
+  std::memcpy(&v, p, sizeof(ulong));
+  return v;
+}
+
+/* Loads a pubkey as its four ul[] words with the widest accesses its
+   address allows: doublewords for transaction account addresses,
+   halfwords for tn_account_meta::owner (offset 14 of an aligned meta),
+   bytes otherwise. */
+inline void pubkey_load(const pubkey_t& key, ulong* w) {
+  const void* p = &key;
+  ulong a = reinterpret_cast<ulong>(p);
+  if (TSDK_LIKELY(!(a & (alignof(ulong) - 1UL)))) {
+    std::memcpy(w, __builtin_assume_aligned(p, alignof(ulong)), sizeof(pubkey_t));
+  } else if (!(a & (alignof(ushort) - 1UL))) {
+    std::memcpy(w, __builtin_assume_aligned(p, alignof(ushort)), sizeof(pubkey_t));
+  } else {
+    std::memcpy(w, p, sizeof(pubkey_t));
+  }
+}
+
+/* a == b for the 32-byte compares at the heart of the ownership,
+   authorization and lookup checks: four word XORs and no call, where
+   memcmp is a byte loop under -mstrict-align. */
+inline bool pubkey_eq(const pubkey_t& a, const pubkey_t& b) {
+  ulong x[4];
+  ulong y[4];
+  pubkey_load(a, x);
+  pubkey_load(b, y);
+  return !((x[0] ^ y[0]) | (x[1] ^ y[1]) | (x[2] ^ y[2]) | (x[3] ^ y[3]));
+}
+
+namespace transaction {
+
+/* AccountIndex maps pubkeys to transaction account indices.
+
+   The table is built on the first find(): an open-addressing table
+   keyed by the first 8 bytes of each account address, holding at most
+   half-full slots of (account index + 1).  A lookup is one prefix
+   probe plus a 32-byte confirm, instead of a memcmp per account.  When
+   the same address appears more than once, the lowest index wins, as
+   with a linear scan.
+
+   Slots come either from a caller buffer (e.g. on the stack) or from an
+   Arena.  A caller buffer must hold a power-of-two number of slots
+   larger than twice the account count; a too-small buffer reverts with
+   TSDK_ACCOUNT_INDEX_ERR_TOO_SMALL when the table is built. */
+
+class AccountIndex {
+public:
+  explicit AccountIndex(mem::Arena& arena)
+      : arena_(&arena), slots_(nullptr), slot_mask_(0UL), built_(false) {}
+
+  AccountIndex(ushort* slots, ulong slot_cnt)
+      : arena_(nullptr), slots_(slots), slot_mask_(slot_cnt - 1UL),
+        built_(false) {}
+
+  AccountIndex(const AccountIndex&) = delete;
+  AccountIndex& operator=(const AccountIndex&) = delete;
+
+  /* Returns the index of the account with address pubkey, or
+     TSDK_ACCOUNT_IDX_NONE if the transaction does not reference it. */
+  ushort find(const pubkey_t& pubkey) {
+    if (TSDK_UNLIKELY(!built_)) {
+      build();
+    }
+    const pubkey_t* accs = tn_txn_get_acct_addrs(tsdk_get_txn());
+    ulong key = pubkey_prefix(pubkey);
+    for (ulong slot = hash(key) & slot_mask_;; slot = (slot + 1UL) & slot_mask_) {
+      ushort entry = slots_[slot];
+      if (entry == 0U) {
+        return TSDK_ACCOUNT_IDX_NONE;
+      }
+      const pubkey_t* acc = &accs[entry - 1U];
+      if (pubkey_prefix(*acc) == key && pubkey_eq(*acc, pubkey)) {
+        return static_cast<ushort>(entry - 1U);
+      }
+    }
+  }
+
+  bool contains(const pubkey_t& pubkey) {
+    return find(pubkey) != TSDK_ACCOUNT_IDX_NONE;
+  }
+
+private:
+  static ulong hash(ulong key) { return (key * 0x9E3779B97F4A7C15UL) >> 32; }
+
+  void build();
+
+  mem::Arena* arena_;
+  ushort* slots_;
+  ulong slot_mask_;
+  bool built_;
+};
+
+/* tsdk_is_account_authorized_by_pubkey with pubkey resolved through
+   index, so repeated checks share one table */
+inline bool is_authorized(const pubkey_t& pubkey, AccountIndex& index) {
+  ushort idx = index.find(pubkey);
+  return idx != TSDK_ACCOUNT_IDX_NONE && tsdk_is_account_authorized_by_idx(idx) != 0;
+}
+
+} // namespace transaction
+
+/* AuthCache answers tsdk_is_account_authorized_by_idx queries from
+   bitsets built by a single walk of the shadow stack.
+
+   tsdk_is_account_authorized_by_* rescan every parent frame and its
+   invoke auth lists on each call.  AuthCache does that walk once, on the
+   first query, and resolves every account index at the same time;
+   later by-index queries are a bit test.  Semantics are unchanged:
+   deauth entries override auth entries in the same frame, the most
+   recent parent frame to mention an account decides it, and querying
+   an account whose deciding auth entry is not owned by that frame's
+   program reverts with TSDK_INVOKE_AUTH_ERR_PARENT_UNOWNED.
+
+   The shadow stack does not change during an invocation, so a cache
+   stays valid until the program returns.  It is opt-in: create one on
+   the stack and pass it to the code that checks authority. */
+class AuthCache {
+public:
+  AuthCache() : acct_cnt_(0U), built_(false) {}
+
+  AuthCache(const AuthCache&) = delete;
+  AuthCache& operator=(const AuthCache&) = delete;
+
+  bool is_authorized(ushort account_idx) {
+    if (TSDK_UNLIKELY(!built_)) {
+      build();
+    }
+    if (TSDK_UNLIKELY(account_idx >= acct_cnt_)) {
+      return false;
+    }
+    if (TSDK_UNLIKELY(unowned_.test(account_idx))) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_PARENT_UNOWNED);
+    }
+    return authorized_.test(account_idx);
+  }
+
+  bool is_authorized(const pubkey_t& pubkey);
+
+  /* By-pubkey query resolved through a shared AccountIndex. */
+  bool is_authorized(const pubkey_t& pubkey, transaction::AccountIndex& index) {
+    ushort idx = index.find(pubkey);
+    return idx != TSDK_ACCOUNT_IDX_NONE && is_authorized(idx);
+  }
+
+private:
+  void build();
+
+  void decide(ushort idx, bool authorized) {
+    if (idx < acct_cnt_ && !decided_.test(idx)) {
+      decided_.set(idx);
+      if (authorized) {
+        authorized_.set(idx);
+      }
+    }
+  }
+
+  AccountSet decided_;
+  AccountSet authorized_;
+  AccountSet unowned_;
+  ushort acct_cnt_;
+  bool built_;
+};
+
 // C++ wrapper classes and functions
 class Account {
 private:
@@ -119,6 +436,8 @@ public:
     return tsdk_is_account_authorized_by_idx(idx_) != 0;
   }
 
+  bool is_authorized(AuthCache& auth) const { return auth.is_authorized(idx_); }
+
   /* Checks if the account is owned by the currently executing program. */
   bool is_owned_by_current_program() const {
     return tsdk_is_account_owned_by_current_program(idx_) != 0;
@@ -138,6 +457,10 @@ public:
 namespace transaction {
 inline const tn_txn* get() { return tsdk_get_txn(); }
 
+/* One-shot linear lookup of pubkey's account index (or
+   TSDK_ACCOUNT_IDX_NONE).  Prefer AccountIndex for repeated lookups. */
+ushort find_account_idx(const pubkey_t& pubkey);
+
 inline ushort get_account_count() { return tn_txn_account_cnt(get()); }
 
 inline Account get_account(ushort idx) { return Account(idx); }
@@ -147,6 +470,106 @@ inline ushort get_current_program_account_idx() {
 }
 } // namespace transaction
 
+/* WritableSet remembers which accounts this invocation has already made
+   writable, so tsys_set_account_data_writable is issued at most once per
+   account no matter how many AccountViewMut are built over it.  Share
+   one across the invocation; a second set would promote again. */
+class WritableSet {
+public:
+  WritableSet() { promoted_.clear(transaction::get_account_count()); }
+
+  bool is_promoted(ushort idx) const { return promoted_.test(idx); }
+
+  /* Makes the account's data writable, reverting with
+     TSDK_ACCOUNT_VIEW_ERR_NOT_WRITABLE if the runtime refuses. */
+  void promote(ushort idx) {
+    if (TSDK_LIKELY(promoted_.test(idx))) {
+      return;
+    }
+    if (TSDK_UNLIKELY(tsys_set_account_data_writable(idx) != TSDK_SUCCESS)) {
+      tsdk_revert(TSDK_ACCOUNT_VIEW_ERR_NOT_WRITABLE);
+    }
+    promoted_.set(idx);
+  }
+
+private:
+  AccountSet promoted_;
+};
+
+/* AccountView<T> is a typed, read-only view of an account's data.  The
+   data size is checked against sizeof(T) once, at construction
+   (reverting with TSDK_ACCOUNT_VIEW_ERR_TOO_SMALL), after which every
+   access is a plain load.  Bytes past sizeof(T) are exposed as tail().
+
+   T is the on-chain layout, so it must be trivially copyable, standard
+   layout and free of padding: the bytes a program reads back must be the
+   bytes it wrote, whatever compiler built it.  Account data is page
+   aligned, so T may have any alignment up to a page. */
+template <typename T> class AccountView {
+  static_assert(std::is_trivially_copyable_v<T>, "account layout must be trivially copyable");
+  static_assert(std::is_standard_layout_v<T>, "account layout must be standard layout");
+  static_assert(std::has_unique_object_representations_v<T>,
+                "account layout has padding; reorder or pack its fields");
+  static_assert(alignof(T) <= TSDK_PAGE_SZ, "account layout over-aligned");
+
+public:
+  explicit AccountView(Account account)
+      : idx_(account.index()), data_sz_(checked_data_sz(account)),
+        data_(static_cast<const T*>(account.get_data_ptr())) {}
+
+  const T& operator*() const { return *data_; }
+  const T* operator->() const { return data_; }
+  const T* get() const { return data_; }
+
+  Account account() const { return Account(idx_); }
+  ushort index() const { return idx_; }
+  ulong data_sz() const { return data_sz_; }
+
+  std::span<const std::byte> tail() const {
+    return {reinterpret_cast<const std::byte*>(data_) + sizeof(T), data_sz_ - sizeof(T)};
+  }
+
+protected:
+  static ulong checked_data_sz(Account account) {
+    ulong data_sz = account.get_meta()->data_sz;
+    if (TSDK_UNLIKELY(data_sz < sizeof(T))) {
+      tsdk_revert(TSDK_ACCOUNT_VIEW_ERR_TOO_SMALL);
+    }
+    return data_sz;
+  }
+
+  ushort idx_;
+  ulong data_sz_;
+  const T* data_;
+};
+
+/* AccountViewMut<T> is the writable counterpart of AccountView<T>.
+   Construction checks the size and promotes the account through
+   writable, so building views of the same account repeatedly costs one
+   syscall in total. */
+template <typename T> class AccountViewMut : public AccountView<T> {
+public:
+  AccountViewMut(Account account, WritableSet& writable) : AccountView<T>(account) {
+    writable.promote(this->idx_);
+  }
+
+  /* Upgrades an existing view without re-checking its size. */
+  AccountViewMut(const AccountView<T>& view, WritableSet& writable) : AccountView<T>(view) {
+    writable.promote(this->idx_);
+  }
+
+  T& operator*() const { return *mut(); }
+  T* operator->() const { return mut(); }
+  T* get() const { return mut(); }
+
+  std::span<std::byte> tail() const {
+    return {reinterpret_cast<std::byte*>(mut()) + sizeof(T), this->data_sz_ - sizeof(T)};
+  }
+
+private:
+  T* mut() const { return const_cast<T*>(this->data_); }
+};
+
 namespace block {
 inline const tn_block_ctx* get_context() { return tsdk_get_current_block_ctx(); }
 
@@ -195,6 +618,143 @@ namespace mem {
 constexpr ulong segment_address(ulong seg_type, ulong seg_idx, ulong offset) {
   return seg_type << 40UL | seg_idx << 24UL | offset;
 }
+
+constexpr ulong align_up(ulong x, ulong a) { return (x + (a - 1UL)) & ~(a - 1UL); }
+
+constexpr bool is_aligned(ulong x, ulong a) { return !(x & (a - 1UL)); }
+
+/* Arena is a bump allocator over the current invocation's heap segment.
+
+   The heap declared with TSDK_PROGRAM_RESOURCES is mapped at entry and
+   used first.  Past it, the heap is mapped lazily with
+   tsys_increment_anonymous_segment_sz.
+   Growth is batched: each ecall maps at least grow_pages pages and the
+   batch doubles (up to TSDK_ARENA_GROW_PAGES_MAX) every time it is used,
+   so N bytes of allocations cost O(log N) ecalls.  Pages are never
+   returned to the VM; rollback() only rewinds the bump pointer.
+
+   There is a single heap segment per invocation, so a program should
+   create one Arena (typically on the stack in start()) and pass it by
+   reference.  Program memory is read-only, so the Arena cannot be a
+   global.
+
+   Arena is also a std::pmr::memory_resource, so pmr containers can be
+   placed on it:
+
+     thru::mem::Arena arena;
+     std::pmr::vector<ulong> v(&arena);
+
+   Deallocation is a no-op unless it frees the most recent allocation,
+   in which case the space is reclaimed. */
+
+constexpr ulong TSDK_ARENA_GROW_PAGES_DEFAULT = 1UL;
+constexpr ulong TSDK_ARENA_GROW_PAGES_MAX = 16UL;
+
+class Arena final : public std::pmr::memory_resource {
+public:
+  /* Opaque position returned by mark() and consumed by rollback(). */
+  struct Mark {
+    ulong used;
+  };
+
+  /* Scope rolls the arena back to its construction point on exit. */
+  class Scope {
+  public:
+    explicit Scope(Arena& arena) : arena_(arena), mark_(arena.mark()) {}
+    ~Scope() { arena_.rollback(mark_); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    Arena& arena_;
+    Mark mark_;
+  };
+
+  explicit Arena(ulong grow_pages = TSDK_ARENA_GROW_PAGES_DEFAULT)
+      : base_(nullptr), used_(0UL), cap_(0UL),
+        grow_pages_(grow_pages ? grow_pages : 1UL) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /* Returns sz bytes aligned to align (a power of two no larger than
+     TSDK_PAGE_SZ).  Reverts with TSDK_ARENA_ERR_OUT_OF_MEMORY if the heap
+     segment cannot hold the request. */
+  void* alloc(ulong sz, ulong align = alignof(ulong)) {
+    ulong off = align_up(used_, align);
+    ulong end = off + sz;
+    if (TSDK_UNLIKELY(end < off)) {
+      tsdk_revert(TSDK_ARENA_ERR_OUT_OF_MEMORY);
+    }
+    if (TSDK_UNLIKELY(end > cap_)) {
+      grow(end);
+    }
+    used_ = end;
+    return base_ + off;
+  }
+
+  template <typename T> T* alloc_array(ulong cnt) {
+    if (TSDK_UNLIKELY(cnt > ~0UL / sizeof(T))) {
+      tsdk_revert(TSDK_ARENA_ERR_OUT_OF_MEMORY);
+    }
+    return static_cast<T*>(alloc(cnt * sizeof(T), alignof(T)));
+  }
+
+  template <typename T, typename... Args> T* make(Args&&... args) {
+    return ::new (alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /* Maps enough pages up front that the next sz bytes of allocations do
+     not issue an ecall. */
+  void reserve(ulong sz) {
+    ulong end = used_ + sz;
+    if (TSDK_UNLIKELY(end < used_)) {
+      tsdk_revert(TSDK_ARENA_ERR_OUT_OF_MEMORY);
+    }
+    if (end > cap_) {
+      grow(end);
+    }
+  }
+
+  Mark mark() const { return Mark{used_}; }
+
+  void rollback(Mark m) {
+    if (TSDK_LIKELY(m.used <= used_)) {
+      used_ = m.used;
+    }
+  }
+
+  void reset() { used_ = 0UL; }
+
+  ulong used() const { return used_; }
+
+  ulong capacity() const { return cap_; }
+
+  ulong remaining() const { return cap_ - used_; }
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    return alloc(bytes, align);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+    if (static_cast<uchar*>(p) + bytes == base_ + used_) {
+      used_ = static_cast<ulong>(static_cast<uchar*>(p) - base_);
+    }
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  /* Maps pages until at least end bytes are available. */
+  void grow(ulong end);
+
+  uchar* base_;
+  ulong used_;
+  ulong cap_;
+  ulong grow_pages_;
+};
 } // namespace mem
 
 } // namespace thru
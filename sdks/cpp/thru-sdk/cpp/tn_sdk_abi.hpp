@@ -0,0 +1,101 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_abi_hpp
+#define HEADER_sdks_cpp_tn_sdk_abi_hpp
+
+#include "tn_sdk.hpp"
+
+#include <concepts>
+#include <span>
+#include <type_traits>
+
+/* Glue between the SDK and headers generated by `abi codegen -l cpp`.
+
+   A generated header gives every ABI type Foo a layout struct Foo (when
+   it is fixed-size), a zero-copy FooView over std::span<const std::byte>
+   and, for structs, a FooMut writer over std::span<std::byte>.  The same
+   schema then drives both sides of a program:
+
+     - Instruction arguments: a handler whose Args is a view is validated
+       against the schema by the Dispatcher, which hands the view over
+       and passes any bytes after it as the tail:
+
+         struct Swap {
+           static constexpr uchar DISCRIMINATOR = 3;
+           using Args = amm::SwapArgsView;
+           static ulong handle(Args args, thru::WritableSet& writable);
+         };
+
+     - Account data: AccountView<amm::Pool> for fixed layouts, or
+       abi_view<amm::PoolView>(account) / abi_view_mut<amm::PoolMut>(...)
+       for layouts with variable-length fields.
+
+     - Events: EventWriter<amm::SwapEvent> for a fixed head, with
+       append_view<amm::FillsMut>(sz) for a schema-described tail.
+
+   Views are validated once, here; their accessors are then plain loads
+   at constant or lazily computed offsets. */
+
+/* ABI view revert codes */
+constexpr ulong TSDK_ABI_ERR_INVALID = 0xBAD0C000UL; /* Bytes do not hold a valid value of the schema */
+
+namespace thru {
+
+/* A generated reader: trivially copyable, built from bytes, and able to
+   check bytes against its schema. */
+template <typename V>
+concept AbiView = std::is_trivially_copyable_v<V> &&
+                  std::is_constructible_v<V, std::span<const std::byte>> &&
+                  requires(std::span<const std::byte> bytes, ulong* footprint, V const& view) {
+                    { V::validate(bytes, footprint) } -> std::same_as<bool>;
+                    { view.footprint() } -> std::convertible_to<ulong>;
+                  };
+
+/* A generated writer, whose view() reads back what it wrote. */
+template <typename M>
+concept AbiWriter = std::is_trivially_copyable_v<M> &&
+                    std::is_constructible_v<M, std::span<std::byte>> &&
+                    requires(M const& writer) {
+                      { writer.view() } -> AbiView;
+                    };
+
+/* Validates the value at the front of bytes and returns a view of
+   exactly its footprint, reverting with TSDK_ABI_ERR_INVALID if bytes
+   hold no valid value.  The bytes after it go to rest, if given. */
+template <AbiView V>
+V abi_decode(std::span<const std::byte> bytes, std::span<const std::byte>* rest = nullptr) {
+  ulong footprint;
+  if (TSDK_UNLIKELY(!V::validate(bytes, &footprint))) {
+    tsdk_revert(TSDK_ABI_ERR_INVALID);
+  }
+  if (rest) {
+    *rest = bytes.subspan(footprint);
+  }
+  return V(bytes.first(footprint));
+}
+
+inline std::span<const std::byte> account_bytes(Account account) {
+  return {static_cast<const std::byte*>(account.get_data_ptr()), account.get_meta()->data_sz};
+}
+
+/* A validated view of an account's data.  Accounts may be larger than
+   the value they hold; the extra bytes are not part of the view. */
+template <AbiView V> V abi_view(Account account) {
+  return abi_decode<V>(account_bytes(account));
+}
+
+/* A writer over an account's data, promoted through writable.  The
+   current contents are validated first, so offsets the writer reads back
+   (counts, tags) are in bounds; a freshly zeroed account is valid for
+   any schema whose variable parts are sized by counts. */
+template <AbiWriter M> M abi_view_mut(Account account, WritableSet& writable) {
+  std::span<const std::byte> bytes = account_bytes(account);
+  using View = decltype(std::declval<M const&>().view());
+  if (TSDK_UNLIKELY(!View::validate(bytes, nullptr))) {
+    tsdk_revert(TSDK_ABI_ERR_INVALID);
+  }
+  writable.promote(account.index());
+  return M(std::span<std::byte>(const_cast<std::byte*>(bytes.data()), bytes.size()));
+}
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_abi_hpp */
@@ -0,0 +1,233 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_accounts_hpp
+#define HEADER_sdks_cpp_tn_sdk_accounts_hpp
+
+#include "tn_sdk.hpp"
+
+#include <concepts>
+#include <type_traits>
+
+/* Accounts<Constraints...> states what an instruction requires of the
+   transaction's accounts and checks all of it in one call:
+
+     using Deposit = thru::Accounts<thru::Signer<2>, thru::Writable<3>,
+                                    thru::OwnedBy<3, thru::Self>,
+                                    thru::MinSize<3, sizeof(Vault)>>;
+
+     Deposit::check(auth);
+
+   Account indices and requirements are template arguments, so the
+   checks unroll into straight-line code: one bounds check for every
+   index at once, one comparison for every Writable (read-write
+   accounts are a contiguous index range), a load of the current
+   program's address only if some OwnedBy<I, Self> needs it, and
+   Signers answered from the handler's AuthCache when it has one.
+
+   A failed constraint reverts with its own code.  Constraints are
+   checked by kind in the order of the codes below, so when several
+   fail the code names the first kind.
+
+   A Dispatcher handler can declare its constraints as a member
+   alias, and the Dispatcher checks them before calling handle():
+
+     struct Deposit {
+       static constexpr uchar DISCRIMINATOR = 1;
+       using Accounts = thru::Accounts<thru::Signer<2>, thru::Writable<3>>;
+       ...
+     }; */
+
+/* Accounts revert codes */
+constexpr ulong TSDK_ACCOUNTS_ERR_INVALID_INDEX = 0xBAD0BE00UL; /* Index past the txn's accounts */
+constexpr ulong TSDK_ACCOUNTS_ERR_NOT_WRITABLE  = 0xBAD0BE01UL; /* Writable<I> on a read-only account */
+constexpr ulong TSDK_ACCOUNTS_ERR_NOT_FOUND     = 0xBAD0BE02UL; /* Exists<I> on a missing account */
+constexpr ulong TSDK_ACCOUNTS_ERR_WRONG_OWNER   = 0xBAD0BE03UL; /* OwnedBy<I, O> failed */
+constexpr ulong TSDK_ACCOUNTS_ERR_TOO_SMALL     = 0xBAD0BE04UL; /* MinSize<I, Sz> failed */
+constexpr ulong TSDK_ACCOUNTS_ERR_NOT_SIGNER    = 0xBAD0BE05UL; /* Signer<I> not authorized */
+
+namespace thru {
+
+/* Owner tag for the executing program */
+struct Self {};
+
+/* An owner: Self, or a type naming a fixed program address as
+   static constexpr pubkey_t KEY */
+template <typename O>
+concept AccountOwner = std::same_as<O, Self> || requires {
+  { O::KEY } -> std::convertible_to<pubkey_t const&>;
+};
+
+namespace detail {
+
+enum class AccountCheck { EXISTS, WRITABLE, OWNED_BY, MIN_SIZE, SIGNER };
+
+} // namespace detail
+
+/* The account holds a v1 account (tsdk_account_exists) */
+template <ushort I> struct Exists {
+  static constexpr detail::AccountCheck CHECK = detail::AccountCheck::EXISTS;
+  static constexpr ushort INDEX = I;
+};
+
+/* The transaction lists the account as read-write */
+template <ushort I> struct Writable {
+  static_assert(I != 1U, "account 1, the transaction's program, is never writable");
+  static constexpr detail::AccountCheck CHECK = detail::AccountCheck::WRITABLE;
+  static constexpr ushort INDEX = I;
+};
+
+/* The account is authorized for this invocation (tsdk_is_account_authorized_by_idx) */
+template <ushort I> struct Signer {
+  static constexpr detail::AccountCheck CHECK = detail::AccountCheck::SIGNER;
+  static constexpr ushort INDEX = I;
+};
+
+/* The account's metadata names O as its owner */
+template <ushort I, AccountOwner O = Self> struct OwnedBy {
+  static constexpr detail::AccountCheck CHECK = detail::AccountCheck::OWNED_BY;
+  static constexpr ushort INDEX = I;
+  using Owner = O;
+};
+
+/* The account holds at least Sz bytes of data */
+template <ushort I, ulong Sz> struct MinSize {
+  static_assert(Sz <= TN_ACCOUNT_DATA_SZ_MAX, "no account holds that much data");
+  static constexpr detail::AccountCheck CHECK = detail::AccountCheck::MIN_SIZE;
+  static constexpr ushort INDEX = I;
+  static constexpr ulong SIZE = Sz;
+};
+
+template <typename C>
+concept AccountConstraint = requires {
+  { C::CHECK } -> std::convertible_to<detail::AccountCheck>;
+  { C::INDEX } -> std::convertible_to<ushort>;
+};
+
+namespace detail {
+
+template <typename T, typename C> T* ctx_ptr(C& c) {
+  if constexpr (std::is_same_v<C, T>) {
+    return &c;
+  } else {
+    return nullptr;
+  }
+}
+
+/* The first argument of type T, or nullptr */
+template <typename T, typename... Ctx> T* find_ctx(Ctx&... ctx) {
+  T* found = nullptr;
+  ((found = found ? found : ctx_ptr<T>(ctx)), ...);
+  return found;
+}
+
+} // namespace detail
+
+template <AccountConstraint... Cs> class Accounts {
+  using Check = detail::AccountCheck;
+
+  static constexpr ushort INDEX_MAX = [] {
+    ushort max = 0U;
+    ((max = Cs::INDEX > max ? Cs::INDEX : max), ...);
+    return max;
+  }();
+
+  /* Account 0, the fee payer, is always writable */
+  static constexpr ushort WRITABLE_MAX = [] {
+    ushort max = 0U;
+    ((max = Cs::CHECK == Check::WRITABLE && Cs::INDEX > max ? Cs::INDEX : max), ...);
+    return max;
+  }();
+
+  /* The fee payer is always authorized, so Signer<0> needs no walk */
+  static constexpr bool WALKS_AUTH = ((Cs::CHECK == Check::SIGNER && Cs::INDEX != 0U) || ...);
+
+  static constexpr bool NEEDS_SELF = [] {
+    bool needs = false;
+    (
+        [&needs] {
+          if constexpr (Cs::CHECK == Check::OWNED_BY) {
+            needs = needs || std::is_same_v<typename Cs::Owner, Self>;
+          }
+        }(),
+        ...);
+    return needs;
+  }();
+
+public:
+  static constexpr ulong CONSTRAINT_CNT = sizeof...(Cs);
+
+  /* Checks every constraint, reverting with the failed one's code.
+     Signers are resolved through the AuthCache among ctx if there is
+     one (check(auth), or the Dispatcher's context arguments), so a
+     cache the handler goes on to query is built once.  Without one each
+     Signer walks the shadow stack itself, which is the cheaper choice
+     for a handful of signers. */
+  template <typename... Ctx> static void check(Ctx&... ctx) {
+    [[maybe_unused]] AuthCache* auth = detail::find_ctx<AuthCache>(ctx...);
+    const tn_txn* txn = transaction::get();
+    if constexpr (sizeof...(Cs) > 0UL) {
+      if (TSDK_UNLIKELY(INDEX_MAX >= tn_txn_account_cnt(txn))) {
+        tsdk_revert(TSDK_ACCOUNTS_ERR_INVALID_INDEX);
+      }
+    }
+    if constexpr (WRITABLE_MAX != 0U) {
+      if (TSDK_UNLIKELY(WRITABLE_MAX >= 2U + tn_txn_readwrite_account_cnt(txn))) {
+        tsdk_revert(TSDK_ACCOUNTS_ERR_NOT_WRITABLE);
+      }
+    }
+    check_kind<Check::EXISTS>();
+    check_kind<Check::OWNED_BY>();
+    check_kind<Check::MIN_SIZE>();
+    if constexpr (WALKS_AUTH) {
+      (check_signer<Cs>(auth), ...);
+    }
+  }
+
+private:
+  template <Check K> static void check_kind() {
+    if constexpr (((Cs::CHECK == K) || ...)) {
+      [[maybe_unused]] const pubkey_t* self = nullptr;
+      if constexpr (K == Check::OWNED_BY && NEEDS_SELF) {
+        self = tsdk_get_current_program_acc_addr();
+      }
+      (check_meta<K, Cs>(self), ...);
+    }
+  }
+
+  template <Check K, typename C> static void check_meta([[maybe_unused]] const pubkey_t* self) {
+    if constexpr (C::CHECK == K) {
+      const tn_account_meta* meta = tsdk_get_account_meta(C::INDEX);
+      if constexpr (K == Check::EXISTS) {
+        if (TSDK_UNLIKELY(meta->version != TN_ACCOUNT_V1)) {
+          tsdk_revert(TSDK_ACCOUNTS_ERR_NOT_FOUND);
+        }
+      } else if constexpr (K == Check::OWNED_BY) {
+        const pubkey_t* owner;
+        if constexpr (std::is_same_v<typename C::Owner, Self>) {
+          owner = self;
+        } else {
+          owner = &C::Owner::KEY;
+        }
+        if (TSDK_UNLIKELY(!pubkey_eq(meta->owner, *owner))) {
+          tsdk_revert(TSDK_ACCOUNTS_ERR_WRONG_OWNER);
+        }
+      } else if constexpr (K == Check::MIN_SIZE) {
+        if (TSDK_UNLIKELY(meta->data_sz < C::SIZE)) {
+          tsdk_revert(TSDK_ACCOUNTS_ERR_TOO_SMALL);
+        }
+      }
+    }
+  }
+
+  template <typename C> static void check_signer(AuthCache* auth) {
+    if constexpr (C::CHECK == Check::SIGNER && C::INDEX != 0U) {
+      bool authorized = auth ? auth->is_authorized(C::INDEX)
+                             : tsdk_is_account_authorized_by_idx(C::INDEX) != 0;
+      if (TSDK_UNLIKELY(!authorized)) {
+        tsdk_revert(TSDK_ACCOUNTS_ERR_NOT_SIGNER);
+      }
+    }
+  }
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_accounts_hpp */
@@ -0,0 +1,245 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_block_hpp
+#define HEADER_sdks_cpp_tn_sdk_block_hpp
+
+#include "tn_sdk.hpp"
+
+#include <compare>
+#include <iterator>
+
+/* Past block contexts as a random-access range.  Element i is the block
+   i blocks ago (0 is the current block), so slot and block_time are
+   non-increasing along the range and it can be binary searched:
+
+     thru::block::History hist;
+     ulong i = hist.lower_bound_by_time(deadline);
+     if (i == hist.size()) {
+       ...no block at or before deadline in the history...
+     }
+     ulong price_then = hist[i].block_price;
+
+   sampled(stride) visits every stride-th block, e.g. one sample per 10
+   blocks over the last 1000 with History(1000).sampled(10).
+
+   PriceWindow<N> keeps the sum, min and max of block_price over the
+   last N blocks.  It is trivially copyable and zero-initialized state is
+   an empty window, so it can live in account data and catch up on only
+   the blocks since its last update:
+
+     auto twap = thru::AccountViewMut<thru::block::PriceWindow<64>>(acct, writable);
+     twap->update();
+     ulong mean = twap->mean(); */
+
+namespace thru {
+namespace block {
+
+/* Most contexts the block context segment can hold */
+constexpr ulong HISTORY_MAX = TSDK_SEG_OFFSET_MAX / TSDK_BLOCK_CTX_VM_SPACING;
+
+class History {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = tn_block_ctx;
+    using difference_type = long;
+    using pointer = tn_block_ctx const*;
+    using reference = tn_block_ctx const&;
+
+    iterator() = default;
+
+    reference operator*() const { return *get(); }
+    pointer operator->() const { return get(); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator& operator++() { return *this += 1L; }
+    iterator& operator--() { return *this -= 1L; }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+    iterator operator--(int) {
+      iterator it = *this;
+      --*this;
+      return it;
+    }
+
+    iterator& operator+=(difference_type n) {
+      idx_ += static_cast<ulong>(n) * stride_;
+      return *this;
+    }
+    iterator& operator-=(difference_type n) { return *this += -n; }
+    friend iterator operator+(iterator it, difference_type n) { return it += n; }
+    friend iterator operator+(difference_type n, iterator it) { return it += n; }
+    friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(iterator a, iterator b) {
+      return static_cast<difference_type>(a.idx_ - b.idx_) / static_cast<difference_type>(a.stride_);
+    }
+
+    bool operator==(iterator const& o) const { return idx_ == o.idx_; }
+    std::strong_ordering operator<=>(iterator const& o) const { return idx_ <=> o.idx_; }
+
+    /* Blocks ago of the current element */
+    ulong blocks_ago() const { return idx_; }
+
+  private:
+    friend class History;
+
+    iterator(ulong idx, ulong stride) : idx_(idx), stride_(stride) {}
+
+    pointer get() const { return tsdk_get_past_block_ctx(idx_); }
+
+    ulong idx_ = 0UL;
+    ulong stride_ = 1UL;
+  };
+
+  /* Every stride-th block of a History, starting with the newest */
+  class Sampled {
+  public:
+    iterator begin() const { return iterator(0UL, stride_); }
+    iterator end() const { return iterator(cnt_ * stride_, stride_); }
+    ulong size() const { return cnt_; }
+    tn_block_ctx const& operator[](ulong i) const { return *tsdk_get_past_block_ctx(i * stride_); }
+
+  private:
+    friend class History;
+
+    Sampled(ulong cnt, ulong stride) : cnt_(cnt), stride_(stride) {}
+
+    ulong cnt_;
+    ulong stride_;
+  };
+
+  /* The last depth blocks, or all of the history if it is shorter */
+  explicit History(ulong depth = HISTORY_MAX) : size_(depth < available() ? depth : available()) {}
+
+  /* Blocks in the history: the current one plus one per earlier slot,
+     up to what the segment holds */
+  static ulong available() {
+    ulong slot = tsdk_get_current_block_ctx()->slot;
+    return slot < HISTORY_MAX - 1UL ? slot + 1UL : HISTORY_MAX;
+  }
+
+  ulong size() const { return size_; }
+  bool empty() const { return !size_; }
+
+  iterator begin() const { return iterator(0UL, 1UL); }
+  iterator end() const { return iterator(size_, 1UL); }
+
+  tn_block_ctx const& operator[](ulong blocks_ago) const {
+    return *tsdk_get_past_block_ctx(blocks_ago);
+  }
+  tn_block_ctx const& front() const { return (*this)[0UL]; }
+  tn_block_ctx const& back() const { return (*this)[size_ - 1UL]; }
+
+  /* Index of the newest block with block_time <= time, or size() if
+     every block in the history is newer */
+  ulong lower_bound_by_time(ulong time) const {
+    return partition_point([time](tn_block_ctx const& ctx) { return ctx.block_time > time; });
+  }
+
+  /* Index of the newest block with slot <= slot, or size() */
+  ulong lower_bound_by_slot(ulong slot) const {
+    return partition_point([slot](tn_block_ctx const& ctx) { return ctx.slot > slot; });
+  }
+
+  /* Blocks 0, stride, 2*stride, ... below size() */
+  Sampled sampled(ulong stride) const {
+    return Sampled(stride ? (size_ + stride - 1UL) / stride : 0UL, stride ? stride : 1UL);
+  }
+
+private:
+  /* First index where newer(ctx) is false; newer must hold for a prefix */
+  template <typename F> ulong partition_point(F newer) const {
+    ulong lo = 0UL;
+    ulong hi = size_;
+    while (lo < hi) {
+      ulong mid = lo + (hi - lo) / 2UL;
+      if (newer((*this)[mid])) {
+        lo = mid + 1UL;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  ulong size_;
+};
+
+/* Sum, min and max of block_price over the last N blocks, updated
+   incrementally.  Min and max are kept with monotonic queues, so a
+   push is amortized O(1) and nothing is rescanned.  The sum is a plain
+   ulong: N * max block_price must fit. */
+template <ulong N> class PriceWindow {
+  static_assert(N > 0UL, "empty window");
+
+public:
+  /* Pushes every block since the last update, oldest first; at most N
+     are read since older ones would be evicted anyway */
+  void update() {
+    History hist(N);
+    ulong new_cnt = 0UL;
+    while (new_cnt < hist.size() && (!seq_ || hist[new_cnt].slot > last_slot_)) {
+      new_cnt++;
+    }
+    for (ulong i = new_cnt; i > 0UL; i--) {
+      tn_block_ctx const& ctx = hist[i - 1UL];
+      push(ctx.slot, ctx.block_price);
+    }
+  }
+
+  void push(ulong slot, ulong price) {
+    ulong seq = seq_++;
+    if (seq >= N) {
+      ulong old = seq - N;
+      sum_ -= prices_[old % N];
+      if (min_q_[min_head_ % N] == old) {
+        min_head_++;
+      }
+      if (max_q_[max_head_ % N] == old) {
+        max_head_++;
+      }
+    }
+    while (min_tail_ != min_head_ && prices_[min_q_[(min_tail_ - 1UL) % N] % N] >= price) {
+      min_tail_--;
+    }
+    while (max_tail_ != max_head_ && prices_[max_q_[(max_tail_ - 1UL) % N] % N] <= price) {
+      max_tail_--;
+    }
+    prices_[seq % N] = price;
+    min_q_[min_tail_++ % N] = seq;
+    max_q_[max_tail_++ % N] = seq;
+    sum_ += price;
+    last_slot_ = slot;
+  }
+
+  /* Blocks in the window, at most N */
+  ulong count() const { return seq_ < N ? seq_ : N; }
+  bool empty() const { return !seq_; }
+
+  ulong sum() const { return sum_; }
+  ulong mean() const { return seq_ ? sum_ / count() : 0UL; }
+  ulong min() const { return seq_ ? prices_[min_q_[min_head_ % N] % N] : 0UL; }
+  ulong max() const { return seq_ ? prices_[max_q_[max_head_ % N] % N] : 0UL; }
+
+  /* Slot of the newest block pushed */
+  ulong last_slot() const { return last_slot_; }
+
+private:
+  ulong seq_;       /* Blocks pushed so far */
+  ulong last_slot_;
+  ulong sum_;
+  ulong min_head_;  /* Queue positions; entries are [head, tail) mod N */
+  ulong min_tail_;
+  ulong max_head_;
+  ulong max_tail_;
+  ulong prices_[N]; /* Ring of the last N prices, by seq % N */
+  ulong min_q_[N];  /* Seqs with increasing prices */
+  ulong max_q_[N];  /* Seqs with decreasing prices */
+};
+
+} // namespace block
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_block_hpp */
@@ -0,0 +1,152 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_bls_hpp
+#define HEADER_sdks_cpp_tn_sdk_bls_hpp
+
+#include "tn_sdk.hpp"
+#include "tn_sdk_rle.hpp"
+
+#include <blst.h>
+
+#include <span>
+
+/* BLS12-381 pubkey aggregation over blst (SDK_EXTRAS=blst, see
+   config/extra/with-blst.mk).  Points use blst's affine layout, the same
+   as the C SDK's tn_bls_pubkey_t, so a guardian set stored in account
+   data can be used in place.
+
+   The aggregate of a quorum certificate's signers is computed straight
+   from its RLE signer set, accumulating in projective coordinates and
+   converting to affine once.  This is the C SDK's
+   tn_crypto_aggregate_pubkeys_rle, which the SDK library builds along
+   with blst, reverting instead of returning an error:
+
+     std::span<const thru::crypto::BlsPubkey> set = ...;
+     thru::crypto::BlsPubkey agg = thru::crypto::aggregate_pubkeys(set, signers, &full);
+
+   full is the aggregate of the whole set (aggregate_pubkeys(set)),
+   typically cached next to it.  When passed and fewer than half of the
+   set is absent, the absent pubkeys are subtracted from it instead of
+   the present ones being added.
+
+   BatchVerifier checks many (signature, pubkey, message) tuples, each
+   with its own message, with one multi-pairing instead of a pairing
+   check per tuple.  Tuples are collected as they are parsed and only
+   referenced, so they must stay in place until verify():
+
+     thru::crypto::BatchVerifier<32> batch;
+     for (...) {
+       batch.add(att->signature, set[att->guardian], att->payload());
+     }
+     if (!batch.verify()) {
+       tsdk_revert(BAD_ATTESTATION_BASE + batch.failed_idx());
+     }
+
+   This is the C SDK's tn_crypto_verify_batch_with_dst: each tuple is
+   weighted by a 128-bit scalar derived from a hash of the whole batch, so
+   invalid signatures cannot cancel each other out.  If the batch fails
+   it is bisected to find the lowest failing tuple.  The pairing context
+   is allocated on the stack with alloca, so programs bound the call for
+   the stack check, e.g. TSDK_STACK_BOUND("tn_crypto_verify_batch_with_dst",
+   12288) (see bench/bls_quorum.cpp). */
+
+/* BLS revert codes */
+constexpr ulong TSDK_BLS_ERR_SIGNER_OUT_OF_RANGE = 0xBAD0B900UL; /* Signer bit past the end of the set */
+constexpr ulong TSDK_BLS_ERR_NO_SIGNERS = 0xBAD0B901UL;          /* Nothing to aggregate */
+constexpr ulong TSDK_BLS_ERR_BATCH_FULL = 0xBAD0B902UL;          /* BatchVerifier capacity exceeded */
+
+/* The C SDK's aggregation routines.  tn_crypto.h takes its base types
+   from the C SDK's VM headers, as tn_sdk_crypto.c is built, and tn_rle
+   is packed through its typedef and ends in a flexible array member,
+   neither of which C++ accepts quietly. */
+#ifndef THRU_VM
+#define THRU_VM 1
+#define TSDK_BLS_THRU_VM
+#endif
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma GCC diagnostic ignored "-Wattributes"
+extern "C" {
+#include "../../../c/thru-sdk/c/tn_crypto.h"
+}
+#pragma GCC diagnostic pop
+#ifdef TSDK_BLS_THRU_VM
+#undef THRU_VM
+#undef TSDK_BLS_THRU_VM
+#endif
+
+namespace thru {
+namespace crypto {
+
+using BlsPubkey = blst_p1_affine;
+using BlsSignature = blst_p2_affine;
+
+/* The aggregate of every pubkey in set; reverts if set is empty */
+inline BlsPubkey aggregate_pubkeys(std::span<const BlsPubkey> set) {
+  BlsPubkey out;
+  if (TSDK_UNLIKELY(tn_crypto_aggregate_pubkeys_many(&out, set.data(), set.size()) != 0)) {
+    tsdk_revert(TSDK_BLS_ERR_NO_SIGNERS);
+  }
+  return out;
+}
+
+/* The aggregate of set[i] for every set bit i in signers.  Positions
+   past the end of signers count as absent.  Reverts if a signer is past
+   the end of set or nobody signed. */
+inline BlsPubkey aggregate_pubkeys(std::span<const BlsPubkey> set, rle::Rle signers,
+                                   BlsPubkey const* full_aggregate = nullptr) {
+  BlsPubkey out;
+  int err = tn_crypto_aggregate_pubkeys_rle(&out, set.data(), set.size(),
+                                            static_cast<tn_rle const*>(signers.data()),
+                                            full_aggregate);
+  if (TSDK_UNLIKELY(err == TN_CRYPTO_ERR_INVALID_PARAM)) {
+    tsdk_revert(TSDK_BLS_ERR_SIGNER_OUT_OF_RANGE);
+  }
+  if (TSDK_UNLIKELY(err != 0)) {
+    tsdk_revert(TSDK_BLS_ERR_NO_SIGNERS);
+  }
+  return out;
+}
+
+/* Domain separation tag of consensus signatures, as in the C SDK */
+inline constexpr uchar BLS_CONSENSUS_DST[] = "TN_CONSENSUS_V1";
+
+template <ulong MaxEntries> class BatchVerifier {
+public:
+  BatchVerifier() : cnt_(0UL), failed_idx_(~0UL) {}
+
+  /* Queues a tuple; the referenced data must stay in place until
+     verify().  Reverts with TSDK_BLS_ERR_BATCH_FULL past MaxEntries. */
+  void add(BlsSignature const& signature, BlsPubkey const& pubkey,
+           std::span<const std::byte> message) {
+    if (TSDK_UNLIKELY(cnt_ >= MaxEntries)) {
+      tsdk_revert(TSDK_BLS_ERR_BATCH_FULL);
+    }
+    /* The C SDK rejects a null message, which an empty span may have */
+    static constexpr std::byte empty_message{};
+    entries_[cnt_++] = tn_crypto_batch_entry{
+        &signature, &pubkey, message.empty() ? &empty_message : message.data(), message.size()};
+  }
+
+  ulong size() const { return cnt_; }
+  bool empty() const { return !cnt_; }
+  void clear() { cnt_ = 0UL; }
+
+  /* True if every queued tuple verifies (vacuously so when empty).  On
+     false, failed_idx() is the index of the lowest failing tuple. */
+  bool verify(std::span<const uchar> dst = {BLS_CONSENSUS_DST, sizeof(BLS_CONSENSUS_DST) - 1UL}) {
+    failed_idx_ = ~0UL;
+    return !cnt_ || !tn_crypto_verify_batch_with_dst(entries_, cnt_, dst.data(), dst.size(),
+                                                      &failed_idx_);
+  }
+
+  ulong failed_idx() const { return failed_idx_; }
+
+private:
+  tn_crypto_batch_entry entries_[MaxEntries];
+  ulong cnt_;
+  ulong failed_idx_;
+};
+
+} // namespace crypto
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_bls_hpp */
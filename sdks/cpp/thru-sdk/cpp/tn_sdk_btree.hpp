@@ -0,0 +1,786 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_btree_hpp
+#define HEADER_sdks_cpp_tn_sdk_btree_hpp
+
+#include "tn_sdk.hpp"
+
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <span>
+
+/* BTree<Key, Value> is an ordered map stored in the data of one or more
+   program-owned accounts, for order books, expiry queues and anything
+   else that needs range scans.  It is a B+tree with one node per VM
+   page (TSDK_PAGE_SZ): values live in the leaves, leaves are chained in
+   key order, and an insert or erase touches O(log n) pages instead of
+   shifting a sorted array:
+
+     using Book = thru::BTree<ulong, Order>;
+
+     thru::WritableSet writable;
+     thru::Account accts[] = {thru::Account(3), thru::Account(4)};
+     Book book = Book::join(accts, writable);
+     book.insert(price, order);
+     for (auto it = book.range(lo, hi).begin(); it != std::default_sentinel; ++it) {
+       ...it.key(), it.value()...
+     }
+
+   Page 0 of the first account holds the tree header, the other pages
+   are nodes.  Pages are numbered across the accounts in the order they
+   were given to format(), 4096 to an account, and join() checks that
+   the same accounts are passed in the same order.  Freed nodes go on a
+   free list and are reused before the tree grows; growth resizes the
+   current account geometrically, so N inserts cost O(log N) resize
+   syscalls.
+
+   Key and Value are stored as raw bytes, so they must be trivially
+   copyable with at most 16-byte alignment.  Keys are ordered by
+   Compare. */
+
+constexpr ulong TSDK_BTREE_MAGIC = 0xB7EEB7EE0C0DE001UL;
+
+/* Accounts one tree may span */
+constexpr ulong TSDK_BTREE_ACCOUNT_MAX = 16UL;
+
+/* BTree revert codes */
+constexpr ulong TSDK_BTREE_ERR_INVALID       = 0xBAD0BC00UL; /* Not a tree of this shape, or other accounts */
+constexpr ulong TSDK_BTREE_ERR_FULL          = 0xBAD0BC01UL; /* Every account is at its maximum size */
+constexpr ulong TSDK_BTREE_ERR_RESIZE_FAILED = 0xBAD0BC02UL; /* tsys_account_resize refused */
+constexpr ulong TSDK_BTREE_ERR_UNSORTED      = 0xBAD0BC03UL; /* bulk_load keys not strictly increasing */
+constexpr ulong TSDK_BTREE_ERR_NOT_EMPTY     = 0xBAD0BC04UL; /* bulk_load into a non-empty tree */
+
+namespace thru {
+
+struct BTreeHeader {
+  ulong magic;
+  uint key_sz;
+  uint val_sz;
+  uint root;
+  uint height;     /* Levels, 1 when the root is a leaf */
+  uint first_leaf;
+  uint free_head;  /* Free list of node pages, 0 when empty */
+  uint page_cnt;   /* Pages handed out so far, including page 0 */
+  uint account_cnt;
+  ulong key_cnt;
+  pubkey_t accounts[TSDK_BTREE_ACCOUNT_MAX];
+};
+
+template <Trivial Key, Trivial Value, typename Compare = std::less<Key>> class BTree {
+  static_assert(alignof(Key) <= 16UL && alignof(Value) <= 16UL, "over-aligned key or value");
+
+  struct Node {
+    uint cnt;
+    uint leaf;
+    uint next; /* Next leaf in key order, or next free page */
+    uint reserved;
+  };
+
+  static constexpr ulong NODE_HDR_SZ = sizeof(Node);
+  static constexpr ulong LG_PAGES_PER_ACCOUNT = 12UL;
+  static constexpr ulong PAGES_PER_ACCOUNT = 1UL << LG_PAGES_PER_ACCOUNT;
+  static_assert(PAGES_PER_ACCOUNT * TSDK_PAGE_SZ == TN_ACCOUNT_DATA_SZ_MAX);
+  static_assert(sizeof(BTreeHeader) <= TSDK_PAGE_SZ);
+
+  static constexpr ulong leaf_val_off(ulong n) {
+    return mem::align_up(NODE_HDR_SZ + n * sizeof(Key), alignof(Value));
+  }
+  static constexpr ulong inner_child_off(ulong n) {
+    return mem::align_up(NODE_HDR_SZ + n * sizeof(Key), alignof(uint));
+  }
+  static constexpr ulong leaf_max() {
+    ulong n = (TSDK_PAGE_SZ - NODE_HDR_SZ) / (sizeof(Key) + sizeof(Value));
+    while (n && leaf_val_off(n) + n * sizeof(Value) > TSDK_PAGE_SZ) {
+      n--;
+    }
+    return n;
+  }
+  static constexpr ulong inner_max() {
+    ulong n = (TSDK_PAGE_SZ - NODE_HDR_SZ - sizeof(uint)) / (sizeof(Key) + sizeof(uint));
+    while (n && inner_child_off(n) + (n + 1UL) * sizeof(uint) > TSDK_PAGE_SZ) {
+      n--;
+    }
+    return n;
+  }
+
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using Header = BTreeHeader;
+
+  struct Entry {
+    Key key;
+    Value value;
+  };
+
+  /* Keys per leaf and per inner node */
+  static constexpr ulong LEAF_MAX = leaf_max();
+  static constexpr ulong INNER_MAX = inner_max();
+  static constexpr ulong LEAF_MIN = LEAF_MAX / 2UL;
+  static constexpr ulong INNER_MIN = INNER_MAX / 2UL;
+  static_assert(LEAF_MAX >= 4UL && INNER_MAX >= 4UL, "key or value too large for a page");
+
+  static constexpr ulong HEIGHT_MAX = 32UL;
+
+  class iterator {
+  public:
+    iterator() = default;
+
+    Key const& key() const { return tree_->leaf_keys(leaf_)[pos_]; }
+    Value& value() const { return tree_->leaf_vals(leaf_)[pos_]; }
+
+    iterator& operator++() {
+      if (++pos_ >= tree_->node(leaf_)->cnt) {
+        leaf_ = tree_->node(leaf_)->next;
+        pos_ = 0U;
+        tree_->skip_empty(leaf_, pos_);
+      }
+      return *this;
+    }
+
+    bool operator==(iterator const& o) const { return leaf_ == o.leaf_ && pos_ == o.pos_; }
+    bool operator==(std::default_sentinel_t) const { return !leaf_; }
+
+  private:
+    friend class BTree;
+
+    iterator(BTree const* tree, uint leaf, uint pos) : tree_(tree), leaf_(leaf), pos_(pos) {
+      if (leaf_) {
+        tree_->skip_empty(leaf_, pos_);
+      }
+    }
+
+    BTree const* tree_ = nullptr;
+    uint leaf_ = 0U;
+    uint pos_ = 0U;
+  };
+
+  /* Keys in [lo, hi), in order */
+  class Range {
+  public:
+    class iterator {
+    public:
+      iterator() = default;
+
+      Key const& key() const { return it_.key(); }
+      Value& value() const { return it_.value(); }
+
+      iterator& operator++() {
+        ++it_;
+        return *this;
+      }
+
+      bool operator==(std::default_sentinel_t) const {
+        return it_ == std::default_sentinel || !Compare()(it_.key(), hi_);
+      }
+
+    private:
+      friend class Range;
+
+      iterator(BTree::iterator it, Key const& hi) : it_(it), hi_(hi) {}
+
+      BTree::iterator it_;
+      Key hi_{};
+    };
+
+    iterator begin() const { return iterator(first_, hi_); }
+    std::default_sentinel_t end() const { return {}; }
+
+  private:
+    friend class BTree;
+
+    Range(BTree::iterator first, Key const& hi) : first_(first), hi_(hi) {}
+
+    BTree::iterator first_;
+    Key hi_;
+  };
+
+  /* Formats an empty tree over accounts, discarding their data.  The
+     first account is resized to two pages (header and root leaf), the
+     others to zero until the tree grows into them. */
+  static BTree format(std::span<const Account> accounts, WritableSet& writable) {
+    BTree t(accounts, writable);
+    for (ulong i = 0UL; i < t.account_cnt_; i++) {
+      t.resize_account(i, i ? 0UL : 2UL);
+    }
+    t.hdr_ = reinterpret_cast<Header*>(t.bases_[0]);
+    std::memset(t.hdr_, 0, sizeof(Header));
+    t.hdr_->magic = TSDK_BTREE_MAGIC;
+    t.hdr_->key_sz = static_cast<uint>(sizeof(Key));
+    t.hdr_->val_sz = static_cast<uint>(sizeof(Value));
+    t.hdr_->page_cnt = 2U;
+    t.hdr_->account_cnt = static_cast<uint>(t.account_cnt_);
+    pubkey_t const* addrs = tn_txn_get_acct_addrs(tsdk_get_txn());
+    for (ulong i = 0UL; i < t.account_cnt_; i++) {
+      t.hdr_->accounts[i] = addrs[accounts[i].index()];
+    }
+    t.init_node(1U, true);
+    t.hdr_->root = 1U;
+    t.hdr_->height = 1U;
+    t.hdr_->first_leaf = 1U;
+    return t;
+  }
+
+  /* Joins the tree formatted over accounts, promoting them through
+     writable.  Reverts with TSDK_BTREE_ERR_INVALID unless they hold a
+     tree of this shape and are the accounts it was formatted over. */
+  static BTree join(std::span<const Account> accounts, WritableSet& writable) {
+    BTree t(accounts, writable);
+    if (TSDK_UNLIKELY(t.pages_[0] < 2UL)) {
+      tsdk_revert(TSDK_BTREE_ERR_INVALID);
+    }
+    t.hdr_ = reinterpret_cast<Header*>(t.bases_[0]);
+    Header const* hdr = t.hdr_;
+    if (TSDK_UNLIKELY(hdr->magic != TSDK_BTREE_MAGIC || hdr->key_sz != sizeof(Key) ||
+                      hdr->val_sz != sizeof(Value) || hdr->account_cnt != t.account_cnt_)) {
+      tsdk_revert(TSDK_BTREE_ERR_INVALID);
+    }
+    pubkey_t const* addrs = tn_txn_get_acct_addrs(tsdk_get_txn());
+    for (ulong i = 0UL; i < t.account_cnt_; i++) {
+      ulong first = i << LG_PAGES_PER_ACCOUNT;
+      ulong used = hdr->page_cnt > first ? hdr->page_cnt - first : 0UL;
+      used = used < PAGES_PER_ACCOUNT ? used : PAGES_PER_ACCOUNT;
+      if (TSDK_UNLIKELY(!pubkey_eq(hdr->accounts[i], addrs[accounts[i].index()]) ||
+                        t.pages_[i] < used)) {
+        tsdk_revert(TSDK_BTREE_ERR_INVALID);
+      }
+    }
+    return t;
+  }
+
+  static BTree format(Account account, WritableSet& writable) {
+    return format(std::span<const Account>(&account, 1UL), writable);
+  }
+  static BTree join(Account account, WritableSet& writable) {
+    return join(std::span<const Account>(&account, 1UL), writable);
+  }
+
+  ulong size() const { return hdr_->key_cnt; }
+  bool empty() const { return !hdr_->key_cnt; }
+  ulong height() const { return hdr_->height; }
+
+  /* Node pages in use (allocated and not on the free list) */
+  ulong page_cnt() const {
+    ulong free = 0UL;
+    for (uint id = hdr_->free_head; id; id = node(id)->next) {
+      free++;
+    }
+    return hdr_->page_cnt - 1UL - free;
+  }
+
+  iterator begin() const { return iterator(this, hdr_->first_leaf, 0U); }
+  std::default_sentinel_t end() const { return {}; }
+
+  Value* find(Key const& key) const {
+    uint leaf = find_leaf(key);
+    uint pos = leaf_pos(leaf, key);
+    if (pos < node(leaf)->cnt && !less(key, leaf_keys(leaf)[pos])) {
+      return &leaf_vals(leaf)[pos];
+    }
+    return nullptr;
+  }
+
+  bool contains(Key const& key) const { return find(key) != nullptr; }
+
+  /* First entry with key >= key */
+  iterator lower_bound(Key const& key) const {
+    uint leaf = find_leaf(key);
+    return iterator(this, leaf, leaf_pos(leaf, key));
+  }
+
+  Range range(Key const& lo, Key const& hi) const { return Range(lower_bound(lo), hi); }
+
+  /* Inserts (key, value) and returns true, or returns false and leaves
+     the tree unchanged if key is present */
+  bool insert(Key const& key, Value const& value) { return put(key, value, false); }
+
+  /* Inserts or overwrites; returns true if key was new */
+  bool insert_or_assign(Key const& key, Value const& value) { return put(key, value, true); }
+
+  /* Removes key; returns false if it was not present */
+  bool erase(Key const& key) {
+    PathEntry path[HEIGHT_MAX];
+    uint leaf = descend(key, path);
+    uint pos = leaf_pos(leaf, key);
+    Node* n = node(leaf);
+    if (pos >= n->cnt || less(key, leaf_keys(leaf)[pos])) {
+      return false;
+    }
+    move(leaf_keys(leaf) + pos, leaf_keys(leaf) + pos + 1U, n->cnt - pos - 1U);
+    move(leaf_vals(leaf) + pos, leaf_vals(leaf) + pos + 1U, n->cnt - pos - 1U);
+    n->cnt--;
+    hdr_->key_cnt--;
+    rebalance(path, hdr_->height - 1U, leaf);
+    return true;
+  }
+
+  /* Loads strictly increasing entries into an empty tree, filling the
+     leaves evenly and building each inner level once.  Reverts with TSDK_BTREE_ERR_NOT_EMPTY or
+     TSDK_BTREE_ERR_UNSORTED. */
+  void bulk_load(std::span<const Entry> entries) {
+    if (TSDK_UNLIKELY(hdr_->key_cnt)) {
+      tsdk_revert(TSDK_BTREE_ERR_NOT_EMPTY);
+    }
+    for (ulong i = 1UL; i < entries.size(); i++) {
+      if (TSDK_UNLIKELY(!less(entries[i - 1UL].key, entries[i].key))) {
+        tsdk_revert(TSDK_BTREE_ERR_UNSORTED);
+      }
+    }
+    if (entries.empty()) {
+      return;
+    }
+
+    /* Leaves, evenly filled so none is under LEAF_MIN; chained with next */
+    ulong n = entries.size();
+    ulong level_cnt = (n + LEAF_MAX - 1UL) / LEAF_MAX;
+    uint first = hdr_->root;
+    uint prev = 0U;
+    for (ulong i = 0UL, off = 0UL; i < level_cnt; i++) {
+      ulong cnt = n / level_cnt + (i < n % level_cnt ? 1UL : 0UL);
+      uint id = i ? alloc_node(true) : first;
+      Node* leaf = node(id);
+      for (ulong j = 0UL; j < cnt; j++) {
+        leaf_keys(id)[j] = entries[off + j].key;
+        leaf_vals(id)[j] = entries[off + j].value;
+      }
+      leaf->cnt = static_cast<uint>(cnt);
+      if (prev) {
+        node(prev)->next = id;
+      }
+      prev = id;
+      off += cnt;
+    }
+    hdr_->key_cnt = n;
+
+    /* Inner levels over the previous one, walked through next links
+       (only leaves keep them afterwards) */
+    uint height = 1U;
+    while (level_cnt > 1UL) {
+      ulong parent_cnt = (level_cnt + INNER_MAX) / (INNER_MAX + 1UL);
+      uint child = first;
+      uint parent_prev = 0U;
+      uint parent_first = 0U;
+      for (ulong i = 0UL; i < parent_cnt; i++) {
+        ulong cnt = level_cnt / parent_cnt + (i < level_cnt % parent_cnt ? 1UL : 0UL);
+        uint id = alloc_node(false);
+        for (ulong j = 0UL; j < cnt; j++) {
+          if (j) {
+            inner_keys(id)[j - 1UL] = min_key(child);
+          }
+          inner_children(id)[j] = child;
+          child = node(child)->next;
+        }
+        node(id)->cnt = static_cast<uint>(cnt - 1UL);
+        if (parent_prev) {
+          node(parent_prev)->next = id;
+        } else {
+          parent_first = id;
+        }
+        parent_prev = id;
+      }
+      if (height > 1U) {
+        for (uint id = first; id;) {
+          uint next = node(id)->next;
+          node(id)->next = 0U;
+          id = next;
+        }
+      }
+      first = parent_first;
+      level_cnt = parent_cnt;
+      height++;
+    }
+    if (height > 1U) {
+      node(first)->next = 0U;
+    }
+    hdr_->root = first;
+    hdr_->height = height;
+  }
+
+private:
+  struct PathEntry {
+    uint id;
+    uint idx; /* Child taken */
+  };
+
+  BTree(std::span<const Account> accounts, WritableSet& writable)
+      : hdr_(nullptr), account_cnt_(accounts.size()) {
+    if (TSDK_UNLIKELY(accounts.empty() || accounts.size() > TSDK_BTREE_ACCOUNT_MAX)) {
+      tsdk_revert(TSDK_BTREE_ERR_INVALID);
+    }
+    for (ulong i = 0UL; i < account_cnt_; i++) {
+      writable.promote(accounts[i].index());
+      idx_[i] = accounts[i].index();
+      bases_[i] = static_cast<uchar*>(accounts[i].get_data_ptr());
+      pages_[i] = accounts[i].get_meta()->data_sz / TSDK_PAGE_SZ;
+    }
+  }
+
+  static bool less(Key const& a, Key const& b) { return Compare()(a, b); }
+
+  template <typename T> static void move(T* dst, T const* src, ulong cnt) {
+    std::memmove(static_cast<void*>(dst), src, cnt * sizeof(T));
+  }
+
+  uchar* page(uint id) const {
+    return bases_[id >> LG_PAGES_PER_ACCOUNT] + (id & (PAGES_PER_ACCOUNT - 1UL)) * TSDK_PAGE_SZ;
+  }
+  Node* node(uint id) const { return reinterpret_cast<Node*>(page(id)); }
+  Key* leaf_keys(uint id) const { return reinterpret_cast<Key*>(page(id) + NODE_HDR_SZ); }
+  Value* leaf_vals(uint id) const {
+    return reinterpret_cast<Value*>(page(id) + leaf_val_off(LEAF_MAX));
+  }
+  Key* inner_keys(uint id) const { return reinterpret_cast<Key*>(page(id) + NODE_HDR_SZ); }
+  uint* inner_children(uint id) const {
+    return reinterpret_cast<uint*>(page(id) + inner_child_off(INNER_MAX));
+  }
+
+  /* Moves an end-of-leaf position to the start of the next non-empty leaf */
+  void skip_empty(uint& leaf, uint& pos) const {
+    while (leaf && pos >= node(leaf)->cnt) {
+      leaf = node(leaf)->next;
+      pos = 0U;
+    }
+  }
+
+  /* First position in leaf with key >= key */
+  uint leaf_pos(uint leaf, Key const& key) const {
+    Key const* keys = leaf_keys(leaf);
+    uint lo = 0U;
+    uint hi = node(leaf)->cnt;
+    while (lo < hi) {
+      uint mid = lo + (hi - lo) / 2U;
+      if (less(keys[mid], key)) {
+        lo = mid + 1U;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /* Child of inner node id whose subtree holds key */
+  uint child_idx(uint id, Key const& key) const {
+    Key const* keys = inner_keys(id);
+    uint lo = 0U;
+    uint hi = node(id)->cnt;
+    while (lo < hi) {
+      uint mid = lo + (hi - lo) / 2U;
+      if (!less(key, keys[mid])) {
+        lo = mid + 1U;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  uint find_leaf(Key const& key) const {
+    uint id = hdr_->root;
+    for (uint level = hdr_->height; level > 1U; level--) {
+      id = inner_children(id)[child_idx(id, key)];
+    }
+    return id;
+  }
+
+  /* Like find_leaf, recording the inner nodes visited */
+  uint descend(Key const& key, PathEntry* path) const {
+    uint id = hdr_->root;
+    for (uint level = 0U; level + 1U < hdr_->height; level++) {
+      uint idx = child_idx(id, key);
+      path[level] = PathEntry{id, idx};
+      id = inner_children(id)[idx];
+    }
+    return id;
+  }
+
+  Key const& min_key(uint id) const {
+    while (!node(id)->leaf) {
+      id = inner_children(id)[0];
+    }
+    return leaf_keys(id)[0];
+  }
+
+  void init_node(uint id, bool leaf) {
+    Node* n = node(id);
+    n->cnt = 0U;
+    n->leaf = leaf ? 1U : 0U;
+    n->next = 0U;
+    n->reserved = 0U;
+  }
+
+  void resize_account(ulong i, ulong pages) {
+    if (TSDK_UNLIKELY(tsys_account_resize(idx_[i], pages * TSDK_PAGE_SZ) != TSDK_SUCCESS)) {
+      tsdk_revert(TSDK_BTREE_ERR_RESIZE_FAILED);
+    }
+    pages_[i] = pages;
+  }
+
+  /* A node page from the free list, or the next unused page, growing
+     its account to at least twice its size if needed */
+  uint alloc_node(bool leaf) {
+    uint id = hdr_->free_head;
+    if (id) {
+      hdr_->free_head = node(id)->next;
+    } else {
+      id = hdr_->page_cnt;
+      ulong acct = id >> LG_PAGES_PER_ACCOUNT;
+      ulong pg = id & (PAGES_PER_ACCOUNT - 1UL);
+      if (TSDK_UNLIKELY(acct >= account_cnt_)) {
+        tsdk_revert(TSDK_BTREE_ERR_FULL);
+      }
+      if (pg >= pages_[acct]) {
+        ulong pages = pages_[acct] * 2UL;
+        pages = pages > pg + 1UL ? pages : pg + 1UL;
+        resize_account(acct, pages < PAGES_PER_ACCOUNT ? pages : PAGES_PER_ACCOUNT);
+      }
+      hdr_->page_cnt = id + 1U;
+    }
+    init_node(id, leaf);
+    return id;
+  }
+
+  void free_node(uint id) {
+    node(id)->next = hdr_->free_head;
+    node(id)->cnt = 0U;
+    hdr_->free_head = id;
+  }
+
+  bool put(Key const& key, Value const& value, bool assign) {
+    PathEntry path[HEIGHT_MAX];
+    uint leaf = descend(key, path);
+    uint pos = leaf_pos(leaf, key);
+    if (pos < node(leaf)->cnt && !less(key, leaf_keys(leaf)[pos])) {
+      if (assign) {
+        leaf_vals(leaf)[pos] = value;
+      }
+      return false;
+    }
+
+    /* Split a full leaf first, then insert into the half that covers pos */
+    uint sep_right = 0U;
+    if (node(leaf)->cnt == LEAF_MAX) {
+      uint right = alloc_node(true);
+      uint keep = static_cast<uint>(LEAF_MAX / 2UL);
+      uint moved = static_cast<uint>(LEAF_MAX) - keep;
+      std::memcpy(static_cast<void*>(leaf_keys(right)), leaf_keys(leaf) + keep, moved * sizeof(Key));
+      std::memcpy(static_cast<void*>(leaf_vals(right)), leaf_vals(leaf) + keep,
+                  moved * sizeof(Value));
+      node(right)->cnt = moved;
+      node(leaf)->cnt = keep;
+      node(right)->next = node(leaf)->next;
+      node(leaf)->next = right;
+      sep_right = right;
+      if (pos > keep) {
+        leaf = right;
+        pos -= keep;
+      }
+    }
+    Node* n = node(leaf);
+    move(leaf_keys(leaf) + pos + 1U, leaf_keys(leaf) + pos, n->cnt - pos);
+    move(leaf_vals(leaf) + pos + 1U, leaf_vals(leaf) + pos, n->cnt - pos);
+    leaf_keys(leaf)[pos] = key;
+    leaf_vals(leaf)[pos] = value;
+    n->cnt++;
+    hdr_->key_cnt++;
+
+    if (sep_right) {
+      Key sep = leaf_keys(sep_right)[0];
+      insert_up(path, hdr_->height - 1U, sep, sep_right);
+    }
+    return true;
+  }
+
+  /* Adds separator sep and its right child to the parent at path[level - 1],
+     splitting up to the root as needed */
+  void insert_up(PathEntry* path, uint level, Key sep, uint right) {
+    while (level > 0U) {
+      PathEntry& p = path[level - 1U];
+      uint id = p.id;
+      uint idx = p.idx;
+      if (node(id)->cnt < INNER_MAX) {
+        inner_insert(id, idx, sep, right);
+        return;
+      }
+      /* Split: id keeps keys [0, m), up is key m, the new node the rest */
+      uint m = static_cast<uint>(INNER_MAX / 2UL);
+      uint sib = alloc_node(false);
+      uint moved = static_cast<uint>(INNER_MAX) - m - 1U;
+      Key up = inner_keys(id)[m];
+      std::memcpy(static_cast<void*>(inner_keys(sib)), inner_keys(id) + m + 1U, moved * sizeof(Key));
+      std::memcpy(inner_children(sib), inner_children(id) + m + 1U, (moved + 1U) * sizeof(uint));
+      node(sib)->cnt = moved;
+      node(id)->cnt = m;
+      if (idx <= m) {
+        inner_insert(id, idx, sep, right);
+      } else {
+        inner_insert(sib, idx - m - 1U, sep, right);
+      }
+      sep = up;
+      right = sib;
+      level--;
+    }
+
+    /* The root split: grow a level */
+    if (TSDK_UNLIKELY(hdr_->height >= HEIGHT_MAX)) {
+      tsdk_revert(TSDK_BTREE_ERR_FULL);
+    }
+    uint root = alloc_node(false);
+    inner_keys(root)[0] = sep;
+    inner_children(root)[0] = hdr_->root;
+    inner_children(root)[1] = right;
+    node(root)->cnt = 1U;
+    hdr_->root = root;
+    hdr_->height++;
+  }
+
+  /* Inserts sep at idx and right as child idx + 1 of a non-full inner node */
+  void inner_insert(uint id, uint idx, Key const& sep, uint right) {
+    uint cnt = node(id)->cnt;
+    move(inner_keys(id) + idx + 1U, inner_keys(id) + idx, cnt - idx);
+    move(inner_children(id) + idx + 2U, inner_children(id) + idx + 1U, cnt - idx);
+    inner_keys(id)[idx] = sep;
+    inner_children(id)[idx + 1U] = right;
+    node(id)->cnt = cnt + 1U;
+  }
+
+  /* Removes key idx and child idx + 1 from inner node id */
+  void inner_remove(uint id, uint idx) {
+    uint cnt = node(id)->cnt;
+    move(inner_keys(id) + idx, inner_keys(id) + idx + 1U, cnt - idx - 1U);
+    move(inner_children(id) + idx + 1U, inner_children(id) + idx + 2U, cnt - idx - 1U);
+    node(id)->cnt = cnt - 1U;
+  }
+
+  /* Restores the minimum fill of node id at path depth level (its parent
+     is path[level - 1]) by borrowing from or merging with a sibling */
+  void rebalance(PathEntry* path, uint level, uint id) {
+    while (level > 0U) {
+      bool leaf = node(id)->leaf != 0U;
+      ulong min = leaf ? LEAF_MIN : INNER_MIN;
+      if (node(id)->cnt >= min) {
+        return;
+      }
+      uint parent = path[level - 1U].id;
+      uint ci = path[level - 1U].idx;
+      uint* children = inner_children(parent);
+      uint left = ci ? children[ci - 1U] : 0U;
+      uint right = ci < node(parent)->cnt ? children[ci + 1U] : 0U;
+
+      if (left && node(left)->cnt > min) {
+        if (leaf) {
+          leaf_borrow_left(id, left);
+          inner_keys(parent)[ci - 1U] = leaf_keys(id)[0];
+        } else {
+          inner_borrow_left(id, left, inner_keys(parent)[ci - 1U]);
+        }
+        return;
+      }
+      if (right && node(right)->cnt > min) {
+        if (leaf) {
+          leaf_borrow_right(id, right);
+          inner_keys(parent)[ci] = leaf_keys(right)[0];
+        } else {
+          inner_borrow_right(id, right, inner_keys(parent)[ci]);
+        }
+        return;
+      }
+
+      /* Merge the right one of (left, id) or (id, right) into the left one */
+      uint dst = left ? left : id;
+      uint src = left ? id : right;
+      uint sep_idx = left ? ci - 1U : ci;
+      if (leaf) {
+        leaf_merge(dst, src);
+      } else {
+        inner_merge(dst, src, inner_keys(parent)[sep_idx]);
+      }
+      free_node(src);
+      inner_remove(parent, sep_idx);
+      id = parent;
+      level--;
+    }
+
+    /* An inner root left with one child is replaced by it */
+    uint root = hdr_->root;
+    if (!node(root)->leaf && !node(root)->cnt) {
+      hdr_->root = inner_children(root)[0];
+      hdr_->height--;
+      free_node(root);
+    }
+  }
+
+  void leaf_borrow_left(uint id, uint left) {
+    uint cnt = node(id)->cnt;
+    uint last = node(left)->cnt - 1U;
+    move(leaf_keys(id) + 1U, leaf_keys(id), cnt);
+    move(leaf_vals(id) + 1U, leaf_vals(id), cnt);
+    leaf_keys(id)[0] = leaf_keys(left)[last];
+    leaf_vals(id)[0] = leaf_vals(left)[last];
+    node(id)->cnt = cnt + 1U;
+    node(left)->cnt = last;
+  }
+
+  void leaf_borrow_right(uint id, uint right) {
+    uint cnt = node(id)->cnt;
+    uint rcnt = node(right)->cnt;
+    leaf_keys(id)[cnt] = leaf_keys(right)[0];
+    leaf_vals(id)[cnt] = leaf_vals(right)[0];
+    move(leaf_keys(right), leaf_keys(right) + 1U, rcnt - 1U);
+    move(leaf_vals(right), leaf_vals(right) + 1U, rcnt - 1U);
+    node(id)->cnt = cnt + 1U;
+    node(right)->cnt = rcnt - 1U;
+  }
+
+  void leaf_merge(uint dst, uint src) {
+    uint cnt = node(dst)->cnt;
+    uint scnt = node(src)->cnt;
+    std::memcpy(static_cast<void*>(leaf_keys(dst) + cnt), leaf_keys(src), scnt * sizeof(Key));
+    std::memcpy(static_cast<void*>(leaf_vals(dst) + cnt), leaf_vals(src), scnt * sizeof(Value));
+    node(dst)->cnt = cnt + scnt;
+    node(dst)->next = node(src)->next;
+  }
+
+  /* Rotates the last child of left through the separator sep into id */
+  void inner_borrow_left(uint id, uint left, Key& sep) {
+    uint cnt = node(id)->cnt;
+    uint lcnt = node(left)->cnt;
+    move(inner_keys(id) + 1U, inner_keys(id), cnt);
+    move(inner_children(id) + 1U, inner_children(id), cnt + 1U);
+    inner_keys(id)[0] = sep;
+    inner_children(id)[0] = inner_children(left)[lcnt];
+    sep = inner_keys(left)[lcnt - 1U];
+    node(id)->cnt = cnt + 1U;
+    node(left)->cnt = lcnt - 1U;
+  }
+
+  /* Rotates the first child of right through the separator sep into id */
+  void inner_borrow_right(uint id, uint right, Key& sep) {
+    uint cnt = node(id)->cnt;
+    uint rcnt = node(right)->cnt;
+    inner_keys(id)[cnt] = sep;
+    inner_children(id)[cnt + 1U] = inner_children(right)[0];
+    sep = inner_keys(right)[0];
+    move(inner_keys(right), inner_keys(right) + 1U, rcnt - 1U);
+    move(inner_children(right), inner_children(right) + 1U, rcnt);
+    node(id)->cnt = cnt + 1U;
+    node(right)->cnt = rcnt - 1U;
+  }
+
+  void inner_merge(uint dst, uint src, Key const& sep) {
+    uint cnt = node(dst)->cnt;
+    uint scnt = node(src)->cnt;
+    inner_keys(dst)[cnt] = sep;
+    std::memcpy(static_cast<void*>(inner_keys(dst) + cnt + 1U), inner_keys(src), scnt * sizeof(Key));
+    std::memcpy(inner_children(dst) + cnt + 1U, inner_children(src), (scnt + 1U) * sizeof(uint));
+    node(dst)->cnt = cnt + 1U + scnt;
+  }
+
+  Header* hdr_;
+  ulong account_cnt_;
+  ushort idx_[TSDK_BTREE_ACCOUNT_MAX];
+  uchar* bases_[TSDK_BTREE_ACCOUNT_MAX];
+  ulong pages_[TSDK_BTREE_ACCOUNT_MAX]; /* Pages each account's data holds */
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_btree_hpp */
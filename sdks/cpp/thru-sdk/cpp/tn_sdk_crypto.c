@@ -0,0 +1,5 @@
+/* The C SDK's BLS routines, built into the SDK library with blst
+   (SDK_EXTRAS=blst, see Local.mk).  Included rather than compiled in
+   place so the object lands in this build's OBJDIR. */
+
+#include "../../../c/thru-sdk/c/tn_crypto.c"
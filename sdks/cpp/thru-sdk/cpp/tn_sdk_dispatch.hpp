@@ -0,0 +1,391 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_dispatch_hpp
+#define HEADER_sdks_cpp_tn_sdk_dispatch_hpp
+
+#include "tn_sdk.hpp"
+#include "tn_sdk_abi.hpp"
+#include "tn_sdk_accounts.hpp"
+#include "tn_sdk_event.hpp"
+
+#include <array>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/* Dispatcher routes the instruction data passed to start() to one of a
+   fixed set of handlers selected by a leading discriminator byte.
+
+   Each handler is a type with a discriminator, a trivially copyable
+   argument struct and a static handle():
+
+     struct Transfer {
+       static constexpr uchar DISCRIMINATOR = 0;
+       struct __attribute__((packed)) Args {
+         ushort from;
+         ushort to;
+         ulong amount;
+       };
+       static ulong handle(const Args& args, thru::WritableSet& writable);
+     };
+
+     using Program = thru::Dispatcher<Transfer, Mint, Burn>;
+
+     TSDK_ENTRYPOINT_FN void start(void const* instr_data, ulong instr_data_sz) {
+       thru::WritableSet writable;
+       Program::run(instr_data, instr_data_sz, writable);
+     }
+
+   The instruction data is [discriminator (1 byte)][Args][tail].  The
+   handlers are selected by comparing the discriminator against each
+   handler's, which GCC turns into a jump table, so decoding is one
+   indexed jump, one size check and a direct call.  Direct calls keep
+   the handlers' frames visible to the build's stack check, which
+   cannot see through a table of function pointers.  Args are handed
+   over in place (no copy) when they are packed or the bytes happen to
+   be suitably aligned.
+
+   handle() may take a std::span<const std::byte> after the args to
+   accept a variable-length tail; otherwise the payload must be exactly
+   sizeof(Args).  An empty Args struct means the instruction takes no
+   arguments.  Any further arguments given to dispatch()/run() are
+   passed through to the handler by reference.  handle() returns a ulong
+   return code or void (treated as TSDK_SUCCESS).
+
+   Args may instead be a view generated by `abi codegen -l cpp`
+   (tn_sdk_abi.hpp) for arguments with variable-length fields: the
+   payload is validated against the schema (reverting with
+   TSDK_ABI_ERR_INVALID), handle() takes the view by value, and the
+   tail is whatever follows the value's footprint.
+
+   A handler may also declare using Accounts = thru::Accounts<...>
+   (tn_sdk_accounts.hpp); its constraints are checked before handle()
+   runs, with the AuthCache among the context arguments if there is
+   one.
+
+   Listing thru::Batch<> among the handlers lets one instruction carry
+   many sub-instructions, so a client sending dozens of small operations
+   pays for entry and account validation once:
+
+     [Batch discriminator][op_cnt (ushort)]
+       [sz (ushort)][discriminator][Args][tail]   op_cnt times
+
+   Each sub-instruction is exactly what the instruction data would be on
+   its own.  The whole envelope is decoded before anything runs, so a
+   malformed or unknown op (or a nested batch) reverts the batch
+   without side effects.  Then the Accounts of every handler the batch
+   uses are checked once, sharing one AuthCache (the context's, if it
+   has one), and the ops run in order with the same context arguments,
+   so they share its Arena and any caches in it.  The arena is rolled
+   back after each op, so nothing an op allocates outlives it.  A
+   context without a mem::Arena cannot carry a batch.
+
+   A batch is all or nothing.  The first op that returns a nonzero code
+   (or reverts) reverts the transaction with that code, undoing the
+   writes of the ops before it, and the ops after it never run.  A
+   batch whose ops all succeed emits one BatchSummary event and returns
+   TSDK_SUCCESS.  The Accounts are checked against the accounts as they
+   stand before the first op: a handler whose constraints an earlier op
+   in the same batch could break (by resizing or handing off an account
+   it checks) must check that itself in handle(). */
+
+/* Dispatcher revert codes */
+constexpr ulong TSDK_DISPATCH_ERR_UNKNOWN  = 0xBAD0B400UL; /* No handler for discriminator */
+constexpr ulong TSDK_DISPATCH_ERR_BAD_SIZE = 0xBAD0B401UL; /* Payload size does not match Args */
+constexpr ulong TSDK_DISPATCH_ERR_NESTED   = 0xBAD0B402UL; /* Batch inside a batch */
+
+/* BatchSummary::tag */
+constexpr ulong TSDK_DISPATCH_BATCH_EVENT = 0x5BA7C4E5C0C0DE01UL;
+
+namespace thru {
+
+template <typename H>
+concept InstructionHandler = requires {
+  { H::DISCRIMINATOR } -> std::convertible_to<uchar>;
+  typename H::Args;
+} && std::is_trivially_copyable_v<typename H::Args>;
+
+/* The batch envelope handler; see above for the format */
+template <uchar Disc = 0xFFU> struct Batch {
+  static constexpr uchar DISCRIMINATOR = Disc;
+  static constexpr bool IS_BATCH = true;
+  struct Args {};
+};
+
+/* The event a batch emits once all its ops have succeeded */
+struct __attribute__((packed)) BatchSummary {
+  ulong tag;
+  ushort op_cnt;
+};
+
+namespace detail {
+
+template <typename H>
+concept BatchHandler = requires {
+  { H::IS_BATCH } -> std::convertible_to<bool>;
+} && H::IS_BATCH;
+
+} // namespace detail
+
+template <InstructionHandler... Handlers> class Dispatcher {
+  static_assert(sizeof...(Handlers) > 0, "Dispatcher needs at least one handler");
+
+  static constexpr ulong disc_max() {
+    ulong max = 0UL;
+    ((max = static_cast<ulong>(Handlers::DISCRIMINATOR) > max
+                ? static_cast<ulong>(Handlers::DISCRIMINATOR)
+                : max),
+     ...);
+    return max;
+  }
+
+  static constexpr bool discs_unique() {
+    std::array<bool, 256> seen{};
+    bool unique = true;
+    ((unique = unique && !seen[Handlers::DISCRIMINATOR],
+      seen[Handlers::DISCRIMINATOR] = true),
+     ...);
+    return unique;
+  }
+
+  static_assert(discs_unique(), "duplicate instruction discriminator");
+  static_assert((static_cast<ulong>(detail::BatchHandler<Handlers>) + ... + 0UL) <= 1UL,
+                "Dispatcher takes at most one Batch");
+
+public:
+  static constexpr ulong TABLE_SZ = disc_max() + 1UL;
+
+private:
+  static constexpr ulong batch_disc() {
+    ulong disc = TABLE_SZ;
+    ((disc = detail::BatchHandler<Handlers> ? Handlers::DISCRIMINATOR : disc), ...);
+    return disc;
+  }
+
+  /* Batch's discriminator, or TABLE_SZ if there is none */
+  static constexpr ulong BATCH_DISC = batch_disc();
+
+public:
+
+  /* Decodes and runs the instruction, returning the handler's code. */
+  template <typename... Ctx>
+  static ulong dispatch(void const* instr_data, ulong instr_data_sz, Ctx&... ctx) {
+    if (TSDK_UNLIKELY(!instr_data_sz)) {
+      tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+    }
+    uchar const* p = static_cast<uchar const*>(instr_data);
+    return call<true>(p[0], p + 1, instr_data_sz - 1UL, ctx...);
+  }
+
+  /* dispatch() followed by tsdk_return with the handler's code. */
+  template <typename... Ctx>
+  [[noreturn]] static void run(void const* instr_data, ulong instr_data_sz, Ctx&... ctx) {
+    tsdk_return(dispatch(instr_data, instr_data_sz, ctx...));
+  }
+
+private:
+  /* Runs the handler for disc, reverting if there is none */
+  template <bool Check, typename... Ctx>
+  static ulong call(ulong disc, uchar const* payload, ulong payload_sz, Ctx&... ctx) {
+    ulong code = TSDK_SUCCESS;
+    bool found = ((disc == Handlers::DISCRIMINATOR &&
+                   (code = thunk<Handlers, Check>(payload, payload_sz, ctx...), true)) ||
+                  ...);
+    if (TSDK_UNLIKELY(!found)) {
+      tsdk_revert(TSDK_DISPATCH_ERR_UNKNOWN);
+    }
+    return code;
+  }
+
+  template <typename H, bool Check, typename... Ctx>
+  static ulong invoke(typename H::Args const& args, std::span<const std::byte> tail,
+                      Ctx&... ctx) {
+    if constexpr (Check && requires { typename H::Accounts; }) {
+      H::Accounts::check(ctx...);
+    }
+    constexpr bool takes_tail = requires(Ctx&... c) {
+      H::handle(args, tail, c...);
+    };
+    if constexpr (takes_tail) {
+      if constexpr (std::is_void_v<decltype(H::handle(args, tail, ctx...))>) {
+        H::handle(args, tail, ctx...);
+        return TSDK_SUCCESS;
+      } else {
+        return H::handle(args, tail, ctx...);
+      }
+    } else {
+      (void)tail;
+      if constexpr (std::is_void_v<decltype(H::handle(args, ctx...))>) {
+        H::handle(args, ctx...);
+        return TSDK_SUCCESS;
+      } else {
+        return H::handle(args, ctx...);
+      }
+    }
+  }
+
+  template <typename H, bool Check, typename... Ctx>
+  static ulong thunk(uchar const* payload, ulong payload_sz, Ctx&... ctx) {
+    using Args = typename H::Args;
+    if constexpr (detail::BatchHandler<H>) {
+      if constexpr (Check) {
+        return batch_thunk(payload, payload_sz, ctx...);
+      } else {
+        tsdk_revert(TSDK_DISPATCH_ERR_NESTED);
+      }
+    } else if constexpr (AbiView<Args>) {
+      return view_thunk<H, Check>(payload, payload_sz, ctx...);
+    } else {
+      return layout_thunk<H, Check>(payload, payload_sz, ctx...);
+    }
+  }
+
+  template <typename H, bool Check, typename... Ctx>
+  static ulong view_thunk(uchar const* payload, ulong payload_sz, Ctx&... ctx) {
+    using Args = typename H::Args;
+    constexpr bool takes_tail = requires(Args const& a, std::span<const std::byte> t,
+                                         Ctx&... c) { H::handle(a, t, c...); };
+
+    std::span<const std::byte> tail;
+    Args args = abi_decode<Args>(
+        std::span<const std::byte>(reinterpret_cast<const std::byte*>(payload), payload_sz),
+        &tail);
+    if constexpr (!takes_tail) {
+      if (TSDK_UNLIKELY(!tail.empty())) {
+        tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+      }
+    }
+    return invoke<H, Check>(args, tail, ctx...);
+  }
+
+  template <typename H, bool Check, typename... Ctx>
+  static ulong layout_thunk(uchar const* payload, ulong payload_sz, Ctx&... ctx) {
+    using Args = typename H::Args;
+    constexpr ulong ARGS_SZ = std::is_empty_v<Args> ? 0UL : sizeof(Args);
+    constexpr bool takes_tail = requires(Args const& a, std::span<const std::byte> t,
+                                         Ctx&... c) { H::handle(a, t, c...); };
+
+    if constexpr (takes_tail) {
+      if (TSDK_UNLIKELY(payload_sz < ARGS_SZ)) {
+        tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+      }
+    } else {
+      if (TSDK_UNLIKELY(payload_sz != ARGS_SZ)) {
+        tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+      }
+    }
+    std::span<const std::byte> tail(reinterpret_cast<const std::byte*>(payload) + ARGS_SZ,
+                                    payload_sz - ARGS_SZ);
+
+    if constexpr (std::is_empty_v<Args>) {
+      Args args{};
+      return invoke<H, Check>(args, tail, ctx...);
+    } else if constexpr (alignof(Args) == 1UL) {
+      return invoke<H, Check>(*reinterpret_cast<Args const*>(payload), tail, ctx...);
+    } else {
+      if (TSDK_LIKELY(mem::is_aligned(reinterpret_cast<ulong>(payload), alignof(Args)))) {
+        return invoke<H, Check>(*reinterpret_cast<Args const*>(payload), tail, ctx...);
+      }
+      Args args;
+      std::memcpy(&args, payload, sizeof(Args));
+      return invoke<H, Check>(args, tail, ctx...);
+    }
+  }
+
+  static ulong load_u16(uchar const* p) {
+    ushort v;
+    std::memcpy(&v, p, sizeof(ushort));
+    return v;
+  }
+
+  /* Decodes the envelope into an op table at the front of the arena,
+     checks constraints once per handler used, then runs the ops with
+     their constraints already checked, each above the table. */
+  template <typename... Ctx>
+  static ulong batch_thunk(uchar const* payload, ulong payload_sz, Ctx&... ctx) {
+    static_assert((std::is_same_v<Ctx, mem::Arena> || ...),
+                  "a Batch needs a mem::Arena among the context arguments");
+    static constexpr std::array<bool, TABLE_SZ> known = [] {
+      std::array<bool, TABLE_SZ> k{};
+      ((k[Handlers::DISCRIMINATOR] = !detail::BatchHandler<Handlers>), ...);
+      return k;
+    }();
+
+    if (TSDK_UNLIKELY(payload_sz < sizeof(ushort))) {
+      tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+    }
+    ulong op_cnt = load_u16(payload);
+    mem::Arena& arena = *detail::find_ctx<mem::Arena>(ctx...);
+    uchar const** ops = arena.alloc_array<uchar const*>(op_cnt);
+
+    std::array<bool, TABLE_SZ> used{};
+    ulong off = sizeof(ushort);
+    for (ulong i = 0UL; i < op_cnt; i++) {
+      if (TSDK_UNLIKELY(payload_sz - off < sizeof(ushort))) {
+        tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+      }
+      ulong sz = load_u16(payload + off);
+      if (TSDK_UNLIKELY(!sz || payload_sz - off - sizeof(ushort) < sz)) {
+        tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+      }
+      ops[i] = payload + off;
+      ulong disc = payload[off + sizeof(ushort)];
+      if (TSDK_UNLIKELY(disc >= TABLE_SZ || !known[disc])) {
+        tsdk_revert(disc == BATCH_DISC ? TSDK_DISPATCH_ERR_NESTED : TSDK_DISPATCH_ERR_UNKNOWN);
+      }
+      used[disc] = true;
+      off += sizeof(ushort) + sz;
+    }
+    if (TSDK_UNLIKELY(off != payload_sz)) {
+      tsdk_revert(TSDK_DISPATCH_ERR_BAD_SIZE);
+    }
+
+    check_used(used, ctx...);
+
+    /* Each op starts from the same arena position, so a batch uses the
+       memory of its largest op, not the sum */
+    mem::Arena::Mark op_mark = arena.mark();
+    for (ulong i = 0UL; i < op_cnt; i++) {
+      ulong sz = load_u16(ops[i]);
+      uchar const* op = ops[i] + sizeof(ushort);
+      ulong code = call<false>(op[0], op + 1, sz - 1UL, ctx...);
+      /* Returning the code would commit the earlier ops' writes */
+      if (TSDK_UNLIKELY(code != TSDK_SUCCESS)) {
+        tsdk_revert(code);
+      }
+      arena.rollback(op_mark);
+    }
+
+    EventWriter<BatchSummary> ev(arena);
+    ev->tag = TSDK_DISPATCH_BATCH_EVENT;
+    ev->op_cnt = static_cast<ushort>(op_cnt);
+    ev.emit();
+    return TSDK_SUCCESS;
+  }
+
+  /* Checks the Accounts of each handler marked in used, resolving
+     signers through the context's AuthCache or, failing that, one made
+     for the batch */
+  template <typename... Ctx>
+  static void check_used(std::array<bool, TABLE_SZ> const& used, Ctx&... ctx) {
+    if constexpr ((std::is_same_v<Ctx, AuthCache> || ...)) {
+      (check_if_used<Handlers>(used, ctx...), ...);
+    } else {
+      AuthCache auth;
+      (check_if_used<Handlers>(used, ctx..., auth), ...);
+    }
+  }
+
+  template <typename H, typename... Ctx>
+  static void check_if_used(std::array<bool, TABLE_SZ> const& used, Ctx&... ctx) {
+    if constexpr (requires { typename H::Accounts; }) {
+      if (used[H::DISCRIMINATOR]) {
+        H::Accounts::check(ctx...);
+      }
+    } else {
+      (void)used;
+    }
+  }
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_dispatch_hpp */
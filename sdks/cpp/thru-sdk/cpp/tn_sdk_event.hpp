@@ -0,0 +1,165 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_event_hpp
+#define HEADER_sdks_cpp_tn_sdk_event_hpp
+
+#include "tn_sdk.hpp"
+
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/* EventWriter<Schema> builds an event directly in arena memory and
+   emits it with a single tsys_emit_event.
+
+   Schema is the packed, fixed-size head of the event.  Its fields are
+   written in place through head() or set<>(), so field offsets are
+   compile-time constants and nothing is staged in a local buffer.
+   Variable-length data (e.g. a list of pubkeys) is appended after the
+   head and grows the same arena allocation, so the event stays
+   contiguous without a second pass:
+
+     struct __attribute__((packed)) FillEvent {
+       uchar kind;
+       ulong order_id;
+       ulong price;
+       ushort maker_cnt;
+     };
+
+     thru::EventWriter<FillEvent> ev(arena);
+     ev.set<&FillEvent::kind>(EVENT_FILL);
+     ev->order_id = order_id;
+     ev->price = price;
+     pubkey_t* makers = ev.append_uninit<pubkey_t>(maker_cnt);
+     ...fill makers in place...
+     ev->maker_cnt = maker_cnt;
+     ev.emit();
+
+   While a writer has a tail to grow it must own the most recent arena
+   allocation: appending after something else was allocated reverts with
+   TSDK_EVENT_ERR_INTERLEAVED.  The buffer is handed back to the arena
+   by emit() or on destruction, so emitting many events per instruction
+   reuses the same pages.  The head is zero-initialized; tail bytes are
+   not. */
+
+/* EventWriter revert codes */
+constexpr ulong TSDK_EVENT_ERR_INTERLEAVED = 0xBAD0B500UL; /* Arena used while the event was building */
+constexpr ulong TSDK_EVENT_ERR_EMITTED     = 0xBAD0B501UL; /* Writer reused after emit() */
+
+namespace thru {
+
+template <typename Schema> class EventWriter {
+  static_assert(std::is_trivially_copyable_v<Schema>, "event schema must be trivially copyable");
+  static_assert(std::is_standard_layout_v<Schema>, "event schema must be standard layout");
+  static_assert(std::has_unique_object_representations_v<Schema>,
+                "event schema has padding; reorder or pack its fields");
+
+public:
+  explicit EventWriter(mem::Arena& arena)
+      : arena_(arena),
+        buf_(static_cast<uchar*>(arena.alloc(sizeof(Schema), alignof(Schema)))),
+        sz_(sizeof(Schema)) {
+    std::memset(buf_, 0, sizeof(Schema));
+  }
+
+  /* As above, and maps enough pages that tail_sz bytes of appends do
+     not issue an ecall. */
+  EventWriter(mem::Arena& arena, ulong tail_sz) : EventWriter(arena) { arena.reserve(tail_sz); }
+
+  ~EventWriter() { release(); }
+
+  EventWriter(const EventWriter&) = delete;
+  EventWriter& operator=(const EventWriter&) = delete;
+
+  Schema& head() const { return *reinterpret_cast<Schema*>(buf_); }
+  Schema* operator->() const { return &head(); }
+
+  /* Writes one head field, e.g. set<&Fill::price>(price). */
+  template <auto Member, typename V> EventWriter& set(V const& value) {
+    head().*Member = value;
+    return *this;
+  }
+
+  /* Appends cnt uninitialized elements to the tail and returns them for
+     in-place construction.  T must be byte aligned (as pubkey_t is),
+     since the tail is packed. */
+  template <typename T> T* append_uninit(ulong cnt) {
+    static_assert(std::is_trivially_copyable_v<T>, "event tail must be trivially copyable");
+    static_assert(alignof(T) == 1UL, "append_uninit needs a byte-aligned type; use append()");
+    if (TSDK_UNLIKELY(cnt > ~0UL / sizeof(T))) {
+      tsdk_revert(TSDK_ARENA_ERR_OUT_OF_MEMORY);
+    }
+    return reinterpret_cast<T*>(grow(cnt * sizeof(T)));
+  }
+
+  /* Appends sz zeroed bytes and returns a writer generated from an ABI
+     schema (e.g. FillsMut, see tn_sdk_abi.hpp) over them, so a
+     variable-length tail is encoded by the same schema that decodes it.
+     sz is the encoded size, typically computed from the counts about to
+     be written. */
+  template <typename M> M append_view(ulong sz) {
+    static_assert(std::is_constructible_v<M, std::span<std::byte>>,
+                  "append_view needs a generated Mut writer");
+    uchar* p = grow(sz);
+    std::memset(p, 0, sz);
+    return M(std::span<std::byte>(reinterpret_cast<std::byte*>(p), sz));
+  }
+
+  EventWriter& append_bytes(void const* data, ulong sz) {
+    std::memcpy(grow(sz), data, sz);
+    return *this;
+  }
+
+  template <Trivial T> EventWriter& append(T const& value) {
+    return append_bytes(&value, sizeof(T));
+  }
+
+  template <Trivial T> EventWriter& append(std::span<T const> values) {
+    return append_bytes(values.data(), values.size_bytes());
+  }
+
+  ulong size() const { return sz_; }
+
+  std::span<const std::byte> bytes() const {
+    return {reinterpret_cast<const std::byte*>(buf_), sz_};
+  }
+
+  /* Emits the event and returns the syscall result.  The writer is
+     spent afterwards. */
+  ulong emit() {
+    if (TSDK_UNLIKELY(!buf_)) {
+      tsdk_revert(TSDK_EVENT_ERR_EMITTED);
+    }
+    ulong err = tsys_emit_event(buf_, sz_);
+    release();
+    return err;
+  }
+
+private:
+  uchar* grow(ulong sz) {
+    if (TSDK_UNLIKELY(!buf_)) {
+      tsdk_revert(TSDK_EVENT_ERR_EMITTED);
+    }
+    uchar* p = static_cast<uchar*>(arena_.alloc(sz, 1UL));
+    if (TSDK_UNLIKELY(p != buf_ + sz_)) {
+      tsdk_revert(TSDK_EVENT_ERR_INTERLEAVED);
+    }
+    sz_ += sz;
+    return p;
+  }
+
+  /* Returns the buffer to the arena if it is still the most recent
+     allocation. */
+  void release() {
+    if (buf_) {
+      arena_.deallocate(buf_, sz_, 1UL);
+      buf_ = nullptr;
+    }
+  }
+
+  mem::Arena& arena_;
+  uchar* buf_;
+  ulong sz_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_event_hpp */
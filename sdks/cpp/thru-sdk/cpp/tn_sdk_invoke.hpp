@@ -0,0 +1,166 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_invoke_hpp
+#define HEADER_sdks_cpp_tn_sdk_invoke_hpp
+
+#include "tn_sdk.hpp"
+#include "tn_sdk_syscall.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+
+/* InvokeAuth<MaxAuth, MaxDeauth> is a tsdk_invoke_auth_t with room for
+   its index lists, laid out as tsys_invoke reads it:
+
+     [magic (8)][auth_cnt (2)][deauth_cnt (2)][auth idxs][deauth idxs]
+
+   When the indices are known up front it can be built at compile time,
+   in which case overfilling it or naming an index past TN_TXN_ACCT_MAX
+   is a compile error:
+
+     static constexpr thru::InvokeAuth<2, 1> VAULT_AUTH{{VAULT_IDX, FEE_IDX}, {USER_IDX}};
+
+   tsys_invoke checks the auth list on every call (magic, index range,
+   and a pubkey compare per auth index for ownership).  A program that
+   invokes repeatedly with the same list can do those checks once:
+
+     thru::InvokeAuthToken auth = VAULT_AUTH.validate();
+     for (...) {
+       thru::syscall::invoke(instr, ROUTE_IDX, err, auth);
+     }
+
+   The token only proves the checks passed in the frame that made it,
+   against the list and the ownership at the time.  It cannot be copied,
+   so it stays in the scope that validated, and it records the list's
+   generation: invoking with it after the list changed reverts with
+   TSDK_INVOKE_AUTH_ERR_STALE_TOKEN.  Validate again after changing the
+   list or the owner of a listed account. */
+
+namespace thru {
+
+class InvokeAuthToken {
+public:
+  InvokeAuthToken(InvokeAuthToken const&) = delete;
+  InvokeAuthToken& operator=(InvokeAuthToken const&) = delete;
+
+  /* The validated list; reverts if it has changed since */
+  tsdk_invoke_auth_t const* get() const {
+    if (TSDK_UNLIKELY(*generation_ != seen_)) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_STALE_TOKEN);
+    }
+    return auth_;
+  }
+
+private:
+  template <ushort MaxAuth, ushort MaxDeauth> friend class InvokeAuth;
+
+  InvokeAuthToken(tsdk_invoke_auth_t const* auth, ulong const* generation)
+      : auth_(auth), generation_(generation), seen_(*generation) {}
+
+  tsdk_invoke_auth_t const* auth_;
+  ulong const* generation_;
+  ulong seen_;
+};
+
+template <ushort MaxAuth, ushort MaxDeauth = 0U> class InvokeAuth {
+  static constexpr ulong IDX_MAX = static_cast<ulong>(MaxAuth) + MaxDeauth;
+  static_assert(IDX_MAX <= TN_TXN_ACCT_MAX, "more indices than a transaction has accounts");
+
+public:
+  constexpr InvokeAuth()
+      : magic_(TSDK_INVOKE_AUTH_MAGIC), auth_cnt_(0U), deauth_cnt_(0U), idxs_{}, generation_(0UL) {}
+
+  constexpr InvokeAuth(std::initializer_list<ushort> auth,
+                       std::initializer_list<ushort> deauth = {})
+      : InvokeAuth() {
+    for (ushort idx : auth) {
+      authorize(idx);
+    }
+    for (ushort idx : deauth) {
+      deauthorize(idx);
+    }
+  }
+
+  /* Passes authority over the account at idx to the callee */
+  constexpr InvokeAuth& authorize(ushort idx) {
+    check(idx, auth_cnt_ < MaxAuth);
+    /* Deauth entries follow the auth entries, so shift them up */
+    for (ulong i = static_cast<ulong>(auth_cnt_) + deauth_cnt_; i > auth_cnt_; i--) {
+      idxs_[i] = idxs_[i - 1UL];
+    }
+    idxs_[auth_cnt_++] = idx;
+    generation_++;
+    return *this;
+  }
+
+  /* Withholds the account at idx from the callee */
+  constexpr InvokeAuth& deauthorize(ushort idx) {
+    check(idx, deauth_cnt_ < MaxDeauth);
+    idxs_[static_cast<ulong>(auth_cnt_) + deauth_cnt_++] = idx;
+    generation_++;
+    return *this;
+  }
+
+  constexpr void clear() {
+    auth_cnt_ = 0U;
+    deauth_cnt_ = 0U;
+    generation_++;
+  }
+
+  constexpr ushort auth_cnt() const { return auth_cnt_; }
+  constexpr ushort deauth_cnt() const { return deauth_cnt_; }
+
+  constexpr std::span<const ushort> auth_idxs() const { return {idxs_, auth_cnt_}; }
+  constexpr std::span<const ushort> deauth_idxs() const {
+    return {idxs_ + auth_cnt_, deauth_cnt_};
+  }
+
+  /* The list in the form tsys_invoke takes */
+  tsdk_invoke_auth_t const* get() const {
+    static_assert(offsetof(InvokeAuth, magic_) == 0UL);
+    static_assert(offsetof(InvokeAuth, auth_cnt_) == sizeof(ulong));
+    static_assert(offsetof(InvokeAuth, deauth_cnt_) == sizeof(ulong) + sizeof(ushort));
+    static_assert(offsetof(InvokeAuth, idxs_) == sizeof(ulong) + 2UL * sizeof(ushort),
+                  "indices must follow the counts, where tsdk_invoke_auth::auth_idxs reads them");
+    return reinterpret_cast<tsdk_invoke_auth_t const*>(this);
+  }
+
+  /* Runs tsys_invoke's checks now, reverting on failure as it would */
+  InvokeAuthToken validate() const {
+    tsdk_invoke_auth_validate(get());
+    return InvokeAuthToken(get(), &generation_);
+  }
+
+private:
+  /* Reverting is not a constant expression, so a bad compile-time list
+     fails to compile */
+  static constexpr void check(ushort idx, bool room) {
+    if (!room) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_TOO_MANY);
+    }
+    if (idx >= TN_TXN_ACCT_MAX) {
+      tsdk_revert(TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX);
+    }
+  }
+
+  ulong magic_;
+  ushort auth_cnt_;
+  ushort deauth_cnt_;
+  ushort idxs_[IDX_MAX ? IDX_MAX : 1UL];
+  ulong generation_; /* Changes of the list, for InvokeAuthToken */
+};
+
+namespace syscall {
+
+/* invoke() with auth already checked by InvokeAuth::validate */
+inline ulong
+invoke( std::span<const std::byte> instr_data,
+        ushort program_account_idx, ulong& invoke_error,
+        InvokeAuthToken const & auth ) {
+  return tsys_invoke_unchecked( instr_data.data( ), instr_data.size( ), program_account_idx,
+                                auth.get( ), &invoke_error );
+}
+
+} // namespace syscall
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_invoke_hpp */
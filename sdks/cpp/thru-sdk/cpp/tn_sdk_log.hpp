@@ -0,0 +1,463 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_log_hpp
+#define HEADER_sdks_cpp_tn_sdk_log_hpp
+
+#include "tn_sdk.hpp"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/* thru::log is a structured logging facility meant to replace
+   tsdk_printf, which formats through vsnprintf into a 1 KiB stack
+   buffer on every call.
+
+     thru::log::info<"transfer {} -> {} amount={:x}">(from, to, amount);
+
+   The format string is a template argument and is parsed at compile
+   time: placeholders are {} (decimal, or hex for pubkeys and pointers)
+   and {:x} (hex), {{ and }} are literal braces, and the placeholder
+   count must match the argument count.  Supported arguments are bool,
+   integers, enums, pointers, pubkey_t (by value or by pointer, const
+   or not) and strings (const char*, std::string_view).  Pubkeys
+   render as 64 hex digits under both placeholders, in text mode and in
+   `thru debug decode-log` alike.
+
+   Messages below TSDK_LOG_LEVEL_MIN compile to nothing.
+
+   Binary mode (the default) sends a compact record through tsys_log:
+
+     [0x00][0x01][0x00 0x00][format id (u32)][args...]
+
+   Args are packed in order, little endian, with no padding: integers at
+   their native width, pubkeys as 32 raw bytes, pointers as 8 bytes and
+   strings as a u16 length followed by at most TSDK_LOG_STR_MAX bytes.
+   The format string itself is never executed or sent.  Instead, each
+   format used is recorded once in the non-loaded .tsdk_logfmt ELF
+   section:
+
+     ['L'][format id (u32)][level (u8)][argc (u8)][arg tags (argc)]
+     [format size (u16)][format (no terminator)]
+
+   Entries may be separated by zero padding.
+
+   `thru debug decode-log --elf <program.elf>` turns records back into
+   text.  The section is never loaded, so it does not add to the
+   program binary.
+
+   Text mode (THRUNET_DEBUG builds, or -DTSDK_LOG_TEXT=1) formats the
+   message with a small built-in formatter into a TSDK_LOG_TEXT_BUF_SZ
+   stack buffer and logs the human-readable line.  Longer lines are
+   truncated. */
+
+#define TSDK_LOG_LEVEL_TRACE 0
+#define TSDK_LOG_LEVEL_DEBUG 1
+#define TSDK_LOG_LEVEL_INFO  2
+#define TSDK_LOG_LEVEL_WARN  3
+#define TSDK_LOG_LEVEL_ERROR 4
+#define TSDK_LOG_LEVEL_NONE  5
+
+#ifndef TSDK_LOG_LEVEL_MIN
+#if defined(THRUNET_DEBUG)
+#define TSDK_LOG_LEVEL_MIN TSDK_LOG_LEVEL_TRACE
+#else
+#define TSDK_LOG_LEVEL_MIN TSDK_LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifndef TSDK_LOG_TEXT
+#if defined(THRUNET_DEBUG)
+#define TSDK_LOG_TEXT 1
+#else
+#define TSDK_LOG_TEXT 0
+#endif
+#endif
+
+constexpr ulong TSDK_LOG_TEXT_BUF_SZ = 256UL;
+constexpr ulong TSDK_LOG_STR_MAX = 64UL;  /* Max string bytes per binary arg */
+constexpr ulong TSDK_LOG_HDR_SZ = 8UL;
+constexpr uchar TSDK_LOG_RECORD_VERSION = 0x01U;
+constexpr uchar TSDK_LOG_FMT_ENTRY_MAGIC = 'L';
+
+namespace thru {
+namespace log {
+
+/* Format is the structural wrapper that lets a string literal be a
+   template argument. */
+template <ulong N> struct Format {
+  char str[N];
+
+  consteval Format(const char (&s)[N]) {
+    for (ulong i = 0UL; i < N; i++) {
+      str[i] = s[i];
+    }
+  }
+
+  static constexpr ulong size() { return N - 1UL; }
+};
+
+namespace detail {
+
+/* Not constexpr: reaching one of these during constant evaluation turns
+   a malformed format into a compile error that names the problem. */
+void log_format_unbalanced_brace();
+void log_format_bad_placeholder();
+void log_format_too_long();
+
+template <typename T> using arg_t = std::remove_cvref_t<std::decay_t<T>>;
+
+template <typename T, bool = std::is_enum_v<T>> struct int_of {
+  using type = T;
+};
+template <typename T> struct int_of<T, true> {
+  using type = std::underlying_type_t<T>;
+};
+
+template <typename T> consteval char type_tag() {
+  using U = arg_t<T>;
+  if constexpr (std::is_same_v<U, bool>) {
+    return 'b';
+  } else if constexpr (std::is_enum_v<U>) {
+    return type_tag<std::underlying_type_t<U>>();
+  } else if constexpr (std::is_integral_v<U>) {
+    constexpr bool s = std::is_signed_v<U>;
+    if constexpr (sizeof(U) == 1) {
+      return s ? 'c' : 'B';
+    } else if constexpr (sizeof(U) == 2) {
+      return s ? 'h' : 'H';
+    } else if constexpr (sizeof(U) == 4) {
+      return s ? 'i' : 'I';
+    } else {
+      static_assert(sizeof(U) == 8, "unsupported integer width");
+      return s ? 'q' : 'Q';
+    }
+  } else if constexpr (std::is_same_v<U, pubkey_t> ||
+                       (std::is_pointer_v<U> &&
+                        std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, pubkey_t>)) {
+    return 'K';
+  } else if constexpr (std::is_same_v<U, char*> || std::is_same_v<U, char const*> ||
+                       std::is_same_v<U, std::string_view>) {
+    return 's';
+  } else if constexpr (std::is_pointer_v<U>) {
+    return 'p';
+  } else {
+    static_assert(sizeof(U) == 0, "unsupported thru::log argument type");
+    return 0;
+  }
+}
+
+/* Counts placeholders, validating the placeholder syntax. */
+template <Format F> consteval ulong placeholder_cnt() {
+  ulong cnt = 0UL;
+  for (ulong i = 0UL; i < F.size(); i++) {
+    char c = F.str[i];
+    if (c == '{') {
+      if (i + 1UL < F.size() && F.str[i + 1UL] == '{') {
+        i++;
+      } else if (i + 1UL < F.size() && F.str[i + 1UL] == '}') {
+        i++;
+        cnt++;
+      } else if (i + 3UL < F.size() && F.str[i + 1UL] == ':' && F.str[i + 2UL] == 'x' &&
+                 F.str[i + 3UL] == '}') {
+        i += 3UL;
+        cnt++;
+      } else {
+        log_format_bad_placeholder();
+      }
+    } else if (c == '}') {
+      if (i + 1UL < F.size() && F.str[i + 1UL] == '}') {
+        i++;
+      } else {
+        log_format_unbalanced_brace();
+      }
+    }
+  }
+  return cnt;
+}
+
+/* FNV-1a over level, argument tags and format.  Never zero. */
+template <int Level, Format F, char... Tags> consteval uint record_id() {
+  uint h = 0x811C9DC5U;
+  auto mix = [&h](uchar b) {
+    h ^= b;
+    h *= 0x01000193U;
+  };
+  mix(static_cast<uchar>(Level));
+  (mix(static_cast<uchar>(Tags)), ...);
+  for (ulong i = 0UL; i < F.size(); i++) {
+    mix(static_cast<uchar>(F.str[i]));
+  }
+  return h ? h : 1U;
+}
+
+/* One .tsdk_logfmt entry.  Instantiations shared across translation
+   units are folded by COMDAT.  GCC places COMDAT data in
+   .rodata.<mangled name> regardless of the section attribute, so
+   link.ld also collects entries by that name. */
+template <int Level, Format F, char... Tags> struct FmtEntry {
+  static constexpr ulong ARGC = sizeof...(Tags);
+  static constexpr ulong SZ = 1UL + 4UL + 1UL + 1UL + ARGC + 2UL + F.size();
+
+  static consteval std::array<uchar, SZ> make() {
+    if (F.size() > 0xFFFFUL || ARGC > 0xFFUL) {
+      log_format_too_long();
+    }
+    std::array<uchar, SZ> e{};
+    uint id = record_id<Level, F, Tags...>();
+    ulong o = 0UL;
+    e[o++] = TSDK_LOG_FMT_ENTRY_MAGIC;
+    for (ulong i = 0UL; i < 4UL; i++) {
+      e[o++] = static_cast<uchar>(id >> (8UL * i));
+    }
+    e[o++] = static_cast<uchar>(Level);
+    e[o++] = static_cast<uchar>(ARGC);
+    ((e[o++] = static_cast<uchar>(Tags)), ...);
+    e[o++] = static_cast<uchar>(F.size());
+    e[o++] = static_cast<uchar>(F.size() >> 8UL);
+    for (ulong i = 0UL; i < F.size(); i++) {
+      e[o++] = static_cast<uchar>(F.str[i]);
+    }
+    return e;
+  }
+
+  static constexpr std::array<uchar, SZ> entry
+      __attribute__((section(".tsdk_logfmt"), used)) = make();
+};
+
+/* Binary encoding ***************************************************/
+
+template <typename T> constexpr ulong max_arg_sz() {
+  constexpr char tag = type_tag<T>();
+  if constexpr (tag == 'b' || tag == 'B' || tag == 'c') {
+    return 1UL;
+  } else if constexpr (tag == 'h' || tag == 'H') {
+    return 2UL;
+  } else if constexpr (tag == 'i' || tag == 'I') {
+    return 4UL;
+  } else if constexpr (tag == 'q' || tag == 'Q' || tag == 'p') {
+    return 8UL;
+  } else if constexpr (tag == 'K') {
+    return 32UL;
+  } else {
+    return 2UL + TSDK_LOG_STR_MAX;
+  }
+}
+
+inline std::string_view as_string(std::string_view s) { return s; }
+inline std::string_view as_string(char const* s) { return s ? std::string_view(s) : std::string_view(); }
+
+inline pubkey_t const& as_key(pubkey_t const& k) { return k; }
+inline pubkey_t const& as_key(pubkey_t const* k) { return *k; }
+
+template <typename T> inline uchar* encode(uchar* p, T const& v) {
+  constexpr char tag = type_tag<T>();
+  using U = arg_t<T>;
+  if constexpr (tag == 'K') {
+    std::memcpy(p, &as_key(v), 32UL);
+    return p + 32UL;
+  } else if constexpr (tag == 's') {
+    std::string_view s = as_string(v);
+    ulong n = s.size() < TSDK_LOG_STR_MAX ? s.size() : TSDK_LOG_STR_MAX;
+    p[0] = static_cast<uchar>(n);
+    p[1] = static_cast<uchar>(n >> 8UL);
+    std::memcpy(p + 2, s.data(), n);
+    return p + 2UL + n;
+  } else if constexpr (tag == 'p') {
+    ulong x = reinterpret_cast<ulong>(v);
+    std::memcpy(p, &x, 8UL);
+    return p + 8UL;
+  } else if constexpr (tag == 'b') {
+    p[0] = static_cast<uchar>(v ? 1U : 0U);
+    return p + 1UL;
+  } else {
+    U x = v;
+    std::memcpy(p, &x, sizeof(U));
+    return p + sizeof(U);
+  }
+}
+
+template <int Level, Format F, typename... Args>
+inline void write_binary(Args const&... args) {
+  using Entry = FmtEntry<Level, F, type_tag<Args>()...>;
+  static_cast<void>(&Entry::entry); /* Instantiate the table entry */
+
+  constexpr uint id = record_id<Level, F, type_tag<Args>()...>();
+  alignas(8) uchar buf[TSDK_LOG_HDR_SZ + (0UL + ... + max_arg_sz<Args>())];
+  buf[0] = 0x00U;
+  buf[1] = TSDK_LOG_RECORD_VERSION;
+  buf[2] = 0x00U;
+  buf[3] = 0x00U;
+  std::memcpy(buf + 4, &id, sizeof(uint));
+  uchar* p = buf + TSDK_LOG_HDR_SZ;
+  ((p = encode(p, args)), ...);
+  tsys_log(buf, static_cast<ulong>(p - buf));
+}
+
+/* Text formatting ***************************************************/
+
+class TextBuf {
+public:
+  TextBuf() : len_(0UL) {}
+
+  void put(char c) {
+    if (TSDK_LIKELY(len_ < TSDK_LOG_TEXT_BUF_SZ)) {
+      buf_[len_++] = c;
+    }
+  }
+
+  void put(std::string_view s) {
+    for (char c : s) {
+      put(c);
+    }
+  }
+
+  void put_dec(ulong x, bool neg) {
+    char tmp[20];
+    ulong n = 0UL;
+    do {
+      tmp[n++] = static_cast<char>('0' + x % 10UL);
+      x /= 10UL;
+    } while (x);
+    if (neg) {
+      put('-');
+    }
+    while (n) {
+      put(tmp[--n]);
+    }
+  }
+
+  void put_hex(ulong x, ulong min_digits) {
+    char tmp[16];
+    ulong n = 0UL;
+    do {
+      tmp[n++] = "0123456789abcdef"[x & 0xFUL];
+      x >>= 4UL;
+    } while (x || n < min_digits);
+    while (n) {
+      put(tmp[--n]);
+    }
+  }
+
+  void put_bytes_hex(uchar const* b, ulong sz) {
+    for (ulong i = 0UL; i < sz; i++) {
+      put_hex(b[i], 2UL);
+    }
+  }
+
+  void flush() const { tsys_log(buf_, len_); }
+
+private:
+  char buf_[TSDK_LOG_TEXT_BUF_SZ];
+  ulong len_;
+};
+
+template <typename T> inline void format_arg(TextBuf& out, T const& v, bool hex) {
+  constexpr char tag = type_tag<T>();
+  if constexpr (tag == 'K') {
+    out.put_bytes_hex(reinterpret_cast<uchar const*>(&as_key(v)), 32UL);
+  } else if constexpr (tag == 's') {
+    out.put(as_string(v));
+  } else if constexpr (tag == 'p') {
+    out.put("0x");
+    out.put_hex(reinterpret_cast<ulong>(v), 1UL);
+  } else if constexpr (tag == 'b') {
+    out.put(v ? std::string_view("true") : std::string_view("false"));
+  } else {
+    using U = arg_t<T>;
+    using I = typename int_of<U>::type;
+    I x = static_cast<I>(v);
+    if (hex) {
+      out.put("0x");
+      out.put_hex(static_cast<ulong>(static_cast<std::make_unsigned_t<I>>(x)), 1UL);
+    } else if constexpr (std::is_signed_v<I>) {
+      long s = x;
+      out.put_dec(s < 0L ? 0UL - static_cast<ulong>(s) : static_cast<ulong>(s), s < 0L);
+    } else {
+      out.put_dec(static_cast<ulong>(x), false);
+    }
+  }
+}
+
+/* Copies literal text up to the next placeholder, leaving *pos just past
+   it.  Returns whether the placeholder was {:x}. */
+template <Format F> inline bool next_literal(TextBuf& out, ulong* pos) {
+  ulong i = *pos;
+  while (i < F.size()) {
+    char c = F.str[i];
+    if (c == '{' && F.str[i + 1UL] == '{') {
+      out.put('{');
+      i += 2UL;
+    } else if (c == '}') {
+      out.put('}');
+      i += 2UL;
+    } else if (c == '{') {
+      bool hex = F.str[i + 1UL] == ':';
+      *pos = i + (hex ? 4UL : 2UL);
+      return hex;
+    } else {
+      out.put(c);
+      i++;
+    }
+  }
+  *pos = i;
+  return false;
+}
+
+constexpr std::string_view level_prefix(int level) {
+  switch (level) {
+  case TSDK_LOG_LEVEL_TRACE: return "trace: ";
+  case TSDK_LOG_LEVEL_DEBUG: return "debug: ";
+  case TSDK_LOG_LEVEL_INFO:  return "info: ";
+  case TSDK_LOG_LEVEL_WARN:  return "warn: ";
+  default:                   return "error: ";
+  }
+}
+
+template <int Level, Format F, typename... Args>
+inline void write_text(Args const&... args) {
+  TextBuf out;
+  out.put(level_prefix(Level));
+  ulong pos = 0UL;
+  ((format_arg(out, args, next_literal<F>(out, &pos))), ...);
+  next_literal<F>(out, &pos);
+  out.flush();
+}
+
+} // namespace detail
+
+template <int Level, Format F, typename... Args> inline void write(Args const&... args) {
+  if constexpr (Level >= TSDK_LOG_LEVEL_MIN) {
+    static_assert(detail::placeholder_cnt<F>() == sizeof...(Args),
+                  "thru::log placeholder count does not match argument count");
+#if TSDK_LOG_TEXT
+    detail::write_text<Level, F>(args...);
+#else
+    detail::write_binary<Level, F>(args...);
+#endif
+  }
+}
+
+template <Format F, typename... Args> inline void trace(Args const&... args) {
+  write<TSDK_LOG_LEVEL_TRACE, F>(args...);
+}
+
+template <Format F, typename... Args> inline void debug(Args const&... args) {
+  write<TSDK_LOG_LEVEL_DEBUG, F>(args...);
+}
+
+template <Format F, typename... Args> inline void info(Args const&... args) {
+  write<TSDK_LOG_LEVEL_INFO, F>(args...);
+}
+
+template <Format F, typename... Args> inline void warn(Args const&... args) {
+  write<TSDK_LOG_LEVEL_WARN, F>(args...);
+}
+
+template <Format F, typename... Args> inline void error(Args const&... args) {
+  write<TSDK_LOG_LEVEL_ERROR, F>(args...);
+}
+
+} // namespace log
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_log_hpp */
@@ -0,0 +1,338 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_map_hpp
+#define HEADER_sdks_cpp_tn_sdk_map_hpp
+
+#include "tn_sdk.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+/* FlatMap is a C++ port of the C SDK's tn_sdk_map_dynamic.c (itself
+   derived from Firedancer's fd_map_dynamic.c): a linear-probing
+   open-addressing map with a power-of-two slot count fixed at compile
+   time and tombstone-free removal.
+
+   The map is position independent and contains no pointers, so it can
+   be formatted inside account data and joined in place on every later
+   invocation with no deserialization:
+
+     using Balances = thru::FlatMap<pubkey_t, ulong, 10>;
+
+     thru::Account acct(2);
+     Balances map = Balances::join(acct);
+     if (!map.valid()) thru::runtime::revert(ERR_BAD_STATE);
+     ulong* bal = map.find(owner);
+
+   Mutating a joined map writes account data, so the account must have
+   been made writable (tsys_set_account_data_writable) first.
+
+   Memory layout (all offsets fixed by the template arguments):
+
+     [Header (24 bytes)][Slot 0] ... [Slot 2^LgSlotCnt - 1]
+
+   A map holds at most 2^LgSlotCnt - 1 keys and is fastest below
+   about half full. */
+
+constexpr ulong TSDK_FLAT_MAP_MAGIC = 0xF1A7AA9D0C0DE001UL;
+
+namespace thru {
+
+/* FlatMapKeyTraits selects, at compile time, how a key type is hashed
+   and compared.  A specialization provides:
+
+     null()       - the key that marks an empty slot; insert() rejects it
+                    and lookups never find it
+     inval(k)     - true if k is the null key
+     equal(a, b)  - key equality
+     hash(k)      - uniform hash of k
+     MEMOIZE      - store hash(k) in each slot so probes and removal only
+                    compare full keys when the hashes match; worth it
+                    when equal() is expensive
+
+   Programs can pass their own traits type as FlatMap's last argument. */
+template <typename Key> struct FlatMapKeyTraits;
+
+template <IntegralType Key> struct FlatMapKeyTraits<Key> {
+  using hash_t = ulong;
+  static constexpr bool MEMOIZE = false;
+
+  static constexpr Key null() { return Key(0); }
+  static constexpr bool inval(Key k) { return k == Key(0); }
+  static constexpr bool equal(Key a, Key b) { return a == b; }
+  static constexpr hash_t hash(Key k) {
+    ulong x = static_cast<ulong>(k);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdUL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53UL;
+    x ^= x >> 33;
+    return x;
+  }
+};
+
+/* Pubkeys and hashes are already uniformly distributed, so the first
+   word is mixed once rather than hashing all 32 bytes.  Equality is a
+   32-byte compare, so the hash is memoized in the slot. */
+template <> struct FlatMapKeyTraits<pubkey_t> {
+  using hash_t = uint;
+  static constexpr bool MEMOIZE = true;
+
+  static pubkey_t null() {
+    pubkey_t k;
+    std::memset(&k, 0, sizeof(k));
+    return k;
+  }
+  static bool inval(const pubkey_t& k) {
+    ulong w[4];
+    pubkey_load(k, w);
+    return !(w[0] | w[1] | w[2] | w[3]);
+  }
+  static bool equal(const pubkey_t& a, const pubkey_t& b) {
+    return pubkey_eq(a, b);
+  }
+  static hash_t hash(const pubkey_t& k) {
+    return static_cast<hash_t>((pubkey_prefix(k) * 0x9E3779B97F4A7C15UL) >> 32);
+  }
+};
+
+namespace detail {
+template <typename Key, typename Value, typename Hash, bool Memoize>
+struct FlatMapSlot {
+  Key key;
+  Value value;
+};
+
+template <typename Key, typename Value, typename Hash>
+struct FlatMapSlot<Key, Value, Hash, true> {
+  Key key;
+  Hash hash;
+  Value value;
+};
+} // namespace detail
+
+template <Trivial Key, Trivial Value, int LgSlotCnt,
+          typename Traits = FlatMapKeyTraits<Key>>
+class FlatMap {
+  static_assert(LgSlotCnt >= 1 && LgSlotCnt <= 24, "LgSlotCnt out of range");
+
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using hash_t = typename Traits::hash_t;
+  using Slot = detail::FlatMapSlot<Key, Value, hash_t, Traits::MEMOIZE>;
+
+  struct Header {
+    ulong magic;
+    ulong key_cnt;
+    ulong lg_slot_cnt;
+  };
+
+  static constexpr ulong SLOT_CNT = 1UL << LgSlotCnt;
+  static constexpr ulong SLOT_MASK = SLOT_CNT - 1UL;
+  static constexpr ulong KEY_MAX = SLOT_MASK;
+
+  static constexpr ulong align() {
+    return alignof(Slot) > alignof(Header) ? alignof(Slot) : alignof(Header);
+  }
+
+  static constexpr ulong slot_off() { return mem::align_up(sizeof(Header), alignof(Slot)); }
+
+  static constexpr ulong footprint() {
+    return mem::align_up(slot_off() + sizeof(Slot) * SLOT_CNT, align());
+  }
+
+  static_assert(footprint() <= TN_ACCOUNT_DATA_SZ_MAX, "map does not fit in an account");
+
+  FlatMap() : hdr_(nullptr), slot_(nullptr) {}
+
+  /* Formats the footprint() bytes at shmem as an empty map.  shmem must
+     be aligned to align(). */
+  static void* format(void* shmem) {
+    Header* hdr = static_cast<Header*>(shmem);
+    hdr->magic = TSDK_FLAT_MAP_MAGIC;
+    hdr->key_cnt = 0UL;
+    hdr->lg_slot_cnt = static_cast<ulong>(LgSlotCnt);
+    Slot* slot = slots_of(shmem);
+    for (ulong i = 0UL; i < SLOT_CNT; i++) {
+      slot[i].key = Traits::null();
+    }
+    return shmem;
+  }
+
+  /* Joins a map previously formatted at shmem.  Returns an invalid map
+     if shmem is misaligned or does not hold a map of this shape. */
+  static FlatMap join(void* shmem) {
+    Header* hdr = static_cast<Header*>(shmem);
+    if (TSDK_UNLIKELY(!shmem || !mem::is_aligned(reinterpret_cast<ulong>(shmem), align()) ||
+                      hdr->magic != TSDK_FLAT_MAP_MAGIC ||
+                      hdr->lg_slot_cnt != static_cast<ulong>(LgSlotCnt))) {
+      return FlatMap();
+    }
+    return FlatMap(hdr, slots_of(shmem));
+  }
+
+  /* Joins a map stored at the start of an account's data.  Returns an
+     invalid map if the account is too small to hold it. */
+  static FlatMap join(const Account& account) {
+    if (TSDK_UNLIKELY(account.get_meta()->data_sz < footprint())) {
+      return FlatMap();
+    }
+    return join(account.get_data_ptr());
+  }
+
+  bool valid() const { return hdr_ != nullptr; }
+
+  ulong key_cnt() const { return hdr_->key_cnt; }
+
+  static constexpr ulong key_max() { return KEY_MAX; }
+
+  static constexpr ulong slot_cnt() { return SLOT_CNT; }
+
+  /* Direct slot access for iteration: slot i is occupied iff
+     !Traits::inval(slot(i).key). */
+  Slot& slot(ulong idx) const { return slot_[idx]; }
+
+  ulong slot_idx(const Slot* s) const { return static_cast<ulong>(s - slot_); }
+
+  /* Inserts key and returns its slot, or nullptr if key is the null key,
+     is already present or the map is full.  The caller fills in value; key and the
+     memoized hash must not be modified.  The returned pointer is valid
+     until the next remove. */
+  Slot* insert(const Key& key) {
+    ulong key_cnt = hdr_->key_cnt;
+    if (TSDK_UNLIKELY(key_cnt >= KEY_MAX || Traits::inval(key))) {
+      return nullptr;
+    }
+
+    hash_t hash = Traits::hash(key);
+    ulong idx = start(hash);
+    Slot* m;
+    for (;;) {
+      m = slot_ + idx;
+      if (TSDK_LIKELY(Traits::inval(m->key))) {
+        break; /* Optimize for not found */
+      }
+      if (TSDK_UNLIKELY(match(m, key, hash))) {
+        return nullptr;
+      }
+      idx = next(idx);
+    }
+    m->key = key;
+    if constexpr (Traits::MEMOIZE) {
+      m->hash = hash;
+    }
+    hdr_->key_cnt = key_cnt + 1UL;
+    return m;
+  }
+
+  /* Returns the slot holding key, or nullptr if absent (always for the
+     null key). */
+  Slot* query(const Key& key) const {
+    if (TSDK_UNLIKELY(Traits::inval(key))) {
+      return nullptr;
+    }
+    hash_t hash = Traits::hash(key);
+    ulong idx = start(hash);
+    for (;;) {
+      Slot* m = slot_ + idx;
+      if (Traits::inval(m->key)) {
+        return nullptr;
+      }
+      if (match(m, key, hash)) {
+        return m;
+      }
+      idx = next(idx);
+    }
+  }
+
+  Value* find(const Key& key) const {
+    Slot* m = query(key);
+    return m ? &m->value : nullptr;
+  }
+
+  /* Removes the entry at slot entry, which must be occupied.  Later
+     entries in the probe run are shifted back to close the hole, so no
+     tombstones are left behind; slot pointers obtained before the call
+     may now refer to different keys. */
+  void remove(Slot* entry) {
+    hdr_->key_cnt--;
+
+    ulong idx = slot_idx(entry);
+    for (;;) {
+      /* Make a hole at idx */
+      slot_[idx].key = Traits::null();
+      ulong hole = idx;
+
+      for (;;) {
+        idx = next(idx);
+
+        /* Entries (hole,idx) are occupied and their probe sequences are
+           intact.  If idx is empty, all probe sequences are intact. */
+        if (Traits::inval(slot_[idx].key)) {
+          return;
+        }
+
+        /* If a probe for the key at idx does not start in (hole,idx]
+           (cyclic), the hole breaks it: move the key into the hole and
+           repeat with the new hole at idx. */
+        ulong s = start(slot_hash(slot_ + idx));
+        if (!(((hole < s) & (s <= idx)) | ((hole > idx) & ((hole < s) | (s <= idx))))) {
+          break;
+        }
+      }
+
+      slot_[hole] = slot_[idx];
+    }
+  }
+
+  /* Removes key; false if it was absent */
+  bool remove(const Key& key) {
+    Slot* m = query(key);
+    if (!m) {
+      return false;
+    }
+    remove(m);
+    return true;
+  }
+
+  void clear() {
+    hdr_->key_cnt = 0UL;
+    for (ulong i = 0UL; i < SLOT_CNT; i++) {
+      slot_[i].key = Traits::null();
+    }
+  }
+
+private:
+  FlatMap(Header* hdr, Slot* slot) : hdr_(hdr), slot_(slot) {}
+
+  static Slot* slots_of(void* shmem) {
+    return reinterpret_cast<Slot*>(static_cast<uchar*>(shmem) + slot_off());
+  }
+
+  static ulong start(hash_t hash) { return static_cast<ulong>(hash) & SLOT_MASK; }
+
+  static ulong next(ulong idx) { return (idx + 1UL) & SLOT_MASK; }
+
+  static hash_t slot_hash(const Slot* m) {
+    if constexpr (Traits::MEMOIZE) {
+      return m->hash;
+    } else {
+      return Traits::hash(m->key);
+    }
+  }
+
+  static bool match(const Slot* m, const Key& key, hash_t hash) {
+    if constexpr (Traits::MEMOIZE) {
+      return m->hash == hash && Traits::equal(m->key, key);
+    } else {
+      (void)hash;
+      return Traits::equal(m->key, key);
+    }
+  }
+
+  Header* hdr_;
+  Slot* slot_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_map_hpp */
@@ -0,0 +1,347 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_math_hpp
+#define HEADER_sdks_cpp_tn_sdk_math_hpp
+
+#include "tn_sdk_base.hpp"
+
+#include <compare>
+#include <type_traits>
+
+/* Overflow-checked integer arithmetic for token amounts.
+
+   a * b / c is the core of every price, fee and share computation, and
+   written as ((unsigned __int128)a * b) / c it costs a call to libgcc's
+   __udivti3, a general 128 by 128 bit division.  The quotient of a
+   mul_div is at most 64 bits whenever it is representable, so here the
+   product is formed with mul/mulhu and divided by a 128 by 64 bit
+   division (two divu, or two multiplies when the divisor is a
+   compile-time constant, see Divisor).
+
+     ulong fee   = thru::math::mul_div(amount, fee_bps, 10000UL, thru::math::Round::UP);
+     ulong share = thru::math::mul_div<1000000000UL>(amount, price_e9);
+
+   The plain functions revert with TSDK_MATH_ERR_OVERFLOW or
+   TSDK_MATH_ERR_DIV_BY_ZERO; the try_ forms return false instead and
+   leave *out unspecified.  Everything is constexpr: in a constant
+   expression the native 128-bit arithmetic is used, and an overflow
+   there is a compile error. */
+
+/* Math revert codes */
+constexpr ulong TSDK_MATH_ERR_OVERFLOW    = 0xBAD0BF00UL; /* Result does not fit */
+constexpr ulong TSDK_MATH_ERR_DIV_BY_ZERO = 0xBAD0BF01UL; /* Division by zero */
+
+namespace thru {
+namespace math {
+
+__extension__ typedef unsigned __int128 uint128;
+
+/* Rounding of a quotient: toward zero, away from zero, or to nearest
+   with halves rounded up */
+enum class Round { DOWN, UP, NEAREST };
+
+/* --- Add and subtract ------------------------------------------------ */
+
+/* a + b + carry_in; *carry_out is set to the carry out of bit 63 */
+constexpr ulong addc(ulong a, ulong b, ulong carry_in, ulong* carry_out) {
+  ulong s;
+  ulong c0 = __builtin_add_overflow(a, b, &s);
+  ulong c1 = __builtin_add_overflow(s, carry_in, &s);
+  *carry_out = c0 | c1;
+  return s;
+}
+
+/* a - b - borrow_in; *borrow_out is set to the borrow into bit 63 */
+constexpr ulong subb(ulong a, ulong b, ulong borrow_in, ulong* borrow_out) {
+  ulong d;
+  ulong b0 = __builtin_sub_overflow(a, b, &d);
+  ulong b1 = __builtin_sub_overflow(d, borrow_in, &d);
+  *borrow_out = b0 | b1;
+  return d;
+}
+
+constexpr bool try_add(ulong a, ulong b, ulong* out) { return !__builtin_add_overflow(a, b, out); }
+
+constexpr bool try_sub(ulong a, ulong b, ulong* out) { return !__builtin_sub_overflow(a, b, out); }
+
+constexpr bool try_mul(ulong a, ulong b, ulong* out) { return !__builtin_mul_overflow(a, b, out); }
+
+constexpr ulong add(ulong a, ulong b) {
+  ulong s;
+  if (TSDK_UNLIKELY(__builtin_add_overflow(a, b, &s))) {
+    tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+  }
+  return s;
+}
+
+constexpr ulong sub(ulong a, ulong b) {
+  ulong d;
+  if (TSDK_UNLIKELY(__builtin_sub_overflow(a, b, &d))) {
+    tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+  }
+  return d;
+}
+
+constexpr ulong mul(ulong a, ulong b) {
+  ulong p;
+  if (TSDK_UNLIKELY(__builtin_mul_overflow(a, b, &p))) {
+    tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+  }
+  return p;
+}
+
+/* --- Wide multiply and divide ---------------------------------------- */
+
+/* Full 128-bit product: the low half is returned, the high half (mulhu)
+   stored in *hi */
+constexpr ulong mul_wide(ulong a, ulong b, ulong* hi) {
+  uint128 p = static_cast<uint128>(a) * b;
+  *hi = static_cast<ulong>(p >> 64);
+  return static_cast<ulong>(p);
+}
+
+namespace detail {
+
+/* (u1:u0) / d for u1 < d, by schoolbook division in 32-bit digits with
+   the divu estimates corrected at most twice each (Hacker's Delight,
+   divlu).  The remainder is stored in *r. */
+constexpr ulong div_2by1(ulong u1, ulong u0, ulong d, ulong* r) {
+  constexpr ulong B = 1UL << 32;
+  int s = __builtin_clzl(d);
+  d <<= s;
+  ulong dn1 = d >> 32;
+  ulong dn0 = d & (B - 1UL);
+  ulong un32 = s ? (u1 << s) | (u0 >> (64 - s)) : u1;
+  ulong un10 = u0 << s;
+  ulong un1 = un10 >> 32;
+  ulong un0 = un10 & (B - 1UL);
+
+  ulong q1 = un32 / dn1;
+  ulong rhat = un32 - q1 * dn1;
+  while (q1 >= B || q1 * dn0 > B * rhat + un1) {
+    q1--;
+    rhat += dn1;
+    if (rhat >= B) {
+      break;
+    }
+  }
+  ulong un21 = un32 * B + un1 - q1 * d;
+
+  ulong q0 = un21 / dn1;
+  rhat = un21 - q0 * dn1;
+  while (q0 >= B || q0 * dn0 > B * rhat + un0) {
+    q0--;
+    rhat += dn1;
+    if (rhat >= B) {
+      break;
+    }
+  }
+  *r = (un21 * B + un0 - q0 * d) >> s;
+  return q1 * B + q0;
+}
+
+/* Adjusts floor quotient q with remainder r of a division by d */
+constexpr bool round_quotient(ulong q, ulong r, ulong d, Round round, ulong* out) {
+  bool up = round == Round::UP ? r != 0UL : round == Round::NEAREST ? r >= d - r : false;
+  return !__builtin_add_overflow(q, static_cast<ulong>(up), out);
+}
+
+} // namespace detail
+
+/* A divisor with its reciprocal, for dividing many 128-bit values by
+   the same d with two multiplies each instead of two divu (Möller and
+   Granlund, "Improved division by invariant integers", 2011).
+   Constructing one costs a division, so it pays for repeated use or,
+   constexpr, for a constant d, where it costs nothing at run time. */
+class Divisor {
+public:
+  constexpr explicit Divisor(ulong d) : d_(d), dn_(0UL), v_(0UL), shift_(0) {
+    if (TSDK_UNLIKELY(!d)) {
+      tsdk_revert(TSDK_MATH_ERR_DIV_BY_ZERO);
+    }
+    shift_ = __builtin_clzl(d);
+    dn_ = d << shift_;
+    /* v = floor((2^128 - 1) / dn) - 2^64 */
+    ulong r = 0UL;
+    if (std::is_constant_evaluated()) {
+      v_ = static_cast<ulong>(~static_cast<uint128>(0) / dn_);
+    } else {
+      v_ = detail::div_2by1(~dn_, ~0UL, dn_, &r);
+    }
+  }
+
+  constexpr ulong value() const { return d_; }
+
+  /* (u1:u0) / d for u1 < d, remainder in *r */
+  constexpr ulong div(ulong u1, ulong u0, ulong* r) const {
+    ulong n1 = shift_ ? (u1 << shift_) | (u0 >> (64 - shift_)) : u1;
+    ulong n0 = u0 << shift_;
+    uint128 q = static_cast<uint128>(v_) * n1;
+    q += (static_cast<uint128>(n1 + 1UL) << 64) | n0;
+    ulong q1 = static_cast<ulong>(q >> 64);
+    ulong q0 = static_cast<ulong>(q);
+    ulong rem = n0 - q1 * dn_;
+    if (rem > q0) {
+      q1--;
+      rem += dn_;
+    }
+    if (TSDK_UNLIKELY(rem >= dn_)) {
+      q1++;
+      rem -= dn_;
+    }
+    *r = rem >> shift_;
+    return q1;
+  }
+
+private:
+  ulong d_;
+  ulong dn_;    /* d shifted so its top bit is set */
+  ulong v_;     /* Reciprocal of dn_ */
+  int shift_;
+};
+
+/* a * b / c at 128-bit precision, rounded as asked.  False if c is zero
+   or the result does not fit in 64 bits. */
+constexpr bool try_mul_div(ulong a, ulong b, ulong c, ulong* out, Round round = Round::DOWN) {
+  if (TSDK_UNLIKELY(!c)) {
+    return false;
+  }
+  ulong hi = 0UL;
+  ulong lo = mul_wide(a, b, &hi);
+  if (TSDK_UNLIKELY(hi >= c)) {
+    return false;
+  }
+  ulong q = 0UL;
+  ulong r = 0UL;
+  if (std::is_constant_evaluated()) {
+    uint128 n = (static_cast<uint128>(hi) << 64) | lo;
+    q = static_cast<ulong>(n / c);
+    r = static_cast<ulong>(n % c);
+  } else if (!hi) {
+    q = lo / c;
+    r = lo - q * c;
+  } else {
+    q = detail::div_2by1(hi, lo, c, &r);
+  }
+  return detail::round_quotient(q, r, c, round, out);
+}
+
+/* try_mul_div by a precomputed divisor */
+constexpr bool try_mul_div(ulong a, ulong b, Divisor const& c, ulong* out,
+                           Round round = Round::DOWN) {
+  ulong hi = 0UL;
+  ulong lo = mul_wide(a, b, &hi);
+  if (TSDK_UNLIKELY(hi >= c.value())) {
+    return false;
+  }
+  ulong r = 0UL;
+  ulong q = c.div(hi, lo, &r);
+  return detail::round_quotient(q, r, c.value(), round, out);
+}
+
+constexpr ulong mul_div(ulong a, ulong b, ulong c, Round round = Round::DOWN) {
+  if (TSDK_UNLIKELY(!c)) {
+    tsdk_revert(TSDK_MATH_ERR_DIV_BY_ZERO);
+  }
+  ulong q = 0UL;
+  if (TSDK_UNLIKELY(!try_mul_div(a, b, c, &q, round))) {
+    tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+  }
+  return q;
+}
+
+constexpr ulong mul_div(ulong a, ulong b, Divisor const& c, Round round = Round::DOWN) {
+  ulong q = 0UL;
+  if (TSDK_UNLIKELY(!try_mul_div(a, b, c, &q, round))) {
+    tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+  }
+  return q;
+}
+
+/* mul_div by a constant: the reciprocal is computed at compile time */
+template <ulong C> constexpr ulong mul_div(ulong a, ulong b, Round round = Round::DOWN) {
+  static_assert(C != 0UL, "division by zero");
+  constexpr Divisor D(C);
+  return mul_div(a, b, D, round);
+}
+
+/* --- Decimal fixed point --------------------------------------------- */
+
+constexpr ulong pow10(uint e) {
+  ulong p = 1UL;
+  for (uint i = 0U; i < e; i++) {
+    p *= 10UL;
+  }
+  return p;
+}
+
+/* Fixed<Frac> is an unsigned decimal with Frac fractional digits,
+   stored as value * 10^Frac in a ulong (Fixed<9> covers 0 to about
+   1.8e10 in steps of 1e-9).  Arithmetic is checked like the functions
+   above; products and quotients are formed at 128-bit precision, by a
+   compile-time reciprocal of 10^Frac, and round down unless asked. */
+template <uint Frac> class Fixed {
+  static_assert(Frac >= 1U && Frac <= 19U, "Frac must be in [1, 19]");
+
+public:
+  static constexpr ulong SCALE = pow10(Frac);
+
+  constexpr Fixed() : raw_(0UL) {}
+
+  static constexpr Fixed from_raw(ulong raw) { return Fixed(raw); }
+  static constexpr Fixed from_int(ulong v) { return Fixed(math::mul(v, SCALE)); }
+
+  /* num / den, rounded */
+  static constexpr Fixed ratio(ulong num, ulong den, Round round = Round::DOWN) {
+    return Fixed(math::mul_div(num, SCALE, den, round));
+  }
+
+  constexpr ulong raw() const { return raw_; }
+
+  /* Integer part, or the value rounded to an integer */
+  constexpr ulong to_int(Round round = Round::DOWN) const {
+    ulong q = raw_ / SCALE;
+    ulong r = raw_ % SCALE;
+    ulong out = 0UL;
+    if (TSDK_UNLIKELY(!detail::round_quotient(q, r, SCALE, round, &out))) {
+      tsdk_revert(TSDK_MATH_ERR_OVERFLOW);
+    }
+    return out;
+  }
+
+  /* amount * this, as an integer: the usual price or rate application */
+  constexpr ulong apply(ulong amount, Round round = Round::DOWN) const {
+    return math::mul_div(amount, raw_, DIVISOR, round);
+  }
+
+  constexpr Fixed mul(Fixed o, Round round = Round::DOWN) const {
+    return Fixed(math::mul_div(raw_, o.raw_, DIVISOR, round));
+  }
+
+  constexpr Fixed div(Fixed o, Round round = Round::DOWN) const {
+    return Fixed(math::mul_div(raw_, SCALE, o.raw_, round));
+  }
+
+  friend constexpr Fixed operator+(Fixed a, Fixed b) { return Fixed(math::add(a.raw_, b.raw_)); }
+  friend constexpr Fixed operator-(Fixed a, Fixed b) { return Fixed(math::sub(a.raw_, b.raw_)); }
+  friend constexpr Fixed operator*(Fixed a, Fixed b) { return a.mul(b); }
+  friend constexpr Fixed operator/(Fixed a, Fixed b) { return a.div(b); }
+
+  constexpr Fixed& operator+=(Fixed o) { return *this = *this + o; }
+  constexpr Fixed& operator-=(Fixed o) { return *this = *this - o; }
+  constexpr Fixed& operator*=(Fixed o) { return *this = *this * o; }
+  constexpr Fixed& operator/=(Fixed o) { return *this = *this / o; }
+
+  friend constexpr bool operator==(Fixed a, Fixed b) = default;
+  friend constexpr auto operator<=>(Fixed a, Fixed b) = default;
+
+private:
+  static constexpr Divisor DIVISOR{SCALE};
+
+  constexpr explicit Fixed(ulong raw) : raw_(raw) {}
+
+  ulong raw_;
+};
+
+} // namespace math
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_math_hpp */
@@ -0,0 +1,217 @@
+#include "tn_sdk.hpp"
+
+/* Memory routines for rv64 with -mstrict-align.  A misaligned word
+   access traps there, so the generic C versions picolibc falls back to
+   move one byte at a time.  These take the word path whenever the
+   alignment of the operands allows it and find the interesting byte of
+   a word with Zbb (orc.b, ctz) rather than a byte loop.
+
+   When source and destination disagree mod 8, memcpy and memcmp read
+   the source with aligned loads and funnel-shift adjacent words.  Those
+   loads can touch up to 7 bytes outside the source range, always within
+   an aligned word that holds some of its bytes and so never in another
+   page.
+
+   Local.mk builds this file with -fno-tree-loop-distribute-patterns so
+   the loops are not turned back into calls to the functions they
+   implement. */
+
+namespace {
+
+constexpr ulong WORD = sizeof(ulong);
+constexpr ulong ONES = 0x0101010101010101UL;
+
+inline ulong ld(uchar const* p) {
+  ulong v;
+  __builtin_memcpy(&v, __builtin_assume_aligned(p, WORD), WORD);
+  return v;
+}
+
+inline void st(uchar* p, ulong v) { __builtin_memcpy(__builtin_assume_aligned(p, WORD), &v, WORD); }
+
+inline ulong misalign(void const* p) { return reinterpret_cast<ulong>(p) & (WORD - 1UL); }
+
+/* 0xff in each nonzero byte of x, 0x00 in each zero byte */
+inline ulong orc_b(ulong x) {
+#if defined(__riscv_zbb)
+  ulong r;
+  __asm__("orc.b %0,%1" : "=r"(r) : "r"(x));
+  return r;
+#else
+  ulong hi = 0x8080808080808080UL;
+  ulong nz = ((x & ~hi) + ~hi) | x; /* High bit of each byte set iff the byte is nonzero */
+  return ((nz & hi) >> 7) * 0xffUL;
+#endif
+}
+
+/* Bytes [sh/8, 8) of *lo followed by bytes [0, sh/8) of *hi */
+inline ulong funnel(ulong lo, ulong hi, ulong sh) { return (lo >> sh) | (hi << (64UL - sh)); }
+
+/* Sign of the first differing byte of words a != b (little-endian) */
+inline int word_diff(ulong a, ulong b) {
+  ulong sh = static_cast<ulong>(__builtin_ctzl(a ^ b)) & ~7UL;
+  return static_cast<int>((a >> sh) & 0xffUL) - static_cast<int>((b >> sh) & 0xffUL);
+}
+
+} // namespace
+
+extern "C" {
+
+void* tsdk_memset(void* dest, int c, ulong n) {
+  uchar* d = static_cast<uchar*>(dest);
+  uchar b = static_cast<uchar>(c);
+  while (n && misalign(d)) {
+    *d++ = b;
+    n--;
+  }
+  ulong w = ONES * b;
+  for (; n >= 4UL * WORD; n -= 4UL * WORD, d += 4UL * WORD) {
+    st(d, w);
+    st(d + WORD, w);
+    st(d + 2UL * WORD, w);
+    st(d + 3UL * WORD, w);
+  }
+  for (; n >= WORD; n -= WORD, d += WORD) {
+    st(d, w);
+  }
+  while (n--) {
+    *d++ = b;
+  }
+  return dest;
+}
+
+void* tsdk_memcpy(void* dest, void const* src, ulong n) {
+  uchar* d = static_cast<uchar*>(dest);
+  uchar const* s = static_cast<uchar const*>(src);
+  if (n >= 2UL * WORD) {
+    while (misalign(d)) {
+      *d++ = *s++;
+      n--;
+    }
+    ulong sh = 8UL * misalign(s);
+    if (!sh) {
+      for (; n >= 4UL * WORD; n -= 4UL * WORD, d += 4UL * WORD, s += 4UL * WORD) {
+        ulong a = ld(s), b = ld(s + WORD), c = ld(s + 2UL * WORD), e = ld(s + 3UL * WORD);
+        st(d, a);
+        st(d + WORD, b);
+        st(d + 2UL * WORD, c);
+        st(d + 3UL * WORD, e);
+      }
+      for (; n >= WORD; n -= WORD, d += WORD, s += WORD) {
+        st(d, ld(s));
+      }
+    } else {
+      /* Aligned loads of the source, shifted into place */
+      uchar const* sa = s - sh / 8UL;
+      ulong lo = ld(sa);
+      for (; n >= WORD; n -= WORD, d += WORD, s += WORD) {
+        sa += WORD;
+        ulong hi = ld(sa);
+        st(d, funnel(lo, hi, sh));
+        lo = hi;
+      }
+    }
+  }
+  while (n--) {
+    *d++ = *s++;
+  }
+  return dest;
+}
+
+void* tsdk_memmove(void* dest, void const* src, ulong n) {
+  uchar* d = static_cast<uchar*>(dest);
+  uchar const* s = static_cast<uchar const*>(src);
+  /* Below src or past its end: the forward copy only ever stores over
+     source bytes it has already loaded */
+  if (reinterpret_cast<ulong>(d) - reinterpret_cast<ulong>(s) >= n) {
+    return tsdk_memcpy(dest, src, n);
+  }
+  d += n;
+  s += n;
+  if (misalign(d) == misalign(s)) {
+    while (n && misalign(d)) {
+      *--d = *--s;
+      n--;
+    }
+    for (; n >= WORD; n -= WORD) {
+      d -= WORD;
+      s -= WORD;
+      st(d, ld(s));
+    }
+  }
+  while (n--) {
+    *--d = *--s;
+  }
+  return dest;
+}
+
+int tsdk_memcmp(void const* s1, void const* s2, ulong n) {
+  uchar const* a = static_cast<uchar const*>(s1);
+  uchar const* b = static_cast<uchar const*>(s2);
+  if (n >= 2UL * WORD) {
+    while (misalign(a)) {
+      if (*a != *b) {
+        return *a - *b;
+      }
+      a++;
+      b++;
+      n--;
+    }
+    ulong sh = 8UL * misalign(b);
+    if (!sh) {
+      for (; n >= WORD; n -= WORD, a += WORD, b += WORD) {
+        ulong x = ld(a), y = ld(b);
+        if (x != y) {
+          return word_diff(x, y);
+        }
+      }
+    } else {
+      uchar const* ba = b - sh / 8UL;
+      ulong lo = ld(ba);
+      for (; n >= WORD; n -= WORD, a += WORD, b += WORD) {
+        ba += WORD;
+        ulong hi = ld(ba);
+        ulong x = ld(a), y = funnel(lo, hi, sh);
+        if (x != y) {
+          return word_diff(x, y);
+        }
+        lo = hi;
+      }
+    }
+  }
+  for (; n; n--, a++, b++) {
+    if (*a != *b) {
+      return *a - *b;
+    }
+  }
+  return 0;
+}
+
+ulong tsdk_strlen(char const* str) {
+  uchar const* p = reinterpret_cast<uchar const*>(str);
+  while (misalign(p)) {
+    if (!*p) {
+      return static_cast<ulong>(p - reinterpret_cast<uchar const*>(str));
+    }
+    p++;
+  }
+  /* Aligned words never cross into an unmapped page */
+  for (;; p += WORD) {
+    ulong z = ~orc_b(ld(p));
+    if (z) {
+      return static_cast<ulong>(p - reinterpret_cast<uchar const*>(str)) +
+             static_cast<ulong>(__builtin_ctzl(z)) / 8UL;
+    }
+  }
+}
+
+#if defined(THRU_VM)
+/* In place of picolibc's, which are byte loops under -mstrict-align */
+void* memset(void* dest, int c, ulong n) { return tsdk_memset(dest, c, n); }
+void* memcpy(void* dest, void const* src, ulong n) { return tsdk_memcpy(dest, src, n); }
+void* memmove(void* dest, void const* src, ulong n) { return tsdk_memmove(dest, src, n); }
+int memcmp(void const* s1, void const* s2, ulong n) { return tsdk_memcmp(s1, s2, n); }
+ulong strlen(char const* str) { return tsdk_strlen(str); }
+#endif
+
+} // extern "C"
@@ -0,0 +1,214 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_merkle_hpp
+#define HEADER_sdks_cpp_tn_sdk_merkle_hpp
+
+#include "tn_sdk.hpp"
+#include "tn_sdk_sha256.hpp"
+
+#include <array>
+#include <cstring>
+#include <span>
+
+/* MerkleAccumulator<Depth> commits to an append-only list of up to
+   2^Depth leaves (deposits, withdrawal receipts, ...) while storing only
+   the right frontier of the tree, one hash per level, in account data:
+
+     [Header (24 bytes)][frontier[0]] ... [frontier[Depth - 1]]
+
+   Interior nodes are SHA-256(left || right) and missing leaves are 32
+   zero bytes, the same tree as the Ethereum deposit contract.  Appending
+   costs one hash per trailing one bit of the leaf count (two on
+   average, Depth at worst) and root() costs Depth hashes; the
+   empty-subtree hashes are compile-time constants.
+
+     using Receipts = thru::MerkleAccumulator<32>;
+
+     thru::WritableSet writable;
+     Receipts receipts = Receipts::join(thru::Account(3), writable);
+     ulong idx = receipts.append(receipt_hash);
+
+   Inclusion proofs are Depth sibling hashes, leaf first, and are read
+   where they lie in instruction data:
+
+     Receipts::Proof proof = Receipts::proof(tail);
+     if (!Receipts::verify(root, leaf, idx, proof)) ...
+
+   Leaves are hashes; callers hash their leaf data first (with their own
+   domain separation if leaves and nodes must not collide). */
+
+constexpr ulong TSDK_MERKLE_MAGIC = 0x3E7C1EACC0C0DE01UL;
+
+/* MerkleAccumulator revert codes */
+constexpr ulong TSDK_MERKLE_ERR_INVALID         = 0xBAD0BD00UL; /* Not an accumulator of this depth */
+constexpr ulong TSDK_MERKLE_ERR_FULL            = 0xBAD0BD01UL; /* 2^Depth leaves appended */
+constexpr ulong TSDK_MERKLE_ERR_RESIZE_FAILED   = 0xBAD0BD02UL; /* tsys_account_resize refused */
+constexpr ulong TSDK_MERKLE_ERR_PROOF_TRUNCATED = 0xBAD0BD03UL; /* Fewer than Depth proof hashes */
+
+namespace thru {
+
+struct MerkleAccumulatorHeader {
+  ulong magic;
+  uint depth;
+  uint reserved;
+  ulong leaf_cnt;
+};
+
+template <ulong Depth> class MerkleAccumulator {
+  static_assert(Depth >= 1UL && Depth <= 63UL, "depth out of range");
+
+public:
+  using Header = MerkleAccumulatorHeader;
+
+  struct Layout {
+    Header hdr;
+    pubkey_t frontier[Depth];
+  };
+
+  /* Sibling hashes from the leaf level up */
+  using Proof = std::span<const pubkey_t, Depth>;
+
+  static constexpr ulong LEAF_CNT_MAX = 1UL << Depth;
+  static constexpr ulong FOOTPRINT = sizeof(Layout);
+  static constexpr ulong PROOF_SZ = Depth * sizeof(pubkey_t);
+
+  /* ZEROS[h] is the root of an empty subtree of height h */
+  static constexpr std::array<pubkey_t, Depth + 1UL> ZEROS = [] {
+    std::array<pubkey_t, Depth + 1UL> z{};
+    for (ulong h = 1UL; h <= Depth; h++) {
+      z[h] = crypto::sha256_pair_constexpr(z[h - 1UL], z[h - 1UL]);
+    }
+    return z;
+  }();
+
+  /* Formats account's data as an empty accumulator, resizing it to
+     FOOTPRINT.  Anything already in the account is discarded. */
+  static MerkleAccumulator format(Account account, WritableSet& writable) {
+    writable.promote(account.index());
+    if (TSDK_UNLIKELY(tsys_account_resize(account.index(), FOOTPRINT) != TSDK_SUCCESS)) {
+      tsdk_revert(TSDK_MERKLE_ERR_RESIZE_FAILED);
+    }
+    Layout* l = account.get_data_as<Layout>();
+    std::memset(l, 0, sizeof(Layout));
+    l->hdr.magic = TSDK_MERKLE_MAGIC;
+    l->hdr.depth = static_cast<uint>(Depth);
+    return MerkleAccumulator(l);
+  }
+
+  /* Joins the accumulator in account's data, promoting the account
+     through writable.  Reverts with TSDK_MERKLE_ERR_INVALID unless the
+     account holds an accumulator of this depth. */
+  static MerkleAccumulator join(Account account, WritableSet& writable) {
+    return MerkleAccumulator(AccountViewMut<Layout>(account, writable));
+  }
+
+  /* Joins through a view that already checked and promoted the account */
+  explicit MerkleAccumulator(AccountViewMut<Layout> const& view) : l_(view.get()) { check(l_); }
+
+  /* Root of the accumulator in account's data, read-only */
+  static pubkey_t root_of(Account account) {
+    AccountView<Layout> view(account);
+    check(view.get());
+    return root(view.get());
+  }
+
+  ulong size() const { return l_->hdr.leaf_cnt; }
+  bool empty() const { return !l_->hdr.leaf_cnt; }
+
+  /* Appends leaf and returns its index */
+  ulong append(pubkey_t const& leaf) {
+    ulong idx = l_->hdr.leaf_cnt;
+    if (TSDK_UNLIKELY(idx >= LEAF_CNT_MAX)) {
+      tsdk_revert(TSDK_MERKLE_ERR_FULL);
+    }
+    /* Each trailing one of idx is a full left subtree to fold in */
+    pubkey_t node = leaf;
+    ulong h = 0UL;
+    ulong i = idx;
+    for (; (i & 1UL) && h < Depth - 1UL; i >>= 1) {
+      crypto::Sha256::hash_pair(&l_->frontier[h], &node, &node);
+      h++;
+    }
+    if (TSDK_UNLIKELY(i & 1UL)) {
+      /* The last leaf: the top entry becomes the root of the full tree */
+      crypto::Sha256::hash_pair(&l_->frontier[h], &node, &node);
+    }
+    l_->frontier[h] = node;
+    l_->hdr.leaf_cnt = idx + 1UL;
+    return idx;
+  }
+
+  void append(std::span<const pubkey_t> leaves) {
+    for (pubkey_t const& leaf : leaves) {
+      append(leaf);
+    }
+  }
+
+  pubkey_t root() const { return root(l_); }
+
+  /* True if leaf is at index idx of the list accumulated so far */
+  bool contains(pubkey_t const& leaf, ulong idx, Proof proof) const {
+    return idx < l_->hdr.leaf_cnt && verify(root(), leaf, idx, proof);
+  }
+
+  /* True if proof shows leaf at index idx of the tree with root root */
+  static bool verify(pubkey_t const& root, pubkey_t const& leaf, ulong idx, Proof proof) {
+    if (TSDK_UNLIKELY(idx >= LEAF_CNT_MAX)) {
+      return false;
+    }
+    pubkey_t node = leaf;
+    for (ulong h = 0UL; h < Depth; h++) {
+      if ((idx >> h) & 1UL) {
+        crypto::Sha256::hash_pair(&proof[h], &node, &node);
+      } else {
+        crypto::Sha256::hash_pair(&node, &proof[h], &node);
+      }
+    }
+    return pubkey_eq(node, root);
+  }
+
+  /* A proof at the front of data, without copying; rest, if given,
+     receives what follows.  Reverts with TSDK_MERKLE_ERR_PROOF_TRUNCATED
+     if data is shorter than PROOF_SZ. */
+  static Proof proof(std::span<const std::byte> data, std::span<const std::byte>* rest = nullptr) {
+    if (TSDK_UNLIKELY(data.size() < PROOF_SZ)) {
+      tsdk_revert(TSDK_MERKLE_ERR_PROOF_TRUNCATED);
+    }
+    if (rest) {
+      *rest = data.subspan(PROOF_SZ);
+    }
+    return Proof(reinterpret_cast<pubkey_t const*>(data.data()), Depth);
+  }
+
+private:
+  explicit MerkleAccumulator(Layout* l) : l_(l) {}
+
+  static void check(Layout const* l) {
+    if (TSDK_UNLIKELY(l->hdr.magic != TSDK_MERKLE_MAGIC || l->hdr.depth != Depth ||
+                      l->hdr.leaf_cnt > LEAF_CNT_MAX)) {
+      tsdk_revert(TSDK_MERKLE_ERR_INVALID);
+    }
+  }
+
+  /* Folds the frontier with the empty subtrees to its right */
+  static pubkey_t root(Layout const* l) {
+    ulong cnt = l->hdr.leaf_cnt;
+    if (TSDK_UNLIKELY(cnt == LEAF_CNT_MAX)) {
+      /* Full: the top frontier entry is the root */
+      return l->frontier[Depth - 1UL];
+    }
+    pubkey_t node = ZEROS[0];
+    for (ulong h = 0UL; h < Depth; h++) {
+      if ((cnt >> h) & 1UL) {
+        crypto::Sha256::hash_pair(&l->frontier[h], &node, &node);
+      } else {
+        crypto::Sha256::hash_pair(&node, &ZEROS[h], &node);
+      }
+    }
+    return node;
+  }
+
+  Layout* l_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_merkle_hpp */
@@ -0,0 +1,107 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_pda_hpp
+#define HEADER_sdks_cpp_tn_sdk_pda_hpp
+
+#include "tn_sdk_sha256.hpp"
+#include "tn_sdk_syscall.hpp"
+
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/* Program-defined account addresses, as derived by the VM on
+   tsys_account_create and by the C SDK's
+   tsdk_create_program_defined_account_address:
+
+     address = SHA-256(owner (32) || is_ephemeral (1) || seed (32))
+
+   A string seed is a template argument, zero-padded to TN_SEED_SIZE,
+   and with a constant owner the whole derivation folds to a 32-byte
+   literal:
+
+     constexpr pubkey_t PROGRAM = {...};
+     constexpr pubkey_t CONFIG = thru::pda<"config">(PROGRAM);
+
+   With a run-time owner the same call hashes at run time.  Programs
+   deriving many addresses under one owner with varying seeds (one vault
+   per user, say) should build a PdaOwner once; each derive() then skips
+   the owner's share of the hashing. */
+
+namespace thru {
+
+/* A seed given as a string literal of at most TN_SEED_SIZE bytes */
+template <ulong N> struct Seed {
+  static_assert(N - 1UL <= TN_SEED_SIZE, "seed longer than TN_SEED_SIZE");
+
+  uchar bytes[TN_SEED_SIZE] = {};
+
+  consteval Seed(const char (&s)[N]) {
+    for (ulong i = 0UL; i + 1UL < N; i++) {
+      bytes[i] = static_cast<uchar>(s[i]);
+    }
+  }
+};
+
+namespace detail {
+
+constexpr ulong PDA_MSG_SZ = sizeof(pubkey_t) + 1UL + TN_SEED_SIZE;
+
+constexpr pubkey_t pda_constexpr(pubkey_t const& owner, uchar const* seed, bool ephemeral) {
+  uchar msg[PDA_MSG_SZ] = {};
+  for (ulong i = 0UL; i < sizeof(pubkey_t); i++) {
+    msg[i] = owner.key[i];
+  }
+  msg[sizeof(pubkey_t)] = ephemeral ? 1U : 0U;
+  for (ulong i = 0UL; i < TN_SEED_SIZE; i++) {
+    msg[sizeof(pubkey_t) + 1UL + i] = seed[i];
+  }
+  return crypto::sha256_constexpr(msg, sizeof(msg));
+}
+
+} // namespace detail
+
+/* Address of the account owner derives from seed */
+constexpr pubkey_t pda(pubkey_t const& owner, std::span<const uchar, TN_SEED_SIZE> seed,
+                       bool ephemeral = false) {
+  if (std::is_constant_evaluated()) {
+    return detail::pda_constexpr(owner, seed.data(), ephemeral);
+  }
+  uchar msg[detail::PDA_MSG_SZ];
+  std::memcpy(msg, &owner, sizeof(pubkey_t));
+  msg[sizeof(pubkey_t)] = ephemeral ? 1U : 0U;
+  std::memcpy(msg + sizeof(pubkey_t) + 1UL, seed.data(), TN_SEED_SIZE);
+  pubkey_t out;
+  crypto::Sha256::hash(msg, sizeof(msg), &out);
+  return out;
+}
+
+template <Seed S, bool Ephemeral = false> constexpr pubkey_t pda(pubkey_t const& owner) {
+  return pda(owner, std::span<const uchar, TN_SEED_SIZE>(S.bytes), Ephemeral);
+}
+
+/* Derives addresses under one owner.  The owner fills the first 32
+   bytes of the first SHA-256 block, so the rounds that read only those
+   are run once here instead of per address. */
+class PdaOwner {
+public:
+  explicit PdaOwner(pubkey_t const& owner) : prefix_(crypto::Sha256::prefix32(&owner)) {}
+
+  pubkey_t derive(std::span<const uchar, TN_SEED_SIZE> seed, bool ephemeral = false) const {
+    uchar rest[1UL + TN_SEED_SIZE];
+    rest[0] = ephemeral ? 1U : 0U;
+    std::memcpy(rest + 1UL, seed.data(), TN_SEED_SIZE);
+    pubkey_t out;
+    crypto::Sha256::hash_prefixed(prefix_, rest, sizeof(rest), &out);
+    return out;
+  }
+
+  template <Seed S, bool Ephemeral = false> pubkey_t derive() const {
+    return derive(std::span<const uchar, TN_SEED_SIZE>(S.bytes), Ephemeral);
+  }
+
+private:
+  crypto::Sha256::Prefix32 prefix_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_pda_hpp */
@@ -0,0 +1,104 @@
+#include "tn_sdk.hpp"
+#include "tn_sdk_prof.hpp"
+#include "tn_sdk_syscall.hpp"
+
+#include <cstring>
+
+#if TSDK_PROFILE
+
+static_assert(TSDK_PROF_SLOT_CNT * sizeof(tsdk_prof_slot_t) <= TSDK_PAGE_SZ,
+              "profile table must fit in its page");
+static_assert((TSDK_PROF_SLOT_CNT & (TSDK_PROF_SLOT_CNT - 1UL)) == 0UL,
+              "TSDK_PROF_SLOT_CNT must be a power of two");
+
+namespace {
+
+tsdk_prof_slot_t* prof_table() {
+  return static_cast<tsdk_prof_slot_t*>(tsdk_get_heap_base());
+}
+
+char* prof_text() {
+  return static_cast<char*>(tsdk_get_heap_base()) + TSDK_PAGE_SZ;
+}
+
+char* put_str(char* p, char const* end, char const* s, ulong max) {
+  for (ulong i = 0UL; i < max && s[i] && p < end; i++) {
+    *p++ = s[i];
+  }
+  return p;
+}
+
+char* put_dec(char* p, char const* end, ulong x) {
+  char tmp[20];
+  ulong n = 0UL;
+  do {
+    tmp[n++] = static_cast<char>('0' + x % 10UL);
+    x /= 10UL;
+  } while (x);
+  while (n && p < end) {
+    *p++ = tmp[--n];
+  }
+  return p;
+}
+
+} // namespace
+
+extern "C" {
+
+void tsdk_prof_init(void) {
+  void* addr = nullptr;
+  if (TSDK_UNLIKELY(tsys_increment_anonymous_segment_sz(tsdk_get_heap_base(),
+                                                        TSDK_PROF_HEAP_RESERVE,
+                                                        &addr) != TSDK_SUCCESS)) {
+    /* Not tsdk_revert: that would try to dump the unmapped table */
+    tsys_exit(TSDK_PROF_ERR_INIT_FAILED, 1UL);
+  }
+  /* A previous invocation at this depth may have left data behind */
+  std::memset(prof_table(), 0, TSDK_PROF_SLOT_CNT * sizeof(tsdk_prof_slot_t));
+}
+
+tsdk_prof_slot_t* tsdk_prof_slot(ulong id, char const* name) {
+  tsdk_prof_slot_t* table = prof_table();
+  ulong mask = TSDK_PROF_SLOT_CNT - 1UL;
+  for (ulong i = 0UL; i < TSDK_PROF_SLOT_CNT; i++) {
+    tsdk_prof_slot_t* slot = &table[(id + i) & mask];
+    if (TSDK_LIKELY(slot->id == id)) {
+      return slot;
+    }
+    if (slot->id == 0UL) {
+      slot->id = id;
+      put_str(slot->name, slot->name + TSDK_PROF_NAME_MAX - 1UL, name, TSDK_PROF_NAME_MAX);
+      return slot;
+    }
+  }
+  return nullptr;
+}
+
+void tsdk_prof_dump(void) {
+  tsdk_prof_slot_t const* table = prof_table();
+  char* const buf = prof_text();
+  char const* const end = buf + TSDK_PAGE_SZ;
+  char* p = buf;
+  for (ulong i = 0UL; i < TSDK_PROF_SLOT_CNT; i++) {
+    tsdk_prof_slot_t const* slot = &table[i];
+    if (!slot->id) {
+      continue;
+    }
+    p = put_str(p, end, "prof ", 5UL);
+    p = put_str(p, end, slot->name, TSDK_PROF_NAME_MAX);
+    p = put_str(p, end, " n=", 3UL);
+    p = put_dec(p, end, slot->calls);
+    p = put_str(p, end, " cyc=", 5UL);
+    p = put_dec(p, end, slot->cycles);
+    p = put_str(p, end, " ins=", 5UL);
+    p = put_dec(p, end, slot->instret);
+    p = put_str(p, end, "\n", 1UL);
+  }
+  if (p != buf) {
+    tsys_log(buf, static_cast<ulong>(p - buf));
+  }
+}
+
+} // extern "C"
+
+#endif /* TSDK_PROFILE */
@@ -0,0 +1,150 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_prof_hpp
+#define HEADER_sdks_cpp_tn_sdk_prof_hpp
+
+#include "tn_sdk_base.hpp"
+
+/* Scoped compute profiling, enabled by building both the SDK and the
+   program with SDK_EXTRAS=profile (config/extra/with-profile.mk).
+
+     void match_orders(...) {
+       TSDK_PROF_SCOPE("match");
+       ...
+     }
+
+   Each probe reads the RISC-V cycle and instret counters on entry and
+   exit and adds the difference to its scope's slot in a table kept at
+   the bottom of the invocation's heap segment (the Arena is moved up to
+   make room).  Scopes are keyed by name, so every probe with the same
+   name shares a slot, and counts are inclusive of nested scopes.
+   tsdk_return and tsdk_revert dump the table as one text log:
+
+     prof match n=12 cyc=48211 ins=40007
+     prof settle n=1 cyc=9120 ins=8884
+
+   Without the profile extra, TSDK_PROF_SCOPE expands to nothing and
+   thru::prof::Scope is an empty type, so probes cost no code.
+
+   The counters are read with raw csrr encodings, so the -march string
+   does not need Zicntr; the VM must still implement the CSRs.  Host
+   builds read the TSC for cycles and report zero instret. */
+
+#ifndef TSDK_PROFILE
+#define TSDK_PROFILE 0
+#endif
+
+/* Reverts with this if the profile table cannot be mapped */
+constexpr ulong TSDK_PROF_ERR_INIT_FAILED = 0xBAD0B600UL;
+
+constexpr ulong TSDK_PROF_SLOT_CNT = 64UL;  /* Distinct scope names tracked */
+constexpr ulong TSDK_PROF_NAME_MAX = 32UL;  /* Name bytes kept per slot */
+
+/* Heap bytes reserved ahead of the Arena: one page for the slot table
+   and one for formatting the summary. */
+constexpr ulong TSDK_PROF_HEAP_RESERVE = TSDK_PROFILE ? 2UL * 4096UL : 0UL;
+
+struct tsdk_prof_slot {
+  ulong id;                     /* Name hash, 0 if the slot is free */
+  ulong calls;
+  ulong cycles;
+  ulong instret;
+  char name[TSDK_PROF_NAME_MAX];
+};
+typedef struct tsdk_prof_slot tsdk_prof_slot_t;
+
+extern "C" {
+#if TSDK_PROFILE
+/* Maps and clears the profile table.  Called by _start. */
+void tsdk_prof_init(void);
+
+/* Returns the slot for the named scope, claiming a free one on first
+   use.  Returns nullptr once the table is full. */
+tsdk_prof_slot_t* tsdk_prof_slot(ulong id, char const* name);
+
+/* Logs the summary.  Called by tsdk_return and tsdk_revert. */
+void tsdk_prof_dump(void);
+#endif
+}
+
+namespace thru {
+namespace prof {
+
+inline ulong read_cycle() {
+#if defined(__riscv)
+  ulong x;
+  __asm__ volatile(".insn i 0x73, 2, %0, x0, -1024" : "=r"(x)); /* csrr %0, cycle */
+  return x;
+#elif defined(__x86_64__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0UL;
+#endif
+}
+
+inline ulong read_instret() {
+#if defined(__riscv)
+  ulong x;
+  __asm__ volatile(".insn i 0x73, 2, %0, x0, -1022" : "=r"(x)); /* csrr %0, instret */
+  return x;
+#else
+  return 0UL;
+#endif
+}
+
+/* FNV-1a of a scope name; never 0, which marks a free slot. */
+constexpr ulong scope_id(char const* name) {
+  ulong h = 0xCBF29CE484222325UL;
+  for (; *name; name++) {
+    h ^= static_cast<uchar>(*name);
+    h *= 0x100000001B3UL;
+  }
+  return h ? h : 1UL;
+}
+
+#if TSDK_PROFILE
+
+template <ulong Id> class Scope {
+public:
+  explicit Scope(char const* name) : slot_(tsdk_prof_slot(Id, name)) {
+    instret_ = read_instret();
+    cycle_ = read_cycle();
+  }
+
+  ~Scope() {
+    ulong cycle = read_cycle();
+    ulong instret = read_instret();
+    if (TSDK_LIKELY(slot_ != nullptr)) {
+      slot_->calls++;
+      slot_->cycles += cycle - cycle_;
+      slot_->instret += instret - instret_;
+    }
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  tsdk_prof_slot_t* slot_;
+  ulong cycle_;
+  ulong instret_;
+};
+
+#define TSDK_PROF_CAT_(a, b) a##b
+#define TSDK_PROF_CAT(a, b) TSDK_PROF_CAT_(a, b)
+#define TSDK_PROF_SCOPE(name)                                                  \
+  ::thru::prof::Scope<::thru::prof::scope_id(name)> TSDK_PROF_CAT(_tsdk_prof_scope_, __LINE__)(name)
+
+#else
+
+template <ulong Id> class Scope {
+public:
+  explicit Scope(char const*) {}
+};
+
+#define TSDK_PROF_SCOPE(name) static_cast<void>(0)
+
+#endif
+
+} // namespace prof
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_prof_hpp */
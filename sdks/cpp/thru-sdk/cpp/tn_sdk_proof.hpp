@@ -0,0 +1,190 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_proof_hpp
+#define HEADER_sdks_cpp_tn_sdk_proof_hpp
+
+#include "tn_sdk.hpp"
+#include "tn_sdk_syscall.hpp"
+
+#include <cstring>
+#include <span>
+
+/* StateProofView validates a state proof where it lies, typically in
+   instruction data, with the same rules as the Rust SDK's StateProof:
+
+     [type_slot (8)][path_bitset (32)][type + popcount(path_bitset) hashes (32 each)]
+
+   The type is the top two bits of type_slot and must be Existing (0),
+   Updating (1) or Creation (2).  A malformed proof reverts here, before
+   paying for the syscall that would reject it, and a valid one is passed
+   to the syscall in place:
+
+     thru::StateProofView proof = thru::StateProofView::prefix(tail, &tail);
+     thru::syscall::account_decompress(idx, meta, data, proof);
+
+   The account syscall overloads taking a view also check that the proof
+   type fits the operation. */
+
+/* State proof revert codes */
+constexpr ulong TSDK_STATE_PROOF_ERR_TRUNCATED    = 0xBAD0BA00UL; /* Shorter than the header */
+constexpr ulong TSDK_STATE_PROOF_ERR_INVALID_TYPE = 0xBAD0BA01UL; /* Type bits are 3 */
+constexpr ulong TSDK_STATE_PROOF_ERR_MIS_SIZED    = 0xBAD0BA02UL; /* Hash count does not match the buffer */
+constexpr ulong TSDK_STATE_PROOF_ERR_WRONG_TYPE   = 0xBAD0BA03UL; /* Proof type does not fit the operation */
+
+namespace thru {
+
+class StateProofView {
+public:
+  enum class Type : ulong {
+    Existing = TN_STATE_PROOF_TYPE_EXISTING,
+    Updating = TN_STATE_PROOF_TYPE_UPDATING,
+    Creation = TN_STATE_PROOF_TYPE_CREATION,
+  };
+
+  static constexpr ulong HDR_SZ = sizeof(tn_state_proof_hdr);
+  static constexpr ulong FOOTPRINT_MAX = HDR_SZ + (TN_STATE_PROOF_KEYS_MAX + 2UL) * sizeof(pubkey_t);
+
+  /* A proof spanning all of data */
+  explicit StateProofView(std::span<const std::byte> data) : StateProofView(parse(data)) {
+    if (TSDK_UNLIKELY(footprint() != data.size())) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_MIS_SIZED);
+    }
+  }
+
+  /* A proof at the front of data; rest, if given, receives what follows */
+  static StateProofView prefix(std::span<const std::byte> data,
+                               std::span<const std::byte>* rest = nullptr) {
+    StateProofView proof = parse(data);
+    if (rest) {
+      *rest = data.subspan(proof.footprint());
+    }
+    return proof;
+  }
+
+  /* For data already known to hold a valid proof */
+  static StateProofView unchecked(void const* data) {
+    return StateProofView(static_cast<uchar const*>(data));
+  }
+
+  Type type() const { return static_cast<Type>(type_slot() >> 62); }
+  ulong slot() const { return type_slot() & ((1UL << 62) - 1UL); }
+  pubkey_t const& path_bitset() const { return hdr()->path_bitset; }
+
+  /* Bytes the proof occupies */
+  ulong footprint() const { return HDR_SZ + (leaf_cnt() + sibling_cnt_) * sizeof(pubkey_t); }
+
+  std::span<const pubkey_t> sibling_hashes() const { return {body() + leaf_cnt(), sibling_cnt_}; }
+
+  /* Hash of the leaf an Updating or Creation proof is anchored on;
+     reverts with TSDK_STATE_PROOF_ERR_WRONG_TYPE for Existing proofs */
+  pubkey_t const& existing_leaf_hash() const {
+    if (TSDK_UNLIKELY(!leaf_cnt())) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+    }
+    return body()[leaf_cnt() - 1UL];
+  }
+
+  /* Pubkey of the neighbouring leaf a Creation proof is anchored on */
+  pubkey_t const& existing_leaf_pubkey() const {
+    expect(Type::Creation);
+    return body()[0];
+  }
+
+  /* Reverts with TSDK_STATE_PROOF_ERR_WRONG_TYPE unless type() is t */
+  StateProofView const& expect(Type t) const {
+    if (TSDK_UNLIKELY(type() != t)) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_WRONG_TYPE);
+    }
+    return *this;
+  }
+
+  tn_state_proof_hdr const* hdr() const { return reinterpret_cast<tn_state_proof_hdr const*>(p_); }
+  std::span<const std::byte> bytes() const {
+    return {reinterpret_cast<std::byte const*>(p_), footprint()};
+  }
+
+private:
+  explicit StateProofView(uchar const* p) : p_(p), sibling_cnt_(popcount_path(p)) {}
+
+  static StateProofView parse(std::span<const std::byte> data) {
+    if (TSDK_UNLIKELY(data.size() < HDR_SZ)) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_TRUNCATED);
+    }
+    StateProofView proof(reinterpret_cast<uchar const*>(data.data()));
+    if (TSDK_UNLIKELY((proof.type_slot() >> 62) > TN_STATE_PROOF_TYPE_CREATION)) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_INVALID_TYPE);
+    }
+    /* At most 40 + 258 * 32 bytes, so no overflow */
+    if (TSDK_UNLIKELY(proof.footprint() > data.size())) {
+      tsdk_revert(TSDK_STATE_PROOF_ERR_MIS_SIZED);
+    }
+    return proof;
+  }
+
+  /* Sibling hash count: one per set bit of path_bitset */
+  static ulong popcount_path(uchar const* p) {
+    ulong w[4];
+    std::memcpy(w, p + offsetof(tn_state_proof_hdr, path_bitset), sizeof(w));
+    return static_cast<ulong>(__builtin_popcountl(w[0]) + __builtin_popcountl(w[1]) +
+                              __builtin_popcountl(w[2]) + __builtin_popcountl(w[3]));
+  }
+
+  ulong type_slot() const {
+    ulong v;
+    std::memcpy(&v, p_, sizeof(v));
+    return v;
+  }
+
+  /* Leaf entries ahead of the siblings: Updating has the leaf hash,
+     Creation the leaf pubkey and hash */
+  ulong leaf_cnt() const { return type_slot() >> 62; }
+
+  pubkey_t const* body() const { return reinterpret_cast<pubkey_t const*>(p_ + HDR_SZ); }
+
+  uchar const* p_;
+  ulong sibling_cnt_;
+};
+
+namespace syscall {
+
+/* Account syscalls taking a validated proof.  Creating an account needs
+   a Creation proof, decompressing an Existing one, and compressing an
+   Updating proof (previously compressed) or a Creation proof (first
+   compression). */
+
+inline ulong
+account_create( ulong account_idx, std::span<const std::byte, TN_SEED_SIZE> seed,
+                StateProofView const & proof ) {
+  proof.expect( StateProofView::Type::Creation );
+  return tsys_account_create( account_idx, reinterpret_cast<const unsigned char *>( seed.data( )),
+                              proof.hdr( ), proof.footprint( ));
+}
+
+inline ulong
+account_compress( ulong account_idx, StateProofView const & proof ) {
+  if( TSDK_UNLIKELY( proof.type( ) == StateProofView::Type::Existing )) {
+    tsdk_revert( TSDK_STATE_PROOF_ERR_WRONG_TYPE );
+  }
+  return tsys_account_compress( account_idx, proof.hdr( ), proof.footprint( ));
+}
+
+inline ulong
+account_decompress( ulong account_idx,
+                    std::span<const std::byte> meta,
+                    std::span<const std::byte> data,
+                    StateProofView const & proof ) {
+  proof.expect( StateProofView::Type::Existing );
+  return tsys_account_decompress( account_idx, meta.data( ), data.data( ),
+                                  proof.hdr( ), proof.footprint( ));
+}
+
+inline ulong
+account_create_eoa( ulong                  account_idx,
+                    const signature_t *    signature,
+                    StateProofView const & proof ) {
+  proof.expect( StateProofView::Type::Creation );
+  return tsys_account_create_eoa( account_idx, signature, proof.hdr( ), proof.footprint( ));
+}
+
+} // namespace syscall
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_proof_hpp */
@@ -0,0 +1,216 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_resumable_hpp
+#define HEADER_sdks_cpp_tn_sdk_resumable_hpp
+
+#include "tn_sdk.hpp"
+
+#include <concepts>
+#include <cstring>
+
+/* Resumable<State> runs a job too large for one transaction as a series
+   of steps over State kept in an account, checkpointing after each one:
+
+     [ResumableHeader (40 bytes)][State]
+
+   A step is a function of the state and the step's cursor (0, 1, ...)
+   that updates the state in place and says whether the job is done.
+   run() takes steps while the budget allows another, so a transaction
+   ends at a step boundary with the cursor and accumulators saved, and
+   the next transaction carries on from there:
+
+     struct Settle {
+       ulong total;
+       ulong order_cnt;
+     };
+
+     thru::WritableSet writable;
+     thru::Resumable<Settle> job(thru::Account(3), writable);
+     thru::ComputeBudget budget(args.step_cus, SETTLE_ORDER_CUS);
+     bool done = job.run(args.expected_seq, budget, [&](Settle& s, ulong cursor) {
+       s.total += settle_order(cursor);
+       return cursor + 1UL == s.order_cnt ? thru::Step::DONE : thru::Step::CONTINUE;
+     });
+
+   Nothing is written but the account, so a transaction that reverts
+   leaves the previous checkpoint in place.  Two transactions resuming
+   the same checkpoint would both do its next steps, so run() takes the
+   tn_account_meta::seq the caller observed: of two resumers built from
+   the same observation only the first to land runs and the other
+   reverts with TSDK_RESUMABLE_ERR_STALE.
+
+   The budget is checked between steps only.  A program cannot read the
+   compute units it has consumed, so both budgets are counts the caller
+   chooses: StepBudget runs a fixed number of steps, ComputeBudget runs
+   steps while their estimated cost (measured beforehand, e.g. with
+   bench/run.sh --cu) fits in a limit.  The limit must leave room for
+   everything else the transaction does, syscalls included. */
+
+constexpr ulong TSDK_RESUMABLE_MAGIC = 0x4E5D7AB1EC0C0DE1UL;
+
+/* Resumable revert codes */
+constexpr ulong TSDK_RESUMABLE_ERR_INVALID     = 0xBAD0C100UL; /* Not a checkpoint of this state */
+constexpr ulong TSDK_RESUMABLE_ERR_STALE       = 0xBAD0C101UL; /* Account seq moved since observed */
+constexpr ulong TSDK_RESUMABLE_ERR_NOT_RUNNING = 0xBAD0C102UL; /* No job to resume */
+constexpr ulong TSDK_RESUMABLE_ERR_RUNNING     = 0xBAD0C103UL; /* Job started over an unfinished one */
+constexpr ulong TSDK_RESUMABLE_ERR_NO_PROGRESS = 0xBAD0C104UL; /* Budget too small for one step */
+
+namespace thru {
+
+enum class Step { CONTINUE, DONE };
+
+enum ResumableStatus : ulong {
+  RESUMABLE_IDLE = 0UL,
+  RESUMABLE_RUNNING = 1UL,
+  RESUMABLE_DONE = 2UL,
+};
+
+struct ResumableHeader {
+  ulong magic;    /* TSDK_RESUMABLE_MAGIC once a job has started */
+  ulong job;      /* Jobs started in this account, 1 for the first */
+  ulong cursor;   /* Steps of the current job completed */
+  ulong runs;     /* Transactions that took steps of the current job */
+  ulong status;   /* ResumableStatus */
+};
+
+/* Runs a fixed number of steps per transaction */
+class StepBudget {
+public:
+  explicit StepBudget(ulong max_steps) : left_(max_steps) {}
+
+  bool next() {
+    if (!left_) {
+      return false;
+    }
+    left_--;
+    return true;
+  }
+
+private:
+  ulong left_;
+};
+
+/* Runs steps while their estimated compute units fit in limit.  Each
+   step is charged step_cost when it starts; charge() adds what a step
+   costs beyond that, e.g. per item it processes. */
+class ComputeBudget {
+public:
+  ComputeBudget(ulong limit, ulong step_cost) : left_(limit), step_cost_(step_cost) {}
+
+  bool next() {
+    if (step_cost_ > left_) {
+      return false;
+    }
+    left_ -= step_cost_;
+    return true;
+  }
+
+  void charge(ulong cost) { left_ = cost < left_ ? left_ - cost : 0UL; }
+
+  ulong left() const { return left_; }
+
+private:
+  ulong left_;
+  ulong step_cost_;
+};
+
+template <typename Budget>
+concept ResumableBudget = requires(Budget& budget) {
+  { budget.next() } -> std::same_as<bool>;
+};
+
+template <typename State> class Resumable {
+public:
+  using Header = ResumableHeader;
+
+  struct Layout {
+    Header hdr;
+    State state;
+  };
+
+  static constexpr ulong FOOTPRINT = sizeof(Layout);
+
+  /* Joins the checkpoint in account's data, promoting the account
+     through writable.  The account must be at least FOOTPRINT bytes; a
+     zeroed account holds no job yet. */
+  Resumable(Account account, WritableSet& writable) : account_(account), view_(account, writable) {
+    Header const& hdr = view_->hdr;
+    if (TSDK_UNLIKELY((hdr.magic != TSDK_RESUMABLE_MAGIC && hdr.magic != 0UL) ||
+                      hdr.status > RESUMABLE_DONE)) {
+      tsdk_revert(TSDK_RESUMABLE_ERR_INVALID);
+    }
+  }
+
+  /* Starts a new job from initial.  Reverts with
+     TSDK_RESUMABLE_ERR_RUNNING if the last job has not finished; use
+     abort() first to abandon it. */
+  void start(State const& initial) {
+    Header& hdr = view_->hdr;
+    if (TSDK_UNLIKELY(hdr.status == RESUMABLE_RUNNING)) {
+      tsdk_revert(TSDK_RESUMABLE_ERR_RUNNING);
+    }
+    hdr.magic = TSDK_RESUMABLE_MAGIC;
+    hdr.job++;
+    hdr.cursor = 0UL;
+    hdr.runs = 0UL;
+    hdr.status = RESUMABLE_RUNNING;
+    std::memcpy(&view_->state, &initial, sizeof(State));
+  }
+
+  /* Takes steps of the running job while budget.next() allows,
+     calling step(state, cursor) -> Step, and returns done().
+     expected_seq is the account's tn_account_meta::seq as the caller
+     last saw it (before start() when starting and running in one
+     transaction).  Reverts with TSDK_RESUMABLE_ERR_NOT_RUNNING if there
+     is no running job, with TSDK_RESUMABLE_ERR_STALE if the account has
+     changed since, and with TSDK_RESUMABLE_ERR_NO_PROGRESS if the budget
+     allows no step, so a job cannot be kept open by transactions that
+     do nothing. */
+  template <ResumableBudget Budget, typename F>
+  bool run(ulong expected_seq, Budget& budget, F&& step) {
+    Header& hdr = view_->hdr;
+    if (TSDK_UNLIKELY(hdr.status != RESUMABLE_RUNNING)) {
+      tsdk_revert(TSDK_RESUMABLE_ERR_NOT_RUNNING);
+    }
+    if (TSDK_UNLIKELY(account_.get_meta()->seq != expected_seq)) {
+      tsdk_revert(TSDK_RESUMABLE_ERR_STALE);
+    }
+    State& state = view_->state;
+    ulong cursor = hdr.cursor;
+    ulong first = cursor;
+    while (budget.next()) {
+      Step s = step(state, cursor);
+      cursor++;
+      if (s == Step::DONE) {
+        hdr.status = RESUMABLE_DONE;
+        break;
+      }
+    }
+    if (TSDK_UNLIKELY(cursor == first)) {
+      tsdk_revert(TSDK_RESUMABLE_ERR_NO_PROGRESS);
+    }
+    hdr.cursor = cursor;
+    hdr.runs++;
+    return done();
+  }
+
+  /* Abandons the running job, if any, keeping its state for inspection */
+  void abort() {
+    if (view_->hdr.status == RESUMABLE_RUNNING) {
+      view_->hdr.status = RESUMABLE_IDLE;
+    }
+  }
+
+  State& state() const { return view_->state; }
+  ulong cursor() const { return view_->hdr.cursor; }
+  ulong runs() const { return view_->hdr.runs; }
+  ulong job() const { return view_->hdr.job; }
+  bool running() const { return view_->hdr.status == RESUMABLE_RUNNING; }
+  bool done() const { return view_->hdr.status == RESUMABLE_DONE; }
+
+private:
+  Account account_;
+  AccountViewMut<Layout> view_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_resumable_hpp */
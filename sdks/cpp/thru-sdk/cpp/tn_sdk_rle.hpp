@@ -0,0 +1,238 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_rle_hpp
+#define HEADER_sdks_cpp_tn_sdk_rle_hpp
+
+#include "tn_sdk.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <span>
+
+/* Read-only views over run-length encoded bitsets in the C SDK's tn_rle
+   layout (e.g. guardian sets passed in instruction data):
+
+     [first_bit (2)][run_count (2)][runs (2 bytes each)]
+
+   Runs alternate in value starting with first_bit; runs longer than
+   65535 bits are split with zero-length runs in between.
+
+   SetBits visits the index of every set bit and SetRuns every maximal
+   run of set bits, stepping from run to run rather than bit by bit:
+
+     thru::rle::Rle signers(tail);
+     for (ulong idx : signers.set_bits(guardian_cnt)) {
+       ...
+     }
+     for (thru::rle::Run run : signers.set_runs()) {
+       ...guardians [run.start, run.start + run.len) signed...
+     }
+
+   ClearBits / ClearRuns do the same for the zero bits.  Nothing is
+   copied: the run list is read in place, so the buffer needs no
+   particular alignment. */
+
+/* RLE revert codes */
+constexpr ulong TSDK_RLE_ERR_TRUNCATED = 0xBAD0B800UL; /* Run list extends past the buffer */
+
+namespace thru {
+namespace rle {
+
+constexpr ulong HDR_SZ = 2UL * sizeof(ushort);
+constexpr ulong RUN_MAX = 65535UL;
+
+/* A maximal run of equal bits: [start, start + len) */
+struct Run {
+  ulong start;
+  ulong len;
+};
+
+template <bool Value> class Runs;
+template <bool Value> class Bits;
+
+class Rle {
+public:
+  /* Reverts with TSDK_RLE_ERR_TRUNCATED unless data holds the header and
+     every run it declares.  Trailing bytes are allowed. */
+  explicit Rle(std::span<const std::byte> data) : p_(reinterpret_cast<uchar const*>(data.data())) {
+    if (TSDK_UNLIKELY(data.size() < HDR_SZ || data.size() < footprint())) {
+      tsdk_revert(TSDK_RLE_ERR_TRUNCATED);
+    }
+  }
+
+  /* For data already known to be a complete RLE */
+  static Rle unchecked(void const* data) { return Rle(static_cast<uchar const*>(data)); }
+
+  bool first_bit() const { return load(0UL) != 0U; }
+  ushort run_count() const { return load(1UL); }
+  ushort run(ulong i) const { return load(2UL + i); }
+
+  /* The encoding, in the C SDK's tn_rle_t layout */
+  void const* data() const { return p_; }
+
+  /* Bytes the header and runs occupy */
+  ulong footprint() const { return HDR_SZ + run_count() * sizeof(ushort); }
+
+  ulong total_bits() const {
+    ulong sum = 0UL;
+    for (ulong i = 0UL, cnt = run_count(); i < cnt; i++) {
+      sum += run(i);
+    }
+    return sum;
+  }
+
+  /* Ranges over the set (or clear) bits below limit */
+  Runs<true> set_runs(ulong limit = ~0UL) const;
+  Runs<false> clear_runs(ulong limit = ~0UL) const;
+  Bits<true> set_bits(ulong limit = ~0UL) const;
+  Bits<false> clear_bits(ulong limit = ~0UL) const;
+
+private:
+  explicit Rle(uchar const* p) : p_(p) {}
+
+  ushort load(ulong i) const {
+    ushort v;
+    std::memcpy(&v, p_ + i * sizeof(ushort), sizeof(ushort));
+    return v;
+  }
+
+  uchar const* p_;
+};
+
+template <bool Value> class Runs {
+public:
+  class iterator {
+  public:
+    using value_type = Run;
+    using difference_type = long;
+
+    iterator() = default;
+
+    Run operator*() const { return cur_; }
+
+    iterator& operator++() {
+      seek();
+      return *this;
+    }
+
+    void operator++(int) { seek(); }
+
+    bool operator==(std::default_sentinel_t) const { return done_; }
+
+  private:
+    friend class Runs;
+
+    iterator(Rle rle, ulong limit)
+        : rle_(rle), run_idx_(0UL), run_cnt_(rle.run_count()), pos_(0UL), limit_(limit),
+          val_(rle.first_bit()), done_(false) {
+      seek();
+    }
+
+    /* Advances to the next non-empty run of Value, merging runs that
+       are only separated by zero-length runs of the other value */
+    void seek() {
+      while (run_idx_ < run_cnt_ && (val_ != Value || !rle_.run(run_idx_))) {
+        pos_ += rle_.run(run_idx_++);
+        val_ = !val_;
+      }
+      if (run_idx_ >= run_cnt_ || pos_ >= limit_) {
+        done_ = true;
+        return;
+      }
+      ulong start = pos_;
+      pos_ += rle_.run(run_idx_++);
+      val_ = !val_;
+      while (run_idx_ + 1UL < run_cnt_ && !rle_.run(run_idx_)) {
+        pos_ += rle_.run(run_idx_ + 1UL);
+        run_idx_ += 2UL;
+      }
+      ulong end = pos_ < limit_ ? pos_ : limit_;
+      cur_ = Run{start, end - start};
+    }
+
+    Rle rle_ = Rle::unchecked(nullptr);
+    ulong run_idx_ = 0UL;
+    ulong run_cnt_ = 0UL;
+    ulong pos_ = 0UL;
+    ulong limit_ = 0UL;
+    Run cur_{0UL, 0UL};
+    bool val_ = false;
+    bool done_ = true;
+  };
+
+  Runs(Rle rle, ulong limit) : rle_(rle), limit_(limit) {}
+
+  iterator begin() const { return iterator(rle_, limit_); }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  Rle rle_;
+  ulong limit_;
+};
+
+template <bool Value> class Bits {
+public:
+  class iterator {
+  public:
+    using value_type = ulong;
+    using difference_type = long;
+
+    iterator() = default;
+
+    ulong operator*() const { return pos_; }
+
+    iterator& operator++() {
+      if (++pos_ == end_) {
+        next_run();
+      }
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const { return runs_ == std::default_sentinel; }
+
+  private:
+    friend class Bits;
+
+    explicit iterator(typename Runs<Value>::iterator runs) : runs_(runs) { load(); }
+
+    void next_run() {
+      ++runs_;
+      load();
+    }
+
+    void load() {
+      if (runs_ != std::default_sentinel) {
+        Run run = *runs_;
+        pos_ = run.start;
+        end_ = run.start + run.len;
+      }
+    }
+
+    typename Runs<Value>::iterator runs_;
+    ulong pos_ = 0UL;
+    ulong end_ = 0UL;
+  };
+
+  Bits(Rle rle, ulong limit) : runs_(rle, limit) {}
+
+  iterator begin() const { return iterator(runs_.begin()); }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  Runs<Value> runs_;
+};
+
+using SetRuns = Runs<true>;
+using ClearRuns = Runs<false>;
+using SetBits = Bits<true>;
+using ClearBits = Bits<false>;
+
+inline Runs<true> Rle::set_runs(ulong limit) const { return {*this, limit}; }
+inline Runs<false> Rle::clear_runs(ulong limit) const { return {*this, limit}; }
+inline Bits<true> Rle::set_bits(ulong limit) const { return {*this, limit}; }
+inline Bits<false> Rle::clear_bits(ulong limit) const { return {*this, limit}; }
+
+} // namespace rle
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_rle_hpp */
@@ -0,0 +1,446 @@
+#include "tn_sdk_sha256.hpp"
+#include "tn_sdk.hpp"
+
+#include <array>
+#include <cstring>
+
+/* The compression function below follows tn_sdk_sha256.c from the C SDK,
+   which is in turn derived from the Firedancer reference implementation.
+   It is written over an arbitrary number of lanes so hash_many() can run
+   independent messages through the round function in lockstep. */
+
+namespace thru {
+namespace crypto {
+
+namespace {
+
+constexpr auto& K = detail::SHA256_K;
+constexpr auto& H0 = detail::SHA256_H0;
+
+#if defined(__riscv_zknh)
+inline uint Sigma0(uint x) { uint r; __asm__("sha256sum0 %0,%1" : "=r"(r) : "r"(x)); return r; }
+inline uint Sigma1(uint x) { uint r; __asm__("sha256sum1 %0,%1" : "=r"(r) : "r"(x)); return r; }
+inline uint sigma0(uint x) { uint r; __asm__("sha256sig0 %0,%1" : "=r"(r) : "r"(x)); return r; }
+inline uint sigma1(uint x) { uint r; __asm__("sha256sig1 %0,%1" : "=r"(r) : "r"(x)); return r; }
+#else
+using detail::rotr;
+inline uint Sigma0(uint x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
+inline uint Sigma1(uint x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
+inline uint sigma0(uint x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3); }
+inline uint sigma1(uint x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10); }
+#endif
+
+inline uint Ch(uint x, uint y, uint z) { return (x & y) ^ (~x & z); }
+inline uint Maj(uint x, uint y, uint z) { return (x & y) ^ (x & z) ^ (y & z); }
+
+/* Loads a 64-byte block as big-endian words.  Message data frequently
+   comes straight out of instruction or account data with no alignment
+   guarantee, and -mstrict-align turns unknown-alignment word loads into
+   byte loads, so take the word path only when it is provably safe. */
+inline void load_block(uint* X, const uchar* block) {
+  if (TSDK_LIKELY(mem::is_aligned(reinterpret_cast<ulong>(block), alignof(uint)))) {
+    const uchar* w = static_cast<const uchar*>(__builtin_assume_aligned(block, alignof(uint)));
+    for (ulong i = 0UL; i < 16UL; i++) {
+      uint v;
+      std::memcpy(&v, w + 4UL * i, sizeof(uint));
+      X[i] = __builtin_bswap32(v);
+    }
+  } else {
+    for (ulong i = 0UL; i < 16UL; i++) {
+      const uchar* p = block + 4UL * i;
+      X[i] = (uint)p[0] << 24 | (uint)p[1] << 16 | (uint)p[2] << 8 | (uint)p[3];
+    }
+  }
+}
+
+/* Compresses one block into each of N independent states.  The round
+   loop is lane-innermost so the N dependency chains are interleaved. */
+template <ulong N> void core(uint* const* state, const uchar* const* block) {
+  uint a[N], b[N], c[N], d[N], e[N], f[N], g[N], h[N];
+  uint X[N][16];
+
+  for (ulong l = 0UL; l < N; l++) {
+    a[l] = state[l][0];
+    b[l] = state[l][1];
+    c[l] = state[l][2];
+    d[l] = state[l][3];
+    e[l] = state[l][4];
+    f[l] = state[l][5];
+    g[l] = state[l][6];
+    h[l] = state[l][7];
+    load_block(X[l], block[l]);
+  }
+
+  for (ulong i = 0UL; i < 64UL; i++) {
+    for (ulong l = 0UL; l < N; l++) {
+      if (i >= 16UL) {
+        X[l][i & 0xfUL] += sigma0(X[l][(i + 1UL) & 0xfUL]) +
+                           sigma1(X[l][(i + 14UL) & 0xfUL]) +
+                           X[l][(i + 9UL) & 0xfUL];
+      }
+      uint T1 = X[l][i & 0xfUL] + h[l] + Sigma1(e[l]) + Ch(e[l], f[l], g[l]) + K[i];
+      uint T2 = Sigma0(a[l]) + Maj(a[l], b[l], c[l]);
+      h[l] = g[l];
+      g[l] = f[l];
+      f[l] = e[l];
+      e[l] = d[l] + T1;
+      d[l] = c[l];
+      c[l] = b[l];
+      b[l] = a[l];
+      a[l] = T1 + T2;
+    }
+  }
+
+  for (ulong l = 0UL; l < N; l++) {
+    state[l][0] += a[l];
+    state[l][1] += b[l];
+    state[l][2] += c[l];
+    state[l][3] += d[l];
+    state[l][4] += e[l];
+    state[l][5] += f[l];
+    state[l][6] += g[l];
+    state[l][7] += h[l];
+  }
+}
+
+/* W[i] + K[i] for the padding block that ends every 64-byte message.
+   It is the same block for all of them, so hash_pair() runs its rounds
+   without expanding the message schedule. */
+constexpr std::array<uint, 64> pad64_wk() {
+  uint W[64] = {0x80000000U};
+  W[15] = 512U;
+  for (ulong i = 16UL; i < 64UL; i++) {
+    uint s0 = detail::rotr(W[i - 15UL], 7) ^ detail::rotr(W[i - 15UL], 18) ^ (W[i - 15UL] >> 3);
+    uint s1 = detail::rotr(W[i - 2UL], 17) ^ detail::rotr(W[i - 2UL], 19) ^ (W[i - 2UL] >> 10);
+    W[i] = W[i - 16UL] + s0 + W[i - 7UL] + s1;
+  }
+  std::array<uint, 64> wk{};
+  for (ulong i = 0UL; i < 64UL; i++) {
+    wk[i] = W[i] + K[i];
+  }
+  return wk;
+}
+
+constexpr std::array<uint, 64> PAD64_WK = pad64_wk();
+
+/* Compresses a block given as its precomputed W[i] + K[i] */
+void core_wk(uint* state, const uint* wk) {
+  uint a = state[0], b = state[1], c = state[2], d = state[3];
+  uint e = state[4], f = state[5], g = state[6], h = state[7];
+  for (ulong i = 0UL; i < 64UL; i++) {
+    uint T1 = wk[i] + h + Sigma1(e) + Ch(e, f, g);
+    uint T2 = Sigma0(a) + Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/* Rounds 0-7 of a first block, which only read its first 32 bytes */
+constexpr ulong PREFIX_ROUNDS = 8UL;
+
+/* Compresses a first block into state (H0) from the working variables
+   mid after its first PREFIX_ROUNDS rounds */
+void core_resume(uint* state, const uint* mid, const uchar* block) {
+  uint X[16];
+  load_block(X, block);
+  uint a = mid[0], b = mid[1], c = mid[2], d = mid[3];
+  uint e = mid[4], f = mid[5], g = mid[6], h = mid[7];
+  for (ulong i = PREFIX_ROUNDS; i < 64UL; i++) {
+    if (i >= 16UL) {
+      X[i & 0xfUL] += sigma0(X[(i + 1UL) & 0xfUL]) + sigma1(X[(i + 14UL) & 0xfUL]) +
+                      X[(i + 9UL) & 0xfUL];
+    }
+    uint T1 = X[i & 0xfUL] + h + Sigma1(e) + Ch(e, f, g) + K[i];
+    uint T2 = Sigma0(a) + Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+void core_blocks(uint* state, const uchar* data, ulong block_cnt) {
+  do {
+    core<1UL>(&state, &data);
+    data += TSDK_SHA256_BLOCK_SZ;
+  } while (--block_cnt);
+}
+
+/* Builds the final one or two padded blocks for a message of sz bytes
+   whose trailing partial block is tail[0,sz%64).  Returns the number of
+   padded blocks written to out. */
+ulong pad_tail(uchar* out, const uchar* tail, ulong sz) {
+  ulong rem = sz & (TSDK_SHA256_BLOCK_SZ - 1UL);
+  if (rem) {
+    std::memcpy(out, tail, rem);
+  }
+  out[rem] = static_cast<uchar>(0x80);
+  ulong blocks = rem + 1UL > TSDK_SHA256_BLOCK_SZ - 8UL ? 2UL : 1UL;
+  ulong end = blocks * TSDK_SHA256_BLOCK_SZ;
+  std::memset(out + rem + 1UL, 0, end - 8UL - rem - 1UL);
+  TSDK_STORE(ulong, out + end - 8UL, __builtin_bswap64(sz << 3));
+  return blocks;
+}
+
+void store_digest(void* hash, const uint* state) {
+  uint out[8];
+  for (ulong i = 0UL; i < 8UL; i++) {
+    out[i] = __builtin_bswap32(state[i]);
+  }
+  std::memcpy(hash, out, TSDK_SHA256_HASH_SZ);
+}
+
+struct Lane {
+  const uchar* data;
+  ulong full;  /* Whole blocks taken directly from data */
+  ulong total; /* full plus padded tail blocks */
+  uint state[8];
+  uchar tail[2UL * TSDK_SHA256_BLOCK_SZ];
+
+  const uchar* block(ulong k) const {
+    return k < full ? data + (k << TSDK_SHA256_LG_BLOCK_SZ)
+                    : tail + ((k - full) << TSDK_SHA256_LG_BLOCK_SZ);
+  }
+};
+
+template <ulong N>
+void hash_lanes(const std::span<const std::byte>* msgs, pubkey_t* hashes) {
+  Lane lane[N];
+  ulong common = ~0UL;
+  for (ulong l = 0UL; l < N; l++) {
+    const uchar* data = reinterpret_cast<const uchar*>(msgs[l].data());
+    ulong sz = msgs[l].size();
+    lane[l].data = data;
+    lane[l].full = sz >> TSDK_SHA256_LG_BLOCK_SZ;
+    lane[l].total = lane[l].full +
+        pad_tail(lane[l].tail, data + (lane[l].full << TSDK_SHA256_LG_BLOCK_SZ), sz);
+    std::memcpy(lane[l].state, H0, sizeof(H0));
+    if (lane[l].total < common) {
+      common = lane[l].total;
+    }
+  }
+
+  uint* state[N];
+  const uchar* block[N];
+  for (ulong l = 0UL; l < N; l++) {
+    state[l] = lane[l].state;
+  }
+
+  for (ulong k = 0UL; k < common; k++) {
+    for (ulong l = 0UL; l < N; l++) {
+      block[l] = lane[l].block(k);
+    }
+    core<N>(state, block);
+  }
+
+  /* Longer messages finish on their own */
+  for (ulong l = 0UL; l < N; l++) {
+    for (ulong k = common; k < lane[l].total; k++) {
+      const uchar* b = lane[l].block(k);
+      core<1UL>(&state[l], &b);
+    }
+    store_digest(&hashes[l], lane[l].state);
+  }
+}
+
+} // namespace
+
+Sha256& Sha256::init() {
+  std::memcpy(state_, H0, sizeof(H0));
+  buf_used_ = 0UL;
+  bit_cnt_ = 0UL;
+  return *this;
+}
+
+Sha256& Sha256::append(const void* _data, ulong sz) {
+  if (TSDK_UNLIKELY(!sz)) {
+    return *this;
+  }
+
+  const uchar* data = static_cast<const uchar*>(_data);
+  bit_cnt_ += sz << 3;
+
+  if (TSDK_UNLIKELY(buf_used_)) {
+    ulong buf_rem = TSDK_SHA256_BLOCK_SZ - buf_used_;
+    if (TSDK_UNLIKELY(sz < buf_rem)) {
+      std::memcpy(buf_ + buf_used_, data, sz);
+      buf_used_ += sz;
+      return *this;
+    }
+
+    std::memcpy(buf_ + buf_used_, data, buf_rem);
+    data += buf_rem;
+    sz -= buf_rem;
+
+    core_blocks(state_, buf_, 1UL);
+    buf_used_ = 0UL;
+  }
+
+  ulong block_cnt = sz >> TSDK_SHA256_LG_BLOCK_SZ;
+  if (TSDK_LIKELY(block_cnt)) {
+    core_blocks(state_, data, block_cnt);
+  }
+
+  ulong rem = sz & (TSDK_SHA256_BLOCK_SZ - 1UL);
+  if (TSDK_UNLIKELY(rem)) {
+    std::memcpy(buf_, data + (block_cnt << TSDK_SHA256_LG_BLOCK_SZ), rem);
+    buf_used_ = rem;
+  }
+
+  return *this;
+}
+
+void* Sha256::fini(void* hash) {
+  buf_[buf_used_] = static_cast<uchar>(0x80);
+  buf_used_++;
+
+  if (TSDK_UNLIKELY(buf_used_ > TSDK_SHA256_BLOCK_SZ - 8UL)) {
+    std::memset(buf_ + buf_used_, 0, TSDK_SHA256_BLOCK_SZ - buf_used_);
+    core_blocks(state_, buf_, 1UL);
+    buf_used_ = 0UL;
+  }
+
+  std::memset(buf_ + buf_used_, 0, TSDK_SHA256_BLOCK_SZ - 8UL - buf_used_);
+  TSDK_STORE(ulong, buf_ + TSDK_SHA256_BLOCK_SZ - 8UL, __builtin_bswap64(bit_cnt_));
+  core_blocks(state_, buf_, 1UL);
+
+  store_digest(hash, state_);
+  return hash;
+}
+
+void* Sha256::hash(const void* _data, ulong sz, void* hash) {
+  /* This is the incremental path streamlined to eliminate the overheads
+     of buffering partial blocks. */
+  const uchar* data = static_cast<const uchar*>(_data);
+  uint state[8];
+  std::memcpy(state, H0, sizeof(H0));
+
+  ulong block_cnt = sz >> TSDK_SHA256_LG_BLOCK_SZ;
+  if (TSDK_LIKELY(block_cnt)) {
+    core_blocks(state, data, block_cnt);
+  }
+
+  uchar tail[2UL * TSDK_SHA256_BLOCK_SZ];
+  ulong tail_cnt = pad_tail(tail, data + (block_cnt << TSDK_SHA256_LG_BLOCK_SZ), sz);
+  core_blocks(state, tail, tail_cnt);
+
+  store_digest(hash, state);
+  return hash;
+}
+
+void* Sha256::hash_pair(const void* left, const void* right, void* hash) {
+  alignas(uint) uchar block[TSDK_SHA256_BLOCK_SZ];
+  std::memcpy(block, left, TSDK_SHA256_HASH_SZ);
+  std::memcpy(block + TSDK_SHA256_HASH_SZ, right, TSDK_SHA256_HASH_SZ);
+  uint state[8];
+  std::memcpy(state, H0, sizeof(H0));
+  core_blocks(state, block, 1UL);
+  core_wk(state, PAD64_WK.data());
+  store_digest(hash, state);
+  return hash;
+}
+
+Sha256::Prefix32 Sha256::prefix32(const void* prefix) {
+  Prefix32 p;
+  std::memcpy(p.prefix, prefix, sizeof(p.prefix));
+  uint X[16];
+  uchar block[TSDK_SHA256_BLOCK_SZ] = {};
+  std::memcpy(block, prefix, sizeof(p.prefix));
+  load_block(X, block);
+  uint a = H0[0], b = H0[1], c = H0[2], d = H0[3];
+  uint e = H0[4], f = H0[5], g = H0[6], h = H0[7];
+  for (ulong i = 0UL; i < PREFIX_ROUNDS; i++) {
+    uint T1 = X[i] + h + Sigma1(e) + Ch(e, f, g) + K[i];
+    uint T2 = Sigma0(a) + Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+  uint mid[8] = {a, b, c, d, e, f, g, h};
+  std::memcpy(p.state, mid, sizeof(mid));
+  return p;
+}
+
+void* Sha256::hash_prefixed(Prefix32 const& prefix, const void* _rest, ulong rest_sz, void* hash) {
+  const uchar* rest = static_cast<const uchar*>(_rest);
+  ulong sz = sizeof(prefix.prefix) + rest_sz;
+  uint state[8];
+  std::memcpy(state, H0, sizeof(H0));
+
+  /* The first block, padded too when the message is shorter than a block */
+  alignas(uint) uchar first[2UL * TSDK_SHA256_BLOCK_SZ];
+  std::memcpy(first, prefix.prefix, sizeof(prefix.prefix));
+  ulong head = TSDK_SHA256_BLOCK_SZ - sizeof(prefix.prefix);
+  if (rest_sz < head) {
+    uchar msg[TSDK_SHA256_BLOCK_SZ];
+    std::memcpy(msg, prefix.prefix, sizeof(prefix.prefix));
+    std::memcpy(msg + sizeof(prefix.prefix), rest, rest_sz);
+    ulong blocks = pad_tail(first, msg, sz);
+    core_resume(state, prefix.state, first);
+    if (blocks > 1UL) {
+      core_blocks(state, first + TSDK_SHA256_BLOCK_SZ, 1UL);
+    }
+    store_digest(hash, state);
+    return hash;
+  }
+  std::memcpy(first + sizeof(prefix.prefix), rest, head);
+  core_resume(state, prefix.state, first);
+
+  rest += head;
+  rest_sz -= head;
+  ulong block_cnt = rest_sz >> TSDK_SHA256_LG_BLOCK_SZ;
+  if (block_cnt) {
+    core_blocks(state, rest, block_cnt);
+  }
+  uchar tail[2UL * TSDK_SHA256_BLOCK_SZ];
+  ulong tail_cnt = pad_tail(tail, rest + (block_cnt << TSDK_SHA256_LG_BLOCK_SZ), sz);
+  core_blocks(state, tail, tail_cnt);
+
+  store_digest(hash, state);
+  return hash;
+}
+
+void Sha256::hash_many(const std::span<const std::byte>* msgs, ulong cnt,
+                       pubkey_t* hashes) {
+  ulong i = 0UL;
+  for (; i + TSDK_SHA256_BATCH_MAX <= cnt; i += TSDK_SHA256_BATCH_MAX) {
+    hash_lanes<TSDK_SHA256_BATCH_MAX>(msgs + i, hashes + i);
+  }
+  for (; i < cnt; i++) {
+    hash_lanes<1UL>(msgs + i, hashes + i);
+  }
+}
+
+} // namespace crypto
+} // namespace thru
@@ -0,0 +1,224 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_sha256_hpp
+#define HEADER_sdks_cpp_tn_sdk_sha256_hpp
+
+#include "tn_sdk_base.hpp"
+
+#include <cstddef>
+#include <span>
+
+/* SHA-256 for Thru programs.  The compression function is a port of the
+   C SDK core in tn_sdk_sha256.c (itself from Firedancer) and uses the
+   Zknh sha256sum0/sum1/sig0/sig1 instructions enabled by thruvm.mk.
+   Builds without Zknh fall back to the equivalent shift/rotate forms. */
+
+constexpr ulong TSDK_SHA256_LG_BLOCK_SZ = 6UL;
+constexpr ulong TSDK_SHA256_BLOCK_SZ = 1UL << TSDK_SHA256_LG_BLOCK_SZ;
+constexpr ulong TSDK_SHA256_HASH_SZ = 32UL;
+
+/* Number of messages hash_many() runs through the compression function
+   in lockstep.  Two lanes keep both working states (16 words) resident
+   in the rv64 register file; wider batches spill. */
+constexpr ulong TSDK_SHA256_BATCH_MAX = 2UL;
+
+namespace thru {
+namespace crypto {
+
+namespace detail {
+
+inline constexpr uint SHA256_K[64] = {
+  0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+  0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+  0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+  0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+  0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+  0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+  0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+  0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U,
+};
+
+inline constexpr uint SHA256_H0[8] = {
+  0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+  0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U,
+};
+
+constexpr uint rotr(uint x, int n) { return (x >> n) | (x << (32 - n)); }
+
+/* Portable compression of the 64-byte block at p, usable in constant
+   expressions */
+constexpr void sha256_compress(uint* state, uchar const* p) {
+  uint W[64] = {};
+  for (ulong i = 0UL; i < 16UL; i++) {
+    W[i] = (uint)p[4UL * i] << 24 | (uint)p[4UL * i + 1UL] << 16 |
+           (uint)p[4UL * i + 2UL] << 8 | (uint)p[4UL * i + 3UL];
+  }
+  for (ulong i = 16UL; i < 64UL; i++) {
+    uint s0 = rotr(W[i - 15UL], 7) ^ rotr(W[i - 15UL], 18) ^ (W[i - 15UL] >> 3);
+    uint s1 = rotr(W[i - 2UL], 17) ^ rotr(W[i - 2UL], 19) ^ (W[i - 2UL] >> 10);
+    W[i] = W[i - 16UL] + s0 + W[i - 7UL] + s1;
+  }
+  uint a = state[0], b = state[1], c = state[2], d = state[3];
+  uint e = state[4], f = state[5], g = state[6], h = state[7];
+  for (ulong i = 0UL; i < 64UL; i++) {
+    uint T1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+              SHA256_K[i] + W[i];
+    uint T2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+} // namespace detail
+
+/* Compile-time SHA-256 of sz bytes at data, for digests of constant
+   inputs (program-defined addresses of fixed seeds, Merkle empty-subtree
+   hashes, ...).  Far slower than Sha256 at run time; in a constant
+   expression the result is a 32-byte literal. */
+constexpr pubkey_t sha256_constexpr(uchar const* data, ulong sz) {
+  uint state[8] = {};
+  for (ulong i = 0UL; i < 8UL; i++) {
+    state[i] = detail::SHA256_H0[i];
+  }
+  ulong full = sz >> TSDK_SHA256_LG_BLOCK_SZ;
+  for (ulong b = 0UL; b < full; b++) {
+    detail::sha256_compress(state, data + (b << TSDK_SHA256_LG_BLOCK_SZ));
+  }
+  uchar tail[2UL * TSDK_SHA256_BLOCK_SZ] = {};
+  ulong rem = sz & (TSDK_SHA256_BLOCK_SZ - 1UL);
+  for (ulong i = 0UL; i < rem; i++) {
+    tail[i] = data[(full << TSDK_SHA256_LG_BLOCK_SZ) + i];
+  }
+  tail[rem] = 0x80U;
+  ulong end = rem + 1UL > TSDK_SHA256_BLOCK_SZ - 8UL ? 2UL * TSDK_SHA256_BLOCK_SZ
+                                                      : TSDK_SHA256_BLOCK_SZ;
+  for (ulong i = 0UL; i < 8UL; i++) {
+    tail[end - 1UL - i] = static_cast<uchar>((sz << 3) >> (8UL * i));
+  }
+  for (ulong off = 0UL; off < end; off += TSDK_SHA256_BLOCK_SZ) {
+    detail::sha256_compress(state, tail + off);
+  }
+  /* key is the union member active in constant evaluation */
+  pubkey_t out{};
+  for (ulong i = 0UL; i < 8UL; i++) {
+    out.key[4UL * i] = static_cast<uchar>(state[i] >> 24);
+    out.key[4UL * i + 1UL] = static_cast<uchar>(state[i] >> 16);
+    out.key[4UL * i + 2UL] = static_cast<uchar>(state[i] >> 8);
+    out.key[4UL * i + 3UL] = static_cast<uchar>(state[i]);
+  }
+  return out;
+}
+
+/* Compile-time Sha256::hash_pair() */
+constexpr pubkey_t sha256_pair_constexpr(pubkey_t const& left, pubkey_t const& right) {
+  uchar block[2UL * TSDK_SHA256_HASH_SZ] = {};
+  for (ulong i = 0UL; i < TSDK_SHA256_HASH_SZ; i++) {
+    block[i] = left.key[i];
+    block[TSDK_SHA256_HASH_SZ + i] = right.key[i];
+  }
+  return sha256_constexpr(block, sizeof(block));
+}
+
+/* Sha256 is an incremental hasher.  It is trivially copyable, so a
+   hasher that has absorbed a common prefix can be copied to reuse its
+   midstate:
+
+     thru::crypto::Sha256 prefix;
+     prefix.append(owner, sizeof(pubkey_t));
+     thru::crypto::Sha256 h = prefix;
+     h.append(seed, 32UL).fini(&out); */
+
+class Sha256 {
+public:
+  Sha256() { init(); }
+
+  Sha256& init();
+
+  Sha256& append(const void* data, ulong sz);
+
+  Sha256& append(std::span<const std::byte> data) {
+    return append(data.data(), data.size());
+  }
+
+  /* Writes the 32-byte digest to hash and returns hash.  The hasher must
+     be re-initialized before reuse. */
+  void* fini(void* hash);
+
+  pubkey_t fini() {
+    pubkey_t out;
+    fini(&out);
+    return out;
+  }
+
+  /* One-shot hash of sz bytes at data into the 32 bytes at hash. */
+  static void* hash(const void* data, ulong sz, void* hash);
+
+  static pubkey_t hash(std::span<const std::byte> data) {
+    pubkey_t out;
+    hash(data.data(), data.size(), &out);
+    return out;
+  }
+
+  /* Hash of the 64-byte message left[0,32) || right[0,32), i.e. a
+     Merkle node over two child hashes.  Same digest as hash() on the
+     concatenation, without the copy into a contiguous buffer by the
+     caller, and the second (padding) block runs from a precomputed
+     message schedule.  hash may alias left or right. */
+  static void* hash_pair(const void* left, const void* right, void* hash);
+
+  static pubkey_t hash_pair(pubkey_t const& left, pubkey_t const& right) {
+    pubkey_t out;
+    hash_pair(&left, &right, &out);
+    return out;
+  }
+
+  /* Where a message whose first 32 bytes are fixed (an owner pubkey,
+     say) stands after rounds 0-7 of its first block, which read only
+     those bytes.  hash_prefixed() starts from here, skipping the
+     rounds and the copy into a hasher that a copied midstate would
+     still pay for. */
+  struct Prefix32 {
+    uint state[8];
+    uchar prefix[32];
+  };
+
+  static Prefix32 prefix32(const void* prefix);
+
+  /* Hash of prefix || rest[0,rest_sz) into the 32 bytes at hash */
+  static void* hash_prefixed(Prefix32 const& prefix, const void* rest, ulong rest_sz, void* hash);
+
+  /* Hashes cnt independent messages, writing digest i to hashes[i].
+     Messages are processed TSDK_SHA256_BATCH_MAX at a time with their
+     compression rounds interleaved, which hides the latency of the
+     dependent round chain of a single message.  Equal-length messages
+     (e.g. pairs of Merkle children) interleave for their full length. */
+  static void hash_many(const std::span<const std::byte>* msgs, ulong cnt,
+                        pubkey_t* hashes);
+
+  static void hash_many(std::span<const std::span<const std::byte>> msgs,
+                        pubkey_t* hashes) {
+    hash_many(msgs.data(), msgs.size(), hashes);
+  }
+
+  uint state_[8];                     /* Current hash state H^(i-1) */
+  uchar buf_[TSDK_SHA256_BLOCK_SZ];   /* Buffer for partial blocks */
+  ulong buf_used_;                    /* Number of bytes used in buf */
+  ulong bit_cnt_;                     /* Total number of bits processed */
+};
+
+} // namespace crypto
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_sha256_hpp */
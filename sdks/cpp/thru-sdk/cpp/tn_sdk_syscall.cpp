@@ -147,31 +147,16 @@ tsys_invoke( const void * instr_data, ulong instr_data_sz,
              tsdk_invoke_auth_t const * auth,
              ulong * invoke_err_code ) {
   /* Validate auth struct if provided */
-  if( auth != nullptr ) {
-    if( auth->magic != TSDK_INVOKE_AUTH_MAGIC ) {
-      tsdk_revert( TSDK_INVOKE_AUTH_ERR_BAD_MAGIC );
-    }
-
-    ushort const * auth_idxs = auth->auth_idxs( );
-    for( ushort i = 0; i < auth->auth_cnt; i++ ) {
-      ushort acc_idx = auth_idxs[ i ];
-      if( !tsdk_is_account_idx_valid( acc_idx ) ) {
-        tsdk_revert( TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX );
-      }
-      if( !tsdk_is_account_owned_by_current_program( acc_idx ) ) {
-        tsdk_revert( TSDK_INVOKE_AUTH_ERR_UNOWNED_AUTH_ACCOUNT );
-      }
-    }
-
-    ushort const * deauth_idxs = auth->deauth_idxs( );
-    for( ushort j = 0; j < auth->deauth_cnt; j++ ) {
-      if( !tsdk_is_account_idx_valid( deauth_idxs[ j ] ) ) {
-        tsdk_revert( TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX );
-      }
-    }
-
-  }
+  if( auth != nullptr ) tsdk_invoke_auth_validate( auth );
+  return tsys_invoke_unchecked( instr_data, instr_data_sz, program_account_idx, auth,
+                                invoke_err_code );
+}
 
+ulong
+tsys_invoke_unchecked( const void * instr_data, ulong instr_data_sz,
+                       ushort program_account_idx,
+                       tsdk_invoke_auth_t const * auth,
+                       ulong * invoke_err_code ) {
   register ulong a0 __asm__ ( "a0" ) = reinterpret_cast<ulong>( instr_data );
   register ulong a1 __asm__ ( "a1" ) = instr_data_sz;
   register ulong a2 __asm__ ( "a2" ) = static_cast<ulong>( program_account_idx );
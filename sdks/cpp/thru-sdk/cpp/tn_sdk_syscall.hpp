@@ -29,6 +29,12 @@ constexpr ulong TSDK_INVOKE_AUTH_MAGIC = 0xC3F7A1D9E5B20846UL;
 constexpr ulong TSDK_INVOKE_AUTH_ERR_BAD_MAGIC             = 0xBAD0A170UL;
 constexpr ulong TSDK_INVOKE_AUTH_ERR_UNOWNED_AUTH_ACCOUNT  = 0xBAD0A171UL;
 constexpr ulong TSDK_INVOKE_AUTH_ERR_INVALID_ACCOUNT_INDEX = 0xBAD0A173UL;
+/* A parent frame's auth list names an account its program does not own */
+constexpr ulong TSDK_INVOKE_AUTH_ERR_PARENT_UNOWNED        = 0xBAD0A174UL;
+/* More indices added to a thru::InvokeAuth than it has room for */
+constexpr ulong TSDK_INVOKE_AUTH_ERR_TOO_MANY              = 0xBAD0A175UL;
+/* A thru::InvokeAuthToken used after its list changed */
+constexpr ulong TSDK_INVOKE_AUTH_ERR_STALE_TOKEN           = 0xBAD0A176UL;
 
 struct tsdk_invoke_auth {
   ulong  magic;
@@ -80,6 +86,14 @@ ulong tsys_invoke( const void * instr_data, ulong instr_data_sz,
                    tsdk_invoke_auth_t const * auth,
                    ulong * invoke_err_code );
 
+/* tsys_invoke without the program-side auth checks.  Only for auth
+   already checked by tsdk_invoke_auth_validate in this frame (see
+   thru::InvokeAuth::validate). */
+ulong tsys_invoke_unchecked( const void * instr_data, ulong instr_data_sz,
+                             ushort program_account_idx,
+                             tsdk_invoke_auth_t const * auth,
+                             ulong * invoke_err_code );
+
 [[noreturn]] ulong tsys_exit( ulong exit_code, ulong revert );
 
 ulong tsys_log( const void * data, ulong data_len );
@@ -0,0 +1,213 @@
+#ifndef HEADER_sdks_cpp_tn_sdk_vec_hpp
+#define HEADER_sdks_cpp_tn_sdk_vec_hpp
+
+#include "tn_sdk.hpp"
+
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/* AccountVec<T> is a growable array stored in an account's data, for
+   programs that append records (order history, audit logs, ...).
+
+   Memory layout:
+
+     [Header (24 bytes)][T 0] ... [T capacity - 1]
+
+   The length lives in the header; the capacity is whatever the account
+   data size holds.  Appending past the capacity resizes the account
+   geometrically (doubling, up to TN_ACCOUNT_DATA_SZ_MAX), so N appends
+   cost O(log N) tsys_account_resize calls instead of one each:
+
+     thru::WritableSet writable;
+     auto history = thru::AccountVec<Order>::join(thru::Account(3), writable);
+     history.push_back(order);
+
+   reserve() resizes once up front when the final length is known, and
+   shrink_to_fit() gives the slack back, e.g. before the account is
+   compressed.  Both the header and the elements are plain data, so the
+   vector is joined in place on every invocation with no
+   deserialization.  Resizing needs the account to be owned by the
+   program, as tsys_account_resize does. */
+
+constexpr ulong TSDK_ACCOUNT_VEC_MAGIC = 0xACC0E7EC0C0DE001UL;
+
+/* AccountVec revert codes */
+constexpr ulong TSDK_ACCOUNT_VEC_ERR_INVALID       = 0xBAD0BB00UL; /* Not a vector of this element type */
+constexpr ulong TSDK_ACCOUNT_VEC_ERR_FULL          = 0xBAD0BB01UL; /* Past TN_ACCOUNT_DATA_SZ_MAX */
+constexpr ulong TSDK_ACCOUNT_VEC_ERR_RESIZE_FAILED = 0xBAD0BB02UL; /* tsys_account_resize refused */
+constexpr ulong TSDK_ACCOUNT_VEC_ERR_EMPTY         = 0xBAD0BB03UL; /* pop_back on an empty vector */
+
+namespace thru {
+
+struct AccountVecHeader {
+  ulong magic;
+  uint elem_sz;
+  uint reserved;
+  ulong len;
+};
+
+template <typename T> class AccountVec {
+  static_assert(std::is_trivially_copyable_v<T>, "account layout must be trivially copyable");
+  static_assert(std::is_standard_layout_v<T>, "account layout must be standard layout");
+  static_assert(std::has_unique_object_representations_v<T>,
+                "account layout has padding; reorder or pack its fields");
+  static_assert(alignof(T) <= TSDK_PAGE_SZ, "account layout over-aligned");
+
+public:
+  using value_type = T;
+  using Header = AccountVecHeader;
+
+  static constexpr ulong DATA_OFF = mem::align_up(sizeof(Header), alignof(T));
+  static constexpr ulong CAPACITY_MAX = (TN_ACCOUNT_DATA_SZ_MAX - DATA_OFF) / sizeof(T);
+  static constexpr ulong GROW_MIN = 4UL; /* Capacity of the first growth */
+
+  /* Account data bytes for cnt elements */
+  static constexpr ulong footprint(ulong cnt) { return DATA_OFF + cnt * sizeof(T); }
+
+  /* Formats account's data as an empty vector with room for capacity
+     elements, resizing the account to fit.  Anything already in the
+     account is discarded. */
+  static AccountVec format(Account account, WritableSet& writable, ulong capacity = 0UL) {
+    writable.promote(account.index());
+    resize_account(account.index(), capacity);
+    Header* hdr = account.get_data_as<Header>();
+    hdr->magic = TSDK_ACCOUNT_VEC_MAGIC;
+    hdr->elem_sz = static_cast<uint>(sizeof(T));
+    hdr->reserved = 0U;
+    hdr->len = 0UL;
+    return AccountVec(account.index(), hdr, capacity);
+  }
+
+  /* Joins the vector formatted in account's data, promoting the account
+     through writable.  Reverts with TSDK_ACCOUNT_VEC_ERR_INVALID unless
+     the account holds a vector of T. */
+  static AccountVec join(Account account, WritableSet& writable) {
+    return AccountVec(AccountViewMut<Header>(account, writable));
+  }
+
+  /* Joins through a view that already checked and promoted the account */
+  explicit AccountVec(AccountViewMut<Header> const& view)
+      : idx_(view.index()), hdr_(view.get()), cap_(checked_capacity(view.get(), view.data_sz())) {}
+
+  /* The elements of the vector formatted in account's data, read-only */
+  static std::span<const T> view(Account account) {
+    AccountView<Header> hdr(account);
+    checked_capacity(hdr.get(), hdr.data_sz());
+    return {reinterpret_cast<T const*>(reinterpret_cast<uchar const*>(hdr.get()) + DATA_OFF),
+            hdr->len};
+  }
+
+  ulong size() const { return hdr_->len; }
+  bool empty() const { return !hdr_->len; }
+  ulong capacity() const { return cap_; }
+  ushort index() const { return idx_; }
+
+  T* data() const { return reinterpret_cast<T*>(reinterpret_cast<uchar*>(hdr_) + DATA_OFF); }
+  T* begin() const { return data(); }
+  T* end() const { return data() + hdr_->len; }
+  T& operator[](ulong i) const { return data()[i]; }
+  T& front() const { return data()[0]; }
+  T& back() const { return data()[hdr_->len - 1UL]; }
+  std::span<T> span() const { return {data(), hdr_->len}; }
+
+  void push_back(T const& v) {
+    ulong len = hdr_->len;
+    if (TSDK_UNLIKELY(len == cap_)) {
+      grow(len + 1UL);
+    }
+    std::memcpy(data() + len, &v, sizeof(T));
+    hdr_->len = len + 1UL;
+  }
+
+  /* Appends every element of vs with at most one resize */
+  void append(std::span<const T> vs) {
+    ulong len = hdr_->len;
+    if (TSDK_UNLIKELY(vs.size() > cap_ - len)) {
+      if (TSDK_UNLIKELY(vs.size() > CAPACITY_MAX - len)) {
+        tsdk_revert(TSDK_ACCOUNT_VEC_ERR_FULL);
+      }
+      grow(len + vs.size());
+    }
+    std::memcpy(data() + len, vs.data(), vs.size() * sizeof(T));
+    hdr_->len = len + vs.size();
+  }
+
+  void pop_back() {
+    if (TSDK_UNLIKELY(!hdr_->len)) {
+      tsdk_revert(TSDK_ACCOUNT_VEC_ERR_EMPTY);
+    }
+    hdr_->len--;
+  }
+
+  void clear() { hdr_->len = 0UL; }
+
+  /* Sets the length to cnt; new elements are zeroed */
+  void resize(ulong cnt) {
+    ulong len = hdr_->len;
+    if (cnt > cap_) {
+      grow(cnt);
+    }
+    if (cnt > len) {
+      std::memset(data() + len, 0, (cnt - len) * sizeof(T));
+    }
+    hdr_->len = cnt;
+  }
+
+  /* Makes room for cnt elements with a single resize, if needed */
+  void reserve(ulong cnt) {
+    if (cnt > cap_) {
+      set_capacity(cnt);
+    }
+  }
+
+  /* Resizes the account down to the current length */
+  void shrink_to_fit() {
+    if (cap_ > hdr_->len) {
+      set_capacity(hdr_->len);
+    }
+  }
+
+private:
+  AccountVec(ushort idx, Header* hdr, ulong cap) : idx_(idx), hdr_(hdr), cap_(cap) {}
+
+  static ulong checked_capacity(Header const* hdr, ulong data_sz) {
+    ulong cap = data_sz < DATA_OFF ? 0UL : (data_sz - DATA_OFF) / sizeof(T);
+    if (TSDK_UNLIKELY(data_sz < DATA_OFF || hdr->magic != TSDK_ACCOUNT_VEC_MAGIC ||
+                      hdr->elem_sz != sizeof(T) || hdr->len > cap)) {
+      tsdk_revert(TSDK_ACCOUNT_VEC_ERR_INVALID);
+    }
+    return cap;
+  }
+
+  static void resize_account(ushort idx, ulong cnt) {
+    if (TSDK_UNLIKELY(cnt > CAPACITY_MAX)) {
+      tsdk_revert(TSDK_ACCOUNT_VEC_ERR_FULL);
+    }
+    if (TSDK_UNLIKELY(tsys_account_resize(idx, footprint(cnt)) != TSDK_SUCCESS)) {
+      tsdk_revert(TSDK_ACCOUNT_VEC_ERR_RESIZE_FAILED);
+    }
+  }
+
+  /* Doubles the capacity, or more if needed is larger */
+  void grow(ulong needed) {
+    ulong cap = cap_ < GROW_MIN ? GROW_MIN : cap_ * 2UL;
+    if (cap > CAPACITY_MAX) {
+      cap = CAPACITY_MAX;
+    }
+    set_capacity(cap > needed ? cap : needed);
+  }
+
+  void set_capacity(ulong cnt) {
+    resize_account(idx_, cnt);
+    cap_ = cnt;
+  }
+
+  ushort idx_;
+  Header* hdr_;
+  ulong cap_;
+};
+
+} // namespace thru
+
+#endif /* HEADER_sdks_cpp_tn_sdk_vec_hpp */
@@ -173,6 +173,10 @@ constexpr uint TN_TXN_FLAG_HAS_FEE_PAYER_PROOF = 0U;
 
 constexpr uchar TN_TXN_V1 = 0x01;
 
+/* Maximum number of accounts (fee payer, program and inputs) a
+   transaction may reference */
+constexpr ulong TN_TXN_ACCT_MAX = 1024UL;
+
 constexpr int TSDK_REG_MAX = 32;
 
 struct tsdk_shadow_stack_frame {
@@ -215,6 +219,21 @@ static_assert(offsetof(tn_block_ctx, cur_block_hash) == 56UL, "tn_block_ctx_cur_
 static_assert(offsetof(tn_block_ctx, block_producer) == 88UL, "tn_block_ctx_block_producer_offset");
 static_assert(offsetof(tn_block_ctx, weight_slot) == 120UL, "tn_block_ctx_weight_slot_offset");
 
+// State proof header, followed by (type + popcount(path_bitset)) 32-byte
+// hashes: the leaf the type needs, then one sibling hash per set bit
+struct __attribute__((packed)) tn_state_proof_hdr {
+  ulong type_slot;      // Upper 2 bits are the proof type, low 62 bits the slot
+  pubkey_t path_bitset; // Trie levels that carry a sibling hash
+};
+
+static_assert(sizeof(tn_state_proof_hdr) == 40UL, "tn_state_proof_hdr_size");
+static_assert(offsetof(tn_state_proof_hdr, path_bitset) == 8UL, "tn_state_proof_hdr_path_bitset_offset");
+
+constexpr ulong TN_STATE_PROOF_KEYS_MAX = 256UL;
+constexpr ulong TN_STATE_PROOF_TYPE_EXISTING = 0UL; // Sibling hashes; decompresses an account
+constexpr ulong TN_STATE_PROOF_TYPE_UPDATING = 1UL; // Leaf hash + siblings; recompresses an account
+constexpr ulong TN_STATE_PROOF_TYPE_CREATION = 2UL; // Neighbouring leaf pubkey + hash + siblings
+
 // Block context constants
 
 #endif /* HEADER_sdks_cpp_types_tn_types_hpp */
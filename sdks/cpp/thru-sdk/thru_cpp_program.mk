@@ -13,6 +13,6 @@ include $(THRU_CPP_SDK_DIR)/config/base.mk
 CPPFLAGS+=-I$(THRU_CPP_SDK_DIR)/include
 LDFLAGS+=-L$(THRU_CPP_SDK_DIR)/lib
 
-include $(THRU_CPP_SDK_DIR)/config/machine/thruvm.mk
+include $(THRU_CPP_SDK_DIR)/config/machine/$(MACHINE).mk
 include $(addprefix $(THRU_CPP_SDK_DIR)/config/extra/with-,$(addsuffix .mk,$(SDK_EXTRAS)))
 include $(THRU_CPP_SDK_DIR)/config/thru_cpp.mk 
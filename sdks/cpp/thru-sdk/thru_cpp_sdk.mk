@@ -9,6 +9,6 @@ all:
 
 # Include configuration
 include $(THRU_CPP_SDK_DIR)/config/base.mk
-include $(THRU_CPP_SDK_DIR)/config/machine/thruvm.mk
+include $(THRU_CPP_SDK_DIR)/config/machine/$(MACHINE).mk
 include $(addprefix $(THRU_CPP_SDK_DIR)/config/extra/with-,$(addsuffix .mk,$(SDK_EXTRAS)))
 include $(THRU_CPP_SDK_DIR)/config/thru_cpp.mk 
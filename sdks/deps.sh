@@ -718,11 +718,13 @@ install_blst () {
 	-march=rv64imc_zba_zbb_zbc_zbs_zknh -mabi=lp64 -mcmodel=medlow -mstrict-align \
 	-specs=picolibc.specs --picolibc-prefix=$PREFIX -O2 -fno-stack-protector -ffreestanding \
 	-ffunction-sections -fdata-sections -nostartfiles -static-pie -fPIE \
-	-Werror -Wall -Wextra"
+	-Werror -Wall -Wextra -fcallgraph-info=su"
 
   ./build.sh CROSS_COMPILE=riscv64-unknown-elf- CC=$PREFIX/bin/riscv64-unknown-elf-gcc AR=$PREFIX/bin/riscv64-unknown-elf-ar RANLIB=$PREFIX/bin/riscv64-unknown-elf-ranlib 
   unset CFLAGS
   cp libblst.a "$PREFIX/lib"
+  # Call graph for the C++ SDK's stack check (SDK_EXTRAS=blst)
+  cat ./*.ci > "$PREFIX/lib/libblst.ci"
   cp bindings/blst.h "$PREFIX/include"
   cp bindings/blst_aux.h "$PREFIX/include"
   echo "[+] Successfully installed libblst"
@@ -17,6 +17,7 @@ pub use vmptr::{copy_bytes_strict, copy_nonoverlapping, VmPtr, VmPtrMut};
 /// Error code used by the panic handler
 pub const PANIC_ERROR_CODE: u64 = 555;
 
+#[cfg(not(test))]
 mod panic;
 pub mod program_utils {
     use crate::mem::{get_account_meta_at_idx, get_txn};
@@ -164,3 +164,97 @@ impl<'a> StateProof<'a> {
         self.data.as_ptr()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Updating proof at slot 0x0102030405 with path bits 29 and 136 set:
+    /// header, leaf hash, then two sibling hashes. Shared byte for byte with
+    /// the C++ SDK's test_proof.cpp.
+    #[rustfmt::skip]
+    const FIXTURE: [u8; 136] = [
+        0x05, 0x04, 0x03, 0x02, 0x01, 0x00, 0x00, 0x40, // type_slot
+        0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, // path_bitset
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, // leaf hash
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, // sibling 0
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, // sibling 1
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+    ];
+
+    #[test]
+    fn test_fixture() {
+        let proof = StateProof::parse_proof(&FIXTURE).unwrap();
+        assert!(matches!(proof.proof_type(), ProofType::Updating));
+        assert_eq!(proof.slot(), 0x0102030405);
+        assert_eq!(proof.footprint(), FIXTURE.len());
+        assert_eq!(proof.as_ptr(), FIXTURE.as_ptr());
+        let unchecked = unsafe { StateProof::parse_proof_unchecked(FIXTURE.as_ptr()) };
+        assert_eq!(unchecked, proof);
+    }
+
+    #[test]
+    fn test_each_type() {
+        // Existing has no leaf entries, Updating the leaf hash, Creation the
+        // leaf pubkey and hash
+        for (ty, leaf_cnt) in [(0u64, 0usize), (1, 1), (2, 2)] {
+            let mut data = [0x44u8; 40 + 4 * 32];
+            data[..40].copy_from_slice(&FIXTURE[..40]);
+            data[7] = (ty << 6) as u8;
+            let len = 40 + (leaf_cnt + 2) * 32;
+            let proof = StateProof::parse_proof(&data[..len]).unwrap();
+            assert_eq!(proof.proof_type() as u64, ty);
+            assert_eq!(proof.footprint(), len);
+        }
+    }
+
+    #[test]
+    fn test_truncated() {
+        for len in 0..40 {
+            assert!(matches!(
+                StateProof::parse_proof_prefix(&FIXTURE[..len]),
+                Err(ProofParseError::Truncated)
+            ));
+        }
+        for len in 40..FIXTURE.len() {
+            assert!(matches!(
+                StateProof::parse_proof_prefix(&FIXTURE[..len]),
+                Err(ProofParseError::MisSized)
+            ));
+        }
+    }
+
+    #[test]
+    fn test_oversized() {
+        let mut data = [0xEEu8; 136 + 5];
+        data[..136].copy_from_slice(&FIXTURE);
+        assert!(matches!(
+            StateProof::parse_proof(&data),
+            Err(ProofParseError::MisSized)
+        ));
+        let (proof, rest) = StateProof::parse_proof_prefix(&data).unwrap();
+        assert_eq!(proof.footprint(), FIXTURE.len());
+        assert_eq!(rest, &[0xEE; 5]);
+    }
+
+    #[test]
+    fn test_invalid_type() {
+        let mut data = FIXTURE;
+        data[7] |= 0xC0;
+        assert!(matches!(
+            StateProof::parse_proof(&data),
+            Err(ProofParseError::InvalidProofType)
+        ));
+    }
+}